@@ -0,0 +1,56 @@
+// Global operator new/delete overrides that count heap traffic for the
+// benchmark. Only linked into simulator_bench.
+#include "BenchHarness.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> gAllocCount{0};
+static std::atomic<uint64_t> gAllocBytes{0};
+
+AllocSnapshot GetAllocSnapshot() {
+  AllocSnapshot s;
+  s.count = gAllocCount.load(std::memory_order_relaxed);
+  s.bytes = gAllocBytes.load(std::memory_order_relaxed);
+  return s;
+}
+
+static void *CountedAlloc(std::size_t size) {
+  gAllocCount.fetch_add(1, std::memory_order_relaxed);
+  gAllocBytes.fetch_add(size, std::memory_order_relaxed);
+  if (size == 0)
+    size = 1;
+  return std::malloc(size);
+}
+
+void *operator new(std::size_t size) {
+  void *p = CountedAlloc(size);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](std::size_t size) {
+  void *p = CountedAlloc(size);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return CountedAlloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return CountedAlloc(size);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  std::free(p);
+}
@@ -0,0 +1,179 @@
+#include "BenchHarness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+size_t GetPeakRssKb() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS pmc = {};
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    return static_cast<size_t>(pmc.PeakWorkingSetSize / 1024);
+  return 0;
+#else
+  struct rusage usage = {};
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return static_cast<size_t>(usage.ru_maxrss / 1024); // bytes on macOS
+#else
+  return static_cast<size_t>(usage.ru_maxrss); // KiB on Linux
+#endif
+#endif
+}
+
+// --- Statistics ---
+
+struct SampleStats {
+  double mean = 0, median = 0, p99 = 0, min = 0, max = 0, stddev = 0;
+};
+
+static SampleStats ComputeStats(std::vector<double> samples) {
+  SampleStats s;
+  if (samples.empty())
+    return s;
+
+  std::sort(samples.begin(), samples.end());
+  size_t n = samples.size();
+
+  double sum = 0.0;
+  for (double v : samples)
+    sum += v;
+  s.mean = sum / n;
+
+  double var = 0.0;
+  for (double v : samples)
+    var += (v - s.mean) * (v - s.mean);
+  s.stddev = std::sqrt(var / n);
+
+  s.min = samples.front();
+  s.max = samples.back();
+  s.median = (n % 2) ? samples[n / 2]
+                     : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+
+  // Nearest-rank percentile
+  size_t rank = static_cast<size_t>(std::ceil(0.99 * n));
+  s.p99 = samples[std::min(n - 1, rank > 0 ? rank - 1 : 0)];
+  return s;
+}
+
+// --- JSON ---
+
+static std::string JsonEscape(const std::string &in) {
+  std::string out;
+  out.reserve(in.size() + 2);
+  for (char c : in) {
+    switch (c) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+        out += ' ';
+      else
+        out += c;
+    }
+  }
+  return out;
+}
+
+static std::string JsonNumber(double v) {
+  if (!std::isfinite(v))
+    return "null";
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.6g", v);
+  return buf;
+}
+
+static const char *CompilerString() {
+#if defined(_MSC_VER)
+  return "msvc";
+#elif defined(__clang__)
+  return "clang";
+#elif defined(__GNUC__)
+  return "gcc";
+#else
+  return "unknown";
+#endif
+}
+
+void WriteJsonReport(std::ostream &out, const BenchOptions &opts,
+                     const std::vector<ScenarioResult> &results) {
+  std::time_t now = std::time(nullptr);
+  char timeBuf[32] = {};
+  std::strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%dT%H:%M:%SZ",
+                std::gmtime(&now));
+
+  out << "{\n";
+  out << "  \"schema\": \"vex-sim-bench/1\",\n";
+  out << "  \"timestamp\": \"" << timeBuf << "\",\n";
+  out << "  \"compiler\": \"" << CompilerString() << "\",\n";
+#ifdef NDEBUG
+  out << "  \"build\": \"release\",\n";
+#else
+  out << "  \"build\": \"debug\",\n";
+#endif
+  out << "  \"hardware_threads\": " << std::thread::hardware_concurrency()
+      << ",\n";
+  out << "  \"config\": {\"steps\": " << opts.steps
+      << ", \"warmup\": " << opts.warmup
+      << ", \"iterations\": " << opts.iterations << ", \"seed\": " << opts.seed
+      << ", \"physx_pool\": " << (opts.poolAllocations ? "true" : "false")
+      << ", \"broadphase\": \"" << JsonEscape(opts.broadPhase)
+      << "\", \"field_collision\": \"" << JsonEscape(opts.fieldCollision)
+      << "\"},\n";
+  out << "  \"scenarios\": [\n";
+
+  for (size_t i = 0; i < results.size(); i++) {
+    const ScenarioResult &r = results[i];
+    SampleStats st = ComputeStats(r.samplesMs);
+    size_t n = r.samplesMs.size();
+
+    out << "    {\n";
+    out << "      \"name\": \"" << JsonEscape(r.name) << "\",\n";
+    out << "      \"status\": \"" << r.status << "\",\n";
+    if (!r.note.empty())
+      out << "      \"note\": \"" << JsonEscape(r.note) << "\",\n";
+    out << "      \"samples\": " << n << ",\n";
+    out << "      \"time_ms\": {\"mean\": " << JsonNumber(st.mean)
+        << ", \"median\": " << JsonNumber(st.median)
+        << ", \"p99\": " << JsonNumber(st.p99)
+        << ", \"min\": " << JsonNumber(st.min)
+        << ", \"max\": " << JsonNumber(st.max)
+        << ", \"stddev\": " << JsonNumber(st.stddev) << "},\n";
+    out << "      \"allocations\": {\"count\": " << r.allocCount
+        << ", \"bytes\": " << r.allocBytes << ", \"per_sample\": "
+        << JsonNumber(n ? static_cast<double>(r.allocCount) / n : 0.0)
+        << "},\n";
+    out << "      \"peak_rss_kb\": " << r.peakRssKb << ",\n";
+    out << "      \"metrics\": {";
+    for (size_t m = 0; m < r.metrics.size(); m++) {
+      out << (m ? ", " : "") << "\"" << JsonEscape(r.metrics[m].first)
+          << "\": " << JsonNumber(r.metrics[m].second);
+    }
+    out << "}\n";
+    out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+
+  out << "  ]\n";
+  out << "}\n";
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// --- Process probes ---
+
+// Heap counters maintained by the operator new/delete overrides in
+// AllocCounter.cpp. Monotonic, process-wide.
+struct AllocSnapshot {
+  uint64_t count = 0;
+  uint64_t bytes = 0;
+};
+AllocSnapshot GetAllocSnapshot();
+
+// Peak resident set size of this process in KiB (monotonic).
+size_t GetPeakRssKb();
+
+// --- Options / results ---
+
+struct BenchOptions {
+  int steps = 600;    // Timed physics steps per scenario (10 s of sim time)
+  int warmup = 120;   // Untimed steps before measuring (lets piles settle)
+  int iterations = 5; // Timed repetitions for load/upload scenarios
+  uint32_t seed = 1234;
+  bool poolAllocations = false; // PhysicsConfig::poolSmallAllocations
+  std::string broadPhase = "abp"; // Default for non-broadphase_* scenarios
+  std::string fieldCollision = "proxies"; // Default for non-narrowphase_*
+  std::string filter;  // Only run scenarios whose name contains this
+  std::string outPath; // JSON report path ("" = stdout)
+  bool list = false;
+};
+
+struct ScenarioResult {
+  std::string name;
+  std::string status = "ok"; // "ok" | "skipped" | "failed"
+  std::string note;
+
+  std::vector<double> samplesMs;
+  uint64_t allocCount = 0; // Heap allocations during the timed section
+  uint64_t allocBytes = 0;
+  size_t peakRssKb = 0;
+
+  // Scenario-specific extras (body counts, cook sizes, ...)
+  std::vector<std::pair<std::string, double>> metrics;
+
+  void AddMetric(const std::string &key, double value) {
+    metrics.emplace_back(key, value);
+  }
+};
+
+// Runs `warmup` untimed calls and then `samples` timed calls of fn(i),
+// recording per-call wall time and the heap traffic of the timed section.
+template <typename F>
+void MeasureSamples(ScenarioResult &result, int warmup, int samples, F &&fn) {
+  for (int i = 0; i < warmup; i++)
+    fn(i);
+
+  result.samplesMs.reserve(result.samplesMs.size() + samples);
+  AllocSnapshot before = GetAllocSnapshot();
+  for (int i = 0; i < samples; i++) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn(warmup + i);
+    auto t1 = std::chrono::steady_clock::now();
+    result.samplesMs.push_back(
+        std::chrono::duration<double, std::milli>(t1 - t0).count());
+  }
+  AllocSnapshot after = GetAllocSnapshot();
+
+  // samplesMs was reserved above, so its push_back never shows up here
+  result.allocCount += after.count - before.count;
+  result.allocBytes += after.bytes - before.bytes;
+}
+
+// Writes every result as one JSON document (schema "vex-sim-bench/1")
+void WriteJsonReport(std::ostream &out, const BenchOptions &opts,
+                     const std::vector<ScenarioResult> &results);
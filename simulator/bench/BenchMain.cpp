@@ -0,0 +1,151 @@
+// simulator_bench — reproducible performance scenarios with a JSON report
+//
+//   simulator_bench [--filter name] [--steps N] [--warmup N]
+//                   [--iterations N] [--seed N] [--pool]
+//                   [--broadphase sap|mbp|abp]
+//                   [--field-collision mesh|proxies]
+//                   [--out report.json] [--list]
+//
+// Peak RSS is process-wide; run one scenario per process (--filter) when
+// comparing memory between releases.
+#include "BenchHarness.h"
+#include "FieldCollision.h"
+#include "PhysicsWorld.h"
+#include "Scenarios.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static void PrintUsage() {
+  std::cerr << "Usage: simulator_bench [--filter name] [--steps N] "
+               "[--warmup N] [--iterations N] [--seed N] [--pool] "
+               "[--broadphase sap|mbp|abp] "
+               "[--field-collision mesh|proxies] [--out file.json] [--list]"
+            << std::endl;
+}
+
+static bool ParseArgs(int argc, char **argv, BenchOptions &opts) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    auto needValue = [&]() {
+      if (!value) {
+        std::cerr << "Missing value for " << arg << std::endl;
+        return false;
+      }
+      i++;
+      return true;
+    };
+
+    if (!strcmp(arg, "--list")) {
+      opts.list = true;
+    } else if (!strcmp(arg, "--pool")) {
+      opts.poolAllocations = true;
+    } else if (!strcmp(arg, "--filter")) {
+      if (!needValue())
+        return false;
+      opts.filter = value;
+    } else if (!strcmp(arg, "--broadphase")) {
+      if (!needValue())
+        return false;
+      PxBroadPhaseType::Enum type;
+      if (!ParseBroadPhaseType(value, type)) {
+        std::cerr << "Unknown broadphase: " << value << std::endl;
+        return false;
+      }
+      opts.broadPhase = value;
+    } else if (!strcmp(arg, "--field-collision")) {
+      if (!needValue())
+        return false;
+      FieldCollisionMode mode;
+      if (!ParseFieldCollisionMode(value, mode)) {
+        std::cerr << "Unknown field collision mode: " << value << std::endl;
+        return false;
+      }
+      opts.fieldCollision = value;
+    } else if (!strcmp(arg, "--out")) {
+      if (!needValue())
+        return false;
+      opts.outPath = value;
+    } else if (!strcmp(arg, "--steps")) {
+      if (!needValue())
+        return false;
+      opts.steps = std::atoi(value);
+    } else if (!strcmp(arg, "--warmup")) {
+      if (!needValue())
+        return false;
+      opts.warmup = std::atoi(value);
+    } else if (!strcmp(arg, "--iterations")) {
+      if (!needValue())
+        return false;
+      opts.iterations = std::atoi(value);
+    } else if (!strcmp(arg, "--seed")) {
+      if (!needValue())
+        return false;
+      opts.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+    } else {
+      std::cerr << "Unknown argument: " << arg << std::endl;
+      return false;
+    }
+  }
+  return opts.steps > 0 && opts.warmup >= 0 && opts.iterations > 0;
+}
+
+int main(int argc, char **argv) {
+  BenchOptions opts;
+  if (!ParseArgs(argc, argv, opts)) {
+    PrintUsage();
+    return 1;
+  }
+
+  const std::vector<Scenario> &scenarios = GetScenarios();
+  if (opts.list) {
+    for (const Scenario &s : scenarios)
+      std::cout << s.name << "\t" << s.description << std::endl;
+    return 0;
+  }
+
+  // Subsystems log to std::cout; send that to stderr while scenarios run so
+  // stdout carries nothing but the JSON report.
+  std::streambuf *stdoutBuf = std::cout.rdbuf(std::cerr.rdbuf());
+
+  std::vector<ScenarioResult> results;
+  for (const Scenario &s : scenarios) {
+    if (!opts.filter.empty() &&
+        std::string(s.name).find(opts.filter) == std::string::npos)
+      continue;
+
+    std::cerr << "[Bench] " << s.name << "..." << std::endl;
+    ScenarioResult result;
+    result.name = s.name;
+    try {
+      s.run(opts, result);
+    } catch (const std::exception &e) {
+      result.status = "failed";
+      result.note = e.what();
+    }
+    result.peakRssKb = GetPeakRssKb();
+    results.push_back(std::move(result));
+  }
+  std::cout.rdbuf(stdoutBuf);
+
+  if (opts.outPath.empty()) {
+    WriteJsonReport(std::cout, opts, results);
+  } else {
+    std::ofstream out(opts.outPath);
+    if (!out) {
+      std::cerr << "[Bench] Cannot write " << opts.outPath << std::endl;
+      return 1;
+    }
+    WriteJsonReport(out, opts, results);
+    std::cerr << "[Bench] Report written to " << opts.outPath << std::endl;
+  }
+
+  for (const ScenarioResult &r : results) {
+    if (r.status == "failed")
+      return 2;
+  }
+  return 0;
+}
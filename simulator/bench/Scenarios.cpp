@@ -0,0 +1,774 @@
+#include "Scenarios.h"
+#include "AssetBundle.h"
+#include "AssetLoader.h"
+#include "FieldCollision.h"
+#include "GameBlock.h"
+#include "GlbFile.h"
+#include "MeshKernels.h"
+#include "PhysicsWorld.h"
+#include "Robot.h"
+#include "renderer/ModelLoader.h"
+#include "renderer/VulkanContext.h"
+
+#include <GLFW/glfw3.h>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <random>
+
+static const float kStep = 1.0f / 60.0f;
+static const char *kFieldPath = "assets/field.glb";
+
+// --- Shared world setup ---
+
+// Field GLB for physics, parsed once per process so physics scenarios
+// neither pay for nor measure the load.
+static const GlbFile *GetFieldModel() {
+  static GlbFile model;
+  static bool attempted = false;
+  static bool ok = false;
+  if (!attempted) {
+    attempted = true;
+    std::string err;
+    ok = model.Open(kFieldPath, &err) && !model.GetMeshes().empty();
+    if (!ok) {
+      std::cerr << "[Bench] Field GLB unavailable (" << err
+                << "), falling back to a ground plane." << std::endl;
+    }
+  }
+  return ok ? &model : nullptr;
+}
+
+static PhysicsConfig BenchPhysicsConfig(const BenchOptions &opts) {
+  PhysicsConfig config;
+  config.enablePvd = false;
+  config.enhancedDeterminism = true;
+  config.poolSmallAllocations = opts.poolAllocations;
+  ParseBroadPhaseType(opts.broadPhase, config.broadPhase);
+  return config;
+}
+
+static FieldCollisionMode BenchFieldMode(const BenchOptions &opts) {
+  FieldCollisionMode mode = FieldCollisionMode::ePROXIES;
+  ParseFieldCollisionMode(opts.fieldCollision, mode);
+  return mode;
+}
+
+// PhysX allocator totals plus the five largest categories by high-water mark
+static void AddPhysxMemoryMetrics(ScenarioResult &result,
+                                  const PhysicsWorld &physics) {
+  AllocatorStats stats = physics.GetAllocatorStats();
+  result.AddMetric("physx_live_bytes", static_cast<double>(stats.liveBytes));
+  result.AddMetric("physx_peak_bytes", static_cast<double>(stats.peakBytes));
+  result.AddMetric("physx_total_allocs",
+                   static_cast<double>(stats.totalAllocs));
+  result.AddMetric("physx_pool_reserved_bytes",
+                   static_cast<double>(stats.poolReservedBytes));
+  for (size_t i = 0; i < stats.categories.size() && i < 5; i++) {
+    result.AddMetric("physx_peak_bytes." + stats.categories[i].name,
+                     static_cast<double>(stats.categories[i].peakBytes));
+  }
+}
+
+struct BenchWorld {
+  PhysicsWorld physics;
+  std::vector<std::unique_ptr<Robot>> robots;
+  std::list<GameBlock> blocks; // std::list for stable pointers (as main.cpp)
+  FieldCollisionStats fieldStats;
+
+  explicit BenchWorld(const BenchOptions &opts)
+      : BenchWorld(BenchPhysicsConfig(opts), BenchFieldMode(opts)) {}
+
+  BenchWorld(const PhysicsConfig &config, FieldCollisionMode fieldMode) {
+    physics.Initialize(config);
+    CreateFieldCollision(physics, GetFieldModel(), fieldMode, kFieldPath,
+                         &fieldStats);
+    physics.ConfigureBroadPhaseRegions(fieldStats.sourceBounds);
+  }
+
+  Robot &AddRobot(PxVec3 position) {
+    robots.push_back(std::make_unique<Robot>());
+    robots.back()->Initialize(physics, position);
+    return *robots.back();
+  }
+
+  void AddBlock(BlockColor color, PxVec3 position) {
+    blocks.push_back(SpawnBlock(physics, color, position, false));
+  }
+
+  // Blocks on a square grid `columns` wide around `center`, stacked in
+  // layers so large counts do not start out interpenetrating.
+  void AddBlockGrid(int count, PxVec3 center, float spacing, int columns) {
+    for (int i = 0; i < count; i++) {
+      int layer = i / (columns * columns);
+      int row = (i / columns) % columns;
+      int col = i % columns;
+      float half = 0.5f * (columns - 1) * spacing;
+      PxVec3 pos(center.x - half + col * spacing,
+                 center.y + layer * spacing,
+                 center.z - half + row * spacing);
+      AddBlock((i % 2) ? BlockColor::BLUE : BlockColor::RED, pos);
+    }
+  }
+
+  void Step() {
+    for (auto &robot : robots)
+      robot->Update(kStep);
+    physics.Update(kStep);
+  }
+
+  // Like MeasureSamples, but also counts PhysX allocations made during the
+  // timed steps (steady-state allocation rate).
+  template <typename F>
+  void Measure(ScenarioResult &result, int warmup, int steps, F &&fn) {
+    for (int i = 0; i < warmup; i++)
+      fn(i);
+    uint64_t before = physics.GetAllocator().GetTotalAllocs();
+    double collideMs = 0.0, solveMs = 0.0, awake = 0.0;
+    MeasureSamples(result, 0, steps, [&](int i) {
+      fn(warmup + i);
+      collideMs += physics.GetLastStepTiming().collideMs;
+      solveMs += physics.GetLastStepTiming().solveMs;
+      awake += physics.GetAwakeBodyCount();
+    });
+    uint64_t during = physics.GetAllocator().GetTotalAllocs() - before;
+    if (steps > 0) {
+      result.AddMetric("physx_allocs_per_step",
+                       static_cast<double>(during) / steps);
+      result.AddMetric("collide_ms_mean", collideMs / steps);
+      result.AddMetric("solve_ms_mean", solveMs / steps);
+      result.AddMetric("awake_mean", awake / steps);
+      result.AddMetric("awake_final", physics.GetAwakeBodyCount());
+    }
+  }
+
+  void AddWorldMetrics(ScenarioResult &result) const {
+    result.AddMetric("field_mesh", fieldStats.triangleMeshes > 0 ? 1.0 : 0.0);
+    result.AddMetric("field_shapes",
+                     fieldStats.planes + fieldStats.boxes + fieldStats.hulls +
+                         fieldStats.triangleMeshes);
+    result.AddMetric("robots", static_cast<double>(robots.size()));
+    result.AddMetric("blocks", static_cast<double>(blocks.size()));
+    result.AddMetric("actors",
+                     physics.GetScene()->getNbActors(
+                         PxActorTypeFlag::eRIGID_DYNAMIC |
+                         PxActorTypeFlag::eRIGID_STATIC));
+    result.AddMetric("out_of_bounds",
+                     static_cast<double>(physics.GetOutOfBoundsCount()));
+    AddPhysxMemoryMetrics(result, physics);
+  }
+};
+
+// --- Scripted driving ---
+
+struct DriveSegment {
+  float duration; // seconds
+  float left;
+  float right;
+};
+
+// Straight, pivot, straight, arc, reverse, pivot back - then loops
+static const DriveSegment kScriptedPath[] = {
+    {2.0f, 1.0f, 1.0f},  {0.8f, 1.0f, -1.0f}, {1.5f, 1.0f, 1.0f},
+    {1.2f, 0.4f, 1.0f},  {1.0f, -1.0f, -1.0f}, {0.8f, -1.0f, 1.0f},
+};
+
+static void ApplyScriptedDrive(Robot &robot, int step, float phaseSeconds) {
+  float total = 0.0f;
+  for (const DriveSegment &seg : kScriptedPath)
+    total += seg.duration;
+
+  float t = std::fmod(step * kStep + phaseSeconds, total);
+  for (const DriveSegment &seg : kScriptedPath) {
+    if (t < seg.duration) {
+      robot.SetDriveInput(seg.left, seg.right);
+      return;
+    }
+    t -= seg.duration;
+  }
+}
+
+static void IntakeNearest(Robot &robot, std::list<GameBlock> &blocks,
+                          PxPhysics *physics) {
+  if (robot.IsIntakeFull())
+    return;
+
+  float bestDist = 999.0f;
+  GameBlock *bestBlock = nullptr;
+  PxVec3 frontPos = robot.GetFrontPosition();
+  for (auto &block : blocks) {
+    if (block.held || !block.body)
+      continue;
+    float dist = (frontPos - block.body->getGlobalPose().p).magnitude();
+    if (dist < bestDist) {
+      bestDist = dist;
+      bestBlock = &block;
+    }
+  }
+  if (bestBlock)
+    robot.TryIntake(*bestBlock, physics);
+}
+
+// --- Scenarios ---
+
+static void RunEmptyField(const BenchOptions &opts, ScenarioResult &result) {
+  BenchWorld world(opts);
+  world.Measure(result, opts.warmup, opts.steps, [&](int) { world.Step(); });
+  world.AddWorldMetrics(result);
+}
+
+static void RunScriptedRobot(const BenchOptions &opts,
+                             ScenarioResult &result) {
+  BenchWorld world(opts);
+  Robot &robot = world.AddRobot(PxVec3(0.0f, 0.5f, 0.0f));
+  world.Measure(result, opts.warmup, opts.steps, [&](int step) {
+    ApplyScriptedDrive(robot, step, 0.0f);
+    world.Step();
+  });
+
+  PxVec3 p = robot.GetChassis()->getGlobalPose().p;
+  result.AddMetric("final_x", p.x);
+  result.AddMetric("final_z", p.z);
+  world.AddWorldMetrics(result);
+}
+
+static void RunBlocks(int count, const BenchOptions &opts,
+                      ScenarioResult &result) {
+  BenchWorld world(opts);
+  world.AddBlockGrid(count, PxVec3(0.0f, 0.3f, 0.0f), 0.16f, 20);
+  world.Measure(result, opts.warmup, opts.steps, [&](int) { world.Step(); });
+  world.AddWorldMetrics(result);
+}
+
+// Same block field under one broadphase; compare collide_ms_mean across the
+// broadphase_* scenarios to see how each scales with body count.
+static void RunBroadPhase(PxBroadPhaseType::Enum type, int count,
+                          const BenchOptions &opts, ScenarioResult &result) {
+  PhysicsConfig config = BenchPhysicsConfig(opts);
+  config.broadPhase = type;
+  BenchWorld world(config, BenchFieldMode(opts));
+  world.AddBlockGrid(count, PxVec3(0.0f, 0.3f, 0.0f), 0.16f, 22);
+  world.Measure(result, opts.warmup, opts.steps, [&](int) { world.Step(); });
+  world.AddWorldMetrics(result);
+}
+
+// Robots driving through blocks scattered over the whole field, so most
+// contacts are against field geometry. Compare collide_ms_mean between the
+// narrowphase_field_* scenarios.
+static void RunFieldNarrowphase(FieldCollisionMode mode,
+                                const BenchOptions &opts,
+                                ScenarioResult &result) {
+  BenchWorld world(BenchPhysicsConfig(opts), mode);
+  const PxVec3 starts[4] = {
+      PxVec3(-1.2f, 0.5f, -1.2f), PxVec3(1.2f, 0.5f, -1.2f),
+      PxVec3(-1.2f, 0.5f, 1.2f), PxVec3(1.2f, 0.5f, 1.2f)};
+  for (const PxVec3 &start : starts)
+    world.AddRobot(start);
+
+  std::mt19937 rng(opts.seed);
+  std::uniform_real_distribution<float> coord(-1.7f, 1.7f);
+  for (int i = 0; i < 300; i++) {
+    world.AddBlock((i % 2) ? BlockColor::BLUE : BlockColor::RED,
+                   PxVec3(coord(rng), 0.3f, coord(rng)));
+  }
+
+  double contactPairs = 0.0;
+  world.Measure(result, opts.warmup, opts.steps, [&](int step) {
+    for (size_t r = 0; r < world.robots.size(); r++)
+      ApplyScriptedDrive(*world.robots[r], step, 1.7f * r);
+    world.Step();
+    PxSimulationStatistics stats;
+    world.physics.GetScene()->getSimulationStatistics(stats);
+    contactPairs += stats.nbDiscreteContactPairsTotal;
+  });
+  result.AddMetric("contact_pairs_mean", contactPairs / opts.steps);
+  result.AddMetric("field_build_ms", world.fieldStats.buildMs);
+  result.AddMetric("field_hulls", world.fieldStats.hulls);
+  world.AddWorldMetrics(result);
+}
+
+// 1000 blocks given 10 s to come to rest, then measured. `tuned` uses the
+// default PhysicsConfig block profile; otherwise blocks get PhysX defaults
+// with island waking and no stabilization, for comparison.
+static void RunSettled(bool tuned, const BenchOptions &opts,
+                       ScenarioResult &result) {
+  PhysicsConfig config = BenchPhysicsConfig(opts);
+  if (!tuned) {
+    config.blockSleep = SleepProfile();
+    config.enableStabilization = false;
+  }
+  BenchWorld world(config, BenchFieldMode(opts));
+  world.AddBlockGrid(1000, PxVec3(0.0f, 0.3f, 0.0f), 0.16f, 20);
+  world.Measure(result, 600, opts.steps, [&](int) { world.Step(); });
+  world.AddWorldMetrics(result);
+}
+
+static void RunPileCollapse(const BenchOptions &opts, ScenarioResult &result) {
+  BenchWorld world(opts);
+  // 6x6 columns, 10 layers, barely separated: the measured window is the
+  // collapse itself, so there is no warmup here.
+  world.AddBlockGrid(360, PxVec3(0.8f, 0.2f, 0.8f), 0.145f, 6);
+  world.Measure(result, 0, opts.steps, [&](int) { world.Step(); });
+  world.AddWorldMetrics(result);
+}
+
+static void RunFourRobotMatch(const BenchOptions &opts,
+                              ScenarioResult &result) {
+  BenchWorld world(opts);
+  const PxVec3 starts[4] = {
+      PxVec3(-1.2f, 0.5f, -1.2f), PxVec3(1.2f, 0.5f, -1.2f),
+      PxVec3(-1.2f, 0.5f, 1.2f), PxVec3(1.2f, 0.5f, 1.2f)};
+  for (const PxVec3 &start : starts)
+    world.AddRobot(start);
+
+  std::mt19937 rng(opts.seed);
+  std::uniform_real_distribution<float> coord(-1.6f, 1.6f);
+  for (int i = 0; i < 80; i++) {
+    world.AddBlock((i % 2) ? BlockColor::BLUE : BlockColor::RED,
+                   PxVec3(coord(rng), 0.3f, coord(rng)));
+  }
+
+  world.Measure(result, opts.warmup, opts.steps, [&](int step) {
+    for (size_t r = 0; r < world.robots.size(); r++) {
+      Robot &robot = *world.robots[r];
+      ApplyScriptedDrive(robot, step, 1.7f * r);
+      if (step % 20 == 0)
+        IntakeNearest(robot, world.blocks, world.physics.GetPhysics());
+      if (step % 180 == 90)
+        robot.Outtake();
+    }
+    world.Step();
+  });
+
+  int held = 0;
+  for (const auto &robot : world.robots)
+    held += robot->GetHeldCount();
+  result.AddMetric("blocks_held", held);
+  world.AddWorldMetrics(result);
+}
+
+static void RunGlbLoadCook(const BenchOptions &opts, ScenarioResult &result) {
+  PhysicsWorld physics;
+  physics.Initialize(BenchPhysicsConfig(opts));
+
+  bool ok = true;
+  size_t meshCount = 0;
+  MeasureSamples(result, 1, opts.iterations, [&](int) {
+    GlbFile model;
+    if (!ok || !model.Open(kFieldPath)) {
+      ok = false;
+      return;
+    }
+    meshCount = model.GetMeshes().size();
+
+    PxRigidStatic *body = AssetLoader::CreateStaticBody(
+        physics.GetPhysics(), physics.GetScene(), model,
+        physics.GetDefaultMaterial(), PxTransform(PxIdentity), PxVec3(1.0f));
+    if (body) {
+      physics.GetScene()->removeActor(*body);
+      body->release();
+    }
+  });
+
+  if (!ok) {
+    result.status = "skipped";
+    result.note = std::string("cannot load ") + kFieldPath;
+    result.samplesMs.clear();
+    return;
+  }
+  result.AddMetric("meshes", static_cast<double>(meshCount));
+  AddPhysxMemoryMetrics(result, physics);
+}
+
+// V-HACD over every field mesh with no cache, one job per mesh. Compare
+// the serial and parallel variants for import time.
+static void RunConvexDecompose(bool parallel, const BenchOptions &opts,
+                               ScenarioResult &result) {
+  const GlbFile *model = GetFieldModel();
+  if (!model) {
+    result.status = "skipped";
+    result.note = std::string("cannot load ") + kFieldPath;
+    return;
+  }
+
+  PhysicsWorld physics;
+  physics.Initialize(BenchPhysicsConfig(opts));
+  DecompositionParams params;
+  params.parallel = parallel;
+
+  size_t hulls = 0, jobCount = 0;
+  MeasureSamples(result, 0, opts.iterations, [&](int) {
+    const std::vector<GlbMesh> &meshes = model->GetMeshes();
+    std::vector<DecompositionJob> jobs(meshes.size());
+    for (size_t m = 0; m < meshes.size(); m++) {
+      jobs[m].key = std::to_string(m);
+      for (const GlbPrimitive &prim : meshes[m].primitives) {
+        AssetLoader::ExtractMeshData(*model, prim, jobs[m].points,
+                                     jobs[m].indices, PxVec3(1.0f));
+      }
+    }
+    CookDecompositions(physics.GetPhysics(), jobs, params, nullptr);
+    hulls = 0;
+    jobCount = jobs.size();
+    for (const DecompositionJob &job : jobs)
+      hulls += job.streams.size();
+  });
+  result.AddMetric("meshes", static_cast<double>(jobCount));
+  result.AddMetric("hulls", static_cast<double>(hulls));
+}
+
+// --- Mesh import kernels ---
+
+static const size_t kSyntheticVertices = 2000000;
+
+// One primitive with interleaved float POSITION/NORMAL (stride 24),
+// normalized UNSIGNED_BYTE COLOR_0 and uint32 indices. Written once per
+// process to the temp directory; returns "" if that fails.
+static std::string GetSyntheticGlb(uint32_t seed) {
+  static std::string path;
+  if (!path.empty())
+    return path;
+
+  const size_t n = kSyntheticVertices;
+  const size_t indexCount = 3 * n;
+  std::vector<uint8_t> bin(n * 24 + n * 4 + indexCount * 4);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+  for (size_t i = 0; i < n; i++) {
+    float pn[6] = {coord(rng), coord(rng), coord(rng), 0.0f, 1.0f, 0.0f};
+    memcpy(&bin[i * 24], pn, sizeof(pn));
+    uint32_t rgba = rng();
+    memcpy(&bin[n * 24 + i * 4], &rgba, 4);
+  }
+  for (size_t i = 0; i < indexCount; i++) {
+    uint32_t index = static_cast<uint32_t>(rng() % n);
+    memcpy(&bin[n * 28 + i * 4], &index, 4);
+  }
+
+  std::string json =
+      "{\"asset\":{\"version\":\"2.0\"},\"buffers\":[{\"byteLength\":" +
+      std::to_string(bin.size()) + "}],\"bufferViews\":[" +
+      "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" +
+      std::to_string(n * 24) + ",\"byteStride\":24}," +
+      "{\"buffer\":0,\"byteOffset\":" + std::to_string(n * 24) +
+      ",\"byteLength\":" + std::to_string(n * 4) + ",\"byteStride\":4}," +
+      "{\"buffer\":0,\"byteOffset\":" + std::to_string(n * 28) +
+      ",\"byteLength\":" + std::to_string(indexCount * 4) + "}]," +
+      "\"accessors\":[" +
+      "{\"bufferView\":0,\"componentType\":5126,\"type\":\"VEC3\",\"count\":" +
+      std::to_string(n) + "}," +
+      "{\"bufferView\":0,\"byteOffset\":12,\"componentType\":5126," +
+      "\"type\":\"VEC3\",\"count\":" + std::to_string(n) + "}," +
+      "{\"bufferView\":1,\"componentType\":5121,\"normalized\":true," +
+      "\"type\":\"VEC4\",\"count\":" + std::to_string(n) + "}," +
+      "{\"bufferView\":2,\"componentType\":5125,\"type\":\"SCALAR\"," +
+      "\"count\":" + std::to_string(indexCount) + "}]," +
+      "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0," +
+      "\"NORMAL\":1,\"COLOR_0\":2},\"indices\":3}]}]}";
+  json.resize((json.size() + 3) & ~size_t(3), ' ');
+
+  auto put32 = [](std::ofstream &out, uint32_t v) {
+    out.write(reinterpret_cast<const char *>(&v), 4);
+  };
+  std::string target =
+      (std::filesystem::temp_directory_path() / "simulator_bench_synthetic.glb")
+          .string();
+  std::ofstream out(target, std::ios::binary | std::ios::trunc);
+  put32(out, 0x46546C67); // "glTF"
+  put32(out, 2);
+  put32(out, static_cast<uint32_t>(12 + 8 + json.size() + 8 + bin.size()));
+  put32(out, static_cast<uint32_t>(json.size()));
+  put32(out, 0x4E4F534A); // JSON
+  out.write(json.data(), static_cast<std::streamsize>(json.size()));
+  put32(out, static_cast<uint32_t>(bin.size()));
+  put32(out, 0x004E4942); // BIN
+  out.write(reinterpret_cast<const char *>(bin.data()),
+            static_cast<std::streamsize>(bin.size()));
+  if (out)
+    path = target;
+  return path;
+}
+
+// Converts the synthetic GLB with one kernel instruction set, through both
+// the renderer (interleaved Vertex) and physics (scaled PxVec3) paths.
+static void RunMeshKernels(KernelIsa isa, const BenchOptions &opts,
+                           ScenarioResult &result) {
+  if (!IsKernelIsaSupported(isa)) {
+    result.status = "skipped";
+    result.note = std::string(KernelIsaName(isa)) + " not supported";
+    return;
+  }
+  GlbFile model;
+  std::string path = GetSyntheticGlb(opts.seed);
+  if (path.empty() || !model.Open(path)) {
+    result.status = "skipped";
+    result.note = "cannot write synthetic GLB";
+    return;
+  }
+
+  const GlbPrimitive &prim = model.GetMeshes()[0].primitives[0];
+  size_t vertexCount = 0, indexCount = 0;
+  CountPrimitive(model, prim, vertexCount, indexCount);
+  std::vector<Vertex> vertices(vertexCount);
+  std::vector<uint32_t> indices(indexCount);
+  std::vector<PxVec3> points;
+  std::vector<PxU32> pointIndices;
+  points.reserve(vertexCount);
+  pointIndices.reserve(indexCount);
+
+  KernelIsa previous = GetKernelIsa();
+  SetKernelIsa(isa);
+  double renderMs = 0.0, physicsMs = 0.0;
+  MeasureSamples(result, 1, opts.iterations, [&](int i) {
+    auto t0 = std::chrono::steady_clock::now();
+    ExtractPrimitive(model, prim, vertices.data(), indices.data());
+    auto t1 = std::chrono::steady_clock::now();
+    points.clear();
+    pointIndices.clear();
+    AssetLoader::ExtractMeshData(model, prim, points, pointIndices,
+                                 PxVec3(0.5f, 0.5f, 0.5f));
+    auto t2 = std::chrono::steady_clock::now();
+    if (i == 0)
+      return; // Warmup
+    renderMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+    physicsMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+  });
+  SetKernelIsa(previous);
+
+  result.AddMetric("vertices", static_cast<double>(vertexCount));
+  result.AddMetric("indices", static_cast<double>(indexCount));
+  result.AddMetric("render_ms_mean", renderMs / opts.iterations);
+  result.AddMetric("physics_ms_mean", physicsMs / opts.iterations);
+}
+
+// The synthetic GLB baked by the same path as asset_baker (LOD 0 only)
+static std::string GetSyntheticBundle(uint32_t seed) {
+  static std::string path;
+  if (!path.empty())
+    return path;
+
+  GlbFile model;
+  std::string glbPath = GetSyntheticGlb(seed);
+  if (glbPath.empty() || !model.Open(glbPath))
+    return path;
+  std::vector<BundleMeshData> meshes;
+  BakeModelMeshes(model, meshes);
+  AssetBundleWriter writer(sizeof(Vertex));
+  std::string target = glbPath + ".bundle";
+  if (writer.AddModel("synthetic", 1, meshes) && writer.Write(target))
+    path = target;
+  return path;
+}
+
+// Time from a cold open to renderer-ready vertices in host memory (the
+// staging buffer stand-in): GLB parse + conversion vs bundle memcpy.
+static void RunAssetLoad(bool bundle, const BenchOptions &opts,
+                         ScenarioResult &result) {
+  std::string path = bundle ? GetSyntheticBundle(opts.seed)
+                            : GetSyntheticGlb(opts.seed);
+  if (path.empty()) {
+    result.status = "skipped";
+    result.note = "cannot write synthetic assets";
+    return;
+  }
+
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
+  MeasureSamples(result, 1, opts.iterations, [&](int) {
+    if (bundle) {
+      AssetBundle file;
+      std::string error;
+      if (!file.Open(path, &error))
+        throw std::runtime_error(error);
+      const BundleMesh *meshes = file.GetMeshes("synthetic", 0);
+      const BundleEntry *entry =
+          file.Find("synthetic", BundleEntryType::eMODEL);
+      if (!meshes || !entry)
+        throw std::runtime_error(path + ": no synthetic model");
+      const BundleMesh &mesh = *meshes;
+      const uint8_t *payload = file.Payload(*entry);
+      vertices.resize(mesh.vertexCount);
+      indices.resize(mesh.indexCount);
+      memcpy(vertices.data(), payload + mesh.vertexOffset,
+             mesh.vertexCount * sizeof(Vertex));
+      memcpy(indices.data(), payload + mesh.indexOffset,
+             mesh.indexCount * sizeof(uint32_t));
+    } else {
+      GlbFile model;
+      std::string error;
+      if (!model.Open(path, &error))
+        throw std::runtime_error(error);
+      if (model.GetMeshes().empty() ||
+          model.GetMeshes()[0].primitives.empty())
+        throw std::runtime_error(path + ": no primitives");
+      const GlbPrimitive &prim = model.GetMeshes()[0].primitives[0];
+      size_t vertexCount = 0, indexCount = 0;
+      CountPrimitive(model, prim, vertexCount, indexCount);
+      vertices.resize(vertexCount);
+      indices.resize(indexCount);
+      ExtractPrimitive(model, prim, vertices.data(), indices.data());
+    }
+  });
+  result.AddMetric("vertices", static_cast<double>(vertices.size()));
+  result.AddMetric("file_mb", std::filesystem::file_size(path) /
+                                  (1024.0 * 1024.0));
+}
+
+static void RunMeshUpload(const BenchOptions &opts, ScenarioResult &result) {
+  if (!glfwInit()) {
+    result.status = "skipped";
+    result.note = "glfwInit failed";
+    return;
+  }
+
+  // Hidden window: the swapchain is never presented, it only satisfies
+  // VulkanContext's surface requirement.
+  glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  GLFWwindow *window =
+      glfwCreateWindow(640, 360, "simulator_bench", nullptr, nullptr);
+
+  {
+    VulkanContext vulkan;
+    try {
+      if (!window)
+        throw std::runtime_error("window creation failed");
+      vulkan.Initialize(window, "simulator_bench");
+    } catch (const std::exception &e) {
+      result.status = "skipped";
+      result.note = std::string("no Vulkan device: ") + e.what();
+    }
+
+    if (result.status == "ok") {
+      size_t primitives = 0;
+      try {
+        MeasureSamples(result, 1, opts.iterations, [&](int) {
+          std::vector<Mesh> meshes = LoadModel(
+              vulkan.GetDevice(), vulkan.GetAllocator(),
+              vulkan.GetGraphicsQueue(), vulkan.GetGraphicsQueueFamily(),
+              kFieldPath);
+          primitives = meshes.size();
+          DestroyModel(vulkan.GetAllocator(), meshes);
+        });
+        result.AddMetric("primitives", static_cast<double>(primitives));
+      } catch (const std::exception &e) {
+        result.status = "skipped";
+        result.note = e.what();
+        result.samplesMs.clear();
+      }
+    }
+    vulkan.Cleanup();
+  }
+
+  if (window)
+    glfwDestroyWindow(window);
+  glfwTerminate();
+}
+
+static std::vector<Scenario> MakeBroadPhaseScenarios() {
+  // Names must outlive the Scenario (which stores const char *)
+  static std::vector<std::string> names;
+  std::vector<Scenario> out;
+  const PxBroadPhaseType::Enum types[] = {
+      PxBroadPhaseType::eSAP, PxBroadPhaseType::eMBP, PxBroadPhaseType::eABP};
+  const int counts[] = {1000, 2000, 4000};
+  names.reserve(9);
+  for (PxBroadPhaseType::Enum type : types) {
+    for (int count : counts) {
+      names.push_back(std::string("broadphase_") + BroadPhaseTypeName(type) +
+                      "_" + std::to_string(count));
+      out.push_back({names.back().c_str(),
+                     "Collide cost of a block field under one broadphase",
+                     [type, count](const BenchOptions &o, ScenarioResult &r) {
+                       RunBroadPhase(type, count, o, r);
+                     }});
+    }
+  }
+  return out;
+}
+
+const std::vector<Scenario> &GetScenarios() {
+  static const std::vector<Scenario> scenarios = [] {
+    std::vector<Scenario> list = {
+        {"empty_field_idle", "Field collision only, nothing moving",
+         RunEmptyField},
+        {"robot_scripted_path", "One robot driving a looping scripted path",
+         RunScriptedRobot},
+        {"blocks_50", "50 blocks resting on the field",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunBlocks(50, o, r);
+         }},
+        {"blocks_200", "200 blocks resting on the field",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunBlocks(200, o, r);
+         }},
+        {"blocks_1000", "1000 blocks in stacked layers",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunBlocks(1000, o, r);
+         }},
+        {"block_pile_collapse", "360-block column collapsing (no warmup)",
+         RunPileCollapse},
+        {"settled_blocks_1000", "1000 blocks at rest, tuned sleep profile",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunSettled(true, o, r);
+         }},
+        {"settled_blocks_1000_untuned",
+         "1000 blocks at rest, PhysX default sleeping",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunSettled(false, o, r);
+         }},
+        {"four_robot_match", "4 scripted robots intaking among 80 blocks",
+         RunFourRobotMatch},
+        {"narrowphase_field_mesh",
+         "4 robots among 300 blocks, full triangle-mesh field",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunFieldNarrowphase(FieldCollisionMode::eFULL_MESH, o, r);
+         }},
+        {"narrowphase_field_proxies",
+         "4 robots among 300 blocks, proxy field collision",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunFieldNarrowphase(FieldCollisionMode::ePROXIES, o, r);
+         }},
+        {"glb_load_cook", "Parse field.glb and cook its triangle meshes",
+         RunGlbLoadCook},
+        {"convex_decompose_serial", "V-HACD every field mesh, one thread",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunConvexDecompose(false, o, r);
+         }},
+        {"convex_decompose_parallel", "V-HACD every field mesh, all cores",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunConvexDecompose(true, o, r);
+         }},
+        {"mesh_kernels_scalar", "2M-vertex GLB import, scalar kernels",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunMeshKernels(KernelIsa::eSCALAR, o, r);
+         }},
+        {"mesh_kernels_sse2", "2M-vertex GLB import, SSE2 kernels",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunMeshKernels(KernelIsa::eSSE2, o, r);
+         }},
+        {"mesh_kernels_avx2", "2M-vertex GLB import, AVX2 kernels",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunMeshKernels(KernelIsa::eAVX2, o, r);
+         }},
+        {"asset_load_glb", "2M-vertex GLB to renderer vertices",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunAssetLoad(false, o, r);
+         }},
+        {"asset_load_bundle", "Same model from a baked asset bundle",
+         [](const BenchOptions &o, ScenarioResult &r) {
+           RunAssetLoad(true, o, r);
+         }},
+        {"mesh_upload", "Load field.glb and upload it through VMA staging",
+         RunMeshUpload},
+    };
+    std::vector<Scenario> broadPhase = MakeBroadPhaseScenarios();
+    list.insert(list.end(), broadPhase.begin(), broadPhase.end());
+    return list;
+  }();
+  return scenarios;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "BenchHarness.h"
+
+#include <functional>
+#include <vector>
+
+// A named, self-contained benchmark scenario. run() builds its own world,
+// measures it into `result` and tears everything down again.
+struct Scenario {
+  const char *name;
+  const char *description;
+  std::function<void(const BenchOptions &, ScenarioResult &)> run;
+};
+
+const std::vector<Scenario> &GetScenarios();
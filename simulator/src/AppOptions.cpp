@@ -0,0 +1,187 @@
+#include "AppOptions.h"
+#include "Autonomous.h"
+#include "Controller.h"
+#include "FieldCollision.h"
+#include "PhysicsWorld.h"
+#include "renderer/Camera.h"
+#include "renderer/ShadowMap.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static void PrintUsage(const char *exe) {
+  std::cerr << "Usage: " << exe << " [options]\n"
+            << "  --broadphase sap|mbp|abp   PhysX broadphase (default abp)\n"
+            << "  --field-collision mesh|proxies\n"
+            << "                             Field collision geometry "
+               "(default proxies)\n"
+            << "  --bundle <file>            Load assets from an asset_baker "
+               "bundle\n"
+            << "  --watch-shaders            Recompile and swap in shaders "
+               "when their sources change\n"
+            << "  --shadows off|low|medium|high\n"
+            << "                             Shadow map quality (default "
+               "medium)\n"
+            << "  --msaa 1|2|4|8             Scene samples per pixel "
+               "(default 1)\n"
+            << "  --render-scale <0.25-1>    Scene resolution relative to "
+               "the window\n"
+            << "  --record <file>            Record the window (.y4m, or "
+               "raw BGRA otherwise)\n"
+            << "  --record-fps <n>           Recording frame rate "
+               "(default 30)\n"
+            << "  --camera orbit|follow|cinematic\n"
+            << "                             Initial camera mode (V cycles)\n"
+            << "  --camera-path <file>       Keyframes for the cinematic "
+               "camera\n"
+            << "  --drive tank|arcade|curvature\n"
+            << "                             Drive mode (default tank)\n"
+            << "  --input-map <file>         Keyboard/gamepad bindings\n"
+            << "  --record-input <file>      Log per-step controller input\n"
+            << "  --replay-input <file>      Drive from a recorded input "
+               "log\n"
+            << "  --telemetry <file>         Log per-step robot and block "
+               "state (.vxtl)\n"
+            << "  --telemetry-blocks <n>     Blocks to log (default 32)\n"
+            << "  --auton <file>             Run an autonomous routine "
+               "at startup\n"
+            << "  --auton-controller pure_pursuit|ramsete\n"
+            << "                             Path tracking (default "
+               "ramsete)\n"
+            << std::endl;
+}
+
+bool ParseAppOptions(int argc, char **argv, AppOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+    if (!strcmp(arg, "--broadphase") && value) {
+      PxBroadPhaseType::Enum type;
+      if (!ParseBroadPhaseType(value, type)) {
+        std::cerr << "Unknown broadphase: " << value << std::endl;
+        PrintUsage(argv[0]);
+        return false;
+      }
+      options.broadPhase = value;
+      i++;
+    } else if (!strcmp(arg, "--field-collision") && value) {
+      FieldCollisionMode mode;
+      if (!ParseFieldCollisionMode(value, mode)) {
+        std::cerr << "Unknown field collision mode: " << value << std::endl;
+        PrintUsage(argv[0]);
+        return false;
+      }
+      options.fieldCollision = value;
+      i++;
+    } else if (!strcmp(arg, "--bundle") && value) {
+      options.bundle = value;
+      i++;
+    } else if (!strcmp(arg, "--shadows") && value) {
+      ShadowQuality quality;
+      if (!ParseShadowQuality(value, quality)) {
+        std::cerr << "Unknown shadow quality: " << value << std::endl;
+        PrintUsage(argv[0]);
+        return false;
+      }
+      options.shadows = value;
+      i++;
+    } else if (!strcmp(arg, "--msaa") && value) {
+      int samples = atoi(value);
+      if (samples != 1 && samples != 2 && samples != 4 && samples != 8) {
+        std::cerr << "Unsupported MSAA sample count: " << value << std::endl;
+        PrintUsage(argv[0]);
+        return false;
+      }
+      options.msaa = samples;
+      i++;
+    } else if (!strcmp(arg, "--render-scale") && value) {
+      float scale = static_cast<float>(atof(value));
+      if (!(scale >= 0.25f && scale <= 1.0f)) {
+        std::cerr << "Render scale must be in [0.25, 1]: " << value
+                  << std::endl;
+        PrintUsage(argv[0]);
+        return false;
+      }
+      options.renderScale = scale;
+      i++;
+    } else if (!strcmp(arg, "--record") && value) {
+      options.recordPath = value;
+      i++;
+    } else if (!strcmp(arg, "--record-fps") && value) {
+      int fps = atoi(value);
+      if (fps < 1 || fps > 240) {
+        std::cerr << "Recording frame rate must be 1-240: " << value
+                  << std::endl;
+        PrintUsage(argv[0]);
+        return false;
+      }
+      options.recordFps = fps;
+      i++;
+    } else if (!strcmp(arg, "--camera") && value) {
+      CameraMode mode;
+      if (!ParseCameraMode(value, mode)) {
+        std::cerr << "Unknown camera mode: " << value << std::endl;
+        PrintUsage(argv[0]);
+        return false;
+      }
+      options.cameraMode = value;
+      i++;
+    } else if (!strcmp(arg, "--camera-path") && value) {
+      options.cameraPath = value;
+      i++;
+    } else if (!strcmp(arg, "--drive") && value) {
+      DriveMode mode;
+      if (!ParseDriveMode(value, mode)) {
+        std::cerr << "Unknown drive mode: " << value << std::endl;
+        PrintUsage(argv[0]);
+        return false;
+      }
+      options.driveMode = value;
+      i++;
+    } else if (!strcmp(arg, "--input-map") && value) {
+      options.inputMap = value;
+      i++;
+    } else if (!strcmp(arg, "--record-input") && value) {
+      options.recordInput = value;
+      i++;
+    } else if (!strcmp(arg, "--replay-input") && value) {
+      options.replayInput = value;
+      i++;
+    } else if (!strcmp(arg, "--telemetry") && value) {
+      options.telemetry = value;
+      i++;
+    } else if (!strcmp(arg, "--telemetry-blocks") && value) {
+      options.telemetryBlocks = atoi(value);
+      if (options.telemetryBlocks < 0) {
+        std::cerr << "--telemetry-blocks must not be negative" << std::endl;
+        PrintUsage(argv[0]);
+        return false;
+      }
+      i++;
+    } else if (!strcmp(arg, "--auton") && value) {
+      options.auton = value;
+      i++;
+    } else if (!strcmp(arg, "--auton-controller") && value) {
+      PathController controller;
+      if (!ParsePathController(value, controller)) {
+        std::cerr << "Unknown path controller: " << value << std::endl;
+        PrintUsage(argv[0]);
+        return false;
+      }
+      options.pathController = value;
+      i++;
+    } else if (!strcmp(arg, "--watch-shaders")) {
+      options.watchShaders = true;
+    } else if (!strcmp(arg, "--help") || !strcmp(arg, "-h")) {
+      PrintUsage(argv[0]);
+      return false;
+    } else {
+      std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+      PrintUsage(argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
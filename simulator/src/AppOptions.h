@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+// Command-line options for the interactive simulator
+struct AppOptions {
+  std::string broadPhase = "abp";         // sap | mbp | abp
+  std::string fieldCollision = "proxies"; // mesh | proxies
+  std::string bundle;                     // asset_baker output; empty = GLBs
+  bool watchShaders = false;              // Hot-reload src/shaders/*
+  std::string shadows = "medium";         // off | low | medium | high
+  int msaa = 1;                           // 1 | 2 | 4 | 8 samples
+  float renderScale = 1.0f;               // Scene resolution, 0.25 - 1
+  std::string recordPath;                 // Record from startup if set
+  int recordFps = 30;
+  std::string cameraMode = "orbit";       // orbit | follow | cinematic
+  std::string cameraPath;                 // CameraPath keys for cinematic
+  std::string driveMode = "tank";         // tank | arcade | curvature
+  std::string inputMap;                   // InputMapping file
+  std::string recordInput;                // InputLog to write
+  std::string replayInput;                // InputLog to drive from
+  std::string telemetry;                  // TelemetryLog to write
+  int telemetryBlocks = 32;               // Block slots in the telemetry
+  std::string auton;                      // AutonRoutine to run at start
+  std::string pathController = "ramsete"; // pure_pursuit | ramsete
+};
+
+// Parses argv into options. Prints usage and returns false on bad input.
+bool ParseAppOptions(int argc, char **argv, AppOptions &options);
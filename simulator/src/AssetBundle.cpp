@@ -0,0 +1,220 @@
+#include "AssetBundle.h"
+#include "PxPhysicsAPI.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static const char kMagic[4] = {'V', 'X', 'A', 'B'};
+static const size_t kAlignment = 16;
+
+static size_t AlignUp(size_t value) {
+  return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+// --- AssetBundle ---
+
+// Checks a model payload once so the accessors can trust it afterwards
+static bool ValidateModel(const uint8_t *payload, uint64_t size,
+                          uint32_t vertexSize) {
+  if (size < sizeof(BundleModelHeader))
+    return false;
+  const BundleModelHeader *model =
+      reinterpret_cast<const BundleModelHeader *>(payload);
+  uint64_t meshCount = uint64_t(model->meshCount) * model->lodCount;
+  if (model->lodCount == 0 ||
+      sizeof(BundleModelHeader) + meshCount * sizeof(BundleMesh) > size)
+    return false;
+
+  const BundleMesh *meshes =
+      reinterpret_cast<const BundleMesh *>(model + 1);
+  for (uint64_t i = 0; i < meshCount; i++) {
+    const BundleMesh &mesh = meshes[i];
+    if (mesh.vertexOffset % kAlignment || mesh.indexOffset % kAlignment ||
+        mesh.vertexOffset + uint64_t(mesh.vertexCount) * vertexSize > size ||
+        mesh.indexOffset + uint64_t(mesh.indexCount) * 4 > size)
+      return false;
+  }
+  return true;
+}
+
+bool AssetBundle::Open(const std::string &path, std::string *error) {
+  auto fail = [&](const std::string &message) {
+    if (error)
+      *error = message;
+    mFile.Close();
+    mHeader = nullptr;
+    mEntries = nullptr;
+    return false;
+  };
+
+  mPath = path;
+  if (!mFile.Open(path))
+    return fail("cannot open " + path);
+
+  const uint8_t *data = mFile.Data();
+  const size_t size = mFile.Size();
+  mHeader = reinterpret_cast<const BundleHeader *>(data);
+  if (size < sizeof(BundleHeader) || memcmp(mHeader->magic, kMagic, 4) != 0)
+    return fail(path + " is not an asset bundle");
+  if (mHeader->version != kBundleVersion)
+    return fail(path + ": bundle version " +
+                std::to_string(mHeader->version) + ", expected " +
+                std::to_string(kBundleVersion) + " (re-run asset_baker)");
+  if (mHeader->physxVersion != PX_PHYSICS_VERSION)
+    return fail(path + ": baked for another PhysX version (re-run "
+                       "asset_baker)");
+
+  uint64_t tocEnd = sizeof(BundleHeader) +
+                    uint64_t(mHeader->entryCount) * sizeof(BundleEntry);
+  if (tocEnd > size)
+    return fail(path + ": truncated table of contents");
+  mEntries = reinterpret_cast<const BundleEntry *>(mHeader + 1);
+
+  for (uint32_t i = 0; i < mHeader->entryCount; i++) {
+    const BundleEntry &entry = mEntries[i];
+    bool ok = memchr(entry.name, '\0', kBundleNameLength) != nullptr &&
+              entry.offset % kAlignment == 0 && entry.offset >= tocEnd &&
+              entry.offset + entry.size <= size;
+    if (ok && entry.type == BundleEntryType::eMODEL)
+      ok = ValidateModel(data + entry.offset, entry.size, mHeader->vertexSize);
+    if (!ok)
+      return fail(path + ": corrupt entry " + std::to_string(i));
+  }
+
+  if (error)
+    error->clear();
+  return true;
+}
+
+const BundleEntry *AssetBundle::Find(const std::string &name,
+                                     BundleEntryType type) const {
+  if (!mEntries)
+    return nullptr;
+  for (uint32_t i = 0; i < mHeader->entryCount; i++) {
+    if (mEntries[i].type == type && name == mEntries[i].name)
+      return &mEntries[i];
+  }
+  return nullptr;
+}
+
+const BundleModelHeader *
+AssetBundle::GetModel(const std::string &name) const {
+  const BundleEntry *entry = Find(name, BundleEntryType::eMODEL);
+  return entry ? reinterpret_cast<const BundleModelHeader *>(Payload(*entry))
+               : nullptr;
+}
+
+const BundleMesh *AssetBundle::GetMeshes(const std::string &name,
+                                         uint32_t lod) const {
+  const BundleModelHeader *model = GetModel(name);
+  if (!model || lod >= model->lodCount)
+    return nullptr;
+  return reinterpret_cast<const BundleMesh *>(model + 1) +
+         size_t(lod) * model->meshCount;
+}
+
+// --- AssetBundleWriter ---
+
+bool AssetBundleWriter::AddModel(const std::string &name, uint32_t lodCount,
+                                 const std::vector<BundleMeshData> &meshes) {
+  if (lodCount == 0 || meshes.size() % lodCount != 0)
+    return false;
+
+  BundleModelHeader header = {};
+  header.meshCount = static_cast<uint32_t>(meshes.size() / lodCount);
+  header.lodCount = lodCount;
+
+  // Records first, then each mesh's vertices and indices
+  std::vector<BundleMesh> records(meshes.size());
+  size_t offset = AlignUp(sizeof(header) + records.size() * sizeof(BundleMesh));
+  for (size_t i = 0; i < meshes.size(); i++) {
+    const BundleMeshData &mesh = meshes[i];
+    BundleMesh &record = records[i];
+    record.vertexCount =
+        static_cast<uint32_t>(mesh.vertices.size() / mVertexSize);
+    record.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    record.vertexOffset = offset;
+    record.indexOffset = AlignUp(offset + mesh.vertices.size());
+    offset = AlignUp(record.indexOffset + mesh.indices.size() * 4);
+    memcpy(record.boundsMin, mesh.boundsMin, sizeof(record.boundsMin));
+    memcpy(record.boundsMax, mesh.boundsMax, sizeof(record.boundsMax));
+  }
+
+  std::vector<uint8_t> payload(offset, 0);
+  memcpy(payload.data(), &header, sizeof(header));
+  if (!records.empty()) {
+    memcpy(payload.data() + sizeof(header), records.data(),
+           records.size() * sizeof(BundleMesh));
+  }
+  for (size_t i = 0; i < meshes.size(); i++) {
+    if (!meshes[i].vertices.empty()) {
+      memcpy(payload.data() + records[i].vertexOffset,
+             meshes[i].vertices.data(), meshes[i].vertices.size());
+    }
+    if (!meshes[i].indices.empty()) {
+      memcpy(payload.data() + records[i].indexOffset,
+             meshes[i].indices.data(), meshes[i].indices.size() * 4);
+    }
+  }
+  return AddBlob(name, BundleEntryType::eMODEL, std::move(payload));
+}
+
+bool AssetBundleWriter::AddBlob(const std::string &name, BundleEntryType type,
+                                std::vector<uint8_t> data) {
+  if (name.empty() || name.size() >= kBundleNameLength) {
+    std::cerr << "[AssetBundle] Entry name must be 1-"
+              << kBundleNameLength - 1 << " characters: " << name
+              << std::endl;
+    return false;
+  }
+  mEntries.push_back({name, type, std::move(data)});
+  return true;
+}
+
+bool AssetBundleWriter::Write(const std::string &path) const {
+  BundleHeader header = {};
+  memcpy(header.magic, kMagic, 4);
+  header.version = kBundleVersion;
+  header.physxVersion = PX_PHYSICS_VERSION;
+  header.vertexSize = mVertexSize;
+  header.entryCount = static_cast<uint32_t>(mEntries.size());
+
+  std::vector<BundleEntry> toc(mEntries.size());
+  size_t offset = AlignUp(sizeof(header) + toc.size() * sizeof(BundleEntry));
+  for (size_t i = 0; i < mEntries.size(); i++) {
+    BundleEntry &entry = toc[i];
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.name, mEntries[i].name.c_str(), mEntries[i].name.size());
+    entry.type = mEntries[i].type;
+    entry.offset = offset;
+    entry.size = mEntries[i].data.size();
+    offset = AlignUp(offset + mEntries[i].data.size());
+  }
+
+  // Same temporary-and-rename as CollisionCache: no torn bundles
+  std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(toc.data()),
+              static_cast<std::streamsize>(toc.size() * sizeof(BundleEntry)));
+
+    static const char kZeros[kAlignment] = {};
+    size_t written = sizeof(header) + toc.size() * sizeof(BundleEntry);
+    for (size_t i = 0; i < mEntries.size(); i++) {
+      out.write(kZeros, static_cast<std::streamsize>(toc[i].offset - written));
+      out.write(reinterpret_cast<const char *>(mEntries[i].data.data()),
+                static_cast<std::streamsize>(mEntries[i].data.size()));
+      written = toc[i].offset + mEntries[i].data.size();
+    }
+    if (!out)
+      return false;
+  }
+
+  std::remove(path.c_str());
+  return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "GlbFile.h" // MappedFile
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Pre-baked assets in one file, written offline by asset_baker and
+// memory-mapped at startup. Every payload is already in its final form
+// (interleaved renderer vertices, uint32 indices, cooked PhysX streams), so
+// loading is a table lookup plus a memcpy into staging memory.
+//
+// Layout (little-endian, offsets from the start of the file, payloads
+// 16-byte aligned):
+//   BundleHeader
+//   BundleEntry[entryCount]   table of contents
+//   payloads
+//
+// A model payload is a BundleModelHeader, then lodCount * meshCount
+// BundleMesh records (LOD-major), then the vertex and index arrays they
+// point into. Mesh offsets are relative to the payload.
+
+enum class BundleEntryType : uint32_t {
+  eMODEL = 1,
+  eFIELD_COLLISION = 2 // FieldCollision's baked proxy set
+};
+
+struct BundleHeader {
+  char magic[4];         // "VXAB"
+  uint32_t version;      // kBundleVersion
+  uint32_t physxVersion; // PX_PHYSICS_VERSION the streams were cooked with
+  uint32_t vertexSize;   // sizeof(Vertex) the vertex arrays were built for
+  uint32_t entryCount;
+  uint32_t reserved[3];
+};
+
+struct BundleEntry {
+  char name[48]; // NUL-terminated
+  BundleEntryType type;
+  uint32_t reserved;
+  uint64_t offset;
+  uint64_t size;
+};
+
+struct BundleModelHeader {
+  uint32_t meshCount; // Meshes per LOD
+  uint32_t lodCount;  // LOD 0 is the source mesh
+  uint32_t reserved[2];
+};
+
+struct BundleMesh {
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  uint64_t vertexOffset;
+  uint64_t indexOffset;
+  float boundsMin[3];
+  float boundsMax[3];
+};
+
+static const uint32_t kBundleVersion = 1;
+static const size_t kBundleNameLength = sizeof(BundleEntry::name);
+
+// Read-only view of a mapped bundle. Pointers stay valid while it is open.
+class AssetBundle {
+public:
+  bool Open(const std::string &path, std::string *error = nullptr);
+  bool IsOpen() const { return mFile.IsOpen(); }
+  const std::string &GetPath() const { return mPath; }
+  uint32_t GetVertexSize() const { return mHeader ? mHeader->vertexSize : 0; }
+
+  const BundleEntry *Find(const std::string &name,
+                          BundleEntryType type) const;
+  const uint8_t *Payload(const BundleEntry &entry) const {
+    return mFile.Data() + entry.offset;
+  }
+
+  // Model accessors; null / 0 if `name` is not a model in this bundle
+  const BundleModelHeader *GetModel(const std::string &name) const;
+  const BundleMesh *GetMeshes(const std::string &name, uint32_t lod) const;
+
+private:
+  MappedFile mFile;
+  std::string mPath;
+  const BundleHeader *mHeader = nullptr;
+  const BundleEntry *mEntries = nullptr;
+};
+
+// One mesh as handed to AssetBundleWriter
+struct BundleMeshData {
+  std::vector<uint8_t> vertices; // vertexCount * vertexSize bytes
+  std::vector<uint32_t> indices;
+  float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+  float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+};
+
+// Assembles a bundle in memory and writes it in one go (asset_baker)
+class AssetBundleWriter {
+public:
+  explicit AssetBundleWriter(uint32_t vertexSize) : mVertexSize(vertexSize) {}
+
+  // Model from lodCount * meshCount meshes, LOD-major
+  bool AddModel(const std::string &name, uint32_t lodCount,
+                const std::vector<BundleMeshData> &meshes);
+  bool AddBlob(const std::string &name, BundleEntryType type,
+               std::vector<uint8_t> data);
+
+  bool Write(const std::string &path) const;
+
+private:
+  struct Pending {
+    std::string name;
+    BundleEntryType type;
+    std::vector<uint8_t> data;
+  };
+
+  uint32_t mVertexSize;
+  std::vector<Pending> mEntries;
+};
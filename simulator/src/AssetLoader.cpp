@@ -1,99 +1,108 @@
 #include "AssetLoader.h"
+#include "CollisionCache.h"
+#include "MeshKernels.h"
 #include <iostream>
+#include <sstream>
 #include <vector>
 
-void AssetLoader::ExtractMeshData(const tinygltf::Model &model,
-                                  const tinygltf::Primitive &prim,
+void AssetLoader::ExtractMeshData(const GlbFile &model,
+                                  const GlbPrimitive &prim,
                                   std::vector<PxVec3> &vertices,
                                   std::vector<PxU32> &indices, PxVec3 scale) {
-  // Extract Positions
-  if (prim.attributes.find("POSITION") == prim.attributes.end())
+  StridedView<PxVec3> positions =
+      model.View<PxVec3>(prim.Attribute("POSITION"));
+  if (positions.Empty())
     return;
 
-  const tinygltf::Accessor &posAccessor =
-      model.accessors.at(prim.attributes.at("POSITION"));
-  const tinygltf::BufferView &posView =
-      model.bufferViews[posAccessor.bufferView];
-  const tinygltf::Buffer &posBuffer = model.buffers[posView.buffer];
-  const float *posData = reinterpret_cast<const float *>(
-      &posBuffer.data[posView.byteOffset + posAccessor.byteOffset]);
-  size_t posStride =
-      posView.byteStride ? posView.byteStride / sizeof(float) : 3;
-
-  vertices.reserve(vertices.size() + posAccessor.count);
-  for (size_t i = 0; i < posAccessor.count; i++) {
-    vertices.push_back(PxVec3(posData[i * posStride + 0] * scale.x,
-                              posData[i * posStride + 1] * scale.y,
-                              posData[i * posStride + 2] * scale.z));
-  }
-
-  // Extract Indices
-  if (prim.indices >= 0) {
-    const tinygltf::Accessor &idxAccessor = model.accessors[prim.indices];
-    const tinygltf::BufferView &idxView =
-        model.bufferViews[idxAccessor.bufferView];
-    const tinygltf::Buffer &idxBuffer = model.buffers[idxView.buffer];
-    const uint8_t *idxData =
-        &idxBuffer.data[idxView.byteOffset + idxAccessor.byteOffset];
-
-    size_t baseVertex = vertices.size() - posAccessor.count;
-    indices.reserve(indices.size() + idxAccessor.count);
-
-    for (size_t i = 0; i < idxAccessor.count; i++) {
-      uint32_t idx = 0;
-      switch (idxAccessor.componentType) {
-      case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-        idx = reinterpret_cast<const uint16_t *>(idxData)[i];
-        break;
-      case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-        idx = reinterpret_cast<const uint32_t *>(idxData)[i];
-        break;
-      case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-        idx = idxData[i];
-        break;
-      default:
-        break;
-      }
-      indices.push_back(static_cast<PxU32>(baseVertex + idx));
-    }
+  const size_t baseVertex = vertices.size();
+  vertices.resize(baseVertex + positions.Count());
+  const float scaleXYZ[3] = {scale.x, scale.y, scale.z};
+  ScaleFloat3(&vertices[baseVertex].x, positions.Data(), positions.Stride(),
+              scaleXYZ, positions.Count());
+
+  GlbIndexView idx = model.Indices(prim.indices);
+  const GlbAccessor *idxAccessor = idx.Accessor();
+  const size_t baseIndex = indices.size();
+  if (idxAccessor && idxAccessor->stride == idxAccessor->elementSize) {
+    indices.resize(baseIndex + idx.Count());
+    WidenIndices(&indices[baseIndex], idxAccessor->data,
+                 idxAccessor->elementSize, idx.Count(),
+                 static_cast<uint32_t>(baseVertex));
+  } else if (idxAccessor) {
+    indices.reserve(baseIndex + idx.Count());
+    for (size_t i = 0; i < idx.Count(); i++)
+      indices.push_back(static_cast<PxU32>(baseVertex + idx[i]));
   } else {
-    size_t baseVertex = vertices.size() - posAccessor.count;
-    for (size_t i = 0; i < posAccessor.count; i++) {
+    indices.reserve(baseIndex + positions.Count());
+    for (size_t i = 0; i < positions.Count(); i++)
       indices.push_back(static_cast<PxU32>(baseVertex + i));
-    }
   }
 }
 
+// Points the triangle descriptor at the GLB data when it can be used as is
+// (unit scale, 16/32-bit indices); otherwise copies into the scratch vectors.
+static bool DescribeTriangles(const GlbFile &model, const GlbPrimitive &prim,
+                              PxVec3 scale, PxTriangleMeshDesc &desc,
+                              std::vector<PxVec3> &scratchVertices,
+                              std::vector<PxU32> &scratchIndices) {
+  StridedView<PxVec3> positions =
+      model.View<PxVec3>(prim.Attribute("POSITION"));
+  GlbIndexView idx = model.Indices(prim.indices);
+  const GlbAccessor *idxAccessor = idx.Accessor();
+  bool direct = scale == PxVec3(1.0f) && idxAccessor &&
+                idxAccessor->stride == idxAccessor->elementSize &&
+                (idxAccessor->componentType == GLB_COMPONENT_UNSIGNED_SHORT ||
+                 idxAccessor->componentType == GLB_COMPONENT_UNSIGNED_INT);
+
+  if (direct) {
+    if (positions.Count() < 3 || idx.Count() < 3)
+      return false;
+    desc.points.count = static_cast<PxU32>(positions.Count());
+    desc.points.stride = static_cast<PxU32>(positions.Stride());
+    desc.points.data = positions.Data();
+    desc.triangles.count = static_cast<PxU32>(idx.Count() / 3);
+    desc.triangles.stride = static_cast<PxU32>(3 * idxAccessor->elementSize);
+    desc.triangles.data = idxAccessor->data;
+    if (idxAccessor->componentType == GLB_COMPONENT_UNSIGNED_SHORT)
+      desc.flags |= PxMeshFlag::e16_BIT_INDICES;
+    return true;
+  }
+
+  AssetLoader::ExtractMeshData(model, prim, scratchVertices, scratchIndices,
+                               scale);
+  if (scratchVertices.empty() || scratchIndices.size() < 3)
+    return false;
+  desc.points.count = static_cast<PxU32>(scratchVertices.size());
+  desc.points.stride = sizeof(PxVec3);
+  desc.points.data = scratchVertices.data();
+  desc.triangles.count = static_cast<PxU32>(scratchIndices.size() / 3);
+  desc.triangles.stride = 3 * sizeof(PxU32);
+  desc.triangles.data = scratchIndices.data();
+  return true;
+}
+
 PxRigidStatic *AssetLoader::CreateStaticBody(PxPhysics *physics, PxScene *scene,
-                                             const tinygltf::Model &model,
+                                             const GlbFile &model,
                                              PxMaterial *material,
                                              PxTransform transform,
                                              PxVec3 scale) {
-  std::cout << "[AssetLoader] Creating static body from " << model.meshes.size()
+  const std::vector<GlbMesh> &meshes = model.GetMeshes();
+  std::cout << "[AssetLoader] Creating static body from " << meshes.size()
             << " meshes." << std::endl;
 
   PxRigidStatic *body = physics->createRigidStatic(transform);
   int shapeCount = 0;
 
-  for (size_t m = 0; m < model.meshes.size(); m++) {
-    for (size_t p = 0; p < model.meshes[m].primitives.size(); p++) {
+  for (size_t m = 0; m < meshes.size(); m++) {
+    for (size_t p = 0; p < meshes[m].primitives.size(); p++) {
       std::vector<PxVec3> vertices;
       std::vector<PxU32> indices;
 
-      ExtractMeshData(model, model.meshes[m].primitives[p], vertices, indices,
-                      scale);
-
-      if (vertices.empty() || indices.size() < 3)
-        continue;
-
       // Cook triangle mesh
       PxTriangleMeshDesc meshDesc;
-      meshDesc.points.count = static_cast<PxU32>(vertices.size());
-      meshDesc.points.stride = sizeof(PxVec3);
-      meshDesc.points.data = vertices.data();
-      meshDesc.triangles.count = static_cast<PxU32>(indices.size() / 3);
-      meshDesc.triangles.stride = 3 * sizeof(PxU32);
-      meshDesc.triangles.data = indices.data();
+      if (!DescribeTriangles(model, meshes[m].primitives[p], scale, meshDesc,
+                             vertices, indices))
+        continue;
 
       PxDefaultMemoryOutputStream writeBuffer;
       PxTriangleMeshCookingResult::Enum cookResult;
@@ -137,62 +146,103 @@ PxRigidStatic *AssetLoader::CreateStaticBody(PxPhysics *physics, PxScene *scene,
 }
 
 PxRigidDynamic *AssetLoader::CreateDynamicConvexBody(
-    PxPhysics *physics, PxScene *scene, const tinygltf::Model &model,
-    PxMaterial *material, PxTransform transform, float density, PxVec3 scale) {
-
-  // Collect all vertices from all primitives
-  std::vector<PxVec3> allVertices;
-  std::vector<PxU32> dummyIndices;
-
-  for (size_t m = 0; m < model.meshes.size(); m++) {
-    for (size_t p = 0; p < model.meshes[m].primitives.size(); p++) {
-      ExtractMeshData(model, model.meshes[m].primitives[p], allVertices,
-                      dummyIndices, scale);
-    }
+    PxPhysics *physics, PxScene *scene, const GlbFile &model,
+    PxMaterial *material, PxTransform transform, float density, PxVec3 scale,
+    const DecompositionParams &decomposition, const std::string &sourcePath) {
+
+  // Gather every primitive into one triangle list
+  std::vector<DecompositionJob> jobs(1);
+  DecompositionJob &job = jobs[0];
+  for (const GlbMesh &mesh : model.GetMeshes()) {
+    for (const GlbPrimitive &prim : mesh.primitives)
+      ExtractMeshData(model, prim, job.points, job.indices, scale);
   }
 
-  if (allVertices.empty()) {
+  if (job.points.empty()) {
     std::cerr << "[AssetLoader] No vertices for convex body!" << std::endl;
     return nullptr;
   }
 
-  // Cook convex hull
-  PxConvexMeshDesc convexDesc;
-  convexDesc.points.count = static_cast<PxU32>(allVertices.size());
-  convexDesc.points.stride = sizeof(PxVec3);
-  convexDesc.points.data = allVertices.data();
-  convexDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
-
-  PxDefaultMemoryOutputStream writeBuffer;
-  PxConvexMeshCookingResult::Enum cookResult;
-  bool success =
-      PxCookConvexMesh(PxCookingParams(physics->getTolerancesScale()),
-                       convexDesc, writeBuffer, &cookResult);
+  std::ostringstream key;
+  key << "body/" << scale.x << "," << scale.y << "," << scale.z;
+  job.key = key.str();
 
-  if (!success) {
-    std::cerr << "[AssetLoader] Failed to cook convex mesh!" << std::endl;
-    return nullptr;
+  CollisionCache cache;
+  const std::string cachePath = sourcePath + ".collision";
+  uint64_t sourceHash = 0;
+  if (!sourcePath.empty()) {
+    sourceHash = CollisionCache::HashFile(sourcePath);
+    cache.Load(cachePath, sourceHash);
   }
 
-  PxDefaultMemoryInputData readBuffer(writeBuffer.getData(),
-                                      writeBuffer.getSize());
-  PxConvexMesh *convexMesh = physics->createConvexMesh(readBuffer);
+  int cooked = CookDecompositions(physics, jobs, decomposition,
+                                  sourcePath.empty() ? nullptr : &cache);
+  if (cooked > 0 && !sourcePath.empty())
+    cache.Save(cachePath, sourceHash);
+
+  PxRigidDynamic *body = physics->createRigidDynamic(transform);
+  int hullCount = 0;
+  for (const std::vector<uint8_t> &stream : job.streams) {
+    PxConvexMesh *convexMesh = CreateConvexMesh(physics, stream);
+    if (!convexMesh)
+      continue;
+    PxShape *shape =
+        physics->createShape(PxConvexMeshGeometry(convexMesh), *material);
+    body->attachShape(*shape);
+    shape->release();
+    convexMesh->release();
+    hullCount++;
+  }
 
-  if (!convexMesh) {
+  if (hullCount == 0) {
+    body->release();
     std::cerr << "[AssetLoader] Failed to create convex mesh!" << std::endl;
     return nullptr;
   }
 
-  PxRigidDynamic *body = physics->createRigidDynamic(transform);
-  PxShape *shape =
-      physics->createShape(PxConvexMeshGeometry(convexMesh), *material);
-  body->attachShape(*shape);
-  shape->release();
-  convexMesh->release();
-
   PxRigidBodyExt::updateMassAndInertia(*body, density);
   scene->addActor(*body);
 
-  std::cout << "[AssetLoader] Dynamic convex body created." << std::endl;
+  std::cout << "[AssetLoader] Dynamic convex body created with " << hullCount
+            << " hulls" << (job.cached ? " (cached)." : ".") << std::endl;
   return body;
 }
+
+bool AssetLoader::CookConvexStream(PxPhysics *physics,
+                                   const std::vector<PxVec3> &points,
+                                   std::vector<uint8_t> &outStream) {
+  if (points.size() < 4)
+    return false;
+
+  PxConvexMeshDesc convexDesc;
+  convexDesc.points.count = static_cast<PxU32>(points.size());
+  convexDesc.points.stride = sizeof(PxVec3);
+  convexDesc.points.data = points.data();
+  convexDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
+
+  PxDefaultMemoryOutputStream writeBuffer;
+  PxConvexMeshCookingResult::Enum cookResult;
+  if (!PxCookConvexMesh(PxCookingParams(physics->getTolerancesScale()),
+                        convexDesc, writeBuffer, &cookResult))
+    return false;
+
+  outStream.assign(writeBuffer.getData(),
+                   writeBuffer.getData() + writeBuffer.getSize());
+  return true;
+}
+
+PxConvexMesh *
+AssetLoader::CreateConvexMesh(PxPhysics *physics,
+                              const std::vector<uint8_t> &stream) {
+  return CreateConvexMesh(physics, stream.data(), stream.size());
+}
+
+PxConvexMesh *AssetLoader::CreateConvexMesh(PxPhysics *physics,
+                                             const uint8_t *stream,
+                                             size_t size) {
+  if (size == 0)
+    return nullptr;
+  PxDefaultMemoryInputData readBuffer(const_cast<PxU8 *>(stream),
+                                      static_cast<PxU32>(size));
+  return physics->createConvexMesh(readBuffer);
+}
@@ -1,32 +1,48 @@
 #pragma once
 
+#include "ConvexDecomposition.h"
+#include "GlbFile.h"
 #include "PxPhysicsAPI.h"
 #include "cooking/PxCooking.h"
-#include <tiny_gltf.h>
+#include <string>
 #include <vector>
 
 using namespace physx;
 
 class AssetLoader {
 public:
-  // Creates a PxRigidStatic from a tinygltf Model (triangle mesh collision)
+  // Creates a PxRigidStatic from a GLB (triangle mesh collision). At unit
+  // scale the cooker reads positions and indices straight from the file.
   static PxRigidStatic *CreateStaticBody(PxPhysics *physics, PxScene *scene,
-                                         const tinygltf::Model &model,
+                                         const GlbFile &model,
                                          PxMaterial *material,
                                          PxTransform transform,
                                          PxVec3 scale = PxVec3(1.0f));
 
-  // Creates a PxRigidDynamic from a tinygltf Model (convex hull collision)
-  static PxRigidDynamic *
-  CreateDynamicConvexBody(PxPhysics *physics, PxScene *scene,
-                          const tinygltf::Model &model, PxMaterial *material,
-                          PxTransform transform, float density,
-                          PxVec3 scale = PxVec3(1.0f));
+  // Creates a PxRigidDynamic from a GLB, with one convex shape
+  // per hull of an approximate convex decomposition of all its primitives.
+  // When `sourcePath` is set the hulls are cached in `<sourcePath>.collision`.
+  static PxRigidDynamic *CreateDynamicConvexBody(
+      PxPhysics *physics, PxScene *scene, const GlbFile &model,
+      PxMaterial *material, PxTransform transform, float density,
+      PxVec3 scale = PxVec3(1.0f),
+      const DecompositionParams &decomposition = DecompositionParams(),
+      const std::string &sourcePath = "");
 
-private:
-  // Helper to extract vertices and indices from a tinygltf primitive
-  static void ExtractMeshData(const tinygltf::Model &model,
-                              const tinygltf::Primitive &prim,
+  // Helper to extract vertices and indices from a GLB primitive
+  static void ExtractMeshData(const GlbFile &model, const GlbPrimitive &prim,
                               std::vector<PxVec3> &vertices,
                               std::vector<PxU32> &indices, PxVec3 scale);
+
+  // Cooks a convex hull of the points into a serialized PhysX stream
+  // (suitable for caching on disk)
+  static bool CookConvexStream(PxPhysics *physics,
+                               const std::vector<PxVec3> &points,
+                               std::vector<uint8_t> &outStream);
+
+  // Creates a convex mesh from a stream produced by CookConvexStream
+  static PxConvexMesh *CreateConvexMesh(PxPhysics *physics,
+                                        const std::vector<uint8_t> &stream);
+  static PxConvexMesh *CreateConvexMesh(PxPhysics *physics,
+                                        const uint8_t *stream, size_t size);
 };
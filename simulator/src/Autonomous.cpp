@@ -0,0 +1,451 @@
+#include "Autonomous.h"
+
+#include "WaypointDriver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static const float kPi = 3.14159265f;
+static const float kDegToRad = kPi / 180.0f;
+// Pure pursuit never plans below this until the end, as the profile
+// starts at rest
+static const float kMinPursuitSpeed = 0.1f;
+// rad/s of heading change below which a turn counts as settled
+static const float kTurnSettleRate = 0.3f;
+
+bool ParsePathController(const std::string &name, PathController &out) {
+  if (name == "pure_pursuit")
+    out = PathController::ePURE_PURSUIT;
+  else if (name == "ramsete")
+    out = PathController::eRAMSETE;
+  else
+    return false;
+  return true;
+}
+
+const char *GetPathControllerName(PathController controller) {
+  switch (controller) {
+  case PathController::ePURE_PURSUIT:
+    return "pure_pursuit";
+  case PathController::eRAMSETE:
+    return "ramsete";
+  }
+  return "ramsete";
+}
+
+// --- AutonConfig ---
+// Values SetAutonParam accepts. Positive ones are divided by, or needed to
+// plan or steer (a path with no speed is skipped as already driven).
+enum class AutonParamLimit {
+  eANY,
+  ePOSITIVE,
+  eUNIT // Strictly between 0 and 1
+};
+
+struct AutonParam {
+  const char *name;
+  float AutonConfig::*field;
+  AutonParamLimit limit;
+};
+
+static const AutonParam kAutonParams[] = {
+    {"max_velocity", &AutonConfig::maxVelocity, AutonParamLimit::ePOSITIVE},
+    {"max_acceleration", &AutonConfig::maxAcceleration,
+     AutonParamLimit::ePOSITIVE},
+    {"max_centripetal", &AutonConfig::maxCentripetal, AutonParamLimit::eANY},
+    {"lookahead", &AutonConfig::lookahead, AutonParamLimit::ePOSITIVE},
+    {"ramsete_b", &AutonConfig::ramseteB, AutonParamLimit::ePOSITIVE},
+    {"ramsete_zeta", &AutonConfig::ramseteZeta, AutonParamLimit::eUNIT},
+    {"turn_kp", &AutonConfig::turnKp, AutonParamLimit::eANY},
+    {"turn_ki", &AutonConfig::turnKi, AutonParamLimit::eANY},
+    {"turn_kd", &AutonConfig::turnKd, AutonParamLimit::eANY},
+    {"turn_tolerance", &AutonConfig::turnTolerance, AutonParamLimit::eANY},
+    {"max_turn_rate", &AutonConfig::maxTurnRate, AutonParamLimit::ePOSITIVE},
+    {"track_width", &AutonConfig::trackWidth, AutonParamLimit::ePOSITIVE},
+};
+
+static bool IsWithinLimit(float value, AutonParamLimit limit) {
+  switch (limit) {
+  case AutonParamLimit::eANY:
+    return true;
+  case AutonParamLimit::ePOSITIVE:
+    return value > 0.0f;
+  case AutonParamLimit::eUNIT:
+    return value > 0.0f && value < 1.0f;
+  }
+  return false;
+}
+
+const std::vector<std::string> &GetAutonParamNames() {
+  static const std::vector<std::string> names = [] {
+    std::vector<std::string> out;
+    for (const AutonParam &param : kAutonParams)
+      out.push_back(param.name);
+    return out;
+  }();
+  return names;
+}
+
+bool SetAutonParam(AutonConfig &config, const std::string &name,
+                   float value) {
+  for (const AutonParam &param : kAutonParams) {
+    if (name == param.name) {
+      if (!IsWithinLimit(value, param.limit))
+        return false;
+      config.*param.field = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool GetAutonParam(const AutonConfig &config, const std::string &name,
+                   float &value) {
+  for (const AutonParam &param : kAutonParams) {
+    if (name == param.name) {
+      value = config.*param.field;
+      return true;
+    }
+  }
+  return false;
+}
+
+// --- AutonRoutine ---
+bool AutonRoutine::Load(const std::string &path, std::string *err) {
+  std::ifstream file(path);
+  if (!file) {
+    if (err)
+      *err = "cannot open " + path;
+    return false;
+  }
+
+  mSteps.clear();
+  mHasStart = false;
+  std::vector<PxVec3> points; // The path being read
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(file, line)) {
+    lineNumber++;
+    line = line.substr(0, line.find('#'));
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+    std::istringstream in(line);
+    std::string word;
+    in >> word;
+    std::string expected;
+    float a = 0.0f, b = 0.0f, c = 0.0f;
+    if (word == "start") {
+      if (in >> a >> b) {
+        if (!(in >> c))
+          c = 0.0f;
+        SetStart(PxVec3(a, 0.0f, b), c * kDegToRad);
+      } else {
+        expected = "start x z [heading]";
+      }
+    } else if (word == "turn" || word == "wait") {
+      if (!points.empty())
+        AddPath(points);
+      points.clear();
+      if (!(in >> a))
+        expected = word + (word == "turn" ? " heading" : " seconds");
+      else if (word == "turn")
+        AddTurn(a * kDegToRad);
+      else if (a >= 0.0f)
+        AddWait(a);
+      else
+        expected = "a wait of zero or more seconds";
+    } else {
+      std::istringstream point(line);
+      if (point >> a >> b)
+        points.push_back(PxVec3(a, 0.0f, b));
+      else
+        expected = "x z, start, turn or wait";
+    }
+    if (!expected.empty()) {
+      if (err)
+        *err = path + ":" + std::to_string(lineNumber) + ": expected " +
+               expected;
+      mSteps.clear();
+      return false;
+    }
+  }
+  if (!points.empty())
+    AddPath(points);
+  if (mSteps.empty()) {
+    if (err)
+      *err = path + ": a routine needs at least one step";
+    return false;
+  }
+  return true;
+}
+
+void AutonRoutine::AddPath(const std::vector<PxVec3> &points) {
+  AutonStep step;
+  step.type = AutonStepType::eFOLLOW;
+  step.points = points;
+  mSteps.push_back(step);
+}
+
+void AutonRoutine::AddTurn(float heading) {
+  AutonStep step;
+  step.type = AutonStepType::eTURN;
+  step.value = heading;
+  mSteps.push_back(step);
+}
+
+void AutonRoutine::AddWait(float seconds) {
+  AutonStep step;
+  step.type = AutonStepType::eWAIT;
+  step.value = seconds;
+  mSteps.push_back(step);
+}
+
+void AutonRoutine::SetStart(const PxVec3 &position, float heading) {
+  mHasStart = true;
+  mStartPosition = position;
+  mStartHeading = heading;
+}
+
+PxTransform AutonRoutine::GetStart(float driveDirection, float height) const {
+  // The chassis front is its local +Z only if driving forward moves it
+  // that way
+  float yaw = mStartHeading + (driveDirection > 0.0f ? 0.0f : kPi);
+  return PxTransform(mStartPosition + PxVec3(0.0f, height, 0.0f),
+                     PxQuat(yaw, PxVec3(0.0f, 1.0f, 0.0f)));
+}
+
+bool AutonRoutine::GetEnd(PxVec3 &position, float &heading) const {
+  bool moved = false;
+  position = mStartPosition;
+  heading = mStartHeading;
+  for (const AutonStep &step : mSteps) {
+    if (step.type == AutonStepType::eFOLLOW && !step.points.empty()) {
+      // Paths arrive along their last chord, which for a single point
+      // starts where the previous path ended
+      PxVec3 from = step.points.size() >= 2
+                        ? step.points[step.points.size() - 2]
+                        : position;
+      position = step.points.back();
+      PxVec3 chord = position - from;
+      if (std::abs(chord.x) + std::abs(chord.z) > 1e-6f)
+        heading = std::atan2(chord.x, chord.z);
+      moved = true;
+    } else if (step.type == AutonStepType::eTURN) {
+      heading = step.value;
+    }
+  }
+  return moved;
+}
+
+// --- AutonRunner ---
+AutonRunner::AutonRunner(const AutonConfig &config, float wheelRadius,
+                         float maxWheelSpeed, float driveDirection)
+    : mConfig(config), mMetresPerPower(wheelRadius * maxWheelSpeed),
+      mDirection(driveDirection) {}
+
+void AutonRunner::Start(const AutonRoutine &routine) {
+  mRoutine = routine;
+  mStep = 0;
+  // ToPower divides by it; without a usable drive the routine is done
+  if (!(mMetresPerPower > 0.0f)) {
+    std::cerr << "[Auton] Wheel radius and speed must be > 0; routine "
+                 "not run"
+              << std::endl;
+    mStep = mRoutine.GetSteps().size();
+  }
+  mStepStarted = false;
+  mTrajectory = Trajectory();
+  mErrorSum = 0.0;
+  mErrorSamples = 0;
+}
+
+float AutonRunner::GetHeading(const PxTransform &chassis) const {
+  PxVec3 forward = chassis.q.rotate(PxVec3(0.0f, 0.0f, mDirection));
+  return std::atan2(forward.x, forward.z);
+}
+
+static float FloorDistance(const PxVec3 &a, const PxVec3 &b) {
+  float dx = b.x - a.x, dz = b.z - a.z;
+  return std::sqrt(dx * dx + dz * dz);
+}
+
+void AutonRunner::BeginStep(const PxTransform &chassis) {
+  const AutonStep &step = mRoutine.GetSteps()[mStep];
+  mStepStarted = true;
+  mStepTime = 0.0f;
+  if (step.type == AutonStepType::eFOLLOW) {
+    // Planned from where the robot actually is
+    std::vector<PxVec3> points = step.points;
+    PxVec3 here(chassis.p.x, 0.0f, chassis.p.z);
+    if (points.empty() ||
+        FloorDistance(here, points.front()) > mConfig.endTolerance)
+      points.insert(points.begin(), here);
+    TrajectoryLimits limits;
+    limits.maxVelocity = mConfig.maxVelocity;
+    limits.maxAcceleration = mConfig.maxAcceleration;
+    limits.maxCentripetal = mConfig.maxCentripetal;
+    float heading = GetHeading(chassis);
+    if (!mTrajectory.Generate(points, limits, &heading))
+      mTrajectory = Trajectory(); // Already there
+    mNearest = 0;
+    mPursuitSpeed = 0.0f;
+  } else if (step.type == AutonStepType::eTURN) {
+    mTurnIntegral = 0.0f;
+    mTurnError = WrapAngle(step.value - GetHeading(chassis));
+  }
+}
+
+bool AutonRunner::Update(const PxTransform &chassis, float dt, float &left,
+                         float &right) {
+  left = right = 0.0f;
+  // Steps that finish at once hand over in the same update
+  while (!IsDone()) {
+    if (!mStepStarted)
+      BeginStep(chassis);
+    const AutonStep &step = mRoutine.GetSteps()[mStep];
+    float v = 0.0f, omega = 0.0f;
+    bool running = false;
+    switch (step.type) {
+    case AutonStepType::eFOLLOW:
+      running = UpdateFollow(chassis, dt, v, omega);
+      break;
+    case AutonStepType::eTURN:
+      running = UpdateTurn(chassis, dt, omega);
+      break;
+    case AutonStepType::eWAIT:
+      running = mStepTime < step.value;
+      break;
+    }
+    if (running) {
+      ToPower(v, omega, left, right);
+      mStepTime += dt;
+      return true;
+    }
+    mStep++;
+    mStepStarted = false;
+    mTrajectory = Trajectory();
+  }
+  return false;
+}
+
+bool AutonRunner::UpdateFollow(const PxTransform &chassis, float dt, float &v,
+                               float &omega) {
+  if (mTrajectory.IsEmpty())
+    return false;
+  const std::vector<TrajectoryPoint> &points = mTrajectory.GetPoints();
+  const PxVec3 &position = chassis.p;
+  const float heading = GetHeading(chassis);
+  const float duration = mTrajectory.GetDuration();
+  if (mStepTime >= duration + mConfig.stepTimeout)
+    return false;
+
+  mNearest = mTrajectory.FindNearest(position, mNearest);
+  mErrorSum += FloorDistance(position, points[mNearest].position);
+  mErrorSamples++;
+  const float toEnd = FloorDistance(position, points.back().position);
+  if (toEnd < mConfig.endTolerance && mNearest + 1 == points.size())
+    return false;
+
+  // Robot frame: `ahead` along the heading, `side` towards increasing
+  // heading (the way a positive turn rate steers)
+  const float sinH = std::sin(heading), cosH = std::cos(heading);
+  auto toLocal = [&](const PxVec3 &target, float &ahead, float &side) {
+    float dx = target.x - position.x, dz = target.z - position.z;
+    ahead = dx * sinH + dz * cosH;
+    side = dx * cosH - dz * sinH;
+  };
+
+  if (mConfig.controller == PathController::ePURE_PURSUIT) {
+    size_t target = mNearest;
+    while (target + 1 < points.size() &&
+           FloorDistance(position, points[target].position) <
+               mConfig.lookahead)
+      target++;
+    float ahead, side;
+    toLocal(points[target].position, ahead, side);
+    if (target + 1 == points.size() && ahead < 0.0f)
+      return false; // Overshot the end
+    float squared = ahead * ahead + side * side;
+    float curvature = squared > 1e-6f ? 2.0f * side / squared : 0.0f;
+
+    // The profile's speed where the robot is, eased into the end (by
+    // distance along the path, as a loop ends where it starts) and ramped
+    // up at the acceleration limit
+    float remaining =
+        std::max(mTrajectory.GetLength() - points[mNearest].distance, toEnd);
+    float speed = std::max(points[mNearest].velocity, kMinPursuitSpeed);
+    speed = std::min(speed,
+                     std::sqrt(2.0f * mConfig.maxAcceleration * remaining));
+    speed = std::min(speed, mPursuitSpeed + mConfig.maxAcceleration * dt);
+    mPursuitSpeed = speed;
+    v = speed;
+    omega = speed * curvature;
+  } else {
+    // RAMSETE: a nonlinear tracking law that converges on the reference
+    // pose for any b > 0 and 0 < zeta < 1. A robot still short of the end
+    // when the plan runs out keeps homing on the final pose (Sample clamps
+    // to it) until it is within endTolerance or the step times out; the
+    // gains, which vanish with the reference speed, are then those of a
+    // reference moving at maxVelocity.
+    TrajectoryPoint ref = mTrajectory.Sample(mStepTime);
+    float ahead, side;
+    toLocal(ref.position, ahead, side);
+    float headingError = WrapAngle(ref.heading - heading);
+    float refOmega = ref.velocity * ref.curvature;
+    float gainSpeed =
+        mStepTime >= duration ? mConfig.maxVelocity : ref.velocity;
+    float k = 2.0f * mConfig.ramseteZeta *
+              std::sqrt(refOmega * refOmega +
+                        mConfig.ramseteB * gainSpeed * gainSpeed);
+    float sinc = std::abs(headingError) < 1e-4f
+                     ? 1.0f - headingError * headingError / 6.0f
+                     : std::sin(headingError) / headingError;
+    v = ref.velocity * std::cos(headingError) + k * ahead;
+    v = std::clamp(v, -mConfig.maxVelocity, mConfig.maxVelocity);
+    omega = refOmega + k * headingError +
+            mConfig.ramseteB * gainSpeed * sinc * side;
+  }
+  omega = std::clamp(omega, -mConfig.maxTurnRate, mConfig.maxTurnRate);
+  return true;
+}
+
+bool AutonRunner::UpdateTurn(const PxTransform &chassis, float dt,
+                             float &omega) {
+  const AutonStep &step = mRoutine.GetSteps()[mStep];
+  float error = WrapAngle(step.value - GetHeading(chassis));
+  float rate = dt > 0.0f ? WrapAngle(error - mTurnError) / dt : 0.0f;
+  mTurnError = error;
+  if (std::abs(error) < mConfig.turnTolerance &&
+      std::abs(rate) < kTurnSettleRate)
+    return false;
+  if (mStepTime >= kPi / mConfig.maxTurnRate + mConfig.stepTimeout)
+    return false;
+
+  // Integral limited so it alone cannot exceed the turn rate limit
+  mTurnIntegral += error * dt;
+  if (mConfig.turnKi > 0.0f) {
+    float limit = mConfig.maxTurnRate / mConfig.turnKi;
+    mTurnIntegral = std::clamp(mTurnIntegral, -limit, limit);
+  }
+  omega = mConfig.turnKp * error + mConfig.turnKi * mTurnIntegral +
+          mConfig.turnKd * rate;
+  omega = std::clamp(omega, -mConfig.maxTurnRate, mConfig.maxTurnRate);
+  return true;
+}
+
+void AutonRunner::ToPower(float v, float omega, float &left,
+                          float &right) const {
+  // Left minus right turns towards increasing heading by mDirection (see
+  // WaypointDriver)
+  float differential = 0.5f * omega * mConfig.trackWidth * mDirection;
+  left = (v + differential) / mMetresPerPower;
+  right = (v - differential) / mMetresPerPower;
+  float peak = std::max(std::abs(left), std::abs(right));
+  if (peak > 1.0f) {
+    left /= peak;
+    right /= peak;
+  }
+}
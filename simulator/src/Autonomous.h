@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Trajectory.h"
+
+#include <PxPhysicsAPI.h>
+#include <string>
+#include <vector>
+
+using namespace physx;
+
+// Path tracking controller for the follow steps of a routine
+enum class PathController {
+  ePURE_PURSUIT, // Steers at a point `lookahead` ahead on the path
+  eRAMSETE       // Tracks the timed reference pose, correcting the error
+};
+
+bool ParsePathController(const std::string &name, PathController &out);
+const char *GetPathControllerName(PathController controller);
+
+// Limits and gains. Defaults suit the default robot, whose top speed is
+// about 1.1 m/s.
+struct AutonConfig {
+  PathController controller = PathController::eRAMSETE;
+  float maxVelocity = 0.8f;     // m/s along a path
+  float maxAcceleration = 1.5f; // m/s^2
+  float maxCentripetal = 1.0f;  // m/s^2; slows paths in curves
+  float lookahead = 0.3f;       // m, pure pursuit
+  float ramseteB = 2.0f;        // RAMSETE correction strength, > 0
+  float ramseteZeta = 0.7f;     // RAMSETE damping, > 0 and < 1
+  float turnKp = 3.0f;          // Turn rate (rad/s) per radian of error
+  float turnKi = 0.0f;          // Per radian-second
+  float turnKd = 0.2f;          // Per rad/s of error change
+  float turnTolerance = 0.035f; // rad; a turn ends inside this, settled
+  float maxTurnRate = 4.0f;     // rad/s
+  float trackWidth = 0.45f;     // m; effective, wider than the wheels as
+                                // the 8-wheel base skids when it turns
+  float endTolerance = 0.05f;   // m from a path's end to finish it early
+  float stepTimeout = 2.0f;     // s a step may overrun its plan
+};
+
+// Parameter names used by sweeps ("lookahead", "ramsete_b", ...)
+const std::vector<std::string> &GetAutonParamNames();
+// False for an unknown name or a value out of range: max_velocity,
+// max_acceleration, lookahead, ramsete_b, max_turn_rate and track_width
+// must be > 0, ramsete_zeta between 0 and 1
+bool SetAutonParam(AutonConfig &config, const std::string &name, float value);
+bool GetAutonParam(const AutonConfig &config, const std::string &name,
+                   float &value);
+
+enum class AutonStepType { eFOLLOW, eTURN, eWAIT };
+
+struct AutonStep {
+  AutonStepType type = AutonStepType::eWAIT;
+  std::vector<PxVec3> points; // eFOLLOW
+  float value = 0.0f;         // eTURN: heading (rad); eWAIT: seconds
+};
+
+// Sequence of steps, loaded from a text file with one entry per line
+// ('#' starts a comment; distances in metres, headings in degrees with 0
+// along +Z and 90 along +X):
+//   start x z [heading]   where the robot is placed, if the host can
+//   x z                   a path point; consecutive points form one path,
+//                         driven from wherever the robot is at its start
+//   turn heading          turn in place to a heading
+//   wait seconds
+class AutonRoutine {
+public:
+  bool Load(const std::string &path, std::string *err = nullptr);
+
+  void AddPath(const std::vector<PxVec3> &points);
+  void AddTurn(float heading);
+  void AddWait(float seconds);
+  void SetStart(const PxVec3 &position, float heading);
+
+  const std::vector<AutonStep> &GetSteps() const { return mSteps; }
+  bool HasStart() const { return mHasStart; }
+  // Chassis pose for the `start` line, `height` above the floor
+  PxTransform GetStart(float driveDirection, float height) const;
+  // Where the last path ends, and the heading after the last path or turn;
+  // false if the routine never moves
+  bool GetEnd(PxVec3 &position, float &heading) const;
+
+private:
+  std::vector<AutonStep> mSteps;
+  bool mHasStart = false;
+  PxVec3 mStartPosition = PxVec3(0.0f, 0.0f, 0.0f);
+  float mStartHeading = 0.0f;
+};
+
+// Runs a routine one physics step at a time: path steps are planned into a
+// Trajectory when they begin and tracked with the configured controller,
+// turns use a PID loop on heading. Output is left/right power for
+// Robot::SetDriveInput. No allocation after a path is planned, so it costs
+// little next to the physics step in batch runs.
+class AutonRunner {
+public:
+  // `driveDirection` as from MeasureDriveDirection (HeadlessSim.h);
+  // `wheelRadius` and `maxWheelSpeed` turn m/s into power and must be > 0,
+  // or Start logs an error and the routine finishes at once
+  AutonRunner(const AutonConfig &config, float wheelRadius,
+              float maxWheelSpeed, float driveDirection = 1.0f);
+
+  void Start(const AutonRoutine &routine);
+  // Power for the next `dt`; zero and false once the routine has finished
+  bool Update(const PxTransform &chassis, float dt, float &left,
+              float &right);
+
+  bool IsDone() const { return mStep >= mRoutine.GetSteps().size(); }
+  size_t GetStepIndex() const { return mStep; }
+  // Path being followed (empty outside follow steps)
+  const Trajectory &GetTrajectory() const { return mTrajectory; }
+  // Mean distance from the planned path over every follow step so far, m
+  float GetMeanTrackingError() const {
+    return mErrorSamples > 0
+               ? static_cast<float>(mErrorSum / mErrorSamples)
+               : 0.0f;
+  }
+  float GetHeading(const PxTransform &chassis) const;
+
+private:
+  void BeginStep(const PxTransform &chassis);
+  bool UpdateFollow(const PxTransform &chassis, float dt, float &v,
+                    float &omega);
+  bool UpdateTurn(const PxTransform &chassis, float dt, float &omega);
+  // Unicycle command (m/s, rad/s) to side powers; scales both down
+  // together past full power so the curvature is kept
+  void ToPower(float v, float omega, float &left, float &right) const;
+
+  AutonConfig mConfig;
+  float mMetresPerPower;
+  float mDirection;
+  AutonRoutine mRoutine;
+  size_t mStep = 0;
+  bool mStepStarted = false;
+  float mStepTime = 0.0f;
+
+  Trajectory mTrajectory;
+  size_t mNearest = 0;
+  float mPursuitSpeed = 0.0f;
+  float mTurnIntegral = 0.0f;
+  float mTurnError = 0.0f;
+
+  double mErrorSum = 0.0;
+  size_t mErrorSamples = 0;
+};
@@ -0,0 +1,129 @@
+#include "CollisionCache.h"
+#include "PxPhysicsAPI.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static const char kMagic[4] = {'V', 'X', 'C', 'C'};
+static const uint32_t kCacheVersion = 1;
+
+uint64_t CollisionCache::HashFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    return 0;
+
+  uint64_t hash = 1469598103934665603ull;
+  char buffer[64 * 1024];
+  while (file) {
+    file.read(buffer, sizeof(buffer));
+    std::streamsize n = file.gcount();
+    for (std::streamsize i = 0; i < n; i++) {
+      hash ^= static_cast<uint8_t>(buffer[i]);
+      hash *= 1099511628211ull;
+    }
+  }
+  return hash;
+}
+
+template <typename T> static bool ReadPod(std::istream &in, T &value) {
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+template <typename T> static void WritePod(std::ostream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+bool CollisionCache::Load(const std::string &path, uint64_t sourceHash) {
+  mEntries.clear();
+
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in)
+    return false;
+  const uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+  in.seekg(0);
+
+  char magic[4];
+  uint32_t version = 0, physxVersion = 0, count = 0;
+  uint64_t hash = 0;
+  if (!in.read(magic, 4) || memcmp(magic, kMagic, 4) != 0 ||
+      !ReadPod(in, version) || !ReadPod(in, physxVersion) ||
+      !ReadPod(in, hash) || !ReadPod(in, count))
+    return false;
+
+  if (version != kCacheVersion || physxVersion != PX_PHYSICS_VERSION ||
+      hash != sourceHash) {
+    std::cout << "[CollisionCache] Stale cache ignored: " << path
+              << std::endl;
+    return false;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t keyLen = 0;
+    uint64_t dataLen = 0;
+    if (!ReadPod(in, keyLen) || keyLen > 4096)
+      break;
+    std::string key(keyLen, '\0');
+    if (!in.read(&key[0], keyLen) || !ReadPod(in, dataLen))
+      break;
+    // A corrupt length must end in the fallback below, not bad_alloc
+    if (dataLen > fileSize - static_cast<uint64_t>(in.tellg()))
+      break;
+    std::vector<uint8_t> data(static_cast<size_t>(dataLen));
+    if (dataLen && !in.read(reinterpret_cast<char *>(data.data()), dataLen))
+      break;
+    mEntries.emplace(std::move(key), std::move(data));
+  }
+
+  if (mEntries.size() != count) {
+    std::cerr << "[CollisionCache] Truncated cache: " << path << std::endl;
+    mEntries.clear();
+    return false;
+  }
+  return true;
+}
+
+bool CollisionCache::Save(const std::string &path, uint64_t sourceHash) const {
+  // Write to a temporary and rename so a crash never leaves a torn cache
+  std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+
+    uint32_t physxVersion = PX_PHYSICS_VERSION;
+    uint32_t count = static_cast<uint32_t>(mEntries.size());
+    out.write(kMagic, 4);
+    WritePod(out, kCacheVersion);
+    WritePod(out, physxVersion);
+    WritePod(out, sourceHash);
+    WritePod(out, count);
+
+    for (const auto &entry : mEntries) {
+      uint32_t keyLen = static_cast<uint32_t>(entry.first.size());
+      uint64_t dataLen = entry.second.size();
+      WritePod(out, keyLen);
+      out.write(entry.first.data(), keyLen);
+      WritePod(out, dataLen);
+      out.write(reinterpret_cast<const char *>(entry.second.data()),
+                static_cast<std::streamsize>(dataLen));
+    }
+    if (!out)
+      return false;
+  }
+
+  std::remove(path.c_str());
+  return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+const std::vector<uint8_t> *
+CollisionCache::Find(const std::string &key) const {
+  auto it = mEntries.find(key);
+  return it != mEntries.end() ? &it->second : nullptr;
+}
+
+void CollisionCache::Put(const std::string &key, std::vector<uint8_t> data) {
+  mEntries[key] = std::move(data);
+}
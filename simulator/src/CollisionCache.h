@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// On-disk store of cooked PhysX collision streams (and other derived
+// collision data), keyed by name. A cache file is only accepted when it was
+// written for the same source asset hash, cache version and PhysX version,
+// so editing the GLB or upgrading PhysX silently invalidates it.
+class CollisionCache {
+public:
+  // FNV-1a over the whole file; 0 if the file cannot be read
+  static uint64_t HashFile(const std::string &path);
+
+  bool Load(const std::string &path, uint64_t sourceHash);
+  bool Save(const std::string &path, uint64_t sourceHash) const;
+
+  const std::vector<uint8_t> *Find(const std::string &key) const;
+  void Put(const std::string &key, std::vector<uint8_t> data);
+
+  bool Empty() const { return mEntries.empty(); }
+  void Clear() { mEntries.clear(); }
+
+private:
+  std::map<std::string, std::vector<uint8_t>> mEntries;
+};
@@ -0,0 +1,167 @@
+#include "ColumnTable.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+static const char kMagic[4] = {'V', 'X', 'C', 'T'};
+static const uint32_t kTableVersion = 1;
+
+template <typename T> static bool ReadPod(std::istream &in, T &value) {
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+template <typename T> static void WritePod(std::ostream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+size_t ColumnTable::AddColumn(const std::string &name) {
+  int existing = FindColumn(name);
+  if (existing >= 0)
+    return static_cast<size_t>(existing);
+  mNames.push_back(name);
+  mColumns.emplace_back(mRows, std::numeric_limits<double>::quiet_NaN());
+  return mNames.size() - 1;
+}
+
+int ColumnTable::FindColumn(const std::string &name) const {
+  for (size_t i = 0; i < mNames.size(); i++) {
+    if (mNames[i] == name)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+void ColumnTable::Resize(size_t rows) {
+  mRows = rows;
+  for (std::vector<double> &column : mColumns)
+    column.resize(rows, std::numeric_limits<double>::quiet_NaN());
+}
+
+static bool EndsWith(const std::string &s, const char *suffix) {
+  size_t n = strlen(suffix);
+  return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+bool ColumnTable::Save(const std::string &path, std::string *err) const {
+  if (EndsWith(path, ".csv"))
+    return SaveCsv(path, err);
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    if (err)
+      *err = "cannot create " + path;
+    return false;
+  }
+  uint32_t columns = static_cast<uint32_t>(mNames.size());
+  uint64_t rows = mRows;
+  out.write(kMagic, 4);
+  WritePod(out, kTableVersion);
+  WritePod(out, columns);
+  WritePod(out, rows);
+  for (size_t c = 0; c < mNames.size(); c++) {
+    uint32_t nameLen = static_cast<uint32_t>(mNames[c].size());
+    WritePod(out, nameLen);
+    out.write(mNames[c].data(), nameLen);
+    out.write(reinterpret_cast<const char *>(mColumns[c].data()),
+              static_cast<std::streamsize>(mRows * sizeof(double)));
+  }
+  if (!out) {
+    if (err)
+      *err = "write failed: " + path;
+    return false;
+  }
+  return true;
+}
+
+bool ColumnTable::SaveCsv(const std::string &path, std::string *err) const {
+  FILE *file = std::fopen(path.c_str(), "w");
+  if (!file) {
+    if (err)
+      *err = "cannot create " + path;
+    return false;
+  }
+  for (size_t c = 0; c < mNames.size(); c++)
+    std::fprintf(file, "%s%s", c ? "," : "", mNames[c].c_str());
+  std::fputc('\n', file);
+  for (size_t r = 0; r < mRows; r++) {
+    for (size_t c = 0; c < mNames.size(); c++) {
+      double value = mColumns[c][r];
+      if (c)
+        std::fputc(',', file);
+      if (!std::isnan(value))
+        std::fprintf(file, "%.9g", value);
+    }
+    std::fputc('\n', file);
+  }
+  bool ok = std::ferror(file) == 0;
+  std::fclose(file);
+  if (!ok && err)
+    *err = "write failed: " + path;
+  return ok;
+}
+
+bool ColumnTable::Load(const std::string &path, std::string *err) {
+  mNames.clear();
+  mColumns.clear();
+  mRows = 0;
+
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    if (err)
+      *err = "cannot open " + path;
+    return false;
+  }
+  const uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+  in.seekg(0);
+  char magic[4];
+  uint32_t version = 0, columns = 0;
+  uint64_t rows = 0;
+  if (!in.read(magic, 4) || memcmp(magic, kMagic, 4) != 0 ||
+      !ReadPod(in, version) || version != kTableVersion ||
+      !ReadPod(in, columns) || !ReadPod(in, rows)) {
+    if (err)
+      *err = path + " is not a column table";
+    return false;
+  }
+
+  // Every column stores a name length and `rows` doubles; counts that could
+  // not fit in the file are corrupt, and are rejected before allocating
+  const uint64_t remaining = fileSize - static_cast<uint64_t>(in.tellg());
+  if (rows > remaining / sizeof(double) ||
+      columns > remaining / (sizeof(uint32_t) + rows * sizeof(double))) {
+    if (err)
+      *err = "truncated column table: " + path;
+    return false;
+  }
+
+  mRows = static_cast<size_t>(rows);
+  for (uint32_t c = 0; c < columns; c++) {
+    uint32_t nameLen = 0;
+    std::string name;
+    std::vector<double> values(mRows);
+    bool ok = ReadPod(in, nameLen) && nameLen <= 4096;
+    if (ok) {
+      name.resize(nameLen);
+      ok = static_cast<bool>(in.read(&name[0], nameLen)) &&
+           static_cast<bool>(
+               in.read(reinterpret_cast<char *>(values.data()),
+                       static_cast<std::streamsize>(mRows * sizeof(double))));
+    }
+    if (!ok) {
+      if (err)
+        *err = "truncated column table: " + path;
+      mNames.clear();
+      mColumns.clear();
+      mRows = 0;
+      return false;
+    }
+    mNames.push_back(std::move(name));
+    mColumns.push_back(std::move(values));
+  }
+  return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Named columns of doubles, stored column by column, for batch-run results
+// (one row per run). Saved as a small binary file (magic "VXCT", then each
+// column's name and its values back to back) that loads straight into
+// per-column arrays, or as CSV when the path ends in ".csv".
+class ColumnTable {
+public:
+  // Returns the column's index; an existing name returns its column
+  size_t AddColumn(const std::string &name);
+  int FindColumn(const std::string &name) const;
+
+  // New rows are NaN
+  void Resize(size_t rows);
+  void Set(size_t column, size_t row, double value) {
+    mColumns[column][row] = value;
+  }
+
+  size_t GetRowCount() const { return mRows; }
+  size_t GetColumnCount() const { return mNames.size(); }
+  const std::string &GetName(size_t column) const { return mNames[column]; }
+  const std::vector<double> &GetColumn(size_t column) const {
+    return mColumns[column];
+  }
+
+  bool Save(const std::string &path, std::string *err = nullptr) const;
+  bool Load(const std::string &path, std::string *err = nullptr);
+
+private:
+  bool SaveCsv(const std::string &path, std::string *err) const;
+
+  std::vector<std::string> mNames;
+  std::vector<std::vector<double>> mColumns;
+  size_t mRows = 0;
+};
@@ -0,0 +1,350 @@
+#include "Controller.h"
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+// --- Names used by mapping files ---
+struct NamedCode {
+  const char *name;
+  int code;
+};
+
+static const char *kAxisNames[kControllerAxes] = {"axis1", "axis2", "axis3",
+                                                  "axis4"};
+static const char *kButtonNames[kControllerButtons] = {
+    "L1", "L2", "R1", "R2", "up", "down", "left", "right", "X", "B", "Y", "A"};
+
+static const NamedCode kKeyNames[] = {
+    {"space", GLFW_KEY_SPACE},       {"enter", GLFW_KEY_ENTER},
+    {"tab", GLFW_KEY_TAB},           {"left_shift", GLFW_KEY_LEFT_SHIFT},
+    {"right_shift", GLFW_KEY_RIGHT_SHIFT},
+    {"left_control", GLFW_KEY_LEFT_CONTROL},
+    {"right_control", GLFW_KEY_RIGHT_CONTROL},
+    {"comma", GLFW_KEY_COMMA},       {"period", GLFW_KEY_PERIOD},
+    {"slash", GLFW_KEY_SLASH},       {"semicolon", GLFW_KEY_SEMICOLON},
+};
+
+static const NamedCode kGamepadAxisNames[] = {
+    {"left_x", GLFW_GAMEPAD_AXIS_LEFT_X},
+    {"left_y", GLFW_GAMEPAD_AXIS_LEFT_Y},
+    {"right_x", GLFW_GAMEPAD_AXIS_RIGHT_X},
+    {"right_y", GLFW_GAMEPAD_AXIS_RIGHT_Y},
+    {"left_trigger", GLFW_GAMEPAD_AXIS_LEFT_TRIGGER},
+    {"right_trigger", GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER},
+};
+
+static const NamedCode kGamepadButtonNames[] = {
+    {"a", GLFW_GAMEPAD_BUTTON_A},
+    {"b", GLFW_GAMEPAD_BUTTON_B},
+    {"x", GLFW_GAMEPAD_BUTTON_X},
+    {"y", GLFW_GAMEPAD_BUTTON_Y},
+    {"left_bumper", GLFW_GAMEPAD_BUTTON_LEFT_BUMPER},
+    {"right_bumper", GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER},
+    {"back", GLFW_GAMEPAD_BUTTON_BACK},
+    {"start", GLFW_GAMEPAD_BUTTON_START},
+    {"guide", GLFW_GAMEPAD_BUTTON_GUIDE},
+    {"left_thumb", GLFW_GAMEPAD_BUTTON_LEFT_THUMB},
+    {"right_thumb", GLFW_GAMEPAD_BUTTON_RIGHT_THUMB},
+    {"dpad_up", GLFW_GAMEPAD_BUTTON_DPAD_UP},
+    {"dpad_right", GLFW_GAMEPAD_BUTTON_DPAD_RIGHT},
+    {"dpad_down", GLFW_GAMEPAD_BUTTON_DPAD_DOWN},
+    {"dpad_left", GLFW_GAMEPAD_BUTTON_DPAD_LEFT},
+};
+
+template <size_t N>
+static bool FindCode(const NamedCode (&table)[N], const std::string &name,
+                     int &out) {
+  for (const NamedCode &entry : table) {
+    if (name == entry.name) {
+      out = entry.code;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Single letters and digits are their GLFW key (which is their ASCII code)
+static bool ParseKey(const std::string &name, int &out) {
+  if (name.size() == 1 && std::isalnum(static_cast<unsigned char>(name[0]))) {
+    out = std::toupper(static_cast<unsigned char>(name[0]));
+    return true;
+  }
+  return FindCode(kKeyNames, name, out);
+}
+
+// --- InputMapping ---
+InputMapping::InputMapping() {
+  auto keys = [this](ControllerAxis axis, int positive, int negative) {
+    mAxes.push_back({axis, Source::eKEYS, positive, negative, false});
+  };
+  auto stick = [this](ControllerAxis axis, int gamepadAxis, bool invert) {
+    mAxes.push_back({axis, Source::eGAMEPAD_AXIS, gamepadAxis, -1, invert});
+  };
+  auto key = [this](ControllerButton button, int code) {
+    mButtons.push_back({button, Source::eKEYS, code});
+  };
+  auto pad = [this](ControllerButton button, int code) {
+    mButtons.push_back({button, Source::eGAMEPAD_BUTTON, code});
+  };
+
+  // Keyboard: D/C left side, A/Z right side, J/L turn for arcade modes
+  keys(ControllerAxis::eAXIS3, GLFW_KEY_D, GLFW_KEY_C);
+  keys(ControllerAxis::eAXIS2, GLFW_KEY_A, GLFW_KEY_Z);
+  keys(ControllerAxis::eAXIS1, GLFW_KEY_L, GLFW_KEY_J);
+  key(ControllerButton::eX, GLFW_KEY_R);
+  key(ControllerButton::eB, GLFW_KEY_B);
+  key(ControllerButton::eR1, GLFW_KEY_F);
+  key(ControllerButton::eR2, GLFW_KEY_G);
+
+  // Gamepad: GLFW sticks are +Y down, the V5's are +Y up
+  stick(ControllerAxis::eAXIS1, GLFW_GAMEPAD_AXIS_RIGHT_X, false);
+  stick(ControllerAxis::eAXIS2, GLFW_GAMEPAD_AXIS_RIGHT_Y, true);
+  stick(ControllerAxis::eAXIS3, GLFW_GAMEPAD_AXIS_LEFT_Y, true);
+  stick(ControllerAxis::eAXIS4, GLFW_GAMEPAD_AXIS_LEFT_X, false);
+  pad(ControllerButton::eL1, GLFW_GAMEPAD_BUTTON_LEFT_BUMPER);
+  pad(ControllerButton::eR1, GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER);
+  mButtons.push_back({ControllerButton::eL2, Source::eGAMEPAD_AXIS,
+                      GLFW_GAMEPAD_AXIS_LEFT_TRIGGER});
+  mButtons.push_back({ControllerButton::eR2, Source::eGAMEPAD_AXIS,
+                      GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER});
+  pad(ControllerButton::eUP, GLFW_GAMEPAD_BUTTON_DPAD_UP);
+  pad(ControllerButton::eDOWN, GLFW_GAMEPAD_BUTTON_DPAD_DOWN);
+  pad(ControllerButton::eLEFT, GLFW_GAMEPAD_BUTTON_DPAD_LEFT);
+  pad(ControllerButton::eRIGHT, GLFW_GAMEPAD_BUTTON_DPAD_RIGHT);
+  pad(ControllerButton::eA, GLFW_GAMEPAD_BUTTON_A);
+  pad(ControllerButton::eB, GLFW_GAMEPAD_BUTTON_B);
+  pad(ControllerButton::eX, GLFW_GAMEPAD_BUTTON_X);
+  pad(ControllerButton::eY, GLFW_GAMEPAD_BUTTON_Y);
+}
+
+bool InputMapping::Load(const std::string &path, std::string *err) {
+  std::ifstream file(path);
+  if (!file) {
+    if (err)
+      *err = "cannot open " + path;
+    return false;
+  }
+
+  std::vector<AxisBinding> axes = mAxes;
+  std::vector<ButtonBinding> buttons = mButtons;
+  float deadzone = mDeadzone;
+  bool axisSeen[kControllerAxes] = {};
+  bool buttonSeen[kControllerButtons] = {};
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(file, line)) {
+    lineNumber++;
+    std::istringstream in(line.substr(0, line.find('#')));
+    std::string channel, source, a, b;
+    if (!(in >> channel))
+      continue;
+    in >> source >> a >> b;
+    auto fail = [&](const std::string &what) {
+      if (err)
+        *err = path + ":" + std::to_string(lineNumber) + ": " + what;
+      return false;
+    };
+
+    if (channel == "deadzone") {
+      deadzone = std::strtof(source.c_str(), nullptr);
+      continue;
+    }
+
+    int axisIndex = -1, buttonIndex = -1;
+    for (int i = 0; i < kControllerAxes; i++) {
+      if (channel == kAxisNames[i])
+        axisIndex = i;
+    }
+    for (int i = 0; i < kControllerButtons; i++) {
+      if (channel == kButtonNames[i])
+        buttonIndex = i;
+    }
+    if (axisIndex < 0 && buttonIndex < 0)
+      return fail("unknown channel '" + channel + "'");
+
+    // The first line for a channel drops its default bindings
+    if (axisIndex >= 0 && !axisSeen[axisIndex]) {
+      axisSeen[axisIndex] = true;
+      axes.erase(std::remove_if(axes.begin(), axes.end(),
+                                [&](const AxisBinding &binding) {
+                                  return static_cast<int>(binding.axis) ==
+                                         axisIndex;
+                                }),
+                 axes.end());
+    }
+    if (buttonIndex >= 0 && !buttonSeen[buttonIndex]) {
+      buttonSeen[buttonIndex] = true;
+      buttons.erase(std::remove_if(buttons.begin(), buttons.end(),
+                                   [&](const ButtonBinding &binding) {
+                                     return static_cast<int>(
+                                                binding.button) == buttonIndex;
+                                   }),
+                    buttons.end());
+    }
+
+    if (axisIndex >= 0) {
+      AxisBinding binding = {static_cast<ControllerAxis>(axisIndex),
+                             Source::eKEYS, -1, -1, false};
+      if (source == "keys") {
+        if (!ParseKey(a, binding.positive) || !ParseKey(b, binding.negative))
+          return fail("expected two key names");
+      } else if (source == "gamepad_axis") {
+        binding.source = Source::eGAMEPAD_AXIS;
+        if (!FindCode(kGamepadAxisNames, a, binding.positive))
+          return fail("unknown gamepad axis '" + a + "'");
+        binding.invert = b == "invert";
+      } else {
+        return fail("axes take 'keys' or 'gamepad_axis'");
+      }
+      axes.push_back(binding);
+    } else {
+      ButtonBinding binding = {static_cast<ControllerButton>(buttonIndex),
+                               Source::eKEYS, -1};
+      bool ok = false;
+      if (source == "key") {
+        ok = ParseKey(a, binding.code);
+      } else if (source == "gamepad_button") {
+        binding.source = Source::eGAMEPAD_BUTTON;
+        ok = FindCode(kGamepadButtonNames, a, binding.code);
+      } else if (source == "gamepad_axis") {
+        binding.source = Source::eGAMEPAD_AXIS;
+        ok = FindCode(kGamepadAxisNames, a, binding.code);
+      }
+      if (!ok)
+        return fail("bad button binding '" + source + " " + a + "'");
+      buttons.push_back(binding);
+    }
+  }
+
+  mAxes = std::move(axes);
+  mButtons = std::move(buttons);
+  mDeadzone = std::clamp(deadzone, 0.0f, 0.9f);
+  return true;
+}
+
+static int FindGamepad() {
+  for (int jid = GLFW_JOYSTICK_1; jid <= GLFW_JOYSTICK_LAST; jid++) {
+    if (glfwJoystickIsGamepad(jid))
+      return jid;
+  }
+  return -1;
+}
+
+std::string InputMapping::GetGamepadName() const {
+  int jid = FindGamepad();
+  const char *name = jid >= 0 ? glfwGetGamepadName(jid) : nullptr;
+  return name ? name : "";
+}
+
+ControllerState InputMapping::Sample(GLFWwindow *window) const {
+  GLFWgamepadstate pad = {};
+  int jid = FindGamepad();
+  bool hasPad = jid >= 0 && glfwGetGamepadState(jid, &pad);
+
+  auto keyDown = [window](int key) {
+    return key >= 0 && glfwGetKey(window, key) == GLFW_PRESS;
+  };
+
+  ControllerState state;
+  for (const AxisBinding &binding : mAxes) {
+    float value = 0.0f;
+    if (binding.source == Source::eKEYS) {
+      value = (keyDown(binding.positive) ? 1.0f : 0.0f) -
+              (keyDown(binding.negative) ? 1.0f : 0.0f);
+    } else if (hasPad) {
+      value = pad.axes[binding.positive];
+      if (binding.invert)
+        value = -value;
+      // Rescale past the deadzone so small deflections stay usable
+      float magnitude = std::abs(value);
+      value = magnitude <= mDeadzone
+                  ? 0.0f
+                  : std::copysign((magnitude - mDeadzone) / (1.0f - mDeadzone),
+                                  value);
+    }
+    float &axis = state.axes[static_cast<int>(binding.axis)];
+    axis = std::clamp(axis + value, -1.0f, 1.0f);
+  }
+
+  for (const ButtonBinding &binding : mButtons) {
+    bool down = false;
+    if (binding.source == Source::eKEYS)
+      down = keyDown(binding.code);
+    else if (hasPad && binding.source == Source::eGAMEPAD_BUTTON)
+      down = pad.buttons[binding.code] == GLFW_PRESS;
+    else if (hasPad)
+      down = pad.axes[binding.code] > 0.0f; // Triggers rest at -1
+    if (down)
+      state.buttons |= 1u << static_cast<int>(binding.button);
+  }
+  return state;
+}
+
+// --- Drive modes ---
+bool ParseDriveMode(const std::string &name, DriveMode &out) {
+  if (name == "tank")
+    out = DriveMode::eTANK;
+  else if (name == "arcade")
+    out = DriveMode::eARCADE;
+  else if (name == "curvature")
+    out = DriveMode::eCURVATURE;
+  else
+    return false;
+  return true;
+}
+
+const char *GetDriveModeName(DriveMode mode) {
+  switch (mode) {
+  case DriveMode::eTANK:
+    return "tank";
+  case DriveMode::eARCADE:
+    return "arcade";
+  case DriveMode::eCURVATURE:
+    return "curvature";
+  }
+  return "tank";
+}
+
+// Scales both sides down together so the turn ratio is kept
+static void Desaturate(float &left, float &right) {
+  float peak = std::max(std::abs(left), std::abs(right));
+  if (peak > 1.0f) {
+    left /= peak;
+    right /= peak;
+  }
+}
+
+void ComputeDrive(const ControllerState &state, DriveMode mode, float &left,
+                  float &right) {
+  float forward = state.Axis(ControllerAxis::eAXIS3);
+  float turn = state.Axis(ControllerAxis::eAXIS1);
+
+  switch (mode) {
+  case DriveMode::eTANK:
+    left = forward;
+    right = state.Axis(ControllerAxis::eAXIS2);
+    break;
+  case DriveMode::eARCADE:
+    left = forward + turn;
+    right = forward - turn;
+    break;
+  case DriveMode::eCURVATURE:
+    // The stick sets how sharply to turn rather than how fast, so turning
+    // feels the same at any speed; near zero throttle it spins in place
+    if (std::abs(forward) < 0.05f) {
+      left = turn;
+      right = -turn;
+    } else {
+      left = forward + std::abs(forward) * turn;
+      right = forward - std::abs(forward) * turn;
+    }
+    break;
+  }
+  Desaturate(left, right);
+}
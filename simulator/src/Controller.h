@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct GLFWwindow;
+
+// Channels of a V5 controller. Axis numbering follows the V5: Axis1/2 are
+// the right stick X/Y, Axis3/4 the left stick Y/X.
+enum class ControllerAxis : uint8_t { eAXIS1, eAXIS2, eAXIS3, eAXIS4 };
+enum class ControllerButton : uint8_t {
+  eL1,
+  eL2,
+  eR1,
+  eR2,
+  eUP,
+  eDOWN,
+  eLEFT,
+  eRIGHT,
+  eX,
+  eB,
+  eY,
+  eA
+};
+static const int kControllerAxes = 4;
+static const int kControllerButtons = 12;
+
+// One sample of the controller, taken once per physics step
+struct ControllerState {
+  float axes[kControllerAxes] = {}; // [-1, 1], stick up/right positive
+  uint16_t buttons = 0;             // Bit per ControllerButton
+
+  float Axis(ControllerAxis axis) const {
+    return axes[static_cast<int>(axis)];
+  }
+  bool Down(ControllerButton button) const {
+    return (buttons >> static_cast<int>(button)) & 1;
+  }
+  // Down now but not in `prev`
+  bool Pressed(ControllerButton button, const ControllerState &prev) const {
+    return Down(button) && !prev.Down(button);
+  }
+};
+
+// Maps keyboard keys and GLFW gamepad axes/buttons to controller channels.
+// Several sources may drive one channel: axes are summed and clamped,
+// buttons are OR'd. The defaults keep the original keyboard layout (tank
+// drive on A/Z and D/C, R/B spawn, F/G intake/outtake) and add an
+// Xbox-layout gamepad.
+//
+// A mapping file replaces the defaults of every channel it mentions:
+//   axis3   keys            D C        # positive key, negative key
+//   axis3   gamepad_axis    left_y invert
+//   R1      key             F
+//   R1      gamepad_button  right_bumper
+//   R2      gamepad_axis    right_trigger   # pressed past half travel
+//   deadzone 0.1
+class InputMapping {
+public:
+  InputMapping();
+
+  bool Load(const std::string &path, std::string *err = nullptr);
+
+  // Reads the keyboard and the first connected gamepad
+  ControllerState Sample(GLFWwindow *window) const;
+
+  // Name of the gamepad Sample reads, or empty if none is connected
+  std::string GetGamepadName() const;
+
+private:
+  enum class Source : uint8_t { eKEYS, eGAMEPAD_AXIS, eGAMEPAD_BUTTON };
+  struct AxisBinding {
+    ControllerAxis axis;
+    Source source;
+    int positive; // Key, or gamepad axis
+    int negative; // Key, or -1
+    bool invert;
+  };
+  struct ButtonBinding {
+    ControllerButton button;
+    Source source; // eKEYS uses `code` as one key
+    int code;
+  };
+
+  std::vector<AxisBinding> mAxes;
+  std::vector<ButtonBinding> mButtons;
+  float mDeadzone = 0.08f; // Gamepad sticks only
+};
+
+// How the sticks become left/right drive power
+enum class DriveMode {
+  eTANK,     // Axis3 left side, Axis2 right side
+  eARCADE,   // Split arcade: Axis3 forward, Axis1 turn
+  eCURVATURE // Axis1 sets path curvature; turns in place when stopped
+};
+
+bool ParseDriveMode(const std::string &name, DriveMode &out);
+const char *GetDriveModeName(DriveMode mode);
+
+// Left/right side power in [-1, 1] for Robot::SetDriveInput
+void ComputeDrive(const ControllerState &state, DriveMode mode, float &left,
+                  float &right);
@@ -0,0 +1,185 @@
+#include "ConvexDecomposition.h"
+#include "AssetLoader.h"
+#include "CollisionCache.h"
+
+#define ENABLE_VHACD_IMPLEMENTATION 1
+#include <VHACD.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+std::string DecompositionParams::Key() const {
+  std::ostringstream key;
+  key << "vhacd4/" << maxHulls << "/" << resolution << "/"
+      << maxVerticesPerHull << "/" << maxRecursionDepth << "/"
+      << minVolumeErrorPercent;
+  return key.str();
+}
+
+static bool DecomposeWith(const std::vector<PxVec3> &points,
+                          const std::vector<PxU32> &indices,
+                          const DecompositionParams &params, bool asyncAcd,
+                          std::vector<std::vector<PxVec3>> &outHulls) {
+  outHulls.clear();
+  if (params.maxHulls <= 1 || indices.size() < 3) {
+    if (points.size() < 4)
+      return false;
+    outHulls.push_back(points);
+    return true;
+  }
+
+  VHACD::IVHACD::Parameters vp;
+  vp.m_maxConvexHulls = params.maxHulls;
+  vp.m_resolution = params.resolution;
+  vp.m_maxNumVerticesPerCH = params.maxVerticesPerHull;
+  vp.m_maxRecursionDepth = params.maxRecursionDepth;
+  vp.m_minimumVolumePercentErrorAllowed = params.minVolumeErrorPercent;
+  vp.m_asyncACD = asyncAcd;
+
+  // PxVec3 is three packed floats, as V-HACD expects
+  VHACD::IVHACD *vhacd = VHACD::CreateVHACD();
+  bool ok = vhacd->Compute(reinterpret_cast<const float *>(points.data()),
+                           static_cast<uint32_t>(points.size()),
+                           indices.data(),
+                           static_cast<uint32_t>(indices.size() / 3), vp);
+  if (ok) {
+    for (uint32_t i = 0; i < vhacd->GetNConvexHulls(); i++) {
+      VHACD::IVHACD::ConvexHull hull;
+      if (!vhacd->GetConvexHull(i, hull) || hull.m_points.size() < 4)
+        continue;
+      std::vector<PxVec3> hullPoints;
+      hullPoints.reserve(hull.m_points.size());
+      for (const VHACD::Vertex &v : hull.m_points) {
+        hullPoints.push_back(PxVec3(static_cast<float>(v.mX),
+                                    static_cast<float>(v.mY),
+                                    static_cast<float>(v.mZ)));
+      }
+      outHulls.push_back(std::move(hullPoints));
+    }
+  }
+  vhacd->Release();
+
+  // Degenerate input (flat or open meshes) can yield nothing; one hull of
+  // the whole mesh is still better than no collision.
+  if (outHulls.empty() && points.size() >= 4)
+    outHulls.push_back(points);
+  return !outHulls.empty();
+}
+
+bool DecomposeConvex(const std::vector<PxVec3> &points,
+                     const std::vector<PxU32> &indices,
+                     const DecompositionParams &params,
+                     std::vector<std::vector<PxVec3>> &outHulls) {
+  return DecomposeWith(points, indices, params, params.parallel, outHulls);
+}
+
+// Cache blob: uint32 hull count, then per hull a uint32 size and the stream
+static std::vector<uint8_t>
+PackStreams(const std::vector<std::vector<uint8_t>> &streams) {
+  std::vector<uint8_t> blob;
+  auto put32 = [&](uint32_t v) {
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(&v);
+    blob.insert(blob.end(), p, p + sizeof(v));
+  };
+  put32(static_cast<uint32_t>(streams.size()));
+  for (const auto &stream : streams) {
+    put32(static_cast<uint32_t>(stream.size()));
+    blob.insert(blob.end(), stream.begin(), stream.end());
+  }
+  return blob;
+}
+
+static bool UnpackStreams(const std::vector<uint8_t> &blob,
+                          std::vector<std::vector<uint8_t>> &streams) {
+  size_t offset = 0;
+  auto get32 = [&](uint32_t &v) {
+    if (offset + sizeof(v) > blob.size())
+      return false;
+    memcpy(&v, blob.data() + offset, sizeof(v));
+    offset += sizeof(v);
+    return true;
+  };
+
+  uint32_t count = 0;
+  // Every stream has a u32 size, so a larger count is corrupt
+  if (!get32(count) || count > (blob.size() - offset) / sizeof(uint32_t))
+    return false;
+  streams.assign(count, {});
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t size = 0;
+    if (!get32(size) || offset + size > blob.size())
+      return false;
+    streams[i].assign(blob.begin() + offset, blob.begin() + offset + size);
+    offset += size;
+  }
+  return true;
+}
+
+int CookDecompositions(PxPhysics *physics, std::vector<DecompositionJob> &jobs,
+                       const DecompositionParams &params,
+                       CollisionCache *cache) {
+  const std::string paramsKey = params.Key();
+  std::vector<DecompositionJob *> pending;
+  for (DecompositionJob &job : jobs) {
+    job.streams.clear();
+    job.cached = false;
+    if (cache) {
+      const std::vector<uint8_t> *blob = cache->Find(job.key + "|" + paramsKey);
+      if (blob && UnpackStreams(*blob, job.streams)) {
+        job.cached = true;
+        continue;
+      }
+    }
+    pending.push_back(&job);
+  }
+  if (pending.empty())
+    return 0;
+
+  // With several jobs, run one per thread and keep each V-HACD serial;
+  // a single job gets V-HACD's own threading instead.
+  const bool acrossJobs = params.parallel && pending.size() > 1;
+  auto cookJob = [&](DecompositionJob &job) {
+    std::vector<std::vector<PxVec3>> hulls;
+    if (!DecomposeWith(job.points, job.indices, params,
+                       params.parallel && !acrossJobs, hulls))
+      return;
+    for (const auto &hull : hulls) {
+      std::vector<uint8_t> stream;
+      if (AssetLoader::CookConvexStream(physics, hull, stream))
+        job.streams.push_back(std::move(stream));
+    }
+  };
+
+  if (acrossJobs) {
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min<unsigned>(threadCount,
+                                     static_cast<unsigned>(pending.size()));
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threadCount; t++) {
+      workers.emplace_back([&]() {
+        for (size_t i = next++; i < pending.size(); i = next++)
+          cookJob(*pending[i]);
+      });
+    }
+    for (std::thread &worker : workers)
+      worker.join();
+  } else {
+    for (DecompositionJob *job : pending)
+      cookJob(*job);
+  }
+
+  for (DecompositionJob *job : pending) {
+    if (job->streams.empty()) {
+      std::cerr << "[ConvexDecomposition] No hulls for " << job->key
+                << std::endl;
+    } else if (cache) {
+      cache->Put(job->key + "|" + paramsKey, PackStreams(job->streams));
+    }
+  }
+  return static_cast<int>(pending.size());
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "PxPhysicsAPI.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace physx;
+
+class CollisionCache;
+
+// V-HACD settings for splitting a concave mesh into convex hulls
+struct DecompositionParams {
+  uint32_t maxHulls = 16;            // 1 = a single hull of every vertex
+  uint32_t resolution = 100000;      // Voxels
+  uint32_t maxVerticesPerHull = 64;  // Well under PhysX's 255 limit
+  uint32_t maxRecursionDepth = 10;
+  double minVolumeErrorPercent = 1.0;
+  bool parallel = true; // Decompose jobs concurrently (and V-HACD's own ACD)
+
+  // Stable text form, used in cache keys so new settings re-cook
+  std::string Key() const;
+};
+
+// One mesh to decompose and cook. `streams` receives one cooked
+// PxConvexMesh stream per hull (see AssetLoader::CreateConvexMesh).
+struct DecompositionJob {
+  std::string key; // Cache key, unique within one CollisionCache
+  std::vector<PxVec3> points;
+  std::vector<PxU32> indices; // Triangle list
+  std::vector<std::vector<uint8_t>> streams;
+  bool cached = false;
+};
+
+// Splits a triangle mesh into convex point clouds. Falls back to a single
+// hull of all points when params.maxHulls <= 1 or the mesh has no faces.
+bool DecomposeConvex(const std::vector<PxVec3> &points,
+                     const std::vector<PxU32> &indices,
+                     const DecompositionParams &params,
+                     std::vector<std::vector<PxVec3>> &outHulls);
+
+// Fills job.streams for every job, from `cache` where possible and by
+// decomposing and cooking otherwise (storing the results back into
+// `cache`). Returns the number of jobs that had to be cooked.
+int CookDecompositions(PxPhysics *physics, std::vector<DecompositionJob> &jobs,
+                       const DecompositionParams &params,
+                       CollisionCache *cache);
@@ -0,0 +1,478 @@
+#include "FieldCollision.h"
+#include "AssetLoader.h"
+#include "CollisionCache.h"
+#include "PhysicsWorld.h"
+#include "SimulationFilter.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// Proxy heuristics, in metres. Field meshes are classified by their AABB:
+// thin and wide is floor, hugging the outer edge is perimeter, tiny is
+// decoration (screws, fillets, nuts) and everything else gets a hull.
+static const float kFloorMaxThickness = 0.03f;
+static const float kFloorMinCoverage = 0.5f; // Fraction of the field's X/Z
+static const float kPerimeterBand = 0.10f;
+static const float kDecorativeDiagonal = 0.04f;
+static const float kMinBoxHalfExtent = 0.005f;
+
+// Regulation perimeter, used when there is no field model
+static const float kWallHeight = 0.30f;
+static const float kWallThickness = 0.05f;
+
+using Clock = std::chrono::high_resolution_clock;
+
+bool ParseFieldCollisionMode(const std::string &name, FieldCollisionMode &out) {
+  if (name == "mesh") {
+    out = FieldCollisionMode::eFULL_MESH;
+    return true;
+  }
+  if (name == "proxies") {
+    out = FieldCollisionMode::ePROXIES;
+    return true;
+  }
+  return false;
+}
+
+const char *FieldCollisionModeName(FieldCollisionMode mode) {
+  return mode == FieldCollisionMode::eFULL_MESH ? "mesh" : "proxies";
+}
+
+// Read straight from the mapped file; no vertex copies
+static PxBounds3 MeshBounds(const GlbFile &model, size_t meshIndex) {
+  PxBounds3 bounds = PxBounds3::empty();
+  for (const GlbPrimitive &prim : model.GetMeshes()[meshIndex].primitives) {
+    StridedView<PxVec3> positions =
+        model.View<PxVec3>(prim.Attribute("POSITION"));
+    for (size_t i = 0; i < positions.Count(); i++)
+      bounds.include(positions[i]);
+  }
+  return bounds;
+}
+
+// Baked proxy set (BakeFieldCollision): source bounds, then one record per
+// shape, each a uint32 kind followed by its fields. Hull records carry the
+// cooked stream, padded to 4 bytes.
+enum BakedShape : uint32_t { kBakedPlane = 0, kBakedBox = 1, kBakedHull = 2 };
+
+template <typename T>
+static void AppendPod(std::vector<uint8_t> &out, const T &value) {
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+namespace {
+
+// Attaches proxy shapes to one static actor, optionally recording them
+struct ProxyBuilder {
+  PhysicsWorld &world;
+  PxRigidStatic *body;
+  FieldCollisionStats &stats;
+  CollisionCache &cache;
+  std::vector<uint8_t> *baked = nullptr;
+  bool cacheDirty = false;
+
+  void AddPlane(float height) {
+    if (baked) {
+      AppendPod(*baked, kBakedPlane);
+      AppendPod(*baked, height);
+    }
+    PxShape *shape = world.GetPhysics()->createShape(
+        PxPlaneGeometry(), *world.GetDefaultMaterial());
+    shape->setLocalPose(
+        PxTransformFromPlaneEquation(PxPlane(0.0f, 1.0f, 0.0f, -height)));
+    body->attachShape(*shape);
+    shape->release();
+    stats.planes++;
+  }
+
+  void AddBox(PxVec3 center, PxVec3 halfExtents, float yawDegrees = 0.0f) {
+    halfExtents = halfExtents.maximum(PxVec3(kMinBoxHalfExtent));
+    if (baked) {
+      AppendPod(*baked, kBakedBox);
+      AppendPod(*baked, center);
+      AppendPod(*baked, halfExtents);
+      AppendPod(*baked, yawDegrees);
+    }
+    PxShape *shape = world.GetPhysics()->createShape(
+        PxBoxGeometry(halfExtents), *world.GetDefaultMaterial());
+    PxQuat yaw(PxPi * yawDegrees / 180.0f, PxVec3(0.0f, 1.0f, 0.0f));
+    shape->setLocalPose(PxTransform(center, yaw));
+    body->attachShape(*shape);
+    shape->release();
+    stats.boxes++;
+  }
+
+  void AddBounds(const PxBounds3 &bounds) {
+    AddBox(bounds.getCenter(), bounds.getExtents());
+  }
+
+  // Hulls are queued and decomposed together so they can run in parallel
+  void AddHull(size_t meshIndex) { hullMeshes.push_back(meshIndex); }
+
+  void BuildHulls(const GlbFile &model,
+                  const DecompositionParams &params) {
+    std::vector<DecompositionJob> jobs(hullMeshes.size());
+    for (size_t i = 0; i < hullMeshes.size(); i++) {
+      jobs[i].key = "mesh/" + std::to_string(hullMeshes[i]);
+      for (const GlbPrimitive &prim :
+           model.GetMeshes()[hullMeshes[i]].primitives) {
+        AssetLoader::ExtractMeshData(model, prim, jobs[i].points,
+                                     jobs[i].indices, PxVec3(1.0f));
+      }
+    }
+
+    int cooked = CookDecompositions(world.GetPhysics(), jobs, params, &cache);
+    stats.decomposedMeshes += cooked;
+    cacheDirty = cacheDirty || cooked > 0;
+
+    for (const DecompositionJob &job : jobs) {
+      for (const std::vector<uint8_t> &stream : job.streams)
+        AddCookedHull(stream.data(), stream.size());
+    }
+    hullMeshes.clear();
+  }
+
+  void AddCookedHull(const uint8_t *stream, size_t size) {
+    PxConvexMesh *convex =
+        AssetLoader::CreateConvexMesh(world.GetPhysics(), stream, size);
+    if (!convex)
+      return;
+    if (baked) {
+      AppendPod(*baked, kBakedHull);
+      AppendPod(*baked, static_cast<uint32_t>(size));
+      baked->insert(baked->end(), stream, stream + size);
+      baked->resize((baked->size() + 3) & ~size_t(3), 0);
+    }
+    PxShape *shape = world.GetPhysics()->createShape(
+        PxConvexMeshGeometry(convex), *world.GetDefaultMaterial());
+    body->attachShape(*shape);
+    shape->release();
+    convex->release();
+    stats.hulls++;
+  }
+
+  std::vector<size_t> hullMeshes;
+};
+
+} // namespace
+
+// Authored proxies, one per line:
+//   plane <y>
+//   box <cx> <cy> <cz> <hx> <hy> <hz> [yawDegrees]
+//   hull <meshIndex>
+// Blank lines and lines starting with '#' are ignored.
+static bool BuildAuthoredProxies(ProxyBuilder &builder,
+                                 const GlbFile &model,
+                                 const std::string &proxyPath) {
+  std::ifstream in(proxyPath);
+  if (!in)
+    return false;
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(in, line)) {
+    lineNumber++;
+    std::istringstream tokens(line);
+    std::string kind;
+    if (!(tokens >> kind) || kind[0] == '#')
+      continue;
+
+    bool ok = false;
+    if (kind == "plane") {
+      float y;
+      if ((ok = static_cast<bool>(tokens >> y)))
+        builder.AddPlane(y);
+    } else if (kind == "box") {
+      PxVec3 c, h;
+      float yaw = 0.0f;
+      if ((ok = static_cast<bool>(tokens >> c.x >> c.y >> c.z >> h.x >> h.y >>
+                                  h.z))) {
+        tokens >> yaw;
+        builder.AddBox(c, h, yaw);
+      }
+    } else if (kind == "hull") {
+      size_t mesh;
+      ok = (tokens >> mesh) && mesh < model.GetMeshes().size();
+      if (ok)
+        builder.AddHull(mesh);
+    }
+
+    if (!ok) {
+      std::cerr << "[FieldCollision] " << proxyPath << ":" << lineNumber
+                << ": cannot parse '" << line << "'" << std::endl;
+    }
+  }
+  builder.stats.authored = true;
+  return true;
+}
+
+static void BuildHeuristicProxies(ProxyBuilder &builder,
+                                  const GlbFile &model) {
+  FieldCollisionStats &stats = builder.stats;
+  std::vector<PxBounds3> meshBounds(model.GetMeshes().size());
+  for (size_t m = 0; m < model.GetMeshes().size(); m++)
+    meshBounds[m] = MeshBounds(model, m);
+
+  const PxBounds3 &field = stats.sourceBounds;
+  const PxVec3 fieldSize = field.getDimensions();
+
+  // Floor: the top of the thin, wide meshes (tiles)
+  bool haveFloor = false;
+  float floorY = field.minimum.y;
+  std::vector<bool> handled(model.GetMeshes().size(), false);
+  for (size_t m = 0; m < meshBounds.size(); m++) {
+    if (meshBounds[m].isEmpty())
+      continue;
+    PxVec3 size = meshBounds[m].getDimensions();
+    if (size.y < kFloorMaxThickness &&
+        size.x >= kFloorMinCoverage * fieldSize.x &&
+        size.z >= kFloorMinCoverage * fieldSize.z) {
+      floorY = haveFloor ? PxMax(floorY, meshBounds[m].maximum.y)
+                         : meshBounds[m].maximum.y;
+      haveFloor = true;
+      handled[m] = true;
+    }
+  }
+  builder.AddPlane(floorY);
+
+  // Perimeter: everything inside the edge band, merged into one box per side
+  PxBounds3 sides[4] = {PxBounds3::empty(), PxBounds3::empty(),
+                        PxBounds3::empty(), PxBounds3::empty()};
+  for (size_t m = 0; m < meshBounds.size(); m++) {
+    const PxBounds3 &b = meshBounds[m];
+    if (handled[m] || b.isEmpty())
+      continue;
+
+    if (b.getDimensions().magnitude() < kDecorativeDiagonal) {
+      stats.skippedMeshes++;
+      handled[m] = true;
+      continue;
+    }
+
+    int side = -1;
+    if (b.maximum.x <= field.minimum.x + kPerimeterBand)
+      side = 0;
+    else if (b.minimum.x >= field.maximum.x - kPerimeterBand)
+      side = 1;
+    else if (b.maximum.z <= field.minimum.z + kPerimeterBand)
+      side = 2;
+    else if (b.minimum.z >= field.maximum.z - kPerimeterBand)
+      side = 3;
+    if (side >= 0) {
+      sides[side].include(b);
+      handled[m] = true;
+    }
+  }
+  for (PxBounds3 &side : sides) {
+    if (side.isEmpty())
+      continue;
+    side.minimum.y = floorY;
+    builder.AddBounds(side);
+  }
+
+  // Goals, barriers and anything else robots can touch. They are concave
+  // (tubes, rings), so each is decomposed into several hulls.
+  for (size_t m = 0; m < meshBounds.size(); m++) {
+    if (!handled[m] && !meshBounds[m].isEmpty())
+      builder.AddHull(m);
+  }
+}
+
+static void BuildRegulationProxies(ProxyBuilder &builder) {
+  const float h = kFieldHalfExtent;
+  const float t = kWallThickness;
+  builder.AddPlane(0.0f);
+  builder.AddBox(PxVec3(-h - 0.5f * t, 0.5f * kWallHeight, 0.0f),
+                 PxVec3(0.5f * t, 0.5f * kWallHeight, h + t));
+  builder.AddBox(PxVec3(h + 0.5f * t, 0.5f * kWallHeight, 0.0f),
+                 PxVec3(0.5f * t, 0.5f * kWallHeight, h + t));
+  builder.AddBox(PxVec3(0.0f, 0.5f * kWallHeight, -h - 0.5f * t),
+                 PxVec3(h, 0.5f * kWallHeight, 0.5f * t));
+  builder.AddBox(PxVec3(0.0f, 0.5f * kWallHeight, h + 0.5f * t),
+                 PxVec3(h, 0.5f * kWallHeight, 0.5f * t));
+}
+
+// Builds the ePROXIES actor (not yet in a scene), recording it into `baked`
+// when given
+static PxRigidStatic *BuildProxyBody(PhysicsWorld &world, const GlbFile *model,
+                                     const std::string &glbPath,
+                                     FieldCollisionStats &stats,
+                                     const DecompositionParams &decomposition,
+                                     std::vector<uint8_t> *baked) {
+  CollisionCache cache;
+  std::string cachePath = glbPath + ".collision";
+  uint64_t sourceHash = model ? CollisionCache::HashFile(glbPath) : 0;
+  if (model)
+    cache.Load(cachePath, sourceHash);
+
+  PxRigidStatic *body =
+      world.GetPhysics()->createRigidStatic(PxTransform(PxIdentity));
+  ProxyBuilder builder{world, body, stats, cache, baked};
+
+  if (model) {
+    for (size_t m = 0; m < model->GetMeshes().size(); m++)
+      stats.sourceBounds.include(MeshBounds(*model, m));
+  } else {
+    stats.sourceBounds =
+        PxBounds3(PxVec3(-kFieldHalfExtent, 0.0f, -kFieldHalfExtent),
+                  PxVec3(kFieldHalfExtent, kWallHeight, kFieldHalfExtent));
+  }
+  if (baked)
+    AppendPod(*baked, stats.sourceBounds);
+
+  if (model) {
+    if (!BuildAuthoredProxies(builder, *model, glbPath + ".proxies"))
+      BuildHeuristicProxies(builder, *model);
+    builder.BuildHulls(*model, decomposition);
+  } else {
+    BuildRegulationProxies(builder);
+  }
+
+  if (builder.cacheDirty && !cache.Save(cachePath, sourceHash)) {
+    std::cerr << "[FieldCollision] Could not write " << cachePath
+              << std::endl;
+  }
+  return body;
+}
+
+// Filters, logs and reports a finished field actor
+static void FinishFieldCollision(PxRigidStatic *body,
+                                 FieldCollisionStats &stats,
+                                 Clock::time_point start,
+                                 FieldCollisionStats *outStats) {
+  SetActorFilter(body, FilterGroup::eGROUND,
+                 FilterGroup::eCHASSIS | FilterGroup::eWHEEL |
+                     FilterGroup::eOBSTACLE | FilterGroup::eBLOCK);
+
+  stats.buildMs =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  if (stats.triangleMeshes > 0) {
+    std::cout << "[FieldCollision] Full mesh: " << stats.triangleMeshes
+              << " triangle meshes";
+  } else {
+    std::cout << "[FieldCollision] "
+              << (stats.baked ? "Baked" : stats.authored ? "Authored" : "Auto")
+              << " proxies: " << stats.planes << " plane, " << stats.boxes
+              << " boxes, " << stats.hulls << " hulls ("
+              << stats.decomposedMeshes << " meshes decomposed), "
+              << stats.skippedMeshes << " meshes skipped";
+  }
+  std::cout << " in " << stats.buildMs << " ms" << std::endl;
+
+  if (outStats)
+    *outStats = stats;
+}
+
+PxRigidStatic *CreateFieldCollision(PhysicsWorld &world,
+                                    const GlbFile *model,
+                                    FieldCollisionMode mode,
+                                    const std::string &glbPath,
+                                    FieldCollisionStats *outStats,
+                                    const DecompositionParams &decomposition) {
+  auto start = Clock::now();
+  FieldCollisionStats stats;
+  if (model && model->GetMeshes().empty())
+    model = nullptr;
+
+  PxRigidStatic *body = nullptr;
+  if (model && mode == FieldCollisionMode::eFULL_MESH) {
+    body = AssetLoader::CreateStaticBody(
+        world.GetPhysics(), world.GetScene(), *model,
+        world.GetDefaultMaterial(), PxTransform(PxIdentity), PxVec3(1.0f));
+    if (body) {
+      stats.triangleMeshes = static_cast<int>(body->getNbShapes());
+      stats.sourceBounds = body->getWorldBounds();
+    }
+  }
+
+  if (!body) {
+    body = BuildProxyBody(world, model, glbPath, stats, decomposition,
+                          nullptr);
+    world.GetScene()->addActor(*body);
+  }
+
+  FinishFieldCollision(body, stats, start, outStats);
+  return body;
+}
+
+bool BakeFieldCollision(PhysicsWorld &world, const GlbFile *model,
+                        const std::string &glbPath, std::vector<uint8_t> &out,
+                        FieldCollisionStats *stats,
+                        const DecompositionParams &decomposition) {
+  FieldCollisionStats built;
+  if (model && model->GetMeshes().empty())
+    model = nullptr;
+
+  out.clear();
+  PxRigidStatic *body =
+      BuildProxyBody(world, model, glbPath, built, decomposition, &out);
+  body->release();
+  if (stats)
+    *stats = built;
+  return built.planes + built.boxes + built.hulls > 0;
+}
+
+PxRigidStatic *CreateBakedFieldCollision(PhysicsWorld &world,
+                                         const uint8_t *data, size_t size,
+                                         FieldCollisionStats *outStats) {
+  auto start = Clock::now();
+  FieldCollisionStats stats;
+  stats.baked = true;
+
+  size_t offset = 0;
+  auto read = [&](void *value, size_t bytes) {
+    if (offset + bytes > size)
+      return false;
+    memcpy(value, data + offset, bytes);
+    offset += bytes;
+    return true;
+  };
+  if (!read(&stats.sourceBounds, sizeof(PxBounds3)))
+    return nullptr;
+
+  CollisionCache unused;
+  PxRigidStatic *body =
+      world.GetPhysics()->createRigidStatic(PxTransform(PxIdentity));
+  ProxyBuilder builder{world, body, stats, unused};
+
+  while (offset < size) {
+    uint32_t kind = 0;
+    bool ok = read(&kind, sizeof(kind));
+    if (ok && kind == kBakedPlane) {
+      float y;
+      if ((ok = read(&y, sizeof(y))))
+        builder.AddPlane(y);
+    } else if (ok && kind == kBakedBox) {
+      PxVec3 c, h;
+      float yaw;
+      if ((ok = read(&c, sizeof(c)) && read(&h, sizeof(h)) &&
+                read(&yaw, sizeof(yaw))))
+        builder.AddBox(c, h, yaw);
+    } else if (ok && kind == kBakedHull) {
+      uint32_t length = 0;
+      ok = read(&length, sizeof(length)) && offset + length <= size;
+      if (ok) {
+        builder.AddCookedHull(data + offset, length);
+        offset = (offset + length + 3) & ~size_t(3);
+      }
+    } else {
+      ok = false;
+    }
+
+    if (!ok) {
+      std::cerr << "[FieldCollision] Corrupt baked collision at byte "
+                << offset << std::endl;
+      body->release();
+      return nullptr;
+    }
+  }
+
+  world.GetScene()->addActor(*body);
+  FinishFieldCollision(body, stats, start, outStats);
+  return body;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ConvexDecomposition.h"
+#include "GlbFile.h"
+#include "PxPhysicsAPI.h"
+#include <string>
+#include <vector>
+
+using namespace physx;
+
+class PhysicsWorld;
+
+// How the static field is represented to PhysX
+enum class FieldCollisionMode {
+  eFULL_MESH, // Every triangle of field.glb (AssetLoader::CreateStaticBody)
+  ePROXIES    // Plane floor, box walls, convex hulls for goals/barriers
+};
+
+bool ParseFieldCollisionMode(const std::string &name, FieldCollisionMode &out);
+const char *FieldCollisionModeName(FieldCollisionMode mode);
+
+struct FieldCollisionStats {
+  int planes = 0;
+  int boxes = 0;
+  int hulls = 0;
+  int triangleMeshes = 0;
+  int skippedMeshes = 0;    // Decorative meshes left without collision
+  int decomposedMeshes = 0; // Meshes decomposed this run (cache misses)
+  bool authored = false;    // Proxies came from a proxy file, not heuristics
+  bool baked = false;       // Loaded from an asset bundle
+  double buildMs = 0.0;
+
+  // Bounds of the source geometry. The actor's own bounds are infinite once
+  // it holds a plane, so broadphase regions should be sized from this.
+  PxBounds3 sourceBounds = PxBounds3::empty();
+};
+
+// Builds the static field actor, adds it to the scene with the ground
+// filter and returns it. `model` may be null (or empty), in which case a
+// plane and regulation-size walls are used regardless of mode.
+//
+// In ePROXIES mode an authored proxy file next to the GLB
+// (`<glb>.proxies`, see ARCHITECTURE.md) takes precedence over the
+// heuristics. Goal and barrier meshes are convex-decomposed and the cooked
+// hulls cached in `<glb>.collision`.
+PxRigidStatic *CreateFieldCollision(
+    PhysicsWorld &world, const GlbFile *model, FieldCollisionMode mode,
+    const std::string &glbPath, FieldCollisionStats *stats = nullptr,
+    const DecompositionParams &decomposition = DecompositionParams());
+
+// Serializes what ePROXIES mode builds for `model` (source bounds, plane,
+// boxes and cooked hulls) for an asset bundle. Goes through the same path
+// as CreateFieldCollision, so it uses and refreshes `<glb>.collision`.
+bool BakeFieldCollision(
+    PhysicsWorld &world, const GlbFile *model, const std::string &glbPath,
+    std::vector<uint8_t> &out, FieldCollisionStats *stats = nullptr,
+    const DecompositionParams &decomposition = DecompositionParams());
+
+// Recreates a field baked by BakeFieldCollision, without the GLB. Returns
+// null if the data is malformed.
+PxRigidStatic *CreateBakedFieldCollision(PhysicsWorld &world,
+                                         const uint8_t *data, size_t size,
+                                         FieldCollisionStats *stats = nullptr);
@@ -0,0 +1,60 @@
+#include "GameBlock.h"
+#include "PhysicsWorld.h"
+#include "SimulationFilter.h"
+#include <iostream>
+
+static void SetBlockFilter(PxRigidDynamic *body) {
+  SetActorFilter(body, FilterGroup::eBLOCK,
+                 FilterGroup::eGROUND | FilterGroup::eCHASSIS |
+                     FilterGroup::eWHEEL | FilterGroup::eOBSTACLE |
+                     FilterGroup::eBLOCK);
+}
+
+GameBlock SpawnBlock(PhysicsWorld &world, BlockColor color, PxVec3 position,
+                     bool verbose) {
+  PxPhysics *physics = world.GetPhysics();
+  PxMaterial *material = world.GetDefaultMaterial();
+
+  GameBlock block;
+  block.color = color;
+  block.held = false;
+
+  // Block is a sphere ~14cm diameter (Big enought to actually collide)
+  float radius = 0.07f;
+  block.body = physics->createRigidDynamic(PxTransform(position));
+  block.prevPose = PxTransform(position);
+  PxShape *shape = physics->createShape(PxSphereGeometry(radius), *material);
+  block.body->attachShape(*shape);
+  shape->release();
+  PxRigidBodyExt::updateMassAndInertia(*block.body, 1.0f);
+
+  // Friction: blocks slow down on the field
+  block.body->setLinearDamping(2.0f);
+  block.body->setAngularDamping(1.0f);
+
+  // Blocks collide with ground, chassis, wheels, obstacles, other blocks
+  SetBlockFilter(block.body);
+
+  world.GetScene()->addActor(*block.body);
+  world.RegisterBody(block.body, BodyClass::eBLOCK);
+
+  if (verbose) {
+    std::cout << "[Block] Spawned "
+              << (color == BlockColor::RED ? "RED" : "BLUE") << " block at ("
+              << position.x << ", " << position.y << ", " << position.z << ")"
+              << std::endl;
+  }
+  return block;
+}
+
+void ResetBlock(GameBlock &block, PxVec3 position) {
+  if (!block.body)
+    return;
+  block.body->setGlobalPose(PxTransform(position));
+  block.body->setLinearVelocity(PxVec3(0));
+  block.body->setAngularVelocity(PxVec3(0));
+  block.prevPose = PxTransform(position);
+  block.held = false;
+  SetBlockFilter(block.body); // An intake clears it
+  block.body->wakeUp();
+}
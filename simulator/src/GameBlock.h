@@ -4,10 +4,22 @@
 
 using namespace physx;
 
+class PhysicsWorld;
+
 enum class BlockColor { RED, BLUE };
 
 struct GameBlock {
   PxRigidDynamic *body = nullptr;
   BlockColor color = BlockColor::RED;
   bool held = false;
+  PxTransform prevPose = PxTransform(PxIdentity); // Before the last step
 };
+
+// Create a block body, add it to the scene, set its collision filter and
+// register it with the world's block sleep profile
+GameBlock SpawnBlock(PhysicsWorld &world, BlockColor color, PxVec3 position,
+                     bool verbose = true);
+
+// Moves a free (not held) block to `position` at rest with its collision
+// filter restored, for reusing bodies between runs
+void ResetBlock(GameBlock &block, PxVec3 position);
@@ -0,0 +1,281 @@
+#include "GlbFile.h"
+
+#include <cstring>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+// --- MappedFile ---
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::Open(const std::string &path) {
+  Close();
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  void *view =
+      mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (!view) {
+    if (mapping)
+      CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+  mFile = file;
+  mMapping = mapping;
+  mData = static_cast<const uint8_t *>(view);
+  mSize = static_cast<size_t>(size.QuadPart);
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                    MAP_PRIVATE, fd, 0);
+  if (view == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+  mFd = fd;
+  mData = static_cast<const uint8_t *>(view);
+  mSize = static_cast<size_t>(st.st_size);
+#endif
+  return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+  if (mData)
+    UnmapViewOfFile(mData);
+  if (mMapping)
+    CloseHandle(mMapping);
+  if (mFile)
+    CloseHandle(mFile);
+  mFile = nullptr;
+  mMapping = nullptr;
+#else
+  if (mData)
+    munmap(const_cast<uint8_t *>(mData), mSize);
+  if (mFd >= 0)
+    close(mFd);
+  mFd = -1;
+#endif
+  mData = nullptr;
+  mSize = 0;
+}
+
+// --- GlbFile ---
+
+static const uint32_t kGlbMagic = 0x46546C67; // "glTF"
+static const uint32_t kChunkJson = 0x4E4F534A;
+static const uint32_t kChunkBin = 0x004E4942;
+
+static uint32_t ReadU32(const uint8_t *p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static int ComponentCount(const std::string &type) {
+  if (type == "SCALAR")
+    return 1;
+  if (type == "VEC2")
+    return 2;
+  if (type == "VEC3")
+    return 3;
+  if (type == "VEC4" || type == "MAT2")
+    return 4;
+  if (type == "MAT3")
+    return 9;
+  if (type == "MAT4")
+    return 16;
+  return 0;
+}
+
+static size_t ComponentSize(int componentType) {
+  switch (componentType) {
+  case GLB_COMPONENT_BYTE:
+  case GLB_COMPONENT_UNSIGNED_BYTE:
+    return 1;
+  case GLB_COMPONENT_SHORT:
+  case GLB_COMPONENT_UNSIGNED_SHORT:
+    return 2;
+  case GLB_COMPONENT_UNSIGNED_INT:
+  case GLB_COMPONENT_FLOAT:
+    return 4;
+  default:
+    return 0;
+  }
+}
+
+const GlbAccessor *GlbFile::GetAccessor(int index) const {
+  if (index < 0 || index >= static_cast<int>(mAccessors.size()))
+    return nullptr;
+  return &mAccessors[index];
+}
+
+bool GlbFile::Open(const std::string &path, std::string *error) {
+  auto fail = [&](const std::string &message) {
+    if (error)
+      *error = message;
+    mFile.Close();
+    mMeshes.clear();
+    mMaterials.clear();
+    mAccessors.clear();
+    return false;
+  };
+
+  mPath = path;
+  mMeshes.clear();
+  mMaterials.clear();
+  mAccessors.clear();
+  if (!mFile.Open(path))
+    return fail("cannot open " + path);
+
+  // Header (12 bytes) then chunks of {length, type, data}
+  const uint8_t *data = mFile.Data();
+  const size_t size = mFile.Size();
+  if (size < 20 || ReadU32(data) != kGlbMagic || ReadU32(data + 4) != 2)
+    return fail(path + " is not a glTF 2.0 binary");
+
+  const uint8_t *jsonChunk = nullptr, *binChunk = nullptr;
+  size_t jsonLength = 0, binLength = 0;
+  size_t offset = 12;
+  while (offset + 8 <= size) {
+    uint32_t length = ReadU32(data + offset);
+    uint32_t type = ReadU32(data + offset + 4);
+    if (offset + 8 + length > size)
+      return fail(path + ": truncated chunk");
+    if (type == kChunkJson && !jsonChunk) {
+      jsonChunk = data + offset + 8;
+      jsonLength = length;
+    } else if (type == kChunkBin && !binChunk) {
+      binChunk = data + offset + 8;
+      binLength = length;
+    }
+    offset += 8 + length;
+  }
+  if (!jsonChunk)
+    return fail(path + ": missing JSON chunk");
+
+  json doc = json::parse(jsonChunk, jsonChunk + jsonLength, nullptr, false);
+  if (doc.is_discarded() || !doc.is_object())
+    return fail(path + ": invalid JSON chunk");
+
+  // Fields of the wrong type throw; treated like any other bad file
+  try {
+    // Only buffer 0, the embedded BIN chunk, is supported
+    const json &buffers = doc.value("buffers", json::array());
+    for (size_t i = 0; i < buffers.size(); i++) {
+      if (i > 0 || buffers[i].contains("uri"))
+        return fail(path + ": external buffers are not supported");
+    }
+
+    struct ViewRange {
+      size_t offset, length, stride;
+    };
+    std::vector<ViewRange> views;
+    for (const json &view : doc.value("bufferViews", json::array())) {
+      ViewRange range;
+      range.offset = view.value("byteOffset", size_t(0));
+      range.length = view.value("byteLength", size_t(0));
+      range.stride = view.value("byteStride", size_t(0));
+      if (view.value("buffer", 0) != 0 || !binChunk ||
+          range.offset > binLength || range.length > binLength - range.offset)
+        return fail(path + ": buffer view outside the BIN chunk");
+      views.push_back(range);
+    }
+
+    for (const json &acc : doc.value("accessors", json::array())) {
+      GlbAccessor accessor;
+      accessor.count = acc.value("count", size_t(0));
+      accessor.componentType = acc.value("componentType", 0);
+      accessor.components = ComponentCount(acc.value("type", std::string()));
+      accessor.elementSize =
+          ComponentSize(accessor.componentType) * accessor.components;
+
+      int viewIndex = acc.value("bufferView", -1);
+      if (acc.contains("sparse")) {
+        std::cerr << "[GlbFile] " << path << ": sparse accessors unsupported"
+                  << std::endl;
+      } else if (viewIndex >= 0 && viewIndex < static_cast<int>(views.size()) &&
+                 accessor.elementSize > 0) {
+        const ViewRange &view = views[viewIndex];
+        size_t byteOffset = acc.value("byteOffset", size_t(0));
+        accessor.stride = view.stride ? view.stride : accessor.elementSize;
+        // The last element needs elementSize bytes, the others a stride
+        // each; compared by division so a hostile count cannot wrap
+        if (accessor.count > 0 &&
+            (byteOffset > view.length ||
+             accessor.elementSize > view.length - byteOffset ||
+             accessor.count - 1 > (view.length - byteOffset -
+                                   accessor.elementSize) /
+                                      accessor.stride))
+          return fail(path + ": accessor overruns its buffer view");
+        accessor.data = binChunk + view.offset + byteOffset;
+      }
+      mAccessors.push_back(accessor);
+    }
+
+    for (const json &mat : doc.value("materials", json::array())) {
+      GlbMaterial material;
+      const json &pbr = mat.value("pbrMetallicRoughness", json::object());
+      const json &factor = pbr.value("baseColorFactor", json::array());
+      for (size_t i = 0; i < factor.size() && i < 4; i++)
+        material.baseColorFactor[i] = factor[i].get<float>();
+      mMaterials.push_back(material);
+    }
+
+    for (const json &m : doc.value("meshes", json::array())) {
+      GlbMesh mesh;
+      mesh.name = m.value("name", std::string());
+      for (const json &p : m.value("primitives", json::array())) {
+        // Triangles only (mode 4, the default)
+        if (p.value("mode", 4) != 4)
+          continue;
+        GlbPrimitive prim;
+        prim.indices = p.value("indices", -1);
+        prim.material = p.value("material", -1);
+        const json attributes = p.value("attributes", json::object());
+        for (const auto &attr : attributes.items())
+          prim.attributes[attr.key()] = attr.value().get<int>();
+        mesh.primitives.push_back(std::move(prim));
+      }
+      mMeshes.push_back(std::move(mesh));
+    }
+  } catch (const json::exception &e) {
+    return fail(path + ": " + e.what());
+  }
+
+  if (error)
+    error->clear();
+  return true;
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool Open(const std::string &path);
+  void Close();
+
+  const uint8_t *Data() const { return mData; }
+  size_t Size() const { return mSize; }
+  bool IsOpen() const { return mData != nullptr; }
+
+private:
+  const uint8_t *mData = nullptr;
+  size_t mSize = 0;
+#ifdef _WIN32
+  void *mFile = nullptr;
+  void *mMapping = nullptr;
+#else
+  int mFd = -1;
+#endif
+};
+
+// Elements of type T spaced `stride` bytes apart, read in place
+template <typename T> class StridedView {
+public:
+  StridedView() = default;
+  StridedView(const uint8_t *data, size_t count, size_t stride)
+      : mData(data), mCount(count), mStride(stride) {}
+
+  const T &operator[](size_t i) const {
+    return *reinterpret_cast<const T *>(mData + i * mStride);
+  }
+  size_t Count() const { return mCount; }
+  size_t Stride() const { return mStride; }
+  const uint8_t *Data() const { return mData; }
+  bool Empty() const { return mCount == 0; }
+
+private:
+  const uint8_t *mData = nullptr;
+  size_t mCount = 0;
+  size_t mStride = 0;
+};
+
+// glTF component types
+enum GlbComponentType {
+  GLB_COMPONENT_BYTE = 5120,
+  GLB_COMPONENT_UNSIGNED_BYTE = 5121,
+  GLB_COMPONENT_SHORT = 5122,
+  GLB_COMPONENT_UNSIGNED_SHORT = 5123,
+  GLB_COMPONENT_UNSIGNED_INT = 5125,
+  GLB_COMPONENT_FLOAT = 5126
+};
+
+// An accessor resolved to a pointer into the mapped BIN chunk
+struct GlbAccessor {
+  const uint8_t *data = nullptr; // First element (null if unresolved)
+  size_t count = 0;
+  size_t stride = 0;      // Bytes between elements
+  size_t elementSize = 0; // Bytes in one element
+  int componentType = 0;
+  int components = 1; // 1 = SCALAR, 3 = VEC3, ...
+};
+
+// Index accessor widened to uint32 on read, whatever its component type
+class GlbIndexView {
+public:
+  GlbIndexView() = default;
+  explicit GlbIndexView(const GlbAccessor &accessor) : mAccessor(&accessor) {}
+
+  uint32_t operator[](size_t i) const {
+    const uint8_t *p = mAccessor->data + i * mAccessor->stride;
+    switch (mAccessor->componentType) {
+    case GLB_COMPONENT_UNSIGNED_BYTE:
+      return *p;
+    case GLB_COMPONENT_UNSIGNED_SHORT:
+      return *reinterpret_cast<const uint16_t *>(p);
+    default:
+      return *reinterpret_cast<const uint32_t *>(p);
+    }
+  }
+  size_t Count() const { return mAccessor ? mAccessor->count : 0; }
+  const GlbAccessor *Accessor() const { return mAccessor; }
+
+private:
+  const GlbAccessor *mAccessor = nullptr;
+};
+
+struct GlbPrimitive {
+  std::map<std::string, int> attributes; // Semantic -> accessor index
+  int indices = -1;
+  int material = -1;
+
+  int Attribute(const char *semantic) const {
+    auto it = attributes.find(semantic);
+    return it != attributes.end() ? it->second : -1;
+  }
+};
+
+struct GlbMesh {
+  std::string name;
+  std::vector<GlbPrimitive> primitives;
+};
+
+struct GlbMaterial {
+  float baseColorFactor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+};
+
+// Binary glTF (.glb) reader. The file is memory-mapped and accessors are
+// exposed as views straight over its BIN chunk, so vertex data is never
+// copied before the caller's own destination (staging buffer, cooking
+// descriptor). Views stay valid while the GlbFile is alive.
+//
+// Only the single embedded BIN buffer is supported; node transforms are
+// ignored, as they always have been for the simulator's assets.
+class GlbFile {
+public:
+  bool Open(const std::string &path, std::string *error = nullptr);
+  bool IsOpen() const { return mFile.IsOpen(); }
+  const std::string &GetPath() const { return mPath; }
+
+  const std::vector<GlbMesh> &GetMeshes() const { return mMeshes; }
+  const std::vector<GlbMaterial> &GetMaterials() const { return mMaterials; }
+  const GlbAccessor *GetAccessor(int index) const;
+
+  // Typed view of an accessor; empty if it is missing or its elements are
+  // smaller than T. The caller is responsible for the component type.
+  template <typename T> StridedView<T> View(int accessorIndex) const {
+    const GlbAccessor *a = GetAccessor(accessorIndex);
+    if (!a || !a->data || a->elementSize < sizeof(T))
+      return StridedView<T>();
+    return StridedView<T>(a->data, a->count, a->stride);
+  }
+
+  GlbIndexView Indices(int accessorIndex) const {
+    const GlbAccessor *a = GetAccessor(accessorIndex);
+    return a && a->data ? GlbIndexView(*a) : GlbIndexView();
+  }
+
+private:
+  MappedFile mFile;
+  std::string mPath;
+  std::vector<GlbMesh> mMeshes;
+  std::vector<GlbMaterial> mMaterials;
+  std::vector<GlbAccessor> mAccessors;
+};
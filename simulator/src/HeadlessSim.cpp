@@ -0,0 +1,85 @@
+#include "HeadlessSim.h"
+#include "FieldCollision.h"
+
+PhysicsConfig HeadlessSim::MakePhysicsConfig() {
+  PhysicsConfig config;
+  config.enablePvd = false;
+  config.workerThreads = 0;
+  config.enhancedDeterminism = true;
+  config.trackAllocationNames = false;
+  return config;
+}
+
+HeadlessSim::HeadlessSim(PhysicsWorld &sdk, const RobotConfig &robot,
+                         PxVec3 start) {
+  mWorld.InitializeShared(sdk, MakePhysicsConfig());
+  FieldCollisionStats fieldStats;
+  CreateFieldCollision(mWorld, nullptr, FieldCollisionMode::ePROXIES, "",
+                       &fieldStats);
+  mWorld.ConfigureBroadPhaseRegions(fieldStats.sourceBounds);
+  mRobot.Initialize(mWorld, start, robot);
+}
+
+HeadlessSim::~HeadlessSim() {
+  PxMaterial *wheelMaterial = mRobot.GetWheelMaterial();
+  mWorld.Cleanup();
+  if (wheelMaterial)
+    wheelMaterial->release();
+}
+
+void HeadlessSim::Reset(const RobotConfig &robot, const PxTransform &start,
+                        const std::vector<PxVec3> &blocks) {
+  mRobot.Reset(start, robot);
+
+  while (mBlocks.size() > blocks.size()) {
+    mWorld.UnregisterBody(mBlocks.back().body);
+    mBlocks.back().body->release();
+    mBlocks.pop_back();
+  }
+  size_t i = 0;
+  for (GameBlock &block : mBlocks)
+    ResetBlock(block, blocks[i++]);
+  for (; i < blocks.size(); i++)
+    AddBlock(i % 2 ? BlockColor::BLUE : BlockColor::RED, blocks[i]);
+  mSteps = 0;
+}
+
+void HeadlessSim::AddBlock(BlockColor color, PxVec3 position) {
+  mBlocks.push_back(SpawnBlock(mWorld, color, position, false));
+}
+
+bool HeadlessSim::IntakeNearest() {
+  if (mRobot.IsIntakeFull())
+    return false;
+
+  float bestDist = 999.0f;
+  GameBlock *bestBlock = nullptr;
+  PxVec3 frontPos = mRobot.GetFrontPosition();
+  for (GameBlock &block : mBlocks) {
+    if (block.held || !block.body)
+      continue;
+    float dist = (frontPos - block.body->getGlobalPose().p).magnitude();
+    if (dist < bestDist) {
+      bestDist = dist;
+      bestBlock = &block;
+    }
+  }
+  return bestBlock && mRobot.TryIntake(*bestBlock, mWorld.GetPhysics());
+}
+
+void HeadlessSim::Step() {
+  mRobot.Update(kStep);
+  mWorld.Update(kStep);
+  mSteps++;
+}
+
+float MeasureDriveDirection(PhysicsWorld &sdk) {
+  HeadlessSim sim(sdk, RobotConfig(), PxVec3(0.0f, 0.5f, 0.0f));
+  PxTransform start = sim.GetRobot().GetChassis()->getGlobalPose();
+  sim.GetRobot().SetDriveInput(1.0f, 1.0f);
+  for (int i = 0; i < 60; i++)
+    sim.Step();
+  PxVec3 moved = sim.GetRobot().GetChassis()->getGlobalPose().p - start.p;
+  return moved.dot(start.q.rotate(PxVec3(0.0f, 0.0f, 1.0f))) >= 0.0f ? 1.0f
+                                                                       : -1.0f;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "GameBlock.h"
+#include "PhysicsWorld.h"
+#include "Robot.h"
+
+#include <list>
+#include <vector>
+
+// Physics-only world for batch runs (parameter sweeps and the like): the
+// regulation field proxies (plane and perimeter walls, built without the
+// GLB or any cooking), one robot and its blocks, stepped at a fixed 60 Hz
+// on the calling thread. Every HeadlessSim is a scene on one shared PhysX
+// SDK, so one per thread can run concurrently.
+class HeadlessSim {
+public:
+  static constexpr float kStep = 1.0f / 60.0f;
+
+  // No PVD, no dispatcher threads (the step runs on the caller) and
+  // enhanced determinism, so a configuration always gives the same result
+  static PhysicsConfig MakePhysicsConfig();
+
+  HeadlessSim(PhysicsWorld &sdk, const RobotConfig &robot, PxVec3 start);
+  ~HeadlessSim();
+
+  HeadlessSim(const HeadlessSim &) = delete;
+  HeadlessSim &operator=(const HeadlessSim &) = delete;
+
+  // Starts a new run in the same scene: the robot is put back at rest at
+  // `start` with `robot` applied and the blocks are moved to `blocks`
+  // (bodies are reused, with any extra spawned or released). Much cheaper
+  // than building a new world, though PhysX keeps some cached contact
+  // state, so a run is not bit-identical to the same run in a fresh world.
+  void Reset(const RobotConfig &robot, const PxTransform &start,
+             const std::vector<PxVec3> &blocks);
+
+  void AddBlock(BlockColor color, PxVec3 position);
+  // Intakes the nearest free block if it is within the robot's range
+  bool IntakeNearest();
+  void Step();
+
+  Robot &GetRobot() { return mRobot; }
+  const std::list<GameBlock> &GetBlocks() const { return mBlocks; }
+  PhysicsWorld &GetWorld() { return mWorld; }
+  int GetStepCount() const { return mSteps; }
+  float GetTime() const { return mSteps * kStep; }
+
+private:
+  PhysicsWorld mWorld;
+  Robot mRobot;
+  std::list<GameBlock> mBlocks; // std::list for stable pointers
+  int mSteps = 0;
+};
+
+// +1 if driving both sides at +1 moves the chassis along its local +Z (its
+// front), -1 otherwise. Measured once with a default robot on `sdk`;
+// controllers scale their forward command by it.
+float MeasureDriveDirection(PhysicsWorld &sdk);
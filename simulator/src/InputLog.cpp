@@ -0,0 +1,92 @@
+#include "InputLog.h"
+
+#include <cstring>
+
+static const char kMagic[4] = {'V', 'X', 'I', 'N'};
+static const uint32_t kLogVersion = 1;
+
+template <typename T> static bool ReadPod(std::istream &in, T &value) {
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+template <typename T> static void WritePod(std::ostream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+bool InputLog::OpenWrite(const std::string &path, uint32_t stepHz,
+                         std::string *err) {
+  Close();
+  mOut.open(path, std::ios::binary | std::ios::trunc);
+  if (!mOut) {
+    if (err)
+      *err = "cannot create " + path;
+    return false;
+  }
+  mOut.write(kMagic, 4);
+  WritePod(mOut, kLogVersion);
+  WritePod(mOut, stepHz);
+  return true;
+}
+
+bool InputLog::OpenRead(const std::string &path, uint32_t stepHz,
+                        std::string *err) {
+  Close();
+  mIn.open(path, std::ios::binary);
+  if (!mIn) {
+    if (err)
+      *err = "cannot open " + path;
+    return false;
+  }
+
+  char magic[4];
+  uint32_t version = 0, fileHz = 0;
+  if (!mIn.read(magic, 4) || memcmp(magic, kMagic, 4) != 0 ||
+      !ReadPod(mIn, version) || version != kLogVersion ||
+      !ReadPod(mIn, fileHz)) {
+    if (err)
+      *err = path + " is not an input log";
+    Close();
+    return false;
+  }
+  if (fileHz != stepHz) {
+    if (err)
+      *err = path + " was recorded at " + std::to_string(fileHz) +
+             " Hz, physics runs at " + std::to_string(stepHz) + " Hz";
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void InputLog::Close() {
+  if (mOut.is_open())
+    mOut.close();
+  if (mIn.is_open())
+    mIn.close();
+  mSteps = 0;
+}
+
+void InputLog::Write(const ControllerState &state) {
+  if (!mOut.is_open())
+    return;
+  for (float axis : state.axes)
+    WritePod(mOut, axis);
+  WritePod(mOut, state.buttons);
+  mSteps++;
+}
+
+bool InputLog::Read(ControllerState &state) {
+  if (!mIn.is_open())
+    return false;
+  ControllerState next;
+  for (float &axis : next.axes) {
+    if (!ReadPod(mIn, axis))
+      return false;
+  }
+  if (!ReadPod(mIn, next.buttons))
+    return false;
+  state = next;
+  mSteps++;
+  return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Controller.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Binary log of the ControllerState fed to each physics step, for
+// recording a driving session and replaying it later. The header stores the
+// step rate; a log only replays at the rate it was recorded at, since the
+// same input at a different step rate is a different drive.
+class InputLog {
+public:
+  ~InputLog() { Close(); }
+
+  bool OpenWrite(const std::string &path, uint32_t stepHz,
+                 std::string *err = nullptr);
+  bool OpenRead(const std::string &path, uint32_t stepHz,
+                std::string *err = nullptr);
+  void Close();
+
+  void Write(const ControllerState &state);
+  // False once the log is exhausted (or was never opened for reading)
+  bool Read(ControllerState &state);
+
+  bool IsWriting() const { return mOut.is_open(); }
+  bool IsReading() const { return mIn.is_open(); }
+  uint64_t GetStepCount() const { return mSteps; }
+
+private:
+  std::ofstream mOut;
+  std::ifstream mIn;
+  uint64_t mSteps = 0; // Records written or read so far
+};
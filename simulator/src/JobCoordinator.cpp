@@ -0,0 +1,184 @@
+#include "JobCoordinator.h"
+
+#include "WorkerProcess.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// One worker process and the job it is running, shared with the watchdog
+struct WorkerSlot {
+  WorkerProcess process;
+  std::mutex mutex; // Guards the fields below and Kill against Wait
+  bool busy = false;
+  bool timedOut = false;
+  Clock::time_point jobStart;
+};
+
+} // namespace
+
+JobCoordinator::JobCoordinator(CoordinatorConfig config)
+    : mConfig(std::move(config)) {}
+
+size_t JobCoordinator::Run(const std::vector<std::string> &jobs,
+                           const ResultCallback &onResult,
+                           const FailureCallback &onFailure) {
+  if (jobs.empty())
+    return 0;
+  const int workers = std::max(
+      1, std::min<int>(mConfig.workers, static_cast<int>(jobs.size())));
+
+  std::mutex mutex; // Guards the queue and counters
+  std::condition_variable changed;
+  std::deque<size_t> queue;
+  for (size_t i = 0; i < jobs.size(); i++)
+    queue.push_back(i);
+  std::vector<int> attempts(jobs.size(), 0);
+  size_t remaining = jobs.size(), failed = 0;
+  int liveWorkers = workers;
+  std::mutex callbackMutex;
+  mRestarts = 0;
+
+  auto fail = [&](size_t job, const std::string &reason) {
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    onFailure(job, reason);
+  };
+
+  std::vector<std::unique_ptr<WorkerSlot>> slots;
+  for (int w = 0; w < workers; w++)
+    slots.push_back(std::make_unique<WorkerSlot>());
+  std::atomic<int> running{workers};
+
+  auto workerLoop = [&](int index) {
+    WorkerSlot &slot = *slots[index];
+    std::string line;
+    while (true) {
+      size_t job;
+      {
+        // Wait while other workers still hold jobs that may come back
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return !queue.empty() || remaining == 0; });
+        if (queue.empty())
+          break;
+        job = queue.front();
+        queue.pop_front();
+      }
+
+      std::string err;
+      if (!slot.process.IsRunning() &&
+          !slot.process.Start(mConfig.workerCommand, &err)) {
+        std::cerr << "[Coordinator] Worker " << index << ": " << err
+                  << std::endl;
+        std::deque<size_t> orphaned;
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          queue.push_front(job);
+          // The last worker standing fails whatever is left
+          if (--liveWorkers == 0) {
+            orphaned.swap(queue);
+            remaining -= orphaned.size();
+            failed += orphaned.size();
+          }
+        }
+        changed.notify_all();
+        for (size_t j : orphaned)
+          fail(j, "no worker could be started");
+        break;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.busy = true;
+        slot.timedOut = false;
+        slot.jobStart = Clock::now();
+      }
+      std::string id = std::to_string(job);
+      bool replied = slot.process.WriteLine(id + " " + jobs[job]) &&
+                     slot.process.ReadLine(line);
+      bool timedOut;
+      {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.busy = false;
+        timedOut = slot.timedOut;
+      }
+
+      bool inStep = line.compare(0, id.size() + 1, id + " ") == 0;
+      if (replied && !timedOut && inStep) {
+        {
+          std::lock_guard<std::mutex> lock(callbackMutex);
+          onResult(job, line.substr(id.size() + 1));
+        }
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          remaining--;
+        }
+        changed.notify_all();
+        continue;
+      }
+
+      // Crashed, hung or out of step: restart the worker, retry the job
+      std::string reason = timedOut  ? "timed out"
+                           : replied ? "bad reply"
+                                     : "worker exited";
+      if (replied || timedOut)
+        slot.process.Kill(); // Otherwise it is already on its way out
+      int status = slot.process.Wait();
+      bool retry;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        mRestarts++;
+        retry = ++attempts[job] < mConfig.maxAttempts;
+        if (retry) {
+          queue.push_back(job);
+        } else {
+          remaining--;
+          failed++;
+        }
+      }
+      changed.notify_all();
+      std::cerr << "[Coordinator] Worker " << index << ": job " << job << " "
+                << reason << " (exit " << status << "), "
+                << (retry ? "retrying" : "giving up") << std::endl;
+      if (!retry)
+        fail(job, reason);
+    }
+
+    slot.process.CloseInput();
+    slot.process.Wait();
+    running--;
+  };
+
+  std::vector<std::thread> threads;
+  for (int w = 0; w < workers; w++)
+    threads.emplace_back(workerLoop, w);
+
+  // Watchdog: kill workers stuck on one job; their threads then see the
+  // pipe close and retry it
+  while (running > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    if (mConfig.jobTimeout <= 0.0f)
+      continue;
+    for (std::unique_ptr<WorkerSlot> &slot : slots) {
+      std::lock_guard<std::mutex> lock(slot->mutex);
+      if (slot->busy && !slot->timedOut &&
+          std::chrono::duration<float>(Clock::now() - slot->jobStart)
+                  .count() > mConfig.jobTimeout) {
+        slot->timedOut = true;
+        slot->process.Kill();
+      }
+    }
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+  return failed;
+}
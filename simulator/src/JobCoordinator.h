@@ -0,0 +1,45 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+struct CoordinatorConfig {
+  std::vector<std::string> workerCommand; // [0] is the executable
+  int workers = 1;
+  int maxAttempts = 3;     // Per job, including the first
+  float jobTimeout = 0.0f; // s before a busy worker is killed; 0 = never
+};
+
+// Fans one-line text jobs out to worker processes that run RunWorkerLoop
+// (WorkerProcess.h), one job in flight per worker, and hands results back
+// as they arrive. Every worker is its own process with its own PhysX SDK,
+// so workers share no state and scale with the cores of the machine.
+//
+// A worker that exits, replies out of turn or outlives jobTimeout is
+// killed and restarted, and its job goes back in the queue until it has
+// failed maxAttempts times. Nothing depends on where a worker runs except
+// how it is started, so the same jobs give the same results here and in a
+// single process.
+class JobCoordinator {
+public:
+  // Both are called one at a time, from the coordinator's threads
+  using ResultCallback =
+      std::function<void(size_t job, const std::string &result)>;
+  using FailureCallback =
+      std::function<void(size_t job, const std::string &reason)>;
+
+  explicit JobCoordinator(CoordinatorConfig config);
+
+  // Blocks until every job has a result or has failed. Returns the number
+  // of jobs that failed.
+  size_t Run(const std::vector<std::string> &jobs,
+             const ResultCallback &onResult,
+             const FailureCallback &onFailure);
+
+  int GetRestartCount() const { return mRestarts; }
+
+private:
+  CoordinatorConfig mConfig;
+  int mRestarts = 0;
+};
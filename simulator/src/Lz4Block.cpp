@@ -0,0 +1,151 @@
+#include "Lz4Block.h"
+
+#include <cstring>
+
+// Format limits: a match needs 4 bytes, the last 5 bytes are always
+// literals and no match may start in the last 12
+static const size_t kMinMatch = 4;
+static const size_t kLastLiterals = 5;
+static const size_t kMatchLimit = 12;
+static const size_t kMaxOffset = 65535;
+static const int kHashBits = 12;
+
+static uint32_t Read32(const uint8_t *p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static uint32_t Hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+size_t Lz4CompressBound(size_t size) { return size + size / 255 + 16; }
+
+// Writes a length's 255-byte continuation after its 15 in the token
+static uint8_t *WriteLength(uint8_t *op, size_t length) {
+  for (; length >= 255; length -= 255)
+    *op++ = 255;
+  *op++ = static_cast<uint8_t>(length);
+  return op;
+}
+
+size_t Lz4Compress(const uint8_t *src, size_t size, uint8_t *dst,
+                   size_t capacity) {
+  if (capacity < Lz4CompressBound(size))
+    return 0;
+  uint32_t table[1 << kHashBits];
+  std::memset(table, 0, sizeof(table));
+
+  const uint8_t *ip = src;
+  const uint8_t *anchor = src; // Start of pending literals
+  const uint8_t *end = src + size;
+  uint8_t *op = dst;
+
+  if (size >= kMatchLimit) {
+    const uint8_t *matchLimit = end - kMatchLimit;
+    const uint8_t *extendLimit = end - kLastLiterals;
+    ip++; // Position 0 is the table's "empty" value
+    while (ip < matchLimit) {
+      uint32_t sequence = Read32(ip);
+      uint32_t &slot = table[Hash(sequence)];
+      const uint8_t *candidate = src + slot;
+      slot = static_cast<uint32_t>(ip - src);
+      if (candidate == src ||
+          static_cast<size_t>(ip - candidate) > kMaxOffset ||
+          Read32(candidate) != sequence) {
+        ip++;
+        continue;
+      }
+
+      const uint8_t *matchEnd = ip + kMinMatch;
+      const uint8_t *ref = candidate + kMinMatch;
+      while (matchEnd < extendLimit && *matchEnd == *ref) {
+        matchEnd++;
+        ref++;
+      }
+      size_t literals = static_cast<size_t>(ip - anchor);
+      size_t matchLength = static_cast<size_t>(matchEnd - ip) - kMinMatch;
+      uint16_t offset = static_cast<uint16_t>(ip - candidate);
+
+      uint8_t *token = op++;
+      *token = static_cast<uint8_t>((literals < 15 ? literals : 15) << 4);
+      if (literals >= 15)
+        op = WriteLength(op, literals - 15);
+      std::memcpy(op, anchor, literals);
+      op += literals;
+      *op++ = static_cast<uint8_t>(offset & 0xFF);
+      *op++ = static_cast<uint8_t>(offset >> 8);
+      *token |= static_cast<uint8_t>(matchLength < 15 ? matchLength : 15);
+      if (matchLength >= 15)
+        op = WriteLength(op, matchLength - 15);
+
+      ip = anchor = matchEnd;
+    }
+  }
+
+  // Closing sequence: the remaining literals, no match
+  size_t literals = static_cast<size_t>(end - anchor);
+  *op++ = static_cast<uint8_t>((literals < 15 ? literals : 15) << 4);
+  if (literals >= 15)
+    op = WriteLength(op, literals - 15);
+  if (literals > 0)
+    std::memcpy(op, anchor, literals);
+  op += literals;
+  return static_cast<size_t>(op - dst);
+}
+
+// Reads a length continued past 15 in the token
+static bool ReadLength(const uint8_t *&ip, const uint8_t *end,
+                       size_t &length) {
+  uint8_t byte;
+  do {
+    if (ip >= end)
+      return false;
+    byte = *ip++;
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+bool Lz4Decompress(const uint8_t *src, size_t size, uint8_t *dst,
+                   size_t dstSize) {
+  const uint8_t *ip = src;
+  const uint8_t *end = src + size;
+  uint8_t *op = dst;
+  uint8_t *opEnd = dst + dstSize;
+
+  while (ip < end) {
+    uint8_t token = *ip++;
+    size_t literals = token >> 4;
+    if (literals == 15 && !ReadLength(ip, end, literals))
+      return false;
+    if (literals > static_cast<size_t>(end - ip) ||
+        literals > static_cast<size_t>(opEnd - op))
+      return false;
+    if (literals > 0)
+      std::memcpy(op, ip, literals);
+    ip += literals;
+    op += literals;
+    if (ip == end)
+      break; // The closing sequence has no match
+
+    if (end - ip < 2)
+      return false;
+    size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    size_t matchLength = token & 15;
+    if (matchLength == 15 && !ReadLength(ip, end, matchLength))
+      return false;
+    matchLength += kMinMatch;
+    if (offset == 0 || offset > static_cast<size_t>(op - dst) ||
+        matchLength > static_cast<size_t>(opEnd - op))
+      return false;
+    // Byte by byte: the match may overlap the bytes it produces
+    const uint8_t *ref = op - offset;
+    for (size_t i = 0; i < matchLength; i++)
+      op[i] = ref[i];
+    op += matchLength;
+  }
+  return op == opEnd;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// LZ4 block format (no frame header or checksum), so output is readable by
+// any LZ4 implementation's block decoder. Greedy, single-probe hash table:
+// fast, compresses a little worse than the reference LZ4 at level 1.
+
+// Largest output Lz4Compress can produce for `size` input bytes
+size_t Lz4CompressBound(size_t size);
+
+// Returns the compressed size, or 0 if `capacity` is too small
+size_t Lz4Compress(const uint8_t *src, size_t size, uint8_t *dst,
+                   size_t capacity);
+
+// Decodes exactly `dstSize` bytes; false on malformed or truncated input
+bool Lz4Decompress(const uint8_t *src, size_t size, uint8_t *dst,
+                   size_t dstSize);
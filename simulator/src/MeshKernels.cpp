@@ -0,0 +1,366 @@
+#include "MeshKernels.h"
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define MESH_KERNELS_X64 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+static const float kInv255 = 1.0f / 255.0f;
+
+// --- Scalar ---
+
+static void CopyFloat3Scalar(void *dst, size_t dstStride, const void *src,
+                             size_t srcStride, size_t count) {
+  uint8_t *d = static_cast<uint8_t *>(dst);
+  const uint8_t *s = static_cast<const uint8_t *>(src);
+  for (size_t i = 0; i < count; i++)
+    memcpy(d + i * dstStride, s + i * srcStride, 3 * sizeof(float));
+}
+
+static void FillFloat3Scalar(void *dst, size_t dstStride, const float value[3],
+                             size_t count) {
+  uint8_t *d = static_cast<uint8_t *>(dst);
+  for (size_t i = 0; i < count; i++)
+    memcpy(d + i * dstStride, value, 3 * sizeof(float));
+}
+
+static void ConvertUnorm8Scalar(void *dst, size_t dstStride,
+                                const uint8_t *src, size_t srcStride,
+                                size_t count) {
+  uint8_t *d = static_cast<uint8_t *>(dst);
+  for (size_t i = 0; i < count; i++) {
+    const uint8_t *c = src + i * srcStride;
+    float rgb[3] = {c[0] * kInv255, c[1] * kInv255, c[2] * kInv255};
+    memcpy(d + i * dstStride, rgb, sizeof(rgb));
+  }
+}
+
+static void ScaleFloat3Scalar(float *dst, const void *src, size_t srcStride,
+                              const float scale[3], size_t count) {
+  const uint8_t *s = static_cast<const uint8_t *>(src);
+  for (size_t i = 0; i < count; i++) {
+    float p[3];
+    memcpy(p, s + i * srcStride, sizeof(p));
+    dst[3 * i + 0] = p[0] * scale[0];
+    dst[3 * i + 1] = p[1] * scale[1];
+    dst[3 * i + 2] = p[2] * scale[2];
+  }
+}
+
+static void WidenIndicesScalar(uint32_t *dst, const void *src,
+                               size_t indexSize, size_t count, uint32_t base) {
+  if (indexSize == 1) {
+    const uint8_t *s = static_cast<const uint8_t *>(src);
+    for (size_t i = 0; i < count; i++)
+      dst[i] = s[i] + base;
+  } else if (indexSize == 2) {
+    const uint16_t *s = static_cast<const uint16_t *>(src);
+    for (size_t i = 0; i < count; i++)
+      dst[i] = s[i] + base;
+  } else {
+    const uint32_t *s = static_cast<const uint32_t *>(src);
+    for (size_t i = 0; i < count; i++)
+      dst[i] = s[i] + base;
+  }
+}
+
+#ifdef MESH_KERNELS_X64
+
+// --- SSE2 (always present on x86-64) ---
+
+static inline void StoreFloat3(uint8_t *dst, __m128 v) {
+  // 8 + 4 bytes: a 16-byte store would clobber the next attribute
+  _mm_storel_pi(reinterpret_cast<__m64 *>(dst), v);
+  _mm_store_ss(reinterpret_cast<float *>(dst + 8), _mm_movehl_ps(v, v));
+}
+
+static void ConvertUnorm8Sse2(void *dst, size_t dstStride, const uint8_t *src,
+                              size_t srcStride, size_t count) {
+  if (count == 0)
+    return;
+  uint8_t *d = static_cast<uint8_t *>(dst);
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 inv = _mm_set1_ps(kInv255);
+  // 4-byte loads; the last element is done in scalar so a 3-byte stride
+  // never reads past the stream.
+  for (size_t i = 0; i + 1 < count; i++) {
+    int32_t packed;
+    memcpy(&packed, src + i * srcStride, sizeof(packed));
+    __m128i v = _mm_cvtsi32_si128(packed);
+    v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero);
+    StoreFloat3(d + i * dstStride, _mm_mul_ps(_mm_cvtepi32_ps(v), inv));
+  }
+  ConvertUnorm8Scalar(d + (count - 1) * dstStride,
+                      dstStride, src + (count - 1) * srcStride, srcStride, 1);
+}
+
+static void ScaleFloat3Sse2(float *dst, const void *src, size_t srcStride,
+                            const float scale[3], size_t count) {
+  if (srcStride != 3 * sizeof(float)) {
+    ScaleFloat3Scalar(dst, src, srcStride, scale, count);
+    return;
+  }
+  // Packed input: 4 vertices = 12 floats = 3 registers, with the scale
+  // pattern rotating across them.
+  const float *s = static_cast<const float *>(src);
+  const __m128 m0 = _mm_setr_ps(scale[0], scale[1], scale[2], scale[0]);
+  const __m128 m1 = _mm_setr_ps(scale[1], scale[2], scale[0], scale[1]);
+  const __m128 m2 = _mm_setr_ps(scale[2], scale[0], scale[1], scale[2]);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const float *in = s + 3 * i;
+    float *out = dst + 3 * i;
+    _mm_storeu_ps(out + 0, _mm_mul_ps(_mm_loadu_ps(in + 0), m0));
+    _mm_storeu_ps(out + 4, _mm_mul_ps(_mm_loadu_ps(in + 4), m1));
+    _mm_storeu_ps(out + 8, _mm_mul_ps(_mm_loadu_ps(in + 8), m2));
+  }
+  ScaleFloat3Scalar(dst + 3 * i, s + 3 * i, srcStride, scale, count - i);
+}
+
+static void WidenIndicesSse2(uint32_t *dst, const void *src, size_t indexSize,
+                             size_t count, uint32_t base) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i b = _mm_set1_epi32(static_cast<int>(base));
+  size_t i = 0;
+  if (indexSize == 1) {
+    const uint8_t *s = static_cast<const uint8_t *>(src);
+    for (; i + 16 <= count; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+      __m128i lo = _mm_unpacklo_epi8(v, zero);
+      __m128i hi = _mm_unpackhi_epi8(v, zero);
+      __m128i *out = reinterpret_cast<__m128i *>(dst + i);
+      _mm_storeu_si128(out + 0, _mm_add_epi32(_mm_unpacklo_epi16(lo, zero), b));
+      _mm_storeu_si128(out + 1, _mm_add_epi32(_mm_unpackhi_epi16(lo, zero), b));
+      _mm_storeu_si128(out + 2, _mm_add_epi32(_mm_unpacklo_epi16(hi, zero), b));
+      _mm_storeu_si128(out + 3, _mm_add_epi32(_mm_unpackhi_epi16(hi, zero), b));
+    }
+  } else if (indexSize == 2) {
+    const uint16_t *s = static_cast<const uint16_t *>(src);
+    for (; i + 8 <= count; i += 8) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+      __m128i *out = reinterpret_cast<__m128i *>(dst + i);
+      _mm_storeu_si128(out + 0, _mm_add_epi32(_mm_unpacklo_epi16(v, zero), b));
+      _mm_storeu_si128(out + 1, _mm_add_epi32(_mm_unpackhi_epi16(v, zero), b));
+    }
+  } else {
+    const uint32_t *s = static_cast<const uint32_t *>(src);
+    for (; i + 4 <= count; i += 4) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                       _mm_add_epi32(v, b));
+    }
+  }
+  WidenIndicesScalar(dst + i, static_cast<const uint8_t *>(src) + i * indexSize,
+                     indexSize, count - i, base);
+}
+
+// --- AVX2 ---
+
+TARGET_AVX2 static void ConvertUnorm8Avx2(void *dst, size_t dstStride,
+                                          const uint8_t *src, size_t srcStride,
+                                          size_t count) {
+  if (count == 0)
+    return;
+  uint8_t *d = static_cast<uint8_t *>(dst);
+  const __m256 inv = _mm256_set1_ps(kInv255);
+  // Two elements per iteration (8 bytes widened to 8 floats)
+  size_t i = 0;
+  for (; i + 2 < count; i += 2) {
+    int32_t a, b;
+    memcpy(&a, src + i * srcStride, sizeof(a));
+    memcpy(&b, src + (i + 1) * srcStride, sizeof(b));
+    __m256i v = _mm256_cvtepu8_epi32(_mm_setr_epi32(a, b, 0, 0));
+    __m256 f = _mm256_mul_ps(_mm256_cvtepi32_ps(v), inv);
+    StoreFloat3(d + i * dstStride, _mm256_castps256_ps128(f));
+    StoreFloat3(d + (i + 1) * dstStride, _mm256_extractf128_ps(f, 1));
+  }
+  ConvertUnorm8Sse2(d + i * dstStride, dstStride, src + i * srcStride,
+                    srcStride, count - i);
+}
+
+TARGET_AVX2 static void ScaleFloat3Avx2(float *dst, const void *src,
+                                        size_t srcStride, const float scale[3],
+                                        size_t count) {
+  if (srcStride != 3 * sizeof(float)) {
+    ScaleFloat3Scalar(dst, src, srcStride, scale, count);
+    return;
+  }
+  // 8 vertices = 24 floats = 3 registers
+  const float *s = static_cast<const float *>(src);
+  const float x = scale[0], y = scale[1], z = scale[2];
+  const __m256 m0 = _mm256_setr_ps(x, y, z, x, y, z, x, y);
+  const __m256 m1 = _mm256_setr_ps(z, x, y, z, x, y, z, x);
+  const __m256 m2 = _mm256_setr_ps(y, z, x, y, z, x, y, z);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const float *in = s + 3 * i;
+    float *out = dst + 3 * i;
+    _mm256_storeu_ps(out + 0, _mm256_mul_ps(_mm256_loadu_ps(in + 0), m0));
+    _mm256_storeu_ps(out + 8, _mm256_mul_ps(_mm256_loadu_ps(in + 8), m1));
+    _mm256_storeu_ps(out + 16, _mm256_mul_ps(_mm256_loadu_ps(in + 16), m2));
+  }
+  ScaleFloat3Sse2(dst + 3 * i, s + 3 * i, srcStride, scale, count - i);
+}
+
+TARGET_AVX2 static void WidenIndicesAvx2(uint32_t *dst, const void *src,
+                                         size_t indexSize, size_t count,
+                                         uint32_t base) {
+  const __m256i b = _mm256_set1_epi32(static_cast<int>(base));
+  size_t i = 0;
+  if (indexSize == 1) {
+    const uint8_t *s = static_cast<const uint8_t *>(src);
+    for (; i + 8 <= count; i += 8) {
+      __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(s + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                          _mm256_add_epi32(_mm256_cvtepu8_epi32(v), b));
+    }
+  } else if (indexSize == 2) {
+    const uint16_t *s = static_cast<const uint16_t *>(src);
+    for (; i + 8 <= count; i += 8) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                          _mm256_add_epi32(_mm256_cvtepu16_epi32(v), b));
+    }
+  } else {
+    const uint32_t *s = static_cast<const uint32_t *>(src);
+    for (; i + 8 <= count; i += 8) {
+      __m256i v =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                          _mm256_add_epi32(v, b));
+    }
+  }
+  WidenIndicesSse2(dst + i, static_cast<const uint8_t *>(src) + i * indexSize,
+                   indexSize, count - i, base);
+}
+
+static bool CpuHasAvx2() {
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 1);
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool avx = (info[2] & (1 << 28)) != 0;
+  if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+    return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // MESH_KERNELS_X64
+
+// --- Dispatch ---
+
+// Float3 copies and fills are bound by memory traffic into the strided
+// destination, so every instruction set shares the scalar versions.
+struct KernelTable {
+  void (*convertUnorm8)(void *, size_t, const uint8_t *, size_t, size_t);
+  void (*scaleFloat3)(float *, const void *, size_t, const float *, size_t);
+  void (*widenIndices)(uint32_t *, const void *, size_t, size_t, uint32_t);
+};
+
+static const KernelTable kScalarTable = {
+    ConvertUnorm8Scalar, ScaleFloat3Scalar, WidenIndicesScalar};
+#ifdef MESH_KERNELS_X64
+static const KernelTable kSse2Table = {ConvertUnorm8Sse2, ScaleFloat3Sse2,
+                                       WidenIndicesSse2};
+static const KernelTable kAvx2Table = {ConvertUnorm8Avx2, ScaleFloat3Avx2,
+                                       WidenIndicesAvx2};
+#endif
+
+static KernelIsa DetectIsa() {
+#ifdef MESH_KERNELS_X64
+  return CpuHasAvx2() ? KernelIsa::eAVX2 : KernelIsa::eSSE2;
+#else
+  return KernelIsa::eSCALAR;
+#endif
+}
+
+static std::atomic<const KernelTable *> gTable{nullptr};
+static std::atomic<int> gIsa{-1};
+
+static const KernelTable *TableFor(KernelIsa isa) {
+#ifdef MESH_KERNELS_X64
+  if (isa == KernelIsa::eAVX2)
+    return &kAvx2Table;
+  if (isa == KernelIsa::eSSE2)
+    return &kSse2Table;
+#endif
+  return &kScalarTable;
+}
+
+static const KernelTable &Table() {
+  const KernelTable *table = gTable.load(std::memory_order_acquire);
+  if (!table) {
+    SetKernelIsa(DetectIsa());
+    table = gTable.load(std::memory_order_acquire);
+  }
+  return *table;
+}
+
+KernelIsa GetKernelIsa() {
+  Table();
+  return static_cast<KernelIsa>(gIsa.load());
+}
+
+const char *KernelIsaName(KernelIsa isa) {
+  switch (isa) {
+  case KernelIsa::eAVX2:
+    return "avx2";
+  case KernelIsa::eSSE2:
+    return "sse2";
+  default:
+    return "scalar";
+  }
+}
+
+bool IsKernelIsaSupported(KernelIsa isa) {
+  static const KernelIsa best = DetectIsa();
+  return static_cast<int>(isa) <= static_cast<int>(best);
+}
+
+void SetKernelIsa(KernelIsa isa) {
+  if (!IsKernelIsaSupported(isa))
+    isa = DetectIsa();
+  gIsa.store(static_cast<int>(isa));
+  gTable.store(TableFor(isa), std::memory_order_release);
+}
+
+// --- Public entry points ---
+
+void CopyFloat3(void *dst, size_t dstStride, const void *src, size_t srcStride,
+                size_t count) {
+  CopyFloat3Scalar(dst, dstStride, src, srcStride, count);
+}
+
+void FillFloat3(void *dst, size_t dstStride, const float value[3],
+                size_t count) {
+  FillFloat3Scalar(dst, dstStride, value, count);
+}
+
+void ConvertUnorm8ToFloat3(void *dst, size_t dstStride, const uint8_t *src,
+                           size_t srcStride, size_t count) {
+  Table().convertUnorm8(dst, dstStride, src, srcStride, count);
+}
+
+void ScaleFloat3(float *dst, const void *src, size_t srcStride,
+                 const float scale[3], size_t count) {
+  Table().scaleFloat3(dst, src, srcStride, scale, count);
+}
+
+void WidenIndices(uint32_t *dst, const void *src, size_t indexSize,
+                  size_t count, uint32_t base) {
+  Table().widenIndices(dst, src, indexSize, count, base);
+}
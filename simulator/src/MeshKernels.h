@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Attribute conversion kernels for mesh import. Each call converts a whole
+// attribute stream, so importers pick one kernel per primitive instead of
+// branching per vertex. The instruction set is chosen once at startup
+// (AVX2 > SSE2 > scalar) from what the CPU supports.
+enum class KernelIsa { eSCALAR, eSSE2, eAVX2 };
+
+KernelIsa GetKernelIsa();
+const char *KernelIsaName(KernelIsa isa);
+bool IsKernelIsaSupported(KernelIsa isa);
+// Forces a (supported) instruction set, for benchmarks. Not thread-safe
+// with respect to conversions running at the same time.
+void SetKernelIsa(KernelIsa isa);
+
+// count float3 elements between strided arrays
+void CopyFloat3(void *dst, size_t dstStride, const void *src, size_t srcStride,
+                size_t count);
+
+// Writes `value` to count strided float3 elements
+void FillFloat3(void *dst, size_t dstStride, const float value[3],
+                size_t count);
+
+// Normalized UNSIGNED_BYTE triples (first three channels) to float3
+void ConvertUnorm8ToFloat3(void *dst, size_t dstStride, const uint8_t *src,
+                           size_t srcStride, size_t count);
+
+// Strided float3 to a packed float3 array, multiplied per axis by `scale`
+void ScaleFloat3(float *dst, const void *src, size_t srcStride,
+                 const float scale[3], size_t count);
+
+// 8/16/32-bit indices (`indexSize` bytes, packed) to uint32 plus `base`
+void WidenIndices(uint32_t *dst, const void *src, size_t indexSize,
+                  size_t count, uint32_t base);
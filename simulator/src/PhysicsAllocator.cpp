@@ -0,0 +1,180 @@
+#include "PhysicsAllocator.h"
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+static void *AlignedAlloc(size_t size) {
+#ifdef _WIN32
+  return _aligned_malloc(size, 16);
+#else
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, 16, size) != 0)
+    return nullptr;
+  return ptr;
+#endif
+}
+
+static void AlignedFree(void *ptr) {
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+
+TrackingAllocator::~TrackingAllocator() {
+  for (void *slab : mSlabs)
+    AlignedFree(slab);
+}
+
+void TrackingAllocator::SetPoolEnabled(bool enabled) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mHasAllocated)
+    return;
+
+  mPoolEnabled = enabled;
+  mPools.clear();
+  if (enabled) {
+    // Payload classes of 32, 64, 128 and 256 bytes
+    for (size_t payload = 32; payload <= kMaxPooledSize; payload *= 2) {
+      Pool pool;
+      pool.blockSize = sizeof(Header) + payload;
+      mPools.push_back(pool);
+    }
+  }
+}
+
+uint32_t TrackingAllocator::GetCategory(const char *typeName) {
+  if (!typeName || !*typeName)
+    typeName = "<unnamed>";
+
+  // Type names are string literals, so the pointer lookup almost always
+  // hits; the name lookup merges literals duplicated across modules.
+  auto byPtr = mCategoryByPtr.find(typeName);
+  if (byPtr != mCategoryByPtr.end())
+    return byPtr->second;
+
+  uint32_t index;
+  auto byName = mCategoryByName.find(typeName);
+  if (byName != mCategoryByName.end()) {
+    index = byName->second;
+  } else {
+    index = static_cast<uint32_t>(mCategories.size());
+    AllocationCategoryStats cat;
+    cat.name = typeName;
+    mCategories.push_back(cat);
+    mCategoryByName.emplace(typeName, index);
+  }
+  mCategoryByPtr.emplace(typeName, index);
+  return index;
+}
+
+void *TrackingAllocator::PoolAlloc(uint32_t sizeClass) {
+  Pool &pool = mPools[sizeClass];
+  if (!pool.freeList) {
+    char *slab = static_cast<char *>(AlignedAlloc(kSlabSize));
+    if (!slab)
+      return nullptr;
+    mSlabs.push_back(slab);
+    mTotals.poolReservedBytes += kSlabSize;
+
+    // Thread the new slab onto the free list
+    size_t count = kSlabSize / pool.blockSize;
+    for (size_t i = 0; i < count; i++) {
+      void *block = slab + i * pool.blockSize;
+      *static_cast<void **>(block) = pool.freeList;
+      pool.freeList = block;
+    }
+  }
+
+  void *block = pool.freeList;
+  pool.freeList = *static_cast<void **>(block);
+  mTotals.poolAllocs++;
+  return block;
+}
+
+void TrackingAllocator::PoolFree(uint32_t sizeClass, void *block) {
+  Pool &pool = mPools[sizeClass];
+  *static_cast<void **>(block) = pool.freeList;
+  pool.freeList = block;
+}
+
+void *TrackingAllocator::allocate(size_t size, const char *typeName,
+                                  const char *filename, int line) {
+  (void)filename;
+  (void)line;
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  mHasAllocated = true;
+
+  uint32_t sizeClass = kHeapClass;
+  if (mPoolEnabled && size <= kMaxPooledSize) {
+    sizeClass = 0;
+    while (mPools[sizeClass].blockSize - sizeof(Header) < size)
+      sizeClass++;
+  }
+
+  void *block = (sizeClass == kHeapClass) ? AlignedAlloc(sizeof(Header) + size)
+                                          : PoolAlloc(sizeClass);
+  if (!block)
+    return nullptr;
+
+  Header *header = static_cast<Header *>(block);
+  header->category = GetCategory(typeName);
+  header->sizeClass = sizeClass;
+  header->size = size;
+
+  AllocationCategoryStats &cat = mCategories[header->category];
+  cat.liveBytes += size;
+  cat.peakBytes = std::max(cat.peakBytes, cat.liveBytes);
+  cat.liveAllocs++;
+  cat.totalAllocs++;
+
+  mTotals.liveBytes += size;
+  mTotals.peakBytes = std::max(mTotals.peakBytes, mTotals.liveBytes);
+  mTotals.liveAllocs++;
+  mTotals.totalAllocs++;
+
+  return header + 1;
+}
+
+void TrackingAllocator::deallocate(void *ptr) {
+  if (!ptr)
+    return;
+
+  Header *header = static_cast<Header *>(ptr) - 1;
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  AllocationCategoryStats &cat = mCategories[header->category];
+  cat.liveBytes -= header->size;
+  cat.liveAllocs--;
+
+  mTotals.liveBytes -= header->size;
+  mTotals.liveAllocs--;
+  mTotals.totalFrees++;
+
+  if (header->sizeClass == kHeapClass)
+    AlignedFree(header);
+  else
+    PoolFree(header->sizeClass, header);
+}
+
+AllocatorStats TrackingAllocator::GetStats() const {
+  std::lock_guard<std::mutex> lock(mMutex);
+  AllocatorStats stats = mTotals;
+  stats.categories = mCategories;
+  std::sort(stats.categories.begin(), stats.categories.end(),
+            [](const AllocationCategoryStats &a,
+               const AllocationCategoryStats &b) {
+              return a.peakBytes > b.peakBytes;
+            });
+  return stats;
+}
+
+uint64_t TrackingAllocator::GetTotalAllocs() const {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mTotals.totalAllocs;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "PxPhysicsAPI.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace physx;
+
+// Memory statistics for one PhysX allocation name (e.g. "NpRigidDynamic")
+struct AllocationCategoryStats {
+  std::string name;
+  uint64_t liveBytes = 0;
+  uint64_t peakBytes = 0; // High-water mark of liveBytes
+  uint64_t liveAllocs = 0;
+  uint64_t totalAllocs = 0;
+};
+
+struct AllocatorStats {
+  uint64_t liveBytes = 0;
+  uint64_t peakBytes = 0;
+  uint64_t liveAllocs = 0;
+  uint64_t totalAllocs = 0;
+  uint64_t totalFrees = 0;
+
+  // Small-allocation pool (only non-zero when pooling is enabled)
+  uint64_t poolAllocs = 0;        // Requests served from a free list
+  uint64_t poolReservedBytes = 0; // Slab memory owned by the pool
+
+  // Sorted by peakBytes, largest first
+  std::vector<AllocationCategoryStats> categories;
+};
+
+// PxAllocatorCallback that tracks bytes, counts and high-water marks per
+// PhysX allocation name. With pooling enabled, requests up to
+// kMaxPooledSize bytes are carved from fixed-size slabs and recycled through
+// free lists instead of going back to the system heap.
+//
+// Must outlive the PxFoundation it is registered with.
+class TrackingAllocator : public PxAllocatorCallback {
+public:
+  static constexpr size_t kMaxPooledSize = 256;
+
+  TrackingAllocator() = default;
+  ~TrackingAllocator() override;
+
+  TrackingAllocator(const TrackingAllocator &) = delete;
+  TrackingAllocator &operator=(const TrackingAllocator &) = delete;
+
+  // Only honoured before the first allocation
+  void SetPoolEnabled(bool enabled);
+  bool IsPoolEnabled() const { return mPoolEnabled; }
+
+  void *allocate(size_t size, const char *typeName, const char *filename,
+                 int line) override;
+  void deallocate(void *ptr) override;
+
+  AllocatorStats GetStats() const;
+
+  // Cheap monotonic counter, for per-step allocation deltas
+  uint64_t GetTotalAllocs() const;
+
+private:
+  // Sits in front of every returned pointer; 16 bytes keeps the payload
+  // 16-byte aligned as PhysX requires.
+  struct Header {
+    uint32_t category;
+    uint32_t sizeClass; // Index into mPools, or kHeapClass
+    uint64_t size;
+  };
+  static_assert(sizeof(Header) == 16, "Header must preserve 16B alignment");
+  static constexpr uint32_t kHeapClass = 0xFFFFFFFFu;
+  static constexpr size_t kSlabSize = 64 * 1024;
+
+  struct Pool {
+    size_t blockSize = 0; // Header + payload
+    void *freeList = nullptr;
+  };
+
+  uint32_t GetCategory(const char *typeName);
+  void *PoolAlloc(uint32_t sizeClass);
+  void PoolFree(uint32_t sizeClass, void *block);
+
+  mutable std::mutex mMutex;
+  bool mPoolEnabled = false;
+  bool mHasAllocated = false;
+
+  std::vector<AllocationCategoryStats> mCategories;
+  std::unordered_map<const char *, uint32_t> mCategoryByPtr;
+  std::unordered_map<std::string, uint32_t> mCategoryByName;
+
+  std::vector<Pool> mPools;
+  std::vector<void *> mSlabs;
+
+  AllocatorStats mTotals; // .categories stays empty; see mCategories
+};
@@ -1,27 +1,61 @@
 #include "PhysicsWorld.h"
 #include "SimulationFilter.h" // [FIX] Moved to top
+#include <chrono>
+#include <vector>
 
 // Define PVD constants
 #define PVD_HOST "127.0.0.1"
 
+bool ParseBroadPhaseType(const std::string &name,
+                         PxBroadPhaseType::Enum &out) {
+  if (name == "sap")
+    out = PxBroadPhaseType::eSAP;
+  else if (name == "mbp")
+    out = PxBroadPhaseType::eMBP;
+  else if (name == "abp")
+    out = PxBroadPhaseType::eABP;
+  else
+    return false;
+  return true;
+}
+
+const char *BroadPhaseTypeName(PxBroadPhaseType::Enum type) {
+  switch (type) {
+  case PxBroadPhaseType::eSAP:
+    return "sap";
+  case PxBroadPhaseType::eMBP:
+    return "mbp";
+  case PxBroadPhaseType::eABP:
+    return "abp";
+  default:
+    return "other";
+  }
+}
+
 PhysicsWorld::PhysicsWorld() {}
 
 PhysicsWorld::~PhysicsWorld() { Cleanup(); }
 
-void PhysicsWorld::Initialize() {
-  // 1. Foundation
+void PhysicsWorld::Initialize(const PhysicsConfig &config) {
+  mConfig = config;
+
+  // 1. Foundation (all PhysX memory goes through mAllocator)
+  mAllocator.SetPoolEnabled(mConfig.poolSmallAllocations);
   mFoundation =
       PxCreateFoundation(PX_PHYSICS_VERSION, mAllocator, mErrorCallback);
   if (!mFoundation) {
     std::cerr << "PxCreateFoundation failed!" << std::endl;
     return;
   }
+  mFoundation->setReportAllocationNames(mConfig.trackAllocationNames);
 
-  // 2. PVD (Visual Debugger)
-  mPvd = PxCreatePvd(*mFoundation);
-  PxPvdTransport *transport =
-      PxDefaultPvdSocketTransportCreate(PVD_HOST, 5425, 10);
-  mPvd->connect(*transport, PxPvdInstrumentationFlag::eALL);
+  // 2. PVD (Visual Debugger) - skipped for headless runs
+  if (mConfig.enablePvd) {
+    mPvd = PxCreatePvd(*mFoundation);
+    PxPvdTransport *transport =
+        PxDefaultPvdSocketTransportCreate(PVD_HOST, 5425, 10);
+    mPvd->connect(*transport, PxPvdInstrumentationFlag::eALL);
+  }
 
   // 3. Physics
   mPhysics = PxCreatePhysics(PX_PHYSICS_VERSION, *mFoundation,
@@ -31,14 +65,42 @@ void PhysicsWorld::Initialize() {
     return;
   }
 
+  CreateScene();
+
+  std::cout << "PhysX Initialized Successfully! (broadphase: "
+            << BroadPhaseTypeName(mConfig.broadPhase) << ")" << std::endl;
+}
+
+void PhysicsWorld::InitializeShared(PhysicsWorld &sdk,
+                                    const PhysicsConfig &config) {
+  mConfig = config;
+  mSdk = &sdk;
+  mPhysics = sdk.GetPhysics();
+  if (!mPhysics) {
+    std::cerr << "[PhysicsWorld] Shared SDK is not initialized" << std::endl;
+    return;
+  }
+  CreateScene();
+}
+
+void PhysicsWorld::CreateScene() {
   // 4. Dispatcher (CPU Multithreading)
-  mDispatcher = PxDefaultCpuDispatcherCreate(2); // 2 threads
+  mDispatcher = PxDefaultCpuDispatcherCreate(mConfig.workerThreads);
 
   // 5. Scene
   PxSceneDesc sceneDesc(mPhysics->getTolerancesScale());
   sceneDesc.gravity = PxVec3(0.0f, -9.81f, 0.0f);
   sceneDesc.cpuDispatcher = mDispatcher;
   sceneDesc.filterShader = VehicleFilterShader; // Use our custom shader
+  if (mConfig.enhancedDeterminism)
+    sceneDesc.flags |= PxSceneFlag::eENABLE_ENHANCED_DETERMINISM;
+  sceneDesc.broadPhaseType = mConfig.broadPhase;
+  sceneDesc.broadPhaseCallback = &mBroadPhaseCallback;
+  // Active actors give a cheap "who is awake" list after each step
+  sceneDesc.flags |= PxSceneFlag::eENABLE_ACTIVE_ACTORS;
+  if (mConfig.enableStabilization)
+    sceneDesc.flags |= PxSceneFlag::eENABLE_STABILIZATION;
+  sceneDesc.wakeCounterResetValue = mConfig.wakeCounterReset;
 
   // Enable PVD in scene
   mScene = mPhysics->createScene(sceneDesc);
@@ -58,31 +120,201 @@ void PhysicsWorld::Initialize() {
   // PxCooking class is deprecated in PhysX 5. We use free functions
   // (PxCookTriangleMesh) instead. No explicit initialization needed for Cooking
   // library, just header inclusion.
+}
+
+void PhysicsWorld::ConfigureBroadPhaseRegions(const PxBounds3 &fieldBounds) {
+  if (!mScene)
+    return;
+
+  // Field footprint (never smaller than the regulation 12 ft square), with
+  // 0.5 m of slack around it and enough height for stacked blocks.
+  PxBounds3 bounds = fieldBounds.isEmpty()
+                         ? PxBounds3(PxVec3(-kFieldHalfExtent, 0.0f,
+                                            -kFieldHalfExtent),
+                                     PxVec3(kFieldHalfExtent, 0.0f,
+                                            kFieldHalfExtent))
+                         : fieldBounds;
+  bounds.include(
+      PxVec3(-kFieldHalfExtent, bounds.minimum.y, -kFieldHalfExtent));
+  bounds.include(
+      PxVec3(kFieldHalfExtent, bounds.maximum.y, kFieldHalfExtent));
+  bounds.minimum -= PxVec3(0.5f, 1.0f, 0.5f);
+  bounds.maximum += PxVec3(0.5f, 2.0f, 0.5f);
+  mWorldBounds = bounds;
+
+  if (mConfig.broadPhase != PxBroadPhaseType::eMBP)
+    return;
 
-  std::cout << "PhysX Initialized Successfully!" << std::endl;
+  PxU32 subdiv = PxMax<PxU32>(1, mConfig.mbpSubdivisions);
+  std::vector<PxBounds3> regions(subdiv * subdiv);
+  PxU32 count = PxBroadPhaseExt::createRegionsFromWorldBounds(
+      regions.data(), bounds, subdiv, 1 /* Y up */);
+  for (PxU32 i = 0; i < count; i++) {
+    PxBroadPhaseRegion region;
+    region.mBounds = regions[i];
+    region.mUserData = nullptr;
+    // Populate so the already-added field body lands in its regions
+    mScene->addBroadPhaseRegion(region, true);
+  }
+
+  std::cout << "[PhysicsWorld] MBP: " << count << " regions over ("
+            << bounds.minimum.x << ", " << bounds.minimum.z << ") - ("
+            << bounds.maximum.x << ", " << bounds.maximum.z << ")"
+            << std::endl;
 }
 
 void PhysicsWorld::Update(float deltaTime) {
   if (mScene) {
-    mScene->simulate(deltaTime);
+    using Clock = std::chrono::steady_clock;
+    uint64_t allocsBefore = GetAllocator().GetTotalAllocs();
+
+    // collide/advance is simulate() split in two, so the broadphase +
+    // narrowphase cost can be timed separately from the solver.
+    auto t0 = Clock::now();
+    mScene->collide(deltaTime);
+    mScene->fetchCollision(true);
+    auto t1 = Clock::now();
+    mScene->advance();
     mScene->fetchResults(true);
+    auto t2 = Clock::now();
+
+    mLastStepTiming.collideMs =
+        std::chrono::duration<double, std::milli>(t1 - t0).count();
+    mLastStepTiming.solveMs =
+        std::chrono::duration<double, std::milli>(t2 - t1).count();
+    mLastStepAllocs = GetAllocator().GetTotalAllocs() - allocsBefore;
+
+    UpdateSleepState();
   }
 }
 
+// --- Sleep ---
+
+const SleepProfile &PhysicsWorld::GetSleepProfile(BodyClass bodyClass) const {
+  switch (bodyClass) {
+  case BodyClass::eCHASSIS:
+    return mConfig.chassisSleep;
+  case BodyClass::eWHEEL:
+    return mConfig.wheelSleep;
+  case BodyClass::eBLOCK:
+  default:
+    return mConfig.blockSleep;
+  }
+}
+
+void PhysicsWorld::RegisterBody(PxRigidDynamic *body, BodyClass bodyClass) {
+  if (!body)
+    return;
+
+  const SleepProfile &profile = GetSleepProfile(bodyClass);
+  body->setSleepThreshold(profile.sleepThreshold);
+  body->setStabilizationThreshold(profile.stabilizationThreshold);
+  body->setSolverIterationCounts(profile.positionIterations,
+                                 profile.velocityIterations);
+
+  if (profile.wakePolicy == WakePolicy::eSETTLE_QUIET)
+    mSettleBodies[body] = {bodyClass, 0};
+  else
+    mSettleBodies.erase(body);
+}
+
+void PhysicsWorld::UnregisterBody(PxRigidDynamic *body) {
+  mSettleBodies.erase(body);
+}
+
+void PhysicsWorld::UpdateSleepState() {
+  // Only bodies that moved this step are listed, so a field of sleeping
+  // blocks costs nothing here.
+  PxU32 nbActive = 0;
+  PxActor **active = mScene->getActiveActors(nbActive);
+
+  PxU32 awake = 0;
+  for (PxU32 i = 0; i < nbActive; i++) {
+    PxRigidDynamic *body = active[i]->is<PxRigidDynamic>();
+    if (!body || body->isSleeping())
+      continue;
+    awake++;
+
+    auto it = mSettleBodies.find(body);
+    if (it == mSettleBodies.end() ||
+        (body->getRigidBodyFlags() & PxRigidBodyFlag::eKINEMATIC))
+      continue;
+
+    const SleepProfile &profile = GetSleepProfile(it->second.bodyClass);
+    float linSq = profile.settleLinearSpeed * profile.settleLinearSpeed;
+    float angSq = profile.settleAngularSpeed * profile.settleAngularSpeed;
+    bool quiet = body->getLinearVelocity().magnitudeSquared() < linSq &&
+                 body->getAngularVelocity().magnitudeSquared() < angSq;
+
+    if (!quiet) {
+      it->second.quietFrames = 0;
+    } else if (++it->second.quietFrames >= profile.settleFrames) {
+      body->putToSleep();
+      it->second.quietFrames = 0;
+      awake--;
+    }
+  }
+
+  mAwakeBodies = awake;
+  mAwakeHistory[mAwakeHistoryPos] = static_cast<float>(awake);
+  mAwakeHistoryPos = (mAwakeHistoryPos + 1) % kAwakeHistorySize;
+}
+
 void PhysicsWorld::Cleanup() {
-  if (mScene)
+  // Pointers are cleared so an explicit Cleanup() followed by the destructor
+  // does not release anything twice.
+  mSettleBodies.clear();
+  if (mScene && mSdk) {
+    // Objects belong to the shared PxPhysics, not the scene, and would
+    // outlive it: release joints first, then every actor
+    std::vector<PxConstraint *> constraints(mScene->getNbConstraints());
+    mScene->getConstraints(constraints.data(),
+                           static_cast<PxU32>(constraints.size()));
+    for (PxConstraint *constraint : constraints) {
+      PxU32 typeId = 0;
+      void *external = constraint->getExternalReference(typeId);
+      if (typeId == PxConstraintExtIDs::eJOINT)
+        static_cast<PxJoint *>(external)->release();
+    }
+    PxActorTypeFlags types =
+        PxActorTypeFlag::eRIGID_STATIC | PxActorTypeFlag::eRIGID_DYNAMIC;
+    std::vector<PxActor *> actors(mScene->getNbActors(types));
+    mScene->getActors(types, actors.data(),
+                      static_cast<PxU32>(actors.size()));
+    for (PxActor *actor : actors)
+      actor->release();
+  }
+  if (mScene) {
     mScene->release();
-  if (mDispatcher)
+    mScene = nullptr;
+  }
+  if (mDispatcher) {
     mDispatcher->release();
-  if (mPhysics)
+    mDispatcher = nullptr;
+  }
+  if (mMaterial) {
+    mMaterial->release();
+    mMaterial = nullptr;
+  }
+  if (mSdk) {
+    // The SDK belongs to the world this one was created from
+    mPhysics = nullptr;
+    mSdk = nullptr;
+  }
+  if (mPhysics) {
     mPhysics->release();
+    mPhysics = nullptr;
+  }
 
   if (mPvd) {
     PxPvdTransport *transport = mPvd->getTransport();
     mPvd->release();
+    mPvd = nullptr;
     if (transport)
       transport->release();
   }
-  if (mFoundation)
+  if (mFoundation) {
     mFoundation->release();
+    mFoundation = nullptr;
+  }
 }
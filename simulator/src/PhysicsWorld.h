@@ -1,37 +1,182 @@
 #pragma once
 
+#include "PhysicsAllocator.h"
 #include "PxPhysicsAPI.h"
 #include "cooking/PxCooking.h"
+#include <array>
 #include <iostream>
+#include <string>
+#include <unordered_map>
 
 using namespace physx;
 
+// VEX field: 12 ft square centred on the origin
+constexpr float kFieldHalfExtent = 1.8288f;
+
+// Dynamic body classes that get their own sleep tuning
+enum class BodyClass { eBLOCK, eCHASSIS, eWHEEL };
+
+// How contacts keep a body awake
+enum class WakePolicy {
+  // PhysX island rules: anything touching an awake body stays awake
+  eISLAND,
+  // Contacts still wake the body, but once its own motion has been quiet
+  // for settleFrames steps it is put to sleep even if a jittering neighbour
+  // keeps its island awake. Meant for piles of resting blocks.
+  eSETTLE_QUIET,
+};
+
+struct SleepProfile {
+  // Mass-normalised kinetic energy below which the body may sleep /
+  // is stabilised (PhysX defaults at the default tolerance scale)
+  float sleepThreshold = 0.005f;
+  float stabilizationThreshold = 0.001f;
+  PxU32 positionIterations = 4;
+  PxU32 velocityIterations = 1;
+
+  WakePolicy wakePolicy = WakePolicy::eISLAND;
+  float settleLinearSpeed = 0.02f; // m/s, eSETTLE_QUIET only
+  float settleAngularSpeed = 0.1f; // rad/s, eSETTLE_QUIET only
+  int settleFrames = 15;           // Quiet steps before forcing sleep
+};
+
+// Blocks: higher thresholds so piles in goals stop jittering and sleep
+inline SleepProfile DefaultBlockSleepProfile() {
+  SleepProfile p;
+  p.sleepThreshold = 0.01f;
+  p.stabilizationThreshold = 0.005f;
+  p.wakePolicy = WakePolicy::eSETTLE_QUIET;
+  return p;
+}
+
+// Startup options for the PhysX world
+struct PhysicsConfig {
+  bool enablePvd = true;             // Connect to the PhysX Visual Debugger
+  PxU32 workerThreads = 2;           // CPU dispatcher worker threads
+  bool enhancedDeterminism = false;  // Bit-exact replays (slightly slower)
+  bool trackAllocationNames = true;  // Per-name stats (PhysX passes names)
+  bool poolSmallAllocations = false; // Serve <=256B requests from free lists
+
+  // Broadphase algorithm. MBP needs world regions, see
+  // PhysicsWorld::ConfigureBroadPhaseRegions.
+  PxBroadPhaseType::Enum broadPhase = PxBroadPhaseType::eABP;
+  PxU32 mbpSubdivisions = 4; // MBP regions per side (NxN grid)
+
+  // Sleeping. The wake counter reset value is scene-wide in PhysX.
+  bool enableStabilization = true;
+  float wakeCounterReset = 0.4f; // Seconds a woken body stays awake
+  SleepProfile blockSleep = DefaultBlockSleepProfile();
+  SleepProfile chassisSleep;
+  SleepProfile wheelSleep;
+};
+
+// "sap" | "mbp" | "abp" <-> PxBroadPhaseType
+bool ParseBroadPhaseType(const std::string &name, PxBroadPhaseType::Enum &out);
+const char *BroadPhaseTypeName(PxBroadPhaseType::Enum type);
+
+// Wall-clock split of the last Update()
+struct StepTiming {
+  double collideMs = 0.0; // Broadphase + narrowphase (collide/fetchCollision)
+  double solveMs = 0.0;   // Solver + integration (advance/fetchResults)
+};
+
 class PhysicsWorld {
 public:
   PhysicsWorld();
   ~PhysicsWorld();
 
-  void Initialize();
+  void Initialize(const PhysicsConfig &config = PhysicsConfig());
+  // Creates only a scene (with its own dispatcher and default material) on
+  // the foundation and PxPhysics of the already initialized `sdk`. PhysX
+  // allows one foundation per process, so this is how independent worlds
+  // run side by side on several threads. `sdk` must outlive this world,
+  // and allocator stats are those of `sdk` (shared by every such world).
+  void InitializeShared(PhysicsWorld &sdk,
+                        const PhysicsConfig &config = PhysicsConfig());
   void Cleanup();
 
   // Simulation
   void Update(float deltaTime);
+  const StepTiming &GetLastStepTiming() const { return mLastStepTiming; }
+
+  // Sizes the broadphase to the field. For MBP this builds an NxN grid of
+  // regions over the field AABB (plus a margin for things pushed off the
+  // edge); other broadphases only record the bounds. Call once the static
+  // field body exists.
+  void ConfigureBroadPhaseRegions(const PxBounds3 &fieldBounds);
+  const PxBounds3 &GetWorldBounds() const { return mWorldBounds; }
+
+  // Shapes that left every MBP region (and stopped colliding)
+  PxU32 GetOutOfBoundsCount() const { return mBroadPhaseCallback.outOfBounds; }
+
+  // Applies the class's sleep profile to a body that is already in the
+  // scene and, for eSETTLE_QUIET, starts tracking it. Bodies must be
+  // unregistered before they are released.
+  void RegisterBody(PxRigidDynamic *body, BodyClass bodyClass);
+  void UnregisterBody(PxRigidDynamic *body);
+  const SleepProfile &GetSleepProfile(BodyClass bodyClass) const;
+
+  // Awake dynamic bodies after the last Update(), and a ring of the last
+  // kAwakeHistorySize values (oldest at GetAwakeHistoryOffset())
+  static constexpr int kAwakeHistorySize = 240;
+  PxU32 GetAwakeBodyCount() const { return mAwakeBodies; }
+  const float *GetAwakeHistory() const { return mAwakeHistory.data(); }
+  int GetAwakeHistoryOffset() const { return mAwakeHistoryPos; }
 
   // Getters
   PxPhysics *GetPhysics() const { return mPhysics; }
   PxScene *GetScene() const { return mScene; }
   PxMaterial *GetDefaultMaterial() const { return mMaterial; }
+  const PhysicsConfig &GetConfig() const { return mConfig; }
+
+  // Memory
+  AllocatorStats GetAllocatorStats() const { return GetAllocator().GetStats(); }
+  const TrackingAllocator &GetAllocator() const {
+    return mSdk ? mSdk->mAllocator : mAllocator;
+  }
+  // PhysX heap allocations made during the most recent Update()
+  uint64_t GetLastStepAllocations() const { return mLastStepAllocs; }
 
 private:
+  struct BroadPhaseCallback : public PxBroadPhaseCallback {
+    PxU32 outOfBounds = 0;
+    void onObjectOutOfBounds(PxShape &, PxActor &) override { outOfBounds++; }
+    void onObjectOutOfBounds(PxAggregate &, PxActor &) override {
+      outOfBounds++;
+    }
+  };
+
+  struct SettleState {
+    BodyClass bodyClass;
+    int quietFrames;
+  };
+
+  void CreateScene();
+  void UpdateSleepState();
+
+  PhysicsConfig mConfig;
+  BroadPhaseCallback mBroadPhaseCallback;
+
+  // Sleep tracking
+  std::unordered_map<PxRigidDynamic *, SettleState> mSettleBodies;
+  PxU32 mAwakeBodies = 0;
+  std::array<float, kAwakeHistorySize> mAwakeHistory = {};
+  int mAwakeHistoryPos = 0;
+
+  PxBounds3 mWorldBounds = PxBounds3::empty();
+  StepTiming mLastStepTiming;
+
   // Core PhysX Objects
   PxFoundation *mFoundation = nullptr;
   PxPhysics *mPhysics = nullptr;
   PxDefaultCpuDispatcher *mDispatcher = nullptr;
   PxScene *mScene = nullptr;
   PxMaterial *mMaterial = nullptr;
-  PxPvd *mPvd = nullptr; // Visual Debugger
+  PxPvd *mPvd = nullptr;        // Visual Debugger
+  PhysicsWorld *mSdk = nullptr; // Owner of mPhysics when initialized shared
 
   // Memory Management
-  PxDefaultAllocator mAllocator;
+  TrackingAllocator mAllocator;
   PxDefaultErrorCallback mErrorCallback;
+  uint64_t mLastStepAllocs = 0;
 };
@@ -1,26 +1,96 @@
 #include "Robot.h"
+#include "PhysicsWorld.h"
 #include "SimulationFilter.h"
 #include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <iostream>
 
+// --- RobotConfig ---
+// Values SetRobotParam accepts; PhysX rejects negative drives, friction and
+// damping, and the wheel speed turns power into m/s
+enum class RobotParamLimit { eNON_NEGATIVE, ePOSITIVE };
+
+struct RobotParam {
+  const char *name;
+  float RobotConfig::*field;
+  RobotParamLimit limit;
+};
+
+static const RobotParam kRobotParams[] = {
+    {"drive_torque", &RobotConfig::driveTorque,
+     RobotParamLimit::eNON_NEGATIVE},
+    {"max_wheel_speed", &RobotConfig::maxWheelSpeed,
+     RobotParamLimit::ePOSITIVE},
+    {"wheel_static_friction", &RobotConfig::wheelStaticFriction,
+     RobotParamLimit::eNON_NEGATIVE},
+    {"wheel_dynamic_friction", &RobotConfig::wheelDynamicFriction,
+     RobotParamLimit::eNON_NEGATIVE},
+    {"linear_damping", &RobotConfig::linearDamping,
+     RobotParamLimit::eNON_NEGATIVE},
+    {"angular_damping", &RobotConfig::angularDamping,
+     RobotParamLimit::eNON_NEGATIVE},
+    {"intake_range", &RobotConfig::intakeRange,
+     RobotParamLimit::eNON_NEGATIVE},
+};
+
+const std::vector<std::string> &GetRobotParamNames() {
+  static const std::vector<std::string> names = [] {
+    std::vector<std::string> out;
+    for (const RobotParam &param : kRobotParams)
+      out.push_back(param.name);
+    return out;
+  }();
+  return names;
+}
+
+bool SetRobotParam(RobotConfig &config, const std::string &name,
+                   float value) {
+  for (const RobotParam &param : kRobotParams) {
+    if (name == param.name) {
+      // Written so NaN fails both
+      bool valid = param.limit == RobotParamLimit::ePOSITIVE ? value > 0.0f
+                                                            : value >= 0.0f;
+      if (!valid)
+        return false;
+      config.*param.field = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool GetRobotParam(const RobotConfig &config, const std::string &name,
+                   float &value) {
+  for (const RobotParam &param : kRobotParams) {
+    if (name == param.name) {
+      value = config.*param.field;
+      return true;
+    }
+  }
+  return false;
+}
+
+// --- Robot ---
 Robot::Robot()
-    : mChassis(nullptr), mThrottleInput(0.0f), mTurnInput(0.0f),
-      mWheelMaterial(nullptr) {}
+    : mChassis(nullptr), mPrevPose(PxIdentity), mThrottleInput(0.0f),
+      mTurnInput(0.0f), mWheelMaterial(nullptr) {}
 
 Robot::~Robot() {
   // Physics objects are released by the scene/physics release
 }
 
 void Robot::Initialize(PxPhysics *physics, PxScene *scene, PxMaterial *material,
-                       PxVec3 startPos) {
+                       PxVec3 startPos, const RobotConfig &config) {
+  mConfig = config;
+
   // 1. Create Chassis with a simple box (mesh hulls cause instability)
   mChassis = physics->createRigidDynamic(PxTransform(startPos));
   if (!mChassis) {
     std::cerr << "[Robot] Failed to create chassis!" << std::endl;
     return;
   }
+  mPrevPose = PxTransform(startPos);
 
   // Simple box matching robot footprint
   PxShape *chassisShape = physics->createShape(
@@ -36,11 +106,12 @@ void Robot::Initialize(PxPhysics *physics, PxScene *scene, PxMaterial *material,
                      FilterGroup::eCHASSIS | FilterGroup::eBLOCK);
 
   // Damping
-  mChassis->setLinearDamping(0.5f);
-  mChassis->setAngularDamping(0.05f);
+  mChassis->setLinearDamping(mConfig.linearDamping);
+  mChassis->setAngularDamping(mConfig.angularDamping);
 
   // Create slippery material for wheels (allows skid-steering)
-  mWheelMaterial = physics->createMaterial(0.2f, 0.2f, 0.0f);
+  mWheelMaterial = physics->createMaterial(mConfig.wheelStaticFriction,
+                                           mConfig.wheelDynamicFriction, 0.0f);
 
   // 2. Create Wheels
   CreateWheels(physics, scene, mWheelMaterial);
@@ -49,20 +120,31 @@ void Robot::Initialize(PxPhysics *physics, PxScene *scene, PxMaterial *material,
             << ", " << startPos.z << ")" << std::endl;
 }
 
-void Robot::CreateWheels(PxPhysics *physics, PxScene *scene,
-                         PxMaterial *material) {
+void Robot::Initialize(PhysicsWorld &world, PxVec3 startPos,
+                       const RobotConfig &config) {
+  Initialize(world.GetPhysics(), world.GetScene(), world.GetDefaultMaterial(),
+             startPos, config);
+  world.RegisterBody(mChassis, BodyClass::eCHASSIS);
+  for (PxRigidDynamic *wheel : mWheels)
+    world.RegisterBody(wheel, BodyClass::eWHEEL);
+}
+
+PxTransform Robot::GetWheelLocalPose(int index) const {
+  float side = index < 4 ? -1.0f : 1.0f;
   float xOffset = ROBOT_WIDTH / 2.0f;
   float zSpacing = ROBOT_LENGTH / 3.0f;
   float zStart = -ROBOT_LENGTH / 2.0f;
+  return PxTransform(side * xOffset, -0.20f, zStart + (index % 4) * zSpacing);
+}
 
-  for (int side = -1; side <= 1; side += 2) {
+void Robot::CreateWheels(PxPhysics *physics, PxScene *scene,
+                         PxMaterial *material) {
+  for (int side = 0; side < 2; side++) {
     for (int i = 0; i < 4; i++) {
-      float zPos = zStart + (i * zSpacing);
-
       PxShape *wheelShape = physics->createShape(
           PxCapsuleGeometry(WHEEL_RADIUS, WHEEL_WIDTH / 2.0f), *material);
 
-      PxTransform wheelLocalPose(side * xOffset, -0.20f, zPos);
+      PxTransform wheelLocalPose = GetWheelLocalPose(side * 4 + i);
       PxTransform chassisPose = mChassis->getGlobalPose();
       PxTransform wheelGlobalPose = chassisPose.transform(wheelLocalPose);
 
@@ -88,42 +170,84 @@ void Robot::CreateWheels(PxPhysics *physics, PxScene *scene,
 
       joint->setDriveVelocity(0.0f);
       joint->setRevoluteJointFlag(PxRevoluteJointFlag::eDRIVE_ENABLED, true);
-      joint->setDriveForceLimit(DRIVE_TORQUE);
+      joint->setDriveForceLimit(mConfig.driveTorque);
 
       mWheelJoints.push_back(joint);
     }
   }
 }
 
+void Robot::Reset(const PxTransform &pose, const RobotConfig &config) {
+  if (!mChassis)
+    return;
+
+  for (HeldBlock &hb : mHeldBlocks) {
+    if (hb.joint)
+      hb.joint->release();
+    if (hb.block)
+      hb.block->held = false;
+  }
+  mHeldBlocks.clear();
+
+  mConfig = config;
+  mChassis->setLinearDamping(mConfig.linearDamping);
+  mChassis->setAngularDamping(mConfig.angularDamping);
+  mWheelMaterial->setStaticFriction(mConfig.wheelStaticFriction);
+  mWheelMaterial->setDynamicFriction(mConfig.wheelDynamicFriction);
+
+  mChassis->setGlobalPose(pose);
+  mChassis->setLinearVelocity(PxVec3(0));
+  mChassis->setAngularVelocity(PxVec3(0));
+  for (size_t i = 0; i < mWheels.size(); i++) {
+    mWheels[i]->setGlobalPose(
+        pose.transform(GetWheelLocalPose(static_cast<int>(i))));
+    mWheels[i]->setLinearVelocity(PxVec3(0));
+    mWheels[i]->setAngularVelocity(PxVec3(0));
+  }
+  for (PxRevoluteJoint *joint : mWheelJoints) {
+    joint->setDriveVelocity(0.0f);
+    joint->setDriveForceLimit(mConfig.driveTorque);
+  }
+  mPrevPose = pose;
+  mThrottleInput = 0.0f;
+  mTurnInput = 0.0f;
+}
+
 void Robot::Update(float dt) {
   if (!mChassis)
     return;
+  mPrevPose = mChassis->getGlobalPose();
 
   // Direct left/right drive (mThrottleInput = left, mTurnInput = right)
   float leftInput = std::max(-1.0f, std::min(1.0f, mThrottleInput));
   float rightInput = std::max(-1.0f, std::min(1.0f, mTurnInput));
 
-  float maxVelocity = 20.0f; // Rad/s
+  float maxVelocity = mConfig.maxWheelSpeed;
 
   for (size_t i = 0; i < mWheelJoints.size(); i++) {
     PxRevoluteJoint *joint = mWheelJoints[i];
     float input = (i < 4) ? leftInput : rightInput;
     joint->setDriveVelocity(input * maxVelocity);
-    joint->setDriveForceLimit(DRIVE_TORQUE);
+    joint->setDriveForceLimit(mConfig.driveTorque);
   }
 }
 
-glm::mat4 Robot::GetTransformMatrix(float visualScale) const {
+glm::mat4 Robot::GetTransformMatrix(float visualScale, float alpha) const {
   if (!mChassis)
     return glm::mat4(1.0f);
 
   PxTransform pose = mChassis->getGlobalPose();
+  const PxTransform &prev = mPrevPose;
 
-  glm::quat q(pose.q.w, pose.q.x, pose.q.y, pose.q.z);
+  glm::quat q = glm::slerp(glm::quat(prev.q.w, prev.q.x, prev.q.y, prev.q.z),
+                           glm::quat(pose.q.w, pose.q.x, pose.q.y, pose.q.z),
+                           alpha);
   glm::mat4 rotation = glm::mat4_cast(q);
 
-  glm::mat4 translation =
-      glm::translate(glm::mat4(1.0f), glm::vec3(pose.p.x, pose.p.y, pose.p.z));
+  glm::vec3 position =
+      glm::mix(glm::vec3(prev.p.x, prev.p.y, prev.p.z),
+               glm::vec3(pose.p.x, pose.p.y, pose.p.z), alpha);
+  glm::mat4 translation = glm::translate(glm::mat4(1.0f), position);
 
   glm::mat4 scale = glm::scale(glm::mat4(1.0f), glm::vec3(visualScale));
 
@@ -155,7 +279,7 @@ bool Robot::TryIntake(GameBlock &block, PxPhysics *physics) {
   PxVec3 blockPos = block.body->getGlobalPose().p;
   float dist = (frontPos - blockPos).magnitude();
 
-  if (dist > INTAKE_RANGE)
+  if (dist > mConfig.intakeRange)
     return false;
 
   // Teleport block to inside the robot
@@ -3,12 +3,35 @@
 #include <PxPhysicsAPI.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <string>
 #include <vector>
 
 #include "GameBlock.h"
 
 using namespace physx;
 
+class PhysicsWorld;
+
+// Tunable drivetrain and intake parameters. Defaults are the hand-tuned
+// values the simulator has always used.
+struct RobotConfig {
+  float driveTorque = 500.0f;        // Wheel joint drive force limit
+  float maxWheelSpeed = 20.0f;       // rad/s at full input
+  float wheelStaticFriction = 0.2f;  // Low so the drive can skid-steer
+  float wheelDynamicFriction = 0.2f;
+  float linearDamping = 0.5f;        // Chassis
+  float angularDamping = 0.05f;      // Chassis
+  float intakeRange = 0.35f;         // m from the front face to a block
+};
+
+// Parameter names used by sweep files ("drive_torque", "intake_range", ...)
+const std::vector<std::string> &GetRobotParamNames();
+// False for an unknown name, a negative value, or a max_wheel_speed that is
+// not > 0
+bool SetRobotParam(RobotConfig &config, const std::string &name, float value);
+bool GetRobotParam(const RobotConfig &config, const std::string &name,
+                   float &value);
+
 class Robot {
 public:
   Robot();
@@ -16,7 +39,18 @@ public:
 
   // Initialize the robot physics (chassis + 8-wheel drive)
   void Initialize(PxPhysics *physics, PxScene *scene, PxMaterial *material,
-                  PxVec3 startPos);
+                  PxVec3 startPos, const RobotConfig &config = RobotConfig());
+  // Same, using the world's default material, and registers the chassis
+  // and wheels with the world's sleep profiles
+  void Initialize(PhysicsWorld &world, PxVec3 startPos,
+                  const RobotConfig &config = RobotConfig());
+
+  // Puts the robot at rest at `pose` with `config` applied, reusing its
+  // bodies instead of rebuilding them. Held blocks are dropped where they
+  // are (still without collision); the caller re-places them.
+  void Reset(const PxTransform &pose, const RobotConfig &config);
+
+  const RobotConfig &GetConfig() const { return mConfig; }
 
   // Update simulation (apply motor forces)
   void Update(float dt);
@@ -27,8 +61,16 @@ public:
     mTurnInput = right;    // Repurposed: right side power
   }
 
-  // Get the model transform matrix from physics pose
-  glm::mat4 GetTransformMatrix(float visualScale = 0.01f) const;
+  // Left/right power as last set, before clamping
+  float GetLeftInput() const { return mThrottleInput; }
+  float GetRightInput() const { return mTurnInput; }
+
+  // Get the model transform matrix from physics pose. `alpha` blends from
+  // the pose before the last Update (0) to the current one (1); rendering
+  // passes the fixed-step accumulator fraction so motion stays smooth when
+  // the frame rate and physics rate differ.
+  glm::mat4 GetTransformMatrix(float visualScale = 0.01f,
+                               float alpha = 1.0f) const;
 
   // --- Intake/Outtake ---
   // Try to pick up a block (checks proximity to front of robot). Max 8 blocks.
@@ -47,12 +89,24 @@ public:
 
   // Accessors
   PxRigidDynamic *GetChassis() const { return mChassis; }
+  const std::vector<PxRigidDynamic *> &GetWheels() const { return mWheels; }
+  // Spin of wheel `index` about its axle, rad/s (0-3 left, 4-7 right)
+  float GetWheelSpeed(size_t index) const {
+    return mWheelJoints[index]->getVelocity();
+  }
+  float GetWheelRadius() const { return WHEEL_RADIUS; }
+  // Lives until the PxPhysics is released; worlds on a shared SDK release
+  // it themselves
+  PxMaterial *GetWheelMaterial() const { return mWheelMaterial; }
 
 private:
   void CreateWheels(PxPhysics *physics, PxScene *scene, PxMaterial *material);
+  // Wheel `index` (0-3 the -X side, 4-7 the +X side) relative to the chassis
+  PxTransform GetWheelLocalPose(int index) const;
 
   // Physics objects
   PxRigidDynamic *mChassis;
+  PxTransform mPrevPose; // Chassis pose before the last step
   std::vector<PxRigidDynamic *> mWheels;
   std::vector<PxRevoluteJoint *> mWheelJoints;
   PxMaterial *mWheelMaterial;
@@ -68,6 +122,7 @@ private:
   // Drive state
   float mThrottleInput;
   float mTurnInput;
+  RobotConfig mConfig;
 
   // Configuration (VEX Robot dimensions)
   const float ROBOT_WIDTH = 0.35f;
@@ -76,7 +131,5 @@ private:
   const float WHEEL_WIDTH = 0.025f;
   const float CHASSIS_DENSITY = 50.0f;
   const float WHEEL_DENSITY = 10.0f;
-  const float DRIVE_TORQUE = 500.0f;
-  const float INTAKE_RANGE = 0.35f;
   const float OUTTAKE_IMPULSE = 0.5f;
 };
@@ -0,0 +1,60 @@
+#include "RobotTelemetry.h"
+
+static const char *kPoseFields[] = {"x", "y", "z", "qx", "qy", "qz", "qw"};
+static const size_t kWheelCount = 8; // Robot::CreateWheels
+
+static float *WritePose(float *out, const PxTransform &pose) {
+  const float values[] = {pose.p.x, pose.p.y, pose.p.z, pose.q.x,
+                          pose.q.y, pose.q.z, pose.q.w};
+  for (float value : values)
+    *out++ = value;
+  return out;
+}
+
+std::vector<std::string> MakeRobotTelemetryColumns(int blockSlots) {
+  std::vector<std::string> columns;
+  for (const char *field : kPoseFields)
+    columns.push_back(std::string("chassis_") + field);
+  for (const char *field : {"vx", "vy", "vz", "wx", "wy", "wz"})
+    columns.push_back(std::string("chassis_") + field);
+  for (size_t i = 0; i < kWheelCount; i++)
+    columns.push_back("wheel" + std::to_string(i) + "_speed");
+  columns.push_back("left_command");
+  columns.push_back("right_command");
+  columns.push_back("held_count");
+  for (int b = 0; b < blockSlots; b++) {
+    std::string prefix = "block" + std::to_string(b) + "_";
+    for (const char *field : kPoseFields)
+      columns.push_back(prefix + field);
+    columns.push_back(prefix + "held");
+  }
+  return columns;
+}
+
+void FillRobotTelemetry(float *row, const Robot &robot,
+                        const std::list<GameBlock> &blocks, int blockSlots) {
+  const PxRigidDynamic *chassis = robot.GetChassis();
+  row = WritePose(row, chassis->getGlobalPose());
+  PxVec3 linear = chassis->getLinearVelocity();
+  PxVec3 angular = chassis->getAngularVelocity();
+  for (float value : {linear.x, linear.y, linear.z, angular.x, angular.y,
+                      angular.z})
+    *row++ = value;
+  for (size_t i = 0; i < kWheelCount; i++)
+    *row++ = robot.GetWheelSpeed(i);
+  *row++ = robot.GetLeftInput();
+  *row++ = robot.GetRightInput();
+  *row++ = static_cast<float>(robot.GetHeldCount());
+
+  int slot = 0;
+  for (const GameBlock &block : blocks) {
+    if (slot++ == blockSlots)
+      break;
+    if (!block.body) {
+      row += 8; // Left NaN
+      continue;
+    }
+    row = WritePose(row, block.body->getGlobalPose());
+    *row++ = block.held ? 1.0f : 0.0f;
+  }
+}
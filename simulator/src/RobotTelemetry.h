@@ -0,0 +1,21 @@
+#pragma once
+
+#include "GameBlock.h"
+#include "Robot.h"
+
+#include <list>
+#include <string>
+#include <vector>
+
+// Telemetry row layout for one robot and its blocks (TelemetryLog.h):
+// chassis pose (chassis_x/y/z, chassis_qx/qy/qz/qw) and velocity
+// (chassis_vx/vy/vz, chassis_wx/wy/wz), wheel0_speed..wheel7_speed,
+// left_command, right_command and held_count, then for each of
+// `blockSlots` blocks in spawn order blockN_x/y/z, blockN_qx/qy/qz/qw and
+// blockN_held. Slots without a block stay NaN; blocks past the last slot
+// are not logged.
+std::vector<std::string> MakeRobotTelemetryColumns(int blockSlots);
+
+// Fills a row laid out as above (from TelemetryWriter::BeginRow)
+void FillRobotTelemetry(float *row, const Robot &robot,
+                        const std::list<GameBlock> &blocks, int blockSlots);
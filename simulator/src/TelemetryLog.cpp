@@ -0,0 +1,355 @@
+#include "TelemetryLog.h"
+
+#include "Lz4Block.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+static const char kMagic[4] = {'V', 'X', 'T', 'L'};
+static const uint32_t kTelemetryVersion = 1;
+static const uint8_t kCodecRaw = 0;
+static const uint8_t kCodecLz4 = 1;
+// New chunks are dropped once this many full ones are queued for the writer
+static const size_t kMaxPending = 4;
+
+template <typename T> static bool ReadPod(std::istream &in, T &value) {
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+template <typename T> static void WritePod(std::ostream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// XOR with the previous row, then byte planes: plane b holds byte b of
+// every row. `out` is rows * 4 bytes.
+static void EncodeColumn(const float *values, uint32_t rows, uint8_t *out) {
+  uint32_t prev = 0;
+  for (uint32_t r = 0; r < rows; r++) {
+    uint32_t bits;
+    std::memcpy(&bits, &values[r], sizeof(bits));
+    uint32_t delta = bits ^ prev;
+    prev = bits;
+    for (uint32_t b = 0; b < 4; b++)
+      out[b * rows + r] = static_cast<uint8_t>(delta >> (8 * b));
+  }
+}
+
+static void DecodeColumn(const uint8_t *in, uint32_t rows, float *values) {
+  uint32_t prev = 0;
+  for (uint32_t r = 0; r < rows; r++) {
+    uint32_t delta = 0;
+    for (uint32_t b = 0; b < 4; b++)
+      delta |= static_cast<uint32_t>(in[b * rows + r]) << (8 * b);
+    prev ^= delta;
+    std::memcpy(&values[r], &prev, sizeof(prev));
+  }
+}
+
+// --- TelemetryWriter ---
+
+bool TelemetryWriter::Open(const std::string &path,
+                           const std::vector<std::string> &columns,
+                           float stepTime, std::string *err,
+                           uint32_t chunkRows) {
+  Close();
+  if (columns.empty() || chunkRows == 0) {
+    if (err)
+      *err = "No columns to log";
+    return false;
+  }
+  mFile.open(path, std::ios::binary | std::ios::trunc);
+  if (!mFile) {
+    if (err)
+      *err = "Cannot write " + path;
+    return false;
+  }
+
+  mColumns = static_cast<uint32_t>(columns.size());
+  mChunkRows = chunkRows;
+  mFile.write(kMagic, sizeof(kMagic));
+  WritePod(mFile, kTelemetryVersion);
+  WritePod(mFile, stepTime);
+  WritePod(mFile, mChunkRows);
+  WritePod(mFile, mColumns);
+  for (const std::string &name : columns) {
+    uint16_t length = static_cast<uint16_t>(name.size());
+    WritePod(mFile, length);
+    mFile.write(name.data(), length);
+  }
+  mFile.flush();
+
+  // Every chunk up front: the one being filled, kMaxPending queued and the
+  // one being written, so Submit never allocates on the sim thread
+  mRow.assign(mColumns, 0.0f);
+  mFilling = std::make_unique<Chunk>();
+  mFilling->data.resize(static_cast<size_t>(mColumns) * mChunkRows);
+  for (size_t i = 0; i < kMaxPending + 1; i++) {
+    mSpare.push_back(std::make_unique<Chunk>());
+    mSpare.back()->data.resize(mFilling->data.size());
+  }
+  mRows = 0;
+  mDropped = 0;
+  mBytes = static_cast<uint64_t>(mFile.tellp());
+  mClosing = false;
+  mThread = std::thread(&TelemetryWriter::WriterLoop, this);
+  return true;
+}
+
+float *TelemetryWriter::BeginRow() {
+  std::fill(mRow.begin(), mRow.end(), std::numeric_limits<float>::quiet_NaN());
+  return mRow.data();
+}
+
+void TelemetryWriter::CommitRow() {
+  if (mFilling->rows == 0)
+    mFilling->firstRow = mRows;
+  uint32_t r = mFilling->rows++;
+  for (uint32_t c = 0; c < mColumns; c++)
+    mFilling->data[static_cast<size_t>(c) * mChunkRows + r] = mRow[c];
+  mRows++;
+  if (mFilling->rows == mChunkRows)
+    Submit();
+}
+
+// Hands the filled chunk to the writer and continues in a spare one. With
+// fewer than kMaxPending queued a spare always exists; the check on it only
+// guards the pool size.
+void TelemetryWriter::Submit() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mPending.size() >= kMaxPending || mSpare.empty()) {
+    mDropped += mFilling->rows;
+    mFilling->rows = 0;
+    return;
+  }
+  mPending.push_back(std::move(mFilling));
+  mFilling = std::move(mSpare.back());
+  mSpare.pop_back();
+  mFilling->rows = 0;
+  mWake.notify_one();
+}
+
+void TelemetryWriter::Close() {
+  if (!IsOpen())
+    return;
+  {
+    // The partial chunk is queued whatever the backlog
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mFilling->rows > 0)
+      mPending.push_back(std::move(mFilling));
+    mClosing = true;
+  }
+  mWake.notify_one();
+  mThread.join();
+  mFile.close();
+  mPending.clear();
+  mSpare.clear();
+  mFilling.reset();
+  if (mDropped > 0)
+    std::cerr << "[Telemetry] Writer fell behind; dropped " << mDropped
+              << " of " << mRows << " rows" << std::endl;
+}
+
+void TelemetryWriter::WriterLoop() {
+  while (true) {
+    std::unique_ptr<Chunk> chunk;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWake.wait(lock, [&] { return !mPending.empty() || mClosing; });
+      if (mPending.empty())
+        return;
+      chunk = std::move(mPending.front());
+      mPending.pop_front();
+    }
+    WriteChunk(*chunk);
+    std::lock_guard<std::mutex> lock(mMutex);
+    mSpare.push_back(std::move(chunk));
+  }
+}
+
+void TelemetryWriter::WriteChunk(const Chunk &chunk) {
+  const uint32_t rows = chunk.rows;
+  const size_t rawSize = static_cast<size_t>(rows) * sizeof(float);
+  const size_t bound = Lz4CompressBound(rawSize);
+  mShuffled.resize(rawSize);
+  mCompressed.resize(bound * mColumns);
+
+  // Encode every column first: the chunk header needs their sizes
+  std::vector<uint8_t> codecs(mColumns);
+  std::vector<uint32_t> sizes(mColumns);
+  for (uint32_t c = 0; c < mColumns; c++) {
+    EncodeColumn(&chunk.data[static_cast<size_t>(c) * mChunkRows], rows,
+                 mShuffled.data());
+    uint8_t *out = &mCompressed[c * bound];
+    size_t size = Lz4Compress(mShuffled.data(), rawSize, out, bound);
+    if (size == 0 || size >= rawSize) {
+      std::memcpy(out, mShuffled.data(), rawSize);
+      codecs[c] = kCodecRaw;
+      size = rawSize;
+    } else {
+      codecs[c] = kCodecLz4;
+    }
+    sizes[c] = static_cast<uint32_t>(size);
+  }
+
+  uint64_t bytes = sizeof(chunk.firstRow) + sizeof(rows);
+  WritePod(mFile, chunk.firstRow);
+  WritePod(mFile, rows);
+  for (uint32_t c = 0; c < mColumns; c++) {
+    WritePod(mFile, codecs[c]);
+    WritePod(mFile, sizes[c]);
+    bytes += sizeof(codecs[c]) + sizeof(sizes[c]) + sizes[c];
+  }
+  for (uint32_t c = 0; c < mColumns; c++) {
+    mFile.write(reinterpret_cast<const char *>(&mCompressed[c * bound]),
+                sizes[c]);
+  }
+  // A crash loses at most the chunks not yet written
+  mFile.flush();
+  mBytes += bytes;
+}
+
+// --- TelemetryReader ---
+
+bool TelemetryReader::Open(const std::string &path, std::string *err) {
+  mFile.close();
+  mFile.clear();
+  mNames.clear();
+  mChunks.clear();
+  mRows = 0;
+  mFile.open(path, std::ios::binary);
+  if (!mFile) {
+    if (err)
+      *err = "Cannot open " + path;
+    return false;
+  }
+  mFile.seekg(0, std::ios::end);
+  const uint64_t fileSize = static_cast<uint64_t>(mFile.tellg());
+  mFile.seekg(0);
+
+  char magic[4];
+  uint32_t version = 0, chunkRows = 0, columns = 0;
+  if (!mFile.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      !ReadPod(mFile, version) || version != kTelemetryVersion ||
+      !ReadPod(mFile, mStepTime) || !ReadPod(mFile, chunkRows) ||
+      !ReadPod(mFile, columns)) {
+    if (err)
+      *err = path + " is not a telemetry log (version " +
+             std::to_string(kTelemetryVersion) + ")";
+    return false;
+  }
+  // Each name takes at least its u16 length, so a count the file cannot
+  // hold is corrupt; rejected before anything is sized by it
+  if (columns > (fileSize - static_cast<uint64_t>(mFile.tellg())) /
+                    sizeof(uint16_t)) {
+    if (err)
+      *err = path + ": truncated header";
+    return false;
+  }
+  mNames.reserve(columns);
+  for (uint32_t c = 0; c < columns; c++) {
+    uint16_t length = 0;
+    std::string name;
+    if (ReadPod(mFile, length)) {
+      name.resize(length);
+      mFile.read(&name[0], length);
+    }
+    if (!mFile) {
+      if (err)
+        *err = path + ": truncated header";
+      return false;
+    }
+    mNames.push_back(name);
+  }
+
+  // Index the chunks; stop at the first incomplete one
+  while (true) {
+    ChunkIndex chunk;
+    if (!ReadPod(mFile, chunk.firstRow) || !ReadPod(mFile, chunk.rows) ||
+        chunk.rows == 0 || chunk.rows > chunkRows)
+      break;
+    const uint64_t headerSize =
+        static_cast<uint64_t>(columns) * (sizeof(uint8_t) + sizeof(uint32_t));
+    if (headerSize > fileSize - static_cast<uint64_t>(mFile.tellg()))
+      break;
+    chunk.codecs.resize(columns);
+    chunk.sizes.resize(columns);
+    bool complete = true;
+    for (uint32_t c = 0; c < columns && complete; c++) {
+      complete = ReadPod(mFile, chunk.codecs[c]) &&
+                 ReadPod(mFile, chunk.sizes[c]);
+    }
+    if (!complete)
+      break;
+    uint64_t offset = static_cast<uint64_t>(mFile.tellg());
+    for (uint32_t c = 0; c < columns; c++) {
+      chunk.offsets.push_back(offset);
+      offset += chunk.sizes[c];
+    }
+    if (offset > fileSize)
+      break;
+    mFile.seekg(static_cast<std::streamoff>(offset));
+    mRows += chunk.rows;
+    mChunks.push_back(std::move(chunk));
+  }
+  mFile.clear();
+  return true;
+}
+
+void TelemetryReader::GetRowNumbers(std::vector<uint64_t> &out) const {
+  out.clear();
+  out.reserve(mRows);
+  for (const ChunkIndex &chunk : mChunks) {
+    for (uint32_t r = 0; r < chunk.rows; r++)
+      out.push_back(chunk.firstRow + r);
+  }
+}
+
+int TelemetryReader::FindColumn(const std::string &name) const {
+  for (size_t i = 0; i < mNames.size(); i++) {
+    if (mNames[i] == name)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+bool TelemetryReader::ReadColumn(size_t column, std::vector<float> &out,
+                                 std::string *err) {
+  if (column >= mNames.size()) {
+    if (err)
+      *err = "No column " + std::to_string(column);
+    return false;
+  }
+  out.resize(mRows);
+  std::vector<uint8_t> stored, shuffled;
+  size_t row = 0;
+  for (size_t i = 0; i < mChunks.size(); i++) {
+    const ChunkIndex &chunk = mChunks[i];
+    const size_t rawSize = static_cast<size_t>(chunk.rows) * sizeof(float);
+    stored.resize(chunk.sizes[column]);
+    mFile.seekg(static_cast<std::streamoff>(chunk.offsets[column]));
+    mFile.read(reinterpret_cast<char *>(stored.data()), stored.size());
+    bool ok = static_cast<bool>(mFile);
+    if (ok && chunk.codecs[column] == kCodecLz4) {
+      shuffled.resize(rawSize);
+      ok = Lz4Decompress(stored.data(), stored.size(), shuffled.data(),
+                         rawSize);
+    } else if (ok) {
+      ok = chunk.codecs[column] == kCodecRaw && stored.size() == rawSize;
+      shuffled.swap(stored);
+    }
+    if (!ok) {
+      if (err)
+        *err = "Chunk " + std::to_string(i) + " of " + mNames[column] +
+               " is corrupt";
+      mFile.clear();
+      return false;
+    }
+    DecodeColumn(shuffled.data(), chunk.rows, &out[row]);
+    row += chunk.rows;
+  }
+  return true;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Columnar log of one float per column per physics step. Rows are grouped
+// into chunks, and each column of a chunk is stored on its own: XORed with
+// the previous row, byte-shuffled (all first bytes, then all second
+// bytes...) and LZ4-compressed, so slowly changing or unused (NaN) columns
+// shrink to almost nothing and one column can be read without the rest.
+//
+// File ("VXTL"): u32 version, f32 step time, u32 chunk rows, u32 column
+// count, then each name as u16 length + bytes. Chunks follow: u64 first
+// row, u32 rows and per column a u8 codec (0 raw, 1 LZ4) and u32 size,
+// then the column data in the same order. A chunk cut short by a crash is
+// ignored on reading.
+
+// Sim thread fills rows; a background thread compresses and writes each
+// full chunk. Chunks come from a pool allocated by Open, so the step never
+// waits on the disk or allocates; once four full chunks are queued for the
+// writer, new ones are dropped and counted.
+class TelemetryWriter {
+public:
+  TelemetryWriter() = default;
+  ~TelemetryWriter() { Close(); }
+  TelemetryWriter(const TelemetryWriter &) = delete;
+  TelemetryWriter &operator=(const TelemetryWriter &) = delete;
+
+  bool Open(const std::string &path, const std::vector<std::string> &columns,
+            float stepTime, std::string *err = nullptr,
+            uint32_t chunkRows = 1024);
+  // Writes the partial chunk and waits for the writer thread
+  void Close();
+  bool IsOpen() const { return mThread.joinable(); }
+
+  // The next row, all NaN; fill it, then CommitRow
+  float *BeginRow();
+  void CommitRow();
+
+  uint64_t GetRowCount() const { return mRows; }
+  uint64_t GetDroppedRows() const { return mDropped; }
+  uint64_t GetBytesWritten() const { return mBytes; }
+
+private:
+  struct Chunk {
+    std::vector<float> data; // Column-major, chunkRows per column
+    uint64_t firstRow = 0;
+    uint32_t rows = 0;
+  };
+
+  void Submit();
+  void WriterLoop();
+  void WriteChunk(const Chunk &chunk);
+
+  std::ofstream mFile;
+  uint32_t mColumns = 0;
+  uint32_t mChunkRows = 0;
+  std::vector<float> mRow;
+  std::unique_ptr<Chunk> mFilling;
+  uint64_t mRows = 0;
+  uint64_t mDropped = 0;
+
+  // Shared with the writer thread
+  std::mutex mMutex;
+  std::condition_variable mWake;
+  std::deque<std::unique_ptr<Chunk>> mPending;
+  std::vector<std::unique_ptr<Chunk>> mSpare;
+  bool mClosing = false;
+  std::atomic<uint64_t> mBytes{0};
+  std::thread mThread;
+
+  // Writer thread scratch
+  std::vector<uint8_t> mShuffled;
+  std::vector<uint8_t> mCompressed;
+};
+
+class TelemetryReader {
+public:
+  bool Open(const std::string &path, std::string *err = nullptr);
+
+  const std::vector<std::string> &GetColumnNames() const { return mNames; }
+  int FindColumn(const std::string &name) const;
+  uint64_t GetRowCount() const { return mRows; }
+  float GetStepTime() const { return mStepTime; }
+
+  // Step number of every stored row, counted from the first CommitRow;
+  // dropped chunks leave gaps
+  void GetRowNumbers(std::vector<uint64_t> &out) const;
+
+  // Every stored row of one column; only that column is read and decoded
+  bool ReadColumn(size_t column, std::vector<float> &out,
+                  std::string *err = nullptr);
+
+private:
+  struct ChunkIndex {
+    uint64_t firstRow;
+    uint32_t rows;
+    std::vector<uint64_t> offsets; // Per column, from the file start
+    std::vector<uint32_t> sizes;
+    std::vector<uint8_t> codecs;
+  };
+
+  std::ifstream mFile;
+  std::vector<std::string> mNames;
+  std::vector<ChunkIndex> mChunks;
+  uint64_t mRows = 0;
+  float mStepTime = 0.0f;
+};
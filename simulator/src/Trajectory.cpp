@@ -0,0 +1,172 @@
+#include "Trajectory.h"
+
+#include "WaypointDriver.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Knot spacing for the centripetal parameterisation: sqrt of the chord
+static float Knot(const PxVec3 &a, const PxVec3 &b) {
+  float dx = b.x - a.x, dz = b.z - a.z;
+  return std::max(std::sqrt(std::sqrt(dx * dx + dz * dz)), 1e-4f);
+}
+
+// Point at `u` (0 - 1) between p1 and p2, Barry-Goldman form
+static PxVec3 CatmullRom(const PxVec3 &p0, const PxVec3 &p1, const PxVec3 &p2,
+                         const PxVec3 &p3, float u) {
+  float t0 = 0.0f;
+  float t1 = t0 + Knot(p0, p1);
+  float t2 = t1 + Knot(p1, p2);
+  float t3 = t2 + Knot(p2, p3);
+  float t = t1 + (t2 - t1) * u;
+  PxVec3 a1 = p0 * ((t1 - t) / (t1 - t0)) + p1 * ((t - t0) / (t1 - t0));
+  PxVec3 a2 = p1 * ((t2 - t) / (t2 - t1)) + p2 * ((t - t1) / (t2 - t1));
+  PxVec3 a3 = p2 * ((t3 - t) / (t3 - t2)) + p3 * ((t - t2) / (t3 - t2));
+  PxVec3 b1 = a1 * ((t2 - t) / (t2 - t0)) + a2 * ((t - t0) / (t2 - t0));
+  PxVec3 b2 = a2 * ((t3 - t) / (t3 - t1)) + a3 * ((t - t1) / (t3 - t1));
+  return b1 * ((t2 - t) / (t2 - t1)) + b2 * ((t - t1) / (t2 - t1));
+}
+
+static float FloorDistance(const PxVec3 &a, const PxVec3 &b) {
+  float dx = b.x - a.x, dz = b.z - a.z;
+  return std::sqrt(dx * dx + dz * dz);
+}
+
+bool Trajectory::Generate(const std::vector<PxVec3> &points,
+                          const TrajectoryLimits &limits,
+                          const float *startHeading, float spacing) {
+  mPoints.clear();
+  std::vector<PxVec3> knots;
+  for (const PxVec3 &p : points) {
+    if (knots.empty() || FloorDistance(knots.back(), p) > 1e-3f)
+      knots.push_back(PxVec3(p.x, 0.0f, p.z));
+  }
+  if (knots.size() < 2 || spacing <= 0.0f || limits.maxVelocity <= 0.0f ||
+      limits.maxAcceleration <= 0.0f)
+    return false;
+
+  // A start heading adds a knot a little way along it, so the spline
+  // leaves the first point that way rather than along the first chord
+  if (startHeading) {
+    float lead = std::min(0.25f * FloorDistance(knots[0], knots[1]), 0.15f);
+    PxVec3 along(std::sin(*startHeading), 0.0f, std::cos(*startHeading));
+    knots.insert(knots.begin() + 1, knots[0] + along * lead);
+  }
+
+  // Ends are extended straight out, so the path leaves the first point and
+  // arrives at the last along their chords
+  std::vector<PxVec3> ext;
+  ext.push_back(knots[0] * 2.0f - knots[1]);
+  ext.insert(ext.end(), knots.begin(), knots.end());
+  ext.push_back(knots.back() * 2.0f - knots[knots.size() - 2]);
+
+  std::vector<PxVec3> samples;
+  for (size_t i = 1; i + 2 < ext.size(); i++) {
+    float chord = FloorDistance(ext[i], ext[i + 1]);
+    int steps = std::max(1, static_cast<int>(std::ceil(chord / spacing)));
+    for (int s = 0; s < steps; s++) {
+      samples.push_back(CatmullRom(ext[i - 1], ext[i], ext[i + 1], ext[i + 2],
+                                   static_cast<float>(s) / steps));
+    }
+  }
+  samples.push_back(knots.back());
+
+  const size_t n = samples.size();
+  mPoints.resize(n);
+  std::vector<float> segment(n, 0.0f); // Length from sample i to i + 1
+  for (size_t i = 0; i + 1 < n; i++)
+    segment[i] = FloorDistance(samples[i], samples[i + 1]);
+
+  // Heading of each sample's outgoing chord; curvature from the turn
+  // between the chords either side
+  for (size_t i = 0; i < n; i++) {
+    TrajectoryPoint &p = mPoints[i];
+    p.position = samples[i];
+    size_t a = i + 1 < n ? i : i - 1;
+    p.heading = std::atan2(samples[a + 1].x - samples[a].x,
+                           samples[a + 1].z - samples[a].z);
+    p.distance = i > 0 ? mPoints[i - 1].distance + segment[i - 1] : 0.0f;
+  }
+  for (size_t i = 1; i + 1 < n; i++) {
+    float arc = 0.5f * (segment[i - 1] + segment[i]);
+    if (arc > 1e-6f) {
+      mPoints[i].curvature =
+          WrapAngle(mPoints[i].heading - mPoints[i - 1].heading) / arc;
+    }
+  }
+
+  // Velocity: the curve limit, then acceleration from rest forwards and
+  // deceleration to rest backwards
+  for (TrajectoryPoint &p : mPoints) {
+    p.velocity = limits.maxVelocity;
+    if (limits.maxCentripetal > 0.0f && std::abs(p.curvature) > 1e-6f) {
+      p.velocity = std::min(
+          p.velocity, std::sqrt(limits.maxCentripetal / std::abs(p.curvature)));
+    }
+  }
+  mPoints.front().velocity = 0.0f;
+  mPoints.back().velocity = 0.0f;
+  const float accel2 = 2.0f * limits.maxAcceleration;
+  for (size_t i = 1; i < n; i++) {
+    float prev = mPoints[i - 1].velocity;
+    mPoints[i].velocity =
+        std::min(mPoints[i].velocity,
+                 std::sqrt(prev * prev + accel2 * segment[i - 1]));
+  }
+  for (size_t i = n - 1; i-- > 0;) {
+    float next = mPoints[i + 1].velocity;
+    mPoints[i].velocity = std::min(
+        mPoints[i].velocity, std::sqrt(next * next + accel2 * segment[i]));
+  }
+
+  // Constant acceleration between samples
+  for (size_t i = 1; i < n; i++) {
+    float v = mPoints[i - 1].velocity + mPoints[i].velocity;
+    mPoints[i].time =
+        mPoints[i - 1].time + (v > 1e-6f ? 2.0f * segment[i - 1] / v : 0.0f);
+  }
+  return true;
+}
+
+TrajectoryPoint Trajectory::Sample(float time) const {
+  if (mPoints.empty())
+    return TrajectoryPoint();
+  if (time <= mPoints.front().time)
+    return mPoints.front();
+  if (time >= mPoints.back().time)
+    return mPoints.back();
+  auto it = std::upper_bound(
+      mPoints.begin(), mPoints.end(), time,
+      [](float t, const TrajectoryPoint &p) { return t < p.time; });
+  const TrajectoryPoint &b = *it;
+  const TrajectoryPoint &a = *(it - 1);
+  float span = b.time - a.time;
+  float f = span > 0.0f ? (time - a.time) / span : 0.0f;
+
+  TrajectoryPoint p;
+  p.time = time;
+  p.distance = a.distance + (b.distance - a.distance) * f;
+  p.position = a.position + (b.position - a.position) * f;
+  p.heading = WrapAngle(a.heading + WrapAngle(b.heading - a.heading) * f);
+  p.curvature = a.curvature + (b.curvature - a.curvature) * f;
+  p.velocity = a.velocity + (b.velocity - a.velocity) * f;
+  return p;
+}
+
+size_t Trajectory::FindNearest(const PxVec3 &position, size_t from,
+                               size_t window) const {
+  if (mPoints.empty())
+    return 0;
+  from = std::min(from, mPoints.size() - 1);
+  size_t last = std::min(mPoints.size() - 1, from + window);
+  size_t best = from;
+  float bestDist = FloorDistance(mPoints[from].position, position);
+  for (size_t i = from + 1; i <= last; i++) {
+    float dist = FloorDistance(mPoints[i].position, position);
+    if (dist < bestDist) {
+      bestDist = dist;
+      best = i;
+    }
+  }
+  return best;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <PxPhysicsAPI.h>
+#include <vector>
+
+using namespace physx;
+
+// One sample of a floor trajectory. Headings follow WaypointDriver: 0 is
+// +Z, positive towards +X.
+struct TrajectoryPoint {
+  float time = 0.0f;      // s from the start
+  float distance = 0.0f;  // m along the path
+  PxVec3 position = PxVec3(0.0f, 0.0f, 0.0f); // y unused
+  float heading = 0.0f;   // rad
+  float curvature = 0.0f; // rad/m; positive while the heading increases
+  float velocity = 0.0f;  // m/s
+};
+
+struct TrajectoryLimits {
+  float maxVelocity = 0.8f;     // m/s
+  float maxAcceleration = 1.5f; // m/s^2, speeding up and slowing down
+  float maxCentripetal = 1.0f;  // m/s^2; slows the robot in curves
+};
+
+// Smooth, timed path through floor points: a centripetal Catmull-Rom spline
+// (no cusps or loops between close points) sampled every few centimetres,
+// with a velocity profile that starts and ends at rest and respects the
+// limits. Built once per path; sampling is a binary search.
+class Trajectory {
+public:
+  // Needs two or more distinct points; false (and empty) otherwise. With
+  // `startHeading` (rad) the path leaves the first point that way, as a
+  // robot that is not facing along the first chord has to.
+  bool Generate(const std::vector<PxVec3> &points,
+                const TrajectoryLimits &limits,
+                const float *startHeading = nullptr, float spacing = 0.02f);
+
+  // Interpolated at `time`, clamped to the ends
+  TrajectoryPoint Sample(float time) const;
+  // Sample index nearest to `position`, searching `window` samples on
+  // from `from`, so a follower that passes a crossing keeps its place
+  size_t FindNearest(const PxVec3 &position, size_t from,
+                     size_t window = 64) const;
+
+  const std::vector<TrajectoryPoint> &GetPoints() const { return mPoints; }
+  bool IsEmpty() const { return mPoints.empty(); }
+  float GetDuration() const {
+    return mPoints.empty() ? 0.0f : mPoints.back().time;
+  }
+  float GetLength() const {
+    return mPoints.empty() ? 0.0f : mPoints.back().distance;
+  }
+
+private:
+  std::vector<TrajectoryPoint> mPoints;
+};
@@ -0,0 +1,49 @@
+#include "WaypointDriver.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const float kPi = 3.14159265f;
+
+float WrapAngle(float angle) {
+  angle = std::fmod(angle + kPi, 2.0f * kPi);
+  if (angle < 0.0f)
+    angle += 2.0f * kPi;
+  return angle - kPi;
+}
+
+void WaypointDriver::SetWaypoints(const std::vector<PxVec3> &waypoints) {
+  mWaypoints = waypoints;
+  mNext = 0;
+}
+
+float WaypointDriver::GetHeading(const PxTransform &chassis) const {
+  PxVec3 forward = chassis.q.rotate(PxVec3(0.0f, 0.0f, mDirection));
+  return std::atan2(forward.x, forward.z);
+}
+
+bool WaypointDriver::Update(const PxTransform &chassis, float &left,
+                            float &right) {
+  left = right = 0.0f;
+  float dx = 0.0f, dz = 0.0f, dist = 0.0f;
+  while (mNext < mWaypoints.size()) {
+    dx = mWaypoints[mNext].x - chassis.p.x;
+    dz = mWaypoints[mNext].z - chassis.p.z;
+    dist = std::sqrt(dx * dx + dz * dz);
+    if (dist >= reachRadius)
+      break;
+    mNext++;
+  }
+  if (IsDone())
+    return false;
+
+  // Driving the +X side forward yaws the chassis by -mDirection
+  float error = WrapAngle(std::atan2(dx, dz) - GetHeading(chassis));
+  float turn = std::clamp(turnGain * error, -1.0f, 1.0f) * -mDirection;
+  float forward = std::abs(error) > pivotAngle ? 0.0f : std::cos(error);
+  if (slowForLast && mNext + 1 == mWaypoints.size())
+    forward *= std::min(1.0f, dist / 0.5f + 0.2f);
+  left = forward - turn;
+  right = forward + turn;
+  return true;
+}
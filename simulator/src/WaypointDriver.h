@@ -0,0 +1,42 @@
+#pragma once
+
+#include <PxPhysicsAPI.h>
+#include <vector>
+
+using namespace physx;
+
+// Drives a robot through floor waypoints (x/z): it pivots towards the next
+// one, then drives at it with proportional steering, and may slow down for
+// the last. Cheap enough for batch runs; the output goes straight to
+// Robot::SetDriveInput.
+class WaypointDriver {
+public:
+  // `driveDirection` as from MeasureDriveDirection (HeadlessSim.h)
+  explicit WaypointDriver(float driveDirection = 1.0f)
+      : mDirection(driveDirection) {}
+
+  void SetWaypoints(const std::vector<PxVec3> &waypoints);
+
+  float reachRadius = 0.2f; // m; a waypoint counts as reached inside this
+  float turnGain = 1.5f;    // Turn power per radian of heading error
+  float pivotAngle = 0.5f;  // rad; larger errors turn in place
+  bool slowForLast = true;  // Ease off approaching the final waypoint
+
+  // Left/right power towards the current waypoint; zero and false once the
+  // last one has been reached
+  bool Update(const PxTransform &chassis, float &left, float &right);
+
+  bool IsDone() const { return mNext >= mWaypoints.size(); }
+  size_t GetNextIndex() const { return mNext; }
+
+  // Direction of travel around Y (0 = +Z, towards +X positive), radians
+  float GetHeading(const PxTransform &chassis) const;
+
+private:
+  std::vector<PxVec3> mWaypoints;
+  size_t mNext = 0;
+  float mDirection;
+};
+
+// Wraps an angle to [-pi, pi]
+float WrapAngle(float angle);
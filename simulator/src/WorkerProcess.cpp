@@ -0,0 +1,341 @@
+#include "WorkerProcess.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char **environ;
+#endif
+
+// Pipes are created and handed to the child under this lock, so a worker
+// started on another thread never inherits them: a stray copy of a
+// worker's stdin would keep it from ever seeing end of input
+static std::mutex &SpawnMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+WorkerProcess::~WorkerProcess() {
+  if (IsRunning()) {
+    Kill();
+    Wait();
+  }
+}
+
+#ifdef _WIN32
+
+// Arguments containing spaces are quoted; embedded quotes are not escaped
+static std::string JoinCommandLine(const std::vector<std::string> &command) {
+  std::string line;
+  for (const std::string &arg : command) {
+    if (!line.empty())
+      line += ' ';
+    if (arg.empty() || arg.find_first_of(" \t") != std::string::npos)
+      line += "\"" + arg + "\"";
+    else
+      line += arg;
+  }
+  return line;
+}
+
+bool WorkerProcess::Start(const std::vector<std::string> &command,
+                          std::string *err) {
+  if (command.empty() || IsRunning())
+    return false;
+  std::lock_guard<std::mutex> lock(SpawnMutex());
+
+  SECURITY_ATTRIBUTES inherit = {sizeof(inherit), nullptr, TRUE};
+  HANDLE childIn = nullptr, parentIn = nullptr;
+  HANDLE parentOut = nullptr, childOut = nullptr;
+  if (!CreatePipe(&childIn, &parentIn, &inherit, 0) ||
+      !CreatePipe(&parentOut, &childOut, &inherit, 0)) {
+    if (err)
+      *err = "CreatePipe failed (error " + std::to_string(GetLastError()) +
+             ")";
+    for (HANDLE h : {childIn, parentIn, parentOut, childOut})
+      if (h)
+        CloseHandle(h);
+    return false;
+  }
+  SetHandleInformation(parentIn, HANDLE_FLAG_INHERIT, 0);
+  SetHandleInformation(parentOut, HANDLE_FLAG_INHERIT, 0);
+
+  STARTUPINFOA startup = {};
+  startup.cb = sizeof(startup);
+  startup.dwFlags = STARTF_USESTDHANDLES;
+  startup.hStdInput = childIn;
+  startup.hStdOutput = childOut;
+  startup.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+  PROCESS_INFORMATION info = {};
+  std::string line = JoinCommandLine(command);
+  BOOL started = CreateProcessA(nullptr, &line[0], nullptr, nullptr, TRUE, 0,
+                                nullptr, nullptr, &startup, &info);
+  CloseHandle(childIn);
+  CloseHandle(childOut);
+  if (!started) {
+    if (err)
+      *err = "Cannot start " + command[0] + " (error " +
+             std::to_string(GetLastError()) + ")";
+    CloseHandle(parentIn);
+    CloseHandle(parentOut);
+    return false;
+  }
+  CloseHandle(info.hThread);
+  mProcess = info.hProcess;
+  mInput = parentIn;
+  mOutput = parentOut;
+  mBuffer.clear();
+  return true;
+}
+
+bool WorkerProcess::WriteLine(const std::string &line) {
+  if (!mInput)
+    return false;
+  std::string data = line + "\n";
+  const char *p = data.data();
+  size_t left = data.size();
+  while (left > 0) {
+    DWORD written = 0;
+    if (!WriteFile(mInput, p, static_cast<DWORD>(left), &written, nullptr))
+      return false;
+    p += written;
+    left -= written;
+  }
+  return true;
+}
+
+bool WorkerProcess::ReadLine(std::string &line) {
+  size_t newline;
+  while ((newline = mBuffer.find('\n')) == std::string::npos) {
+    char chunk[4096];
+    DWORD read = 0;
+    if (!mOutput || !ReadFile(mOutput, chunk, sizeof(chunk), &read, nullptr) ||
+        read == 0)
+      return false;
+    mBuffer.append(chunk, read);
+  }
+  line.assign(mBuffer, 0, newline);
+  mBuffer.erase(0, newline + 1);
+  if (!line.empty() && line.back() == '\r')
+    line.pop_back();
+  return true;
+}
+
+void WorkerProcess::CloseInput() {
+  if (mInput)
+    CloseHandle(mInput);
+  mInput = nullptr;
+}
+
+void WorkerProcess::Kill() {
+  if (mProcess)
+    TerminateProcess(mProcess, 1);
+}
+
+int WorkerProcess::Wait() {
+  if (!mProcess)
+    return -1;
+  CloseInput();
+  WaitForSingleObject(mProcess, INFINITE);
+  DWORD code = 0;
+  GetExitCodeProcess(mProcess, &code);
+  CloseHandle(mProcess);
+  if (mOutput)
+    CloseHandle(mOutput);
+  mProcess = nullptr;
+  mOutput = nullptr;
+  return static_cast<int>(code);
+}
+
+bool WorkerProcess::IsRunning() const { return mProcess != nullptr; }
+
+std::string GetExecutablePath(const char *argv0) {
+  char path[MAX_PATH];
+  DWORD length = GetModuleFileNameA(nullptr, path, MAX_PATH);
+  if (length == 0 || length == MAX_PATH)
+    return argv0;
+  return std::string(path, length);
+}
+
+#else
+
+static void CloseFd(int &fd) {
+  if (fd >= 0)
+    close(fd);
+  fd = -1;
+}
+
+bool WorkerProcess::Start(const std::vector<std::string> &command,
+                          std::string *err) {
+  if (command.empty() || IsRunning())
+    return false;
+  std::lock_guard<std::mutex> lock(SpawnMutex());
+  // A worker that dies mid-write must fail WriteLine, not kill us
+  static bool ignoreSigpipe = (std::signal(SIGPIPE, SIG_IGN), true);
+  (void)ignoreSigpipe;
+
+  int toChild[2] = {-1, -1}, fromChild[2] = {-1, -1};
+  if (pipe(toChild) != 0 || pipe(fromChild) != 0) {
+    if (err)
+      *err = std::string("pipe failed: ") + strerror(errno);
+    for (int *fd : {&toChild[0], &toChild[1], &fromChild[0], &fromChild[1]})
+      CloseFd(*fd);
+    return false;
+  }
+  // The child gets its ends as stdin/stdout (dup2 clears the flag there);
+  // no other copy may survive into any child
+  for (int fd : {toChild[0], toChild[1], fromChild[0], fromChild[1]})
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, toChild[0], STDIN_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, fromChild[1], STDOUT_FILENO);
+  std::vector<char *> argv;
+  for (const std::string &arg : command)
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  argv.push_back(nullptr);
+  pid_t pid = -1;
+  int status = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(),
+                           environ);
+  posix_spawn_file_actions_destroy(&actions);
+  CloseFd(toChild[0]);
+  CloseFd(fromChild[1]);
+  if (status != 0) {
+    if (err)
+      *err = "Cannot start " + command[0] + ": " + strerror(status);
+    CloseFd(toChild[1]);
+    CloseFd(fromChild[0]);
+    return false;
+  }
+  mPid = pid;
+  mInput = toChild[1];
+  mOutput = fromChild[0];
+  mBuffer.clear();
+  return true;
+}
+
+bool WorkerProcess::WriteLine(const std::string &line) {
+  if (mInput < 0)
+    return false;
+  std::string data = line + "\n";
+  const char *p = data.data();
+  size_t left = data.size();
+  while (left > 0) {
+    ssize_t written = write(mInput, p, left);
+    if (written < 0 && errno == EINTR)
+      continue;
+    if (written <= 0)
+      return false;
+    p += written;
+    left -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+bool WorkerProcess::ReadLine(std::string &line) {
+  size_t newline;
+  while ((newline = mBuffer.find('\n')) == std::string::npos) {
+    char chunk[4096];
+    ssize_t count = mOutput >= 0 ? read(mOutput, chunk, sizeof(chunk)) : -1;
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count <= 0)
+      return false;
+    mBuffer.append(chunk, static_cast<size_t>(count));
+  }
+  line.assign(mBuffer, 0, newline);
+  mBuffer.erase(0, newline + 1);
+  return true;
+}
+
+void WorkerProcess::CloseInput() { CloseFd(mInput); }
+
+void WorkerProcess::Kill() {
+  if (mPid > 0)
+    kill(mPid, SIGKILL);
+}
+
+int WorkerProcess::Wait() {
+  if (mPid <= 0)
+    return -1;
+  CloseInput();
+  int status = 0;
+  while (waitpid(mPid, &status, 0) < 0 && errno == EINTR) {
+  }
+  CloseFd(mOutput);
+  mPid = -1;
+  if (WIFSIGNALED(status))
+    return 128 + WTERMSIG(status);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+bool WorkerProcess::IsRunning() const { return mPid > 0; }
+
+std::string GetExecutablePath(const char *argv0) {
+  char path[4096];
+  ssize_t length = readlink("/proc/self/exe", path, sizeof(path));
+  if (length <= 0 || length == static_cast<ssize_t>(sizeof(path)))
+    return argv0;
+  return std::string(path, static_cast<size_t>(length));
+}
+
+#endif
+
+// --- Worker side ---
+
+int RunWorkerLoop(const WorkerHandler &handler) {
+  // Keep the real stdout for replies and point fd 1 at stderr, so library
+  // logging cannot corrupt the protocol
+  std::cout.flush();
+  std::fflush(stdout);
+#ifdef _WIN32
+  _setmode(_fileno(stdin), _O_BINARY);
+  int replyFd = _dup(_fileno(stdout));
+  _dup2(_fileno(stderr), _fileno(stdout));
+  SetStdHandle(STD_OUTPUT_HANDLE, GetStdHandle(STD_ERROR_HANDLE));
+  FILE *replies = replyFd >= 0 ? _fdopen(replyFd, "wb") : nullptr;
+#else
+  int replyFd = dup(STDOUT_FILENO);
+  dup2(STDERR_FILENO, STDOUT_FILENO);
+  FILE *replies = replyFd >= 0 ? fdopen(replyFd, "w") : nullptr;
+#endif
+  if (!replies) {
+    std::cerr << "[Worker] Cannot open the reply stream" << std::endl;
+    return 1;
+  }
+
+  std::string line, result;
+  while (std::getline(std::cin, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    size_t space = line.find(' ');
+    std::string id = line.substr(0, space);
+    std::string job = space == std::string::npos ? "" : line.substr(space + 1);
+    result.clear();
+    if (!handler(job, result)) {
+      std::cerr << "[Worker] Job " << id << " failed" << std::endl;
+      std::fclose(replies);
+      return 1;
+    }
+    std::fprintf(replies, "%s %s\n", id.c_str(), result.c_str());
+    std::fflush(replies);
+  }
+  std::fclose(replies);
+  return 0;
+}
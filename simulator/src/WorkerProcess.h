@@ -0,0 +1,60 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// A child process with its stdin and stdout connected to pipes, spoken to
+// one line at a time. Its stderr is shared with the parent. Start and Wait
+// belong to one thread; Kill may be called from another while that thread
+// is blocked in ReadLine, which then returns false.
+class WorkerProcess {
+public:
+  WorkerProcess() = default;
+  ~WorkerProcess(); // Kills a worker that is still running
+  WorkerProcess(const WorkerProcess &) = delete;
+  WorkerProcess &operator=(const WorkerProcess &) = delete;
+
+  // `command[0]` is the executable path, the rest its arguments
+  bool Start(const std::vector<std::string> &command,
+             std::string *err = nullptr);
+
+  // Both return false once the worker has exited or closed its end
+  bool WriteLine(const std::string &line);
+  bool ReadLine(std::string &line);
+
+  // Closing stdin asks a worker loop to finish (it sees end of input)
+  void CloseInput();
+  void Kill();
+  // Closes stdin, reaps the worker and returns its exit code (128 + signal
+  // for a worker killed by one on POSIX, -1 if none was running)
+  int Wait();
+
+  bool IsRunning() const;
+
+private:
+#ifdef _WIN32
+  void *mProcess = nullptr;
+  void *mInput = nullptr;  // Our end of the worker's stdin
+  void *mOutput = nullptr; // Our end of the worker's stdout
+#else
+  int mPid = -1;
+  int mInput = -1;
+  int mOutput = -1;
+#endif
+  std::string mBuffer; // Read but not yet returned
+};
+
+// Path of the running executable, so a tool can start copies of itself;
+// `argv0` if the platform cannot tell
+std::string GetExecutablePath(const char *argv0);
+
+// Worker side of the protocol. Each input line is "<id> <job>"; `handler`
+// turns the job into a one-line result, written back as "<id> <result>".
+// stdout is kept for these replies only: anything else the process prints
+// there goes to stderr instead, so call this before printing anything.
+// Returns 0 at end of input, or 1 as soon as the handler fails, so the
+// coordinator treats it like a crash.
+using WorkerHandler =
+    std::function<bool(const std::string &job, std::string &result)>;
+int RunWorkerLoop(const WorkerHandler &handler);
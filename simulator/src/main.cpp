@@ -1,16 +1,33 @@
 // Block Spawning & Intake — Robot drives, spawns blocks, picks up and ejects
-#include "AssetLoader.h"
+#include "AppOptions.h"
+#include "AssetBundle.h"
+#include "Autonomous.h"
+#include "Controller.h"
+#include "FieldCollision.h"
 #include "GameBlock.h"
+#include "GlbFile.h"
+#include "HeadlessSim.h"
+#include "InputLog.h"
 #include "PhysicsWorld.h"
 #include "Robot.h"
+#include "RobotTelemetry.h"
 #include "SimulationFilter.h"
+#include "TelemetryLog.h"
 #include "renderer/Camera.h"
+#include "renderer/FrameRecorder.h"
+#include "renderer/GpuTimer.h"
 #include "renderer/Mesh.h"
 #include "renderer/ModelLoader.h"
 #include "renderer/Pipeline.h"
+#include "renderer/SceneBuffers.h"
+#include "renderer/SceneViews.h"
+#include "renderer/ShaderReloader.h"
+#include "renderer/ShadowMap.h"
 #include "renderer/VulkanContext.h"
 
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cfloat>
 #include <cstring>
 #include <functional>
 #include <glm/glm.hpp>
@@ -18,7 +35,7 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <list>
-#include <tiny_gltf.h>
+#include <memory>
 
 // Dear ImGui
 #include <imgui.h>
@@ -32,54 +49,11 @@ void framebufferResizeCallback(GLFWwindow *window, int width, int height) {
   framebufferResized = true;
 }
 
-// --- Helper: spawn a block ---
-GameBlock SpawnBlock(PxPhysics *physics, PxScene *scene, PxMaterial *material,
-                     BlockColor color, PxVec3 position) {
-  GameBlock block;
-  block.color = color;
-  block.held = false;
-
-  // Block is a sphere ~14cm diameter (Big enought to actually collide)
-  float radius = 0.07f;
-  block.body = physics->createRigidDynamic(PxTransform(position));
-  PxShape *shape = physics->createShape(PxSphereGeometry(radius), *material);
-  block.body->attachShape(*shape);
-  shape->release();
-  PxRigidBodyExt::updateMassAndInertia(*block.body, 1.0f);
-
-  // Friction: blocks slow down on the field
-  block.body->setLinearDamping(2.0f);
-  block.body->setAngularDamping(1.0f);
-
-  // Blocks collide with ground, chassis, wheels, obstacles, other blocks
-  SetActorFilter(block.body, FilterGroup::eBLOCK,
-                 FilterGroup::eGROUND | FilterGroup::eCHASSIS |
-                     FilterGroup::eWHEEL | FilterGroup::eOBSTACLE |
-                     FilterGroup::eBLOCK);
-
-  scene->addActor(*block.body);
-
-  std::cout << "[Block] Spawned " << (color == BlockColor::RED ? "RED" : "BLUE")
-            << " block at (" << position.x << ", " << position.y << ", "
-            << position.z << ")" << std::endl;
-  return block;
-}
-
-// --- Helper: draw with transform ---
-template <typename F>
-static void DrawWithPushConstants(VkCommandBuffer cmd, VkPipelineLayout layout,
-                                  const glm::mat4 &vp,
-                                  const glm::mat4 &modelMat, F drawFn) {
-  glm::mat4 mvp = vp * modelMat;
-  PushConstants pc;
-  memcpy(pc.mvp, glm::value_ptr(mvp), sizeof(pc.mvp));
-  memcpy(pc.model, glm::value_ptr(modelMat), sizeof(pc.model));
-  vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pc),
-                     &pc);
-  drawFn(cmd);
-}
+int main(int argc, char **argv) {
+  AppOptions options;
+  if (!ParseAppOptions(argc, argv, options))
+    return 1;
 
-int main() {
   // --- GLFW Init ---
   if (!glfwInit()) {
     std::cerr << "Failed to initialize GLFW!" << std::endl;
@@ -105,6 +79,8 @@ int main() {
 
   // --- Vulkan Init ---
   VulkanContext vulkan;
+  vulkan.SetRenderSettings(
+      static_cast<VkSampleCountFlagBits>(options.msaa), options.renderScale);
   try {
     vulkan.Initialize(window);
   } catch (const std::exception &e) {
@@ -116,10 +92,18 @@ int main() {
 
   // --- Pipeline ---
   Pipeline pipeline;
+  ShadowMap shadowMap;
   try {
     pipeline.Create(vulkan.GetDevice(), vulkan.GetRenderPass(),
                     vulkan.GetDepthFormat(), "shaders/basic.vert.spv",
-                    "shaders/basic.frag.spv");
+                    "shaders/basic.frag.spv", vulkan.GetPipelineCache(),
+                    vulkan.GetSampleCount());
+    ShadowQuality shadowQuality = ShadowQuality::eMEDIUM;
+    ParseShadowQuality(options.shadows, shadowQuality);
+    shadowMap.Create(vulkan.GetDevice(), vulkan.GetAllocator(),
+                     vulkan.GetGraphicsQueue(), vulkan.GetGraphicsQueueFamily(),
+                     vulkan.GetPipelineCache(), "shaders/shadow.vert.spv",
+                     shadowQuality);
   } catch (const std::exception &e) {
     std::cerr << "Pipeline failed: " << e.what() << std::endl;
     vulkan.Cleanup();
@@ -128,6 +112,47 @@ int main() {
     return -1;
   }
 
+  uint32_t pipelineGeneration = vulkan.GetRenderPassGeneration();
+
+  // Camera and per-object transforms, one buffer set per swapchain image
+  SceneBuffers sceneBuffers;
+  sceneBuffers.Create(vulkan.GetDevice(), vulkan.GetPhysicalDevice(),
+                      vulkan.GetAllocator(), vulkan.GetImageCount());
+  sceneBuffers.SetShadowMap(shadowMap.GetView(), shadowMap.GetSampler());
+  std::vector<DrawItem> drawItems;
+  // Main camera plus the match-review insets toggled in the info panel
+  SceneViews sceneViews;
+  std::vector<glm::mat4> robotTransforms;
+
+  ShadowQuality pendingShadowQuality = shadowMap.GetQuality();
+  // Likewise for MSAA and render scale, which replace the scene targets
+  int pendingMsaa = vulkan.GetSampleCount();
+  float pendingRenderScale = vulkan.GetRenderScale();
+
+  GpuTimer gpuTimer;
+  gpuTimer.Create(vulkan.GetDevice(), vulkan.GetPhysicalDevice(),
+                  vulkan.GetGraphicsQueueFamily(), vulkan.GetImageCount());
+
+  // Match footage; the panel can start it later (H hides the panel)
+  FrameRecorder recorder;
+  recorder.Create(vulkan.GetDevice(), vulkan.GetAllocator(),
+                  vulkan.GetImageCount());
+  std::string recordPath =
+      options.recordPath.empty() ? "match.y4m" : options.recordPath;
+  if (!options.recordPath.empty())
+    recorder.Start(recordPath, vulkan.GetSwapchainFormat(), options.recordFps);
+
+  // Edits to the GLSL sources are compiled and swapped in while running
+  std::unique_ptr<ShaderReloader> shaderReloader;
+  if (options.watchShaders) {
+    shaderReloader = std::make_unique<ShaderReloader>(
+        SIMULATOR_GLSLC, SIMULATOR_SHADER_SOURCE_DIR "/basic.vert",
+        SIMULATOR_SHADER_SOURCE_DIR "/basic.frag", "shaders/basic.vert.spv",
+        "shaders/basic.frag.spv");
+    // A rebuild in flight must not outlive the render pass it targets
+    vulkan.SetRenderPassReplaceCallback([&]() { shaderReloader->Wait(); });
+  }
+
   // --- ImGui Descriptor Pool ---
   VkDescriptorPool imguiPool = VK_NULL_HANDLE;
   {
@@ -168,86 +193,112 @@ int main() {
   initInfo.DescriptorPool = imguiPool;
   initInfo.MinImageCount = 2;
   initInfo.ImageCount = 2;
-  initInfo.RenderPass = vulkan.GetRenderPass();
+  initInfo.RenderPass = vulkan.GetOverlayRenderPass();
+  initInfo.PipelineCache = vulkan.GetPipelineCache();
   ImGui_ImplVulkan_Init(&initInfo);
 
   // Upload ImGui font textures
   ImGui_ImplVulkan_CreateFontsTexture();
+  uint32_t overlayGeneration = vulkan.GetOverlayGeneration();
 
   bool showInfoPanel = true;
   bool hWasPressed = false;
+  bool vWasPressed = false;
 
   // --- Camera ---
   Camera camera;
   camera.Init(3.0f, -90.0f, 30.0f);
 
-  // --- Load GLB models for rendering ---
-  std::vector<Mesh> robotMeshes, fieldMeshes, redBlockMeshes, blueBlockMeshes;
-  try {
-    robotMeshes = LoadModel(
-        vulkan.GetDevice(), vulkan.GetAllocator(), vulkan.GetGraphicsQueue(),
-        vulkan.GetGraphicsQueueFamily(), "assets/example_robot.glb");
-  } catch (const std::exception &e) {
-    std::cerr << "Robot model load failed: " << e.what() << std::endl;
-  }
-
-  try {
-    fieldMeshes = LoadModel(
-        vulkan.GetDevice(), vulkan.GetAllocator(), vulkan.GetGraphicsQueue(),
-        vulkan.GetGraphicsQueueFamily(), "assets/field.glb");
-  } catch (const std::exception &e) {
-    std::cerr << "Field model load failed: " << e.what() << std::endl;
+  // --- Load models for rendering (baked bundle or GLBs) ---
+  double assetStart = glfwGetTime();
+  AssetBundle bundle;
+  if (!options.bundle.empty()) {
+    std::string err;
+    if (!bundle.Open(options.bundle, &err))
+      std::cerr << "Bundle load failed, using GLBs: " << err << std::endl;
   }
 
-  try {
-    redBlockMeshes = LoadModel(
-        vulkan.GetDevice(), vulkan.GetAllocator(), vulkan.GetGraphicsQueue(),
-        vulkan.GetGraphicsQueueFamily(), "assets/red_block.glb");
-  } catch (const std::exception &e) {
-    std::cerr << "Red block model load failed: " << e.what() << std::endl;
-  }
-
-  try {
-    blueBlockMeshes = LoadModel(
-        vulkan.GetDevice(), vulkan.GetAllocator(), vulkan.GetGraphicsQueue(),
-        vulkan.GetGraphicsQueueFamily(), "assets/blue_block.glb");
-  } catch (const std::exception &e) {
-    std::cerr << "Blue block model load failed: " << e.what() << std::endl;
-  }
-
-  // --- Load GLB models for physics collision ---
-  tinygltf::Model fieldGltfModel;
-  {
-    tinygltf::TinyGLTF loader;
-    std::string err, warn;
-    if (!loader.LoadBinaryFromFile(&fieldGltfModel, &err, &warn,
-                                   "assets/field.glb")) {
-      std::cerr << "Failed to load field GLB for physics: " << err << std::endl;
+  auto loadModel = [&](const char *name) {
+    try {
+      if (bundle.IsOpen()) {
+        return LoadBundledModel(vulkan.GetDevice(), vulkan.GetAllocator(),
+                                vulkan.GetGraphicsQueue(),
+                                vulkan.GetGraphicsQueueFamily(), bundle, name);
+      }
+      return LoadModel(vulkan.GetDevice(), vulkan.GetAllocator(),
+                       vulkan.GetGraphicsQueue(),
+                       vulkan.GetGraphicsQueueFamily(),
+                       std::string("assets/") + name + ".glb");
+    } catch (const std::exception &e) {
+      std::cerr << "Model " << name << " load failed: " << e.what()
+                << std::endl;
+      return std::vector<Mesh>();
     }
+  };
+  std::vector<Mesh> robotMeshes = loadModel("example_robot");
+  std::vector<Mesh> fieldMeshes = loadModel("field");
+  std::vector<Mesh> redBlockMeshes = loadModel("red_block");
+  std::vector<Mesh> blueBlockMeshes = loadModel("blue_block");
+  // Places the overview and driver-station cameras
+  glm::vec3 fieldMin(-1.8f, 0.0f, -1.8f), fieldMax(1.8f, 0.5f, 1.8f);
+  if (!fieldMeshes.empty())
+    GetModelBounds(fieldMeshes, glm::mat4(1.0f), fieldMin, fieldMax);
+
+  // Cinematic mode plays --camera-path, or circles the field
+  CameraPath cameraPath;
+  std::string pathErr;
+  if (options.cameraPath.empty() ||
+      !cameraPath.Load(options.cameraPath, &pathErr)) {
+    if (!pathErr.empty())
+      std::cerr << "Camera path: " << pathErr << std::endl;
+    glm::vec3 fieldCenter = (fieldMin + fieldMax) * 0.5f;
+    float fieldRadius =
+        0.5f * glm::length(glm::vec2(fieldMax.x - fieldMin.x,
+                                     fieldMax.z - fieldMin.z));
+    cameraPath = CameraPath::MakeOrbit(fieldCenter, fieldRadius, 2.0f, 30.0f);
   }
+  camera.SetPath(cameraPath);
+  CameraMode cameraMode = CameraMode::eORBIT;
+  ParseCameraMode(options.cameraMode.c_str(), cameraMode);
+  camera.SetMode(cameraMode);
 
   // --- PhysX Init ---
   PhysicsWorld physics;
-  physics.Initialize();
-
-  // Create field collision body (static)
+  PhysicsConfig physicsConfig;
+  ParseBroadPhaseType(options.broadPhase, physicsConfig.broadPhase);
+  physics.Initialize(physicsConfig);
+
+  // Create field collision body (static). A bundle carries the proxies
+  // prebuilt; full-mesh mode always needs the GLB.
+  FieldCollisionMode fieldCollisionMode = FieldCollisionMode::ePROXIES;
+  ParseFieldCollisionMode(options.fieldCollision, fieldCollisionMode);
+  FieldCollisionStats fieldCollisionStats;
+  const BundleEntry *bakedField =
+      bundle.Find("field", BundleEntryType::eFIELD_COLLISION);
   PxRigidStatic *fieldBody = nullptr;
-  if (!fieldGltfModel.meshes.empty()) {
-    fieldBody = AssetLoader::CreateStaticBody(
-        physics.GetPhysics(), physics.GetScene(), fieldGltfModel,
-        physics.GetDefaultMaterial(), PxTransform(PxIdentity), PxVec3(1.0f));
-
-    if (fieldBody) {
-      SetActorFilter(fieldBody, FilterGroup::eGROUND,
-                     FilterGroup::eCHASSIS | FilterGroup::eWHEEL |
-                         FilterGroup::eOBSTACLE | FilterGroup::eBLOCK);
-    }
+  if (bakedField && fieldCollisionMode == FieldCollisionMode::ePROXIES) {
+    fieldBody = CreateBakedFieldCollision(
+        physics, bundle.Payload(*bakedField),
+        static_cast<size_t>(bakedField->size), &fieldCollisionStats);
+  }
+  if (!fieldBody) {
+    GlbFile fieldGlb;
+    std::string err;
+    if (!fieldGlb.Open("assets/field.glb", &err))
+      std::cerr << "Failed to load field GLB for physics: " << err
+                << std::endl;
+    CreateFieldCollision(physics, fieldGlb.IsOpen() ? &fieldGlb : nullptr,
+                         fieldCollisionMode, "assets/field.glb",
+                         &fieldCollisionStats);
   }
+  physics.ConfigureBroadPhaseRegions(fieldCollisionStats.sourceBounds);
+  std::cout << "Assets ready in " << (glfwGetTime() - assetStart) * 1000.0
+            << " ms" << (bundle.IsOpen() ? " (bundle)" : " (GLB)")
+            << std::endl;
 
   // Create robot
   Robot robot;
-  robot.Initialize(physics.GetPhysics(), physics.GetScene(),
-                   physics.GetDefaultMaterial(), PxVec3(0.0f, 0.5f, 0.0f));
+  robot.Initialize(physics, PxVec3(0.0f, 0.5f, 0.0f));
 
   // --- Block storage (std::list for stable pointers) ---
   std::list<GameBlock> blocks;
@@ -256,16 +307,82 @@ int main() {
   std::cout << "A/Z: right fwd/rev | D/C: left fwd/rev | R/B: spawn blocks"
             << std::endl;
   std::cout << "F: intake | G: outtake | ESC: exit" << std::endl;
+  std::cout << "J/L: turn (arcade / curvature drive) | Gamepad: sticks "
+               "drive, RB/RT intake/outtake, X/B spawn"
+            << std::endl;
   std::cout << "Arrow keys: pan camera | Right-click: orbit | +/-: zoom"
             << std::endl;
+  std::cout << "V: camera mode (orbit / follow / cinematic)" << std::endl;
 
   double lastTime = glfwGetTime();
-  const float physicsTimestep = 1.0f / 60.0f;
+  const uint32_t physicsHz = 60;
+  const float physicsTimestep = 1.0f / physicsHz;
   float physicsAccumulator = 0.0f;
 
-  // Key debounce state
-  bool rWasPressed = false, bWasPressed = false;
-  bool fWasPressed = false, gWasPressed = false;
+  // --- Controller ---
+  InputMapping inputMapping;
+  if (!options.inputMap.empty()) {
+    std::string err;
+    if (inputMapping.Load(options.inputMap, &err))
+      std::cout << "[Input] Mapping loaded: " << options.inputMap << std::endl;
+    else
+      std::cerr << "[Input] Mapping: " << err << std::endl;
+  }
+  DriveMode driveMode = DriveMode::eTANK;
+  ParseDriveMode(options.driveMode, driveMode);
+
+  // Logs are tied to the step rate, not the frame rate
+  InputLog inputRecord, inputReplay;
+  if (!options.recordInput.empty()) {
+    std::string err;
+    if (!inputRecord.OpenWrite(options.recordInput, physicsHz, &err))
+      std::cerr << "[Input] Record: " << err << std::endl;
+  }
+  if (!options.replayInput.empty()) {
+    std::string err;
+    if (inputReplay.OpenRead(options.replayInput, physicsHz, &err))
+      std::cout << "[Input] Replaying " << options.replayInput << std::endl;
+    else
+      std::cerr << "[Input] Replay: " << err << std::endl;
+  }
+  // Every step's state, compressed and written off the main thread
+  TelemetryWriter telemetry;
+  if (!options.telemetry.empty()) {
+    std::string err;
+    if (telemetry.Open(options.telemetry,
+                       MakeRobotTelemetryColumns(options.telemetryBlocks),
+                       physicsTimestep, &err))
+      std::cout << "[Telemetry] Logging to " << options.telemetry << std::endl;
+    else
+      std::cerr << "[Telemetry] " << err << std::endl;
+  }
+  // Autonomous routine: drives the robot until it finishes, then the
+  // controller takes over
+  std::unique_ptr<AutonRunner> auton;
+  size_t autonSteps = 0;
+  if (!options.auton.empty()) {
+    AutonRoutine routine;
+    std::string err;
+    if (routine.Load(options.auton, &err)) {
+      AutonConfig autonConfig;
+      ParsePathController(options.pathController, autonConfig.controller);
+      float driveDirection = MeasureDriveDirection(physics);
+      if (routine.HasStart())
+        robot.Reset(routine.GetStart(driveDirection, 0.5f), robot.GetConfig());
+      auton = std::make_unique<AutonRunner>(
+          autonConfig, robot.GetWheelRadius(),
+          robot.GetConfig().maxWheelSpeed, driveDirection);
+      auton->Start(routine);
+      autonSteps = routine.GetSteps().size();
+      std::cout << "[Auton] Running " << options.auton << " ("
+                << autonSteps << " steps, "
+                << GetPathControllerName(autonConfig.controller) << ")"
+                << std::endl;
+    } else {
+      std::cerr << "[Auton] " << err << std::endl;
+    }
+  }
+  ControllerState prevInput;
   int spawnCounter = 0;
 
   // --- Main Loop ---
@@ -289,59 +406,90 @@ int main() {
       framebufferResized = false;
       int w, h;
       glfwGetFramebufferSize(window, &w, &h);
-      if (w > 0 && h > 0) {
+      if (w > 0 && h > 0)
         vulkan.RecreateSwapchain(w, h);
-        pipeline.Destroy(vulkan.GetDevice());
-        pipeline.Create(vulkan.GetDevice(), vulkan.GetRenderPass(),
-                        vulkan.GetDepthFormat(), "shaders/basic.vert.spv",
-                        "shaders/basic.frag.spv");
-      }
       continue;
     }
 
-    // --- Robot Input ---
-    // A = right forward, D = left forward, Z = right backward, C = left
-    // backward
-    float leftInput = 0.0f, rightInput = 0.0f;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-      rightInput += 1.0f; // Right wheels forward
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-      leftInput += 1.0f; // Left wheels forward
-    if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS)
-      rightInput -= 1.0f; // Right wheels backward
-    if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS)
-      leftInput -= 1.0f; // Left wheels backward
-    robot.SetDriveInput(leftInput, rightInput);
-
-    // --- Spawn Blocks (R = red, B = blue) ---
-    {
-      bool rPressed = glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS;
-      if (rPressed && !rWasPressed) {
-        // Spawn above the robot's position
-        PxVec3 spawnPos = robot.GetFrontPosition();
-        spawnPos.y += 0.3f;
-        blocks.push_back(SpawnBlock(physics.GetPhysics(), physics.GetScene(),
-                                    physics.GetDefaultMaterial(),
-                                    BlockColor::RED, spawnPos));
-      }
-      rWasPressed = rPressed;
+    if (pendingMsaa != vulkan.GetSampleCount() ||
+        pendingRenderScale != vulkan.GetRenderScale()) {
+      vulkan.SetRenderSettings(static_cast<VkSampleCountFlagBits>(pendingMsaa),
+                               pendingRenderScale);
+      // The device may not support the requested count
+      pendingMsaa = vulkan.GetSampleCount();
+      pendingRenderScale = vulkan.GetRenderScale();
+    }
+
+    // The viewport and scissor are dynamic, so the pipeline survives
+    // resizes; only a new render pass (surface format or MSAA change) needs
+    // one
+    if (vulkan.GetRenderPassGeneration() != pipelineGeneration) {
+      pipelineGeneration = vulkan.GetRenderPassGeneration();
+      pipeline.Destroy(vulkan.GetDevice());
+      pipeline.Create(vulkan.GetDevice(), vulkan.GetRenderPass(),
+                      vulkan.GetDepthFormat(), "shaders/basic.vert.spv",
+                      "shaders/basic.frag.spv", vulkan.GetPipelineCache(),
+                      vulkan.GetSampleCount());
+    }
+    // ImGui's pipeline was built against the overlay pass it was given at
+    // init; a new surface format replaces that pass, so restart its backend
+    if (vulkan.GetOverlayGeneration() != overlayGeneration) {
+      overlayGeneration = vulkan.GetOverlayGeneration();
+      vkDeviceWaitIdle(vulkan.GetDevice());
+      ImGui_ImplVulkan_Shutdown();
+      initInfo.RenderPass = vulkan.GetOverlayRenderPass();
+      ImGui_ImplVulkan_Init(&initInfo);
+      ImGui_ImplVulkan_CreateFontsTexture();
+    }
+    if (shaderReloader) {
+      shaderReloader->Update(vulkan.GetDevice(), vulkan.GetRenderPass(),
+                             vulkan.GetRenderPassGeneration(),
+                             vulkan.GetDepthFormat(), vulkan.GetSampleCount(),
+                             vulkan.GetPipelineCache(), pipeline,
+                             vulkan.GetImageCount());
+    }
 
-      bool bPressed = glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS;
-      if (bPressed && !bWasPressed) {
+    // --- Physics Update (fixed timestep) ---
+    physicsAccumulator += dt;
+    while (physicsAccumulator >= physicsTimestep) {
+      // --- Controller Input (one sample per step) ---
+      ControllerState input;
+      if (inputReplay.IsReading() && !inputReplay.Read(input)) {
+        std::cout << "[Input] Replay finished after "
+                  << inputReplay.GetStepCount() << " steps" << std::endl;
+        inputReplay.Close();
+      }
+      if (!inputReplay.IsReading())
+        input = inputMapping.Sample(window);
+      inputRecord.Write(input);
+
+      float leftInput = 0.0f, rightInput = 0.0f;
+      if (auton && !auton->Update(robot.GetChassis()->getGlobalPose(),
+                                  physicsTimestep, leftInput, rightInput)) {
+        std::cout << "[Auton] Finished, mean tracking error "
+                  << auton->GetMeanTrackingError() * 100.0f << " cm"
+                  << std::endl;
+        auton.reset();
+      }
+      if (!auton)
+        ComputeDrive(input, driveMode, leftInput, rightInput);
+      robot.SetDriveInput(leftInput, rightInput);
+
+      // Spawn above the robot's front (X = red, B = blue)
+      bool spawnRed = input.Pressed(ControllerButton::eX, prevInput);
+      bool spawnBlue = input.Pressed(ControllerButton::eB, prevInput);
+      if (spawnRed || spawnBlue) {
         PxVec3 spawnPos = robot.GetFrontPosition();
         spawnPos.y += 0.3f;
-        blocks.push_back(SpawnBlock(physics.GetPhysics(), physics.GetScene(),
-                                    physics.GetDefaultMaterial(),
-                                    BlockColor::BLUE, spawnPos));
+        if (spawnRed)
+          blocks.push_back(SpawnBlock(physics, BlockColor::RED, spawnPos));
+        if (spawnBlue)
+          blocks.push_back(SpawnBlock(physics, BlockColor::BLUE, spawnPos));
       }
-      bWasPressed = bPressed;
-    }
 
-    // --- Intake (F) ---
-    {
-      bool fPressed = glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS;
-      if (fPressed && !fWasPressed && !robot.IsIntakeFull()) {
-        // Try to intake the nearest block
+      // Intake (R1) the nearest block
+      if (input.Pressed(ControllerButton::eR1, prevInput) &&
+          !robot.IsIntakeFull()) {
         float bestDist = 999.0f;
         GameBlock *bestBlock = nullptr;
         PxVec3 frontPos = robot.GetFrontPosition();
@@ -360,77 +508,127 @@ int main() {
           robot.TryIntake(*bestBlock, physics.GetPhysics());
         }
       }
-      fWasPressed = fPressed;
-    }
 
-    // --- Outtake (G) ---
-    {
-      bool gPressed = glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS;
-      if (gPressed && !gWasPressed) {
+      // Outtake (R2)
+      if (input.Pressed(ControllerButton::eR2, prevInput))
         robot.Outtake();
-      }
-      gWasPressed = gPressed;
-    }
+      prevInput = input;
 
-    // --- Physics Update (fixed timestep) ---
-    physicsAccumulator += dt;
-    while (physicsAccumulator >= physicsTimestep) {
       robot.Update(physicsTimestep);
+      for (GameBlock &block : blocks) {
+        if (block.body)
+          block.prevPose = block.body->getGlobalPose();
+      }
       physics.Update(physicsTimestep);
       physicsAccumulator -= physicsTimestep;
+      if (telemetry.IsOpen()) {
+        FillRobotTelemetry(telemetry.BeginRow(), robot, blocks,
+                           options.telemetryBlocks);
+        telemetry.CommitRow();
+      }
     }
+    // Fraction of a step simulated ahead of the render time: draw and track
+    // poses blended between the last two steps
+    float renderAlpha = physicsAccumulator / physicsTimestep;
+    glm::mat4 robotRenderTransform =
+        robot.GetTransformMatrix(0.01f, renderAlpha);
 
     // --- Camera Input ---
+    // V cycles orbit / follow / cinematic
+    bool vPressed = glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS;
+    if (vPressed && !vWasPressed) {
+      camera.SetMode(static_cast<CameraMode>(
+          (static_cast<int>(camera.GetMode()) + 1) % 3));
+    }
+    vWasPressed = vPressed;
+    camera.SetFollowTarget(robotRenderTransform);
     camera.ProcessInput(window, dt);
+    camera.Update(dt);
+
+    if (pendingShadowQuality != shadowMap.GetQuality()) {
+      shadowMap.SetQuality(pendingShadowQuality);
+      sceneBuffers.SetShadowMap(shadowMap.GetView(), shadowMap.GetSampler());
+    }
 
     // --- Render Frame ---
     VkCommandBuffer cmd;
     if (vulkan.BeginFrame(cmd)) {
-      pipeline.Bind(cmd);
-
-      VkExtent2D extent = vulkan.GetSwapchainExtent();
+      uint32_t frame = vulkan.GetCurrentImageIndex();
+      VkExtent2D extent = vulkan.GetRenderExtent();
       float aspect =
           static_cast<float>(extent.width) / static_cast<float>(extent.height);
-      glm::mat4 vp = camera.GetViewProjection(aspect);
-      VkPipelineLayout layout = pipeline.GetLayout();
-
-      // Draw field
-      if (!fieldMeshes.empty()) {
-        DrawWithPushConstants(
-            cmd, layout, vp, glm::mat4(1.0f),
-            [&](VkCommandBuffer c) { DrawModel(c, fieldMeshes); });
-      }
-
-      // Draw robot
-      if (!robotMeshes.empty()) {
-        glm::mat4 robotModel = robot.GetTransformMatrix(0.01f);
-        DrawWithPushConstants(
-            cmd, layout, vp, robotModel,
-            [&](VkCommandBuffer c) { DrawModel(c, robotMeshes); });
-      }
-
-      // Draw blocks
+      // A recreated swapchain may have more images than before
+      sceneBuffers.EnsureFrames(vulkan.GetImageCount());
+      gpuTimer.EnsureFrames(vulkan.GetImageCount());
+      recorder.EnsureFrames(vulkan.GetImageCount());
+      gpuTimer.BeginFrame(cmd, frame);
+
+      CameraData cameraData = {};
+      cameraData.viewProj = camera.GetViewProjection(aspect);
+      cameraData.view = camera.GetViewMatrix();
+      shadowMap.FitCascades(camera, aspect, cameraData);
+      sceneBuffers.BeginFrame(frame, cameraData);
+      drawItems.clear();
+
+      auto addItem = [&](const std::vector<Mesh> &meshes,
+                         const glm::mat4 &transform) {
+        DrawItem item;
+        item.meshes = &meshes;
+        item.object = sceneBuffers.AddObject(transform);
+        GetModelBounds(meshes, transform, item.boundsMin, item.boundsMax);
+        drawItems.push_back(item);
+      };
+
+      // Field
+      if (!fieldMeshes.empty())
+        addItem(fieldMeshes, glm::mat4(1.0f));
+
+      // Robot
+      robotTransforms.assign(1, robotRenderTransform);
+      if (!robotMeshes.empty())
+        addItem(robotMeshes, robotTransforms[0]);
+
+      // Blocks
       for (const auto &block : blocks) {
         if (!block.body)
           continue;
 
+        // Interpolated like the robot, so held blocks stay attached
         PxTransform pose = block.body->getGlobalPose();
-        glm::quat q(pose.q.w, pose.q.x, pose.q.y, pose.q.z);
+        const PxTransform &prev = block.prevPose;
+        glm::quat q = glm::slerp(
+            glm::quat(prev.q.w, prev.q.x, prev.q.y, prev.q.z),
+            glm::quat(pose.q.w, pose.q.x, pose.q.y, pose.q.z), renderAlpha);
+        glm::vec3 p = glm::mix(glm::vec3(prev.p.x, prev.p.y, prev.p.z),
+                               glm::vec3(pose.p.x, pose.p.y, pose.p.z),
+                               renderAlpha);
         glm::mat4 blockModel =
-            glm::translate(glm::mat4(1.0f),
-                           glm::vec3(pose.p.x, pose.p.y, pose.p.z)) *
-            glm::mat4_cast(q);
+            glm::translate(glm::mat4(1.0f), p) * glm::mat4_cast(q);
 
         const auto &meshes =
             (block.color == BlockColor::RED) ? redBlockMeshes : blueBlockMeshes;
 
-        if (!meshes.empty()) {
-          DrawWithPushConstants(
-              cmd, layout, vp, blockModel,
-              [&](VkCommandBuffer c) { DrawModel(c, meshes); });
-        }
+        if (!meshes.empty())
+          addItem(meshes, blockModel);
       }
 
+      // All transforms are written; shadow casters first, outside the
+      // swapchain render pass
+      uint32_t shadowScope = gpuTimer.Begin(cmd, "shadows");
+      shadowMap.Record(cmd, sceneBuffers, drawItems);
+      gpuTimer.End(cmd, shadowScope);
+
+      // Every view shares the objects, bounds and shadow map above
+      sceneViews.Update(camera, extent, fieldMin, fieldMax, robotTransforms);
+      sceneViews.Upload(sceneBuffers, cameraData);
+      sceneViews.Cull(drawItems);
+
+      vulkan.BeginMainPass();
+      uint32_t sceneScope = gpuTimer.Begin(cmd, "scene");
+      pipeline.Bind(cmd);
+      sceneViews.Record(cmd, pipeline, sceneBuffers, gpuTimer, drawItems);
+      gpuTimer.End(cmd, sceneScope);
+
       // --- ImGui Rendering ---
       // Wait for GPU to finish previous frames before ImGui potentially
       // resizes its vertex/index buffers (prevents vkDestroyBuffer errors)
@@ -478,9 +676,12 @@ int main() {
           row("B", "Spawn blue block");
           row("F", "Intake block");
           row("G", "Outtake block");
+          row("J / L", "Turn (arcade, curvature)");
+          row("Gamepad", "Sticks drive, RB / RT in / out");
           row("Arrows", "Pan camera");
           row("RMB drag", "Orbit camera");
           row("+  /  -", "Zoom in / out");
+          row("V", "Camera: orbit / follow / cinematic");
           row("H", "Toggle this panel");
           row("ESC", "Quit");
 
@@ -491,19 +692,170 @@ int main() {
         ImGui::Text("Blocks on field: %d", static_cast<int>(blocks.size()));
         ImGui::Text("Blocks held: %d / %d", robot.GetHeldCount(), 8);
         ImGui::Text("FPS: %.0f", io.Framerate);
+        ImGui::Text("Last resize: %.1f ms", vulkan.GetLastRecreateMs());
+        if (gpuTimer.IsSupported()) {
+          ImGui::Text("GPU: shadows %.2f ms | scene %.2f ms",
+                      gpuTimer.GetMs("shadows"), gpuTimer.GetMs("scene"));
+        }
+
+        // Applied before the next frame: this one already references the
+        // current shadow image
+        int quality = static_cast<int>(pendingShadowQuality);
+        const char *qualities[] = {"Off", "Low", "Medium", "High"};
+        if (ImGui::Combo("Shadows", &quality, qualities, 4))
+          pendingShadowQuality = static_cast<ShadowQuality>(quality);
+
+        int msaaIndex = 0;
+        while ((2 << msaaIndex) <= pendingMsaa && msaaIndex < 3)
+          msaaIndex++;
+        const char *msaaModes[] = {"Off", "2x", "4x", "8x"};
+        if (ImGui::Combo("MSAA", &msaaIndex, msaaModes, 4))
+          pendingMsaa = 1 << msaaIndex;
+        ImGui::SliderFloat("Render scale", &pendingRenderScale, 0.25f, 1.0f,
+                           "%.2f");
+
+        int mode = static_cast<int>(camera.GetMode());
+        const char *modes[] = {"Orbit", "Follow robot", "Cinematic"};
+        if (ImGui::Combo("Camera", &mode, modes, 3))
+          camera.SetMode(static_cast<CameraMode>(mode));
+        int drive = static_cast<int>(driveMode);
+        const char *drives[] = {"Tank", "Arcade", "Curvature"};
+        if (ImGui::Combo("Drive", &drive, drives, 3))
+          driveMode = static_cast<DriveMode>(drive);
+        std::string gamepadName = inputMapping.GetGamepadName();
+        ImGui::Text("Gamepad: %s",
+                    gamepadName.empty() ? "none" : gamepadName.c_str());
+        if (inputReplay.IsReading()) {
+          ImGui::Text("Input: replaying %s (step %llu)",
+                      options.replayInput.c_str(),
+                      static_cast<unsigned long long>(
+                          inputReplay.GetStepCount()));
+        } else if (inputRecord.IsWriting()) {
+          ImGui::Text("Input: recording %s (%llu steps)",
+                      options.recordInput.c_str(),
+                      static_cast<unsigned long long>(
+                          inputRecord.GetStepCount()));
+        }
+        if (auton) {
+          ImGui::Text("Autonomous: step %zu/%zu (%s)",
+                      auton->GetStepIndex() + 1, autonSteps,
+                      options.pathController.c_str());
+          ImGui::SameLine();
+          if (ImGui::SmallButton("Stop"))
+            auton.reset();
+        }
+        if (telemetry.IsOpen()) {
+          ImGui::Text("Telemetry: %s (%llu steps, %.1f MB written)",
+                      options.telemetry.c_str(),
+                      static_cast<unsigned long long>(telemetry.GetRowCount()),
+                      telemetry.GetBytesWritten() / (1024.0 * 1024.0));
+        }
+        ImGui::Checkbox("Overview", &sceneViews.showOverview);
+        ImGui::SameLine();
+        ImGui::Checkbox("Driver", &sceneViews.showDriver);
+        ImGui::SameLine();
+        ImGui::Checkbox("Chase", &sceneViews.showChase);
+        for (const SceneView &view : sceneViews.GetViews()) {
+          ImGui::Text("%-8s %3zu/%zu drawn | cull %.3f ms | record %.3f ms"
+                      " | GPU %.2f ms",
+                      view.name, view.visible.size(), drawItems.size(),
+                      view.cullMs, view.recordMs, gpuTimer.GetMs(view.name));
+        }
+        VkExtent2D renderExtent = vulkan.GetRenderExtent();
+        ImGui::Text("Scene resolution: %ux%u", renderExtent.width,
+                    renderExtent.height);
+        ImGui::Text("Shadow casters drawn: %u (%u cascades, %u px)",
+                    shadowMap.GetCasterDraws(), shadowMap.GetCascadeCount(),
+                    shadowMap.GetResolution());
+        if (recorder.IsRecording()) {
+          if (ImGui::Button("Stop recording"))
+            recorder.Stop();
+          ImGui::SameLine();
+          ImGui::Text("%s: %llu frames, %llu dropped, encode %.1f ms",
+                      recorder.GetPath().c_str(),
+                      static_cast<unsigned long long>(
+                          recorder.GetFramesWritten()),
+                      static_cast<unsigned long long>(
+                          recorder.GetFramesDropped()),
+                      recorder.GetEncodeMs());
+        } else if (ImGui::Button("Record")) {
+          recorder.Start(recordPath, vulkan.GetSwapchainFormat(),
+                         options.recordFps);
+        }
+        if (shaderReloader && !shaderReloader->GetLastError().empty()) {
+          ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f),
+                             "Shader reload failed (see console)");
+        }
+
+        const StepTiming &stepTiming = physics.GetLastStepTiming();
+        ImGui::Text("Physics: collide %.2f ms | solve %.2f ms (%s)",
+                    stepTiming.collideMs, stepTiming.solveMs,
+                    options.broadPhase.c_str());
+        ImGui::Text("Field collision: %s (%d boxes, %d hulls, %d tri meshes)",
+                    FieldCollisionModeName(fieldCollisionMode),
+                    fieldCollisionStats.boxes, fieldCollisionStats.hulls,
+                    fieldCollisionStats.triangleMeshes);
+        ImGui::Text("Awake bodies: %u", physics.GetAwakeBodyCount());
+        ImGui::PlotLines("##awake", physics.GetAwakeHistory(),
+                         PhysicsWorld::kAwakeHistorySize,
+                         physics.GetAwakeHistoryOffset(), nullptr, 0.0f,
+                         FLT_MAX, ImVec2(0, 40));
+
+        AllocatorStats physxMem = physics.GetAllocatorStats();
+        ImGui::Text("PhysX memory: %.2f MB (peak %.2f MB)",
+                    physxMem.liveBytes / (1024.0 * 1024.0),
+                    physxMem.peakBytes / (1024.0 * 1024.0));
+        ImGui::Text("PhysX allocs/step: %llu",
+                    static_cast<unsigned long long>(
+                        physics.GetLastStepAllocations()));
+
+        if (ImGui::CollapsingHeader("PhysX allocations")) {
+          if (ImGui::BeginTable("physxAllocs", 3,
+                                ImGuiTableFlags_RowBg |
+                                    ImGuiTableFlags_BordersInnerV)) {
+            ImGui::TableSetupColumn("Name");
+            ImGui::TableSetupColumn("Live KB", ImGuiTableColumnFlags_WidthFixed,
+                                    60.0f);
+            ImGui::TableSetupColumn("Peak KB", ImGuiTableColumnFlags_WidthFixed,
+                                    60.0f);
+            ImGui::TableHeadersRow();
+
+            size_t shown = std::min<size_t>(physxMem.categories.size(), 10);
+            for (size_t i = 0; i < shown; i++) {
+              const AllocationCategoryStats &cat = physxMem.categories[i];
+              ImGui::TableNextRow();
+              ImGui::TableNextColumn();
+              ImGui::TextUnformatted(cat.name.c_str());
+              ImGui::TableNextColumn();
+              ImGui::Text("%.1f", cat.liveBytes / 1024.0);
+              ImGui::TableNextColumn();
+              ImGui::Text("%.1f", cat.peakBytes / 1024.0);
+            }
+            ImGui::EndTable();
+          }
+        }
 
         ImGui::End();
       }
 
       ImGui::Render();
+      // The UI stays at window resolution whatever the render scale
+      vulkan.BeginOverlayPass();
       ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cmd);
 
-      vulkan.EndFrame();
+      vulkan.EndFrame(&recorder);
     }
   }
 
   // --- Cleanup ---
+  if (telemetry.IsOpen()) {
+    telemetry.Close();
+    std::cout << "[Telemetry] " << telemetry.GetRowCount() << " steps, "
+              << telemetry.GetBytesWritten() << " bytes -> "
+              << options.telemetry << std::endl;
+  }
   vkDeviceWaitIdle(vulkan.GetDevice());
+  recorder.Destroy();
   ImGui_ImplVulkan_Shutdown();
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
@@ -512,6 +864,11 @@ int main() {
   DestroyModel(vulkan.GetAllocator(), fieldMeshes);
   DestroyModel(vulkan.GetAllocator(), redBlockMeshes);
   DestroyModel(vulkan.GetAllocator(), blueBlockMeshes);
+  if (shaderReloader)
+    shaderReloader->Shutdown(vulkan.GetDevice());
+  gpuTimer.Destroy();
+  sceneBuffers.Destroy();
+  shadowMap.Destroy();
   pipeline.Destroy(vulkan.GetDevice());
   vulkan.Cleanup();
 
@@ -4,6 +4,31 @@
 #include <GLFW/glfw3.h>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+
+bool ParseCameraMode(const char *name, CameraMode &out) {
+  if (!strcmp(name, "orbit"))
+    out = CameraMode::eORBIT;
+  else if (!strcmp(name, "follow"))
+    out = CameraMode::eFOLLOW;
+  else if (!strcmp(name, "cinematic"))
+    out = CameraMode::eCINEMATIC;
+  else
+    return false;
+  return true;
+}
+
+const char *GetCameraModeName(CameraMode mode) {
+  switch (mode) {
+  case CameraMode::eORBIT:
+    return "orbit";
+  case CameraMode::eFOLLOW:
+    return "follow";
+  case CameraMode::eCINEMATIC:
+    return "cinematic";
+  }
+  return "orbit";
+}
 
 void Camera::Init(float distance, float yaw, float pitch) {
   mDistance = distance;
@@ -12,6 +37,44 @@ void Camera::Init(float distance, float yaw, float pitch) {
   mTarget = glm::vec3(0.0f, 0.5f, 0.0f); // Slightly above ground
 }
 
+void Camera::SetMode(CameraMode mode) {
+  if (mode == CameraMode::eCINEMATIC && mMode != mode)
+    mPathTime = 0.0f;
+  mMode = mode;
+}
+
+void Camera::SetFollowTarget(const glm::mat4 &transform) {
+  mFollowPosition = glm::vec3(transform[3]);
+  glm::vec3 forward(transform[2].x, 0.0f, transform[2].z);
+  if (glm::length(forward) > 1e-6f)
+    mFollowForward = glm::normalize(forward);
+  mHasFollowTarget = true;
+}
+
+void Camera::Update(float dt) {
+  if (mMode == CameraMode::eCINEMATIC) {
+    mPathTime += dt;
+    if (!mPath.IsEmpty())
+      mPath.Evaluate(mPathTime, mPathEye, mPathTarget);
+    return;
+  }
+  if (mMode != CameraMode::eFOLLOW || !mHasFollowTarget)
+    return;
+
+  // Exponential smoothing, independent of frame rate
+  float blend = 1.0f - std::exp(-dt / mFollowTime);
+  mTarget += (mFollowPosition - mTarget) * blend;
+
+  // Swing behind the heading unless the user is orbiting by hand; the eye
+  // offset is (cos yaw, _, sin yaw), so behind means -forward
+  if (!mDragging) {
+    float goalYaw =
+        glm::degrees(std::atan2(-mFollowForward.z, -mFollowForward.x));
+    float delta = std::remainder(goalYaw - mYaw, 360.0f);
+    mYaw += delta * (1.0f - std::exp(-dt / mFollowYawTime));
+  }
+}
+
 glm::vec3 Camera::GetEyePosition() const {
   float yawRad = glm::radians(mYaw);
   float pitchRad = glm::radians(mPitch);
@@ -25,6 +88,8 @@ glm::vec3 Camera::GetEyePosition() const {
 }
 
 glm::mat4 Camera::GetViewMatrix() const {
+  if (mMode == CameraMode::eCINEMATIC && !mPath.IsEmpty())
+    return glm::lookAt(mPathEye, mPathTarget, glm::vec3(0.0f, 1.0f, 0.0f));
   return glm::lookAt(GetEyePosition(), mTarget, glm::vec3(0.0f, 1.0f, 0.0f));
 }
 
@@ -80,6 +145,9 @@ void Camera::ProcessInput(GLFWwindow *window, float dt) {
   mDistance = std::clamp(mDistance, mMinDistance, mMaxDistance);
 
   // --- Arrow keys to pan target ---
+  // Only the free orbit has a user-placed target
+  if (mMode != CameraMode::eORBIT)
+    return;
   // Calculate forward/right relative to camera yaw (projected on XZ plane)
   float yawRad = glm::radians(mYaw);
   glm::vec3 forward(-cos(yawRad), 0.0f, -sin(yawRad));
@@ -1,10 +1,20 @@
 #pragma once
 
+#include "renderer/CameraPath.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 struct GLFWwindow;
 
+// eORBIT: free orbit around a target moved with the arrow keys.
+// eFOLLOW: the target eases towards the followed pose and the orbit swings
+// round behind its heading; dragging still orbits, zoom still works.
+// eCINEMATIC: eye and target come from a CameraPath.
+enum class CameraMode { eORBIT, eFOLLOW, eCINEMATIC };
+
+bool ParseCameraMode(const char *name, CameraMode &out);
+const char *GetCameraModeName(CameraMode mode);
+
 class Camera {
 public:
   void Init(float distance = 5.0f, float yaw = -90.0f, float pitch = 25.0f);
@@ -12,10 +22,24 @@ public:
   // Call each frame with delta time
   void ProcessInput(GLFWwindow *window, float dt);
 
+  void SetMode(CameraMode mode);
+  CameraMode GetMode() const { return mMode; }
+  // Pose eFOLLOW tracks (local +Z forward). Pass the interpolated render
+  // transform every frame, before Update, so tracking does not step with
+  // the fixed physics rate.
+  void SetFollowTarget(const glm::mat4 &transform);
+  void SetPath(const CameraPath &path) { mPath = path; }
+  // Advances follow smoothing and the path clock; call after ProcessInput
+  void Update(float dt);
+
   glm::mat4 GetViewMatrix() const;
   glm::mat4 GetProjectionMatrix(float aspectRatio) const;
   glm::mat4 GetViewProjection(float aspectRatio) const;
 
+  float GetFov() const { return mFov; } // Vertical, degrees
+  float GetNearPlane() const { return mNearPlane; }
+  float GetFarPlane() const { return mFarPlane; }
+
 private:
   // Orbital parameters
   glm::vec3 mTarget = glm::vec3(0.0f);
@@ -40,5 +64,17 @@ private:
   float mNearPlane = 0.1f;
   float mFarPlane = 200.0f;
 
+  // Modes
+  CameraMode mMode = CameraMode::eORBIT;
+  glm::vec3 mFollowPosition = glm::vec3(0.0f);
+  glm::vec3 mFollowForward = glm::vec3(0.0f, 0.0f, 1.0f);
+  bool mHasFollowTarget = false;
+  float mFollowTime = 0.15f;    // Seconds to close ~63% of the gap
+  float mFollowYawTime = 0.6f;  // Slower, so turns do not whip the view
+  CameraPath mPath;
+  float mPathTime = 0.0f;
+  glm::vec3 mPathEye = glm::vec3(0.0f);
+  glm::vec3 mPathTarget = glm::vec3(0.0f);
+
   glm::vec3 GetEyePosition() const;
 };
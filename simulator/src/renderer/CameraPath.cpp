@@ -0,0 +1,115 @@
+#include "renderer/CameraPath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+bool CameraPath::Load(const std::string &path, std::string *err) {
+  std::ifstream file(path);
+  if (!file) {
+    if (err)
+      *err = "cannot open " + path;
+    return false;
+  }
+
+  mKeys.clear();
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(file, line)) {
+    lineNumber++;
+    line = line.substr(0, line.find('#'));
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+    std::istringstream in(line);
+    Key key;
+    if (!(in >> key.time >> key.eye.x >> key.eye.y >> key.eye.z >>
+          key.target.x >> key.target.y >> key.target.z)) {
+      if (err)
+        *err = path + ":" + std::to_string(lineNumber) +
+               ": expected time, eye xyz and target xyz";
+      mKeys.clear();
+      return false;
+    }
+    AddKey(key);
+  }
+  if (mKeys.size() < 2) {
+    if (err)
+      *err = path + ": a path needs at least two keys";
+    mKeys.clear();
+    return false;
+  }
+  return true;
+}
+
+CameraPath CameraPath::MakeOrbit(const glm::vec3 &center, float radius,
+                                 float height, float period) {
+  // Eight keys round the circle plus a closing one; the spline rounds the
+  // octagon off
+  const int keyCount = 8;
+  CameraPath path;
+  for (int i = 0; i <= keyCount; i++) {
+    float angle = 2.0f * 3.14159265f * static_cast<float>(i) / keyCount;
+    Key key;
+    key.time = period * static_cast<float>(i) / keyCount;
+    key.eye = center + glm::vec3(radius * std::cos(angle), height,
+                                 radius * std::sin(angle));
+    key.target = center;
+    path.AddKey(key);
+  }
+  return path;
+}
+
+void CameraPath::AddKey(const Key &key) {
+  auto it = std::upper_bound(
+      mKeys.begin(), mKeys.end(), key.time,
+      [](float time, const Key &other) { return time < other.time; });
+  mKeys.insert(it, key);
+}
+
+static glm::vec3 CatmullRom(const glm::vec3 &p0, const glm::vec3 &p1,
+                            const glm::vec3 &p2, const glm::vec3 &p3,
+                            float t) {
+  float t2 = t * t, t3 = t2 * t;
+  return 0.5f * ((2.0f * p1) + (p2 - p0) * t +
+                 (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                 (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
+
+void CameraPath::Evaluate(float time, glm::vec3 &eye,
+                          glm::vec3 &target) const {
+  if (mKeys.empty())
+    return;
+  if (mKeys.size() == 1 || GetDuration() <= 0.0f) {
+    eye = mKeys.front().eye;
+    target = mKeys.front().target;
+    return;
+  }
+
+  float duration = GetDuration();
+  time = std::fmod(time, duration);
+  if (time < 0.0f)
+    time += duration;
+
+  size_t last = mKeys.size() - 1;
+  size_t i = 0;
+  while (i + 1 < last && mKeys[i + 1].time <= time)
+    i++;
+  const Key &k1 = mKeys[i];
+  const Key &k2 = mKeys[i + 1];
+  // A path that ends where it starts is a closed loop: neighbours wrap so
+  // the seam is smooth. Open paths repeat their end keys instead.
+  bool closed =
+      glm::length(mKeys.front().eye - mKeys.back().eye) < 1e-4f &&
+      glm::length(mKeys.front().target - mKeys.back().target) < 1e-4f;
+  size_t prev = i > 0 ? i - 1 : (closed ? last - 1 : i);
+  size_t next = i + 2 <= last ? i + 2 : (closed ? 1 : last);
+  const Key &k0 = mKeys[prev];
+  const Key &k3 = mKeys[next];
+
+  float span = k2.time - k1.time;
+  float t = span > 0.0f ? std::clamp((time - k1.time) / span, 0.0f, 1.0f)
+                        : 0.0f;
+  eye = CatmullRom(k0.eye, k1.eye, k2.eye, k3.eye, t);
+  target = CatmullRom(k0.target, k1.target, k2.target, k3.target, t);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+// Scripted camera move for replay videos: keyframes of eye and look-at
+// positions at given times, interpolated with a Catmull-Rom spline so the
+// camera passes through every key without velocity jumps. The path repeats
+// after its last key; one whose last key equals its first is a smooth loop.
+//
+// Text format, one key per line ('#' starts a comment):
+//   time  eye.x eye.y eye.z  target.x target.y target.z
+class CameraPath {
+public:
+  struct Key {
+    float time;
+    glm::vec3 eye;
+    glm::vec3 target;
+  };
+
+  bool Load(const std::string &path, std::string *err = nullptr);
+  // Circles `center` once per `period` seconds; used when no file is given
+  static CameraPath MakeOrbit(const glm::vec3 &center, float radius,
+                              float height, float period);
+
+  void AddKey(const Key &key);
+  bool IsEmpty() const { return mKeys.empty(); }
+  float GetDuration() const { return mKeys.empty() ? 0.0f : mKeys.back().time; }
+
+  void Evaluate(float time, glm::vec3 &eye, glm::vec3 &target) const;
+
+private:
+  std::vector<Key> mKeys; // Sorted by time
+};
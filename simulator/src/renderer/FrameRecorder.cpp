@@ -0,0 +1,348 @@
+#include "renderer/FrameRecorder.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// Frames waiting for the encoder before new ones are dropped
+static const size_t kMaxQueued = 4;
+static const double kSmoothing = 0.1; // Weight of each new encode time
+
+FrameRecorder::~FrameRecorder() { Destroy(); }
+
+void FrameRecorder::Create(VkDevice device, VmaAllocator allocator,
+                           uint32_t frameCount) {
+  mDevice = device;
+  mAllocator = allocator;
+  EnsureFrames(frameCount);
+}
+
+void FrameRecorder::Destroy() {
+  if (mRecording)
+    Stop();
+  for (Slot &slot : mSlots)
+    DestroySlot(slot);
+  mSlots.clear();
+}
+
+void FrameRecorder::EnsureFrames(uint32_t frameCount) {
+  if (mSlots.size() < frameCount)
+    mSlots.resize(frameCount);
+}
+
+void FrameRecorder::DestroySlot(Slot &slot) {
+  if (slot.buffer)
+    vmaDestroyBuffer(mAllocator, slot.buffer, slot.allocation);
+  slot = Slot();
+}
+
+// Host-cached memory: the CPU reads the whole buffer back, which is very
+// slow from write-combined memory
+bool FrameRecorder::EnsureSlotSize(Slot &slot, VkDeviceSize size) {
+  if (slot.buffer && slot.size >= size)
+    return true;
+  DestroySlot(slot);
+
+  VkBufferCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  info.size = size;
+  info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo allocInfo = {};
+  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
+                    VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VmaAllocationInfo mapped;
+  if (vmaCreateBuffer(mAllocator, &info, &allocInfo, &slot.buffer,
+                      &slot.allocation, &mapped) != VK_SUCCESS) {
+    std::cerr << "[FrameRecorder] Failed to create readback buffer"
+              << std::endl;
+    slot = Slot();
+    return false;
+  }
+  slot.mapped = mapped.pMappedData;
+  slot.size = size;
+  return true;
+}
+
+bool FrameRecorder::Start(const std::string &path, VkFormat format,
+                          uint32_t fps) {
+  if (mRecording)
+    Stop();
+
+  switch (format) {
+  case VK_FORMAT_B8G8R8A8_SRGB:
+  case VK_FORMAT_B8G8R8A8_UNORM:
+    mBgra = true;
+    break;
+  case VK_FORMAT_R8G8B8A8_SRGB:
+  case VK_FORMAT_R8G8B8A8_UNORM:
+    mBgra = false;
+    break;
+  default:
+    std::cerr << "[FrameRecorder] Unsupported swapchain format " << format
+              << ", not recording" << std::endl;
+    return false;
+  }
+
+  mFile = fopen(path.c_str(), "wb");
+  if (!mFile) {
+    std::cerr << "[FrameRecorder] Cannot open " << path << std::endl;
+    return false;
+  }
+
+  mPath = path;
+  mY4m = path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0;
+  mFps = std::max(fps, 1u);
+  mInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / mFps));
+  mNextCapture = std::chrono::steady_clock::now();
+  mStreamWidth = mStreamHeight = 0;
+  mFramesWritten = 0;
+  mFramesDropped = 0;
+  mEncodeMs = 0.0;
+  mDone = false;
+  mRecording = true;
+  mEncoder = std::thread(&FrameRecorder::EncoderLoop, this);
+
+  std::cout << "[FrameRecorder] Recording to " << path << " at " << mFps
+            << " fps" << (mY4m ? " (Y4M)" : " (raw)") << std::endl;
+  return true;
+}
+
+void FrameRecorder::Stop() {
+  if (!mRecording)
+    return;
+  // Copies recorded in submitted frames must land before they are read
+  vkDeviceWaitIdle(mDevice);
+  FlushUpTo(UINT64_MAX);
+  mRecording = false;
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mDone = true;
+  }
+  mWake.notify_one();
+  if (mEncoder.joinable())
+    mEncoder.join();
+  fclose(mFile);
+  mFile = nullptr;
+
+  std::cout << "[FrameRecorder] Wrote " << mFramesWritten << " frames ("
+            << mStreamWidth << "x" << mStreamHeight << ") to " << mPath
+            << ", dropped " << mFramesDropped << std::endl;
+}
+
+void FrameRecorder::ReadBack(Slot &slot) {
+  slot.pending = false;
+  uint32_t width = slot.extent.width, height = slot.extent.height;
+  size_t bytes = static_cast<size_t>(width) * height * 4;
+
+  Frame frame;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mQueue.size() >= kMaxQueued) {
+      mFramesDropped++;
+      return;
+    }
+    if (!mFree.empty()) {
+      frame = std::move(mFree.back());
+      mFree.pop_back();
+    }
+  }
+
+  vmaInvalidateAllocation(mAllocator, slot.allocation, 0, VK_WHOLE_SIZE);
+  frame.pixels.resize(bytes);
+  memcpy(frame.pixels.data(), slot.mapped, bytes);
+  frame.width = width;
+  frame.height = height;
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mQueue.push_back(std::move(frame));
+  }
+  mWake.notify_one();
+}
+
+// A slot's fence also covers every earlier submission on the queue, so
+// older pending copies are complete as well; reading them first keeps the
+// stream in capture order when images are acquired out of order
+void FrameRecorder::FlushUpTo(uint64_t sequence) {
+  for (;;) {
+    Slot *oldest = nullptr;
+    for (Slot &slot : mSlots) {
+      if (slot.pending && slot.sequence <= sequence &&
+          (!oldest || slot.sequence < oldest->sequence))
+        oldest = &slot;
+    }
+    if (!oldest)
+      return;
+    ReadBack(*oldest);
+  }
+}
+
+void FrameRecorder::Capture(VkCommandBuffer cmd, uint32_t frame,
+                            VkImage image, VkExtent2D extent) {
+  if (!mRecording || frame >= mSlots.size())
+    return;
+  Slot &slot = mSlots[frame];
+  if (slot.pending)
+    FlushUpTo(slot.sequence);
+
+  auto now = std::chrono::steady_clock::now();
+  if (now < mNextCapture)
+    return;
+  // Skip missed capture times rather than bursting to catch up
+  mNextCapture += mInterval;
+  if (mNextCapture < now)
+    mNextCapture = now + mInterval;
+
+  VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) *
+                      extent.height * 4;
+  if (!EnsureSlotSize(slot, size))
+    return;
+
+  VkImageMemoryBarrier barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = image;
+  barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+  vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                       nullptr, 1, &barrier);
+
+  VkBufferImageCopy region = {};
+  region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+  region.imageExtent = {extent.width, extent.height, 1};
+  vkCmdCopyImageToBuffer(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         slot.buffer, 1, &region);
+
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  barrier.dstAccessMask = 0;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  VkBufferMemoryBarrier hostBarrier = {};
+  hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  hostBarrier.buffer = slot.buffer;
+  hostBarrier.size = VK_WHOLE_SIZE;
+  vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT |
+                           VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                       0, 0, nullptr, 1, &hostBarrier, 1, &barrier);
+
+  slot.pending = true;
+  slot.sequence = mNextSequence++;
+  slot.extent = extent;
+}
+
+// --- Encoder thread ---
+void FrameRecorder::EncoderLoop() {
+  for (;;) {
+    Frame frame;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWake.wait(lock, [this] { return mDone || !mQueue.empty(); });
+      if (mQueue.empty())
+        return; // Done and drained
+      frame = std::move(mQueue.front());
+      mQueue.pop_front();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    WriteFrame(frame);
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    double avg = mEncodeMs;
+    mEncodeMs = avg == 0.0 ? ms : avg + (ms - avg) * kSmoothing;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mFree.push_back(std::move(frame));
+  }
+}
+
+void FrameRecorder::WriteFrame(const Frame &frame) {
+  // The stream size is fixed by the first frame; frames captured after a
+  // window resize cannot be appended
+  if (mStreamWidth == 0) {
+    mStreamWidth = frame.width;
+    mStreamHeight = frame.height;
+    if (mY4m) {
+      fprintf(mFile, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg\n",
+              mStreamWidth, mStreamHeight, mFps);
+    } else {
+      std::cout << "[FrameRecorder] Raw stream: " << mStreamWidth << "x"
+                << mStreamHeight << ", " << (mBgra ? "BGRA" : "RGBA")
+                << std::endl;
+    }
+  }
+  if (frame.width != mStreamWidth || frame.height != mStreamHeight) {
+    mFramesDropped++;
+    return;
+  }
+
+  if (mY4m)
+    WriteY4mFrame(frame);
+  else
+    fwrite(frame.pixels.data(), 1, frame.pixels.size(), mFile);
+  mFramesWritten++;
+}
+
+// Full-range BT.601, matching C420jpeg. Chroma is the average of each 2x2
+// block; the swapchain bytes are already sRGB-encoded, as video expects.
+void FrameRecorder::WriteY4mFrame(const Frame &frame) {
+  uint32_t w = frame.width, h = frame.height;
+  uint32_t cw = (w + 1) / 2, ch = (h + 1) / 2;
+  mPlanes.resize(static_cast<size_t>(w) * h + 2 * cw * ch);
+  uint8_t *yPlane = mPlanes.data();
+  uint8_t *uPlane = yPlane + static_cast<size_t>(w) * h;
+  uint8_t *vPlane = uPlane + static_cast<size_t>(cw) * ch;
+  int ri = mBgra ? 2 : 0, bi = mBgra ? 0 : 2;
+
+  for (uint32_t y = 0; y < h; y++) {
+    const uint8_t *row = frame.pixels.data() + static_cast<size_t>(y) * w * 4;
+    uint8_t *out = yPlane + static_cast<size_t>(y) * w;
+    for (uint32_t x = 0; x < w; x++) {
+      const uint8_t *p = row + x * 4;
+      // Fixed point, weights scaled by 256
+      out[x] = static_cast<uint8_t>((77 * p[ri] + 150 * p[1] + 29 * p[bi] +
+                                     128) >>
+                                    8);
+    }
+  }
+
+  for (uint32_t cy = 0; cy < ch; cy++) {
+    uint32_t y0 = cy * 2, y1 = std::min(y0 + 1, h - 1);
+    for (uint32_t cx = 0; cx < cw; cx++) {
+      uint32_t x0 = cx * 2, x1 = std::min(x0 + 1, w - 1);
+      int r = 0, g = 0, b = 0;
+      for (uint32_t sy : {y0, y1}) {
+        for (uint32_t sx : {x0, x1}) {
+          const uint8_t *p =
+              frame.pixels.data() + (static_cast<size_t>(sy) * w + sx) * 4;
+          r += p[ri];
+          g += p[1];
+          b += p[bi];
+        }
+      }
+      // Sums of four samples: divide by 4 along with the 256 scale
+      int u = (-43 * r - 85 * g + 128 * b + 512) / 1024 + 128;
+      int v = (128 * r - 107 * g - 21 * b + 512) / 1024 + 128;
+      uPlane[cy * cw + cx] = static_cast<uint8_t>(std::clamp(u, 0, 255));
+      vPlane[cy * cw + cx] = static_cast<uint8_t>(std::clamp(v, 0, 255));
+    }
+  }
+
+  fputs("FRAME\n", mFile);
+  fwrite(mPlanes.data(), 1, mPlanes.size(), mFile);
+}
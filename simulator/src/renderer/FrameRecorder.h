@@ -0,0 +1,114 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vk_mem_alloc.h>
+
+// Records the presented frames to disk without stalling rendering. At the
+// end of each captured frame the swapchain image is copied into a
+// host-visible buffer owned by that swapchain slot; the copy is read back
+// the next time the slot is recorded, after BeginFrame has waited on its
+// fence, and handed to an encoder thread. The encoder writes a Y4M stream
+// (4:2:0, playable by ffmpeg/mpv) for `.y4m` paths and raw 8-bit pixels in
+// swapchain order otherwise.
+//
+// Frames are taken at a fixed rate rather than every presented frame. When
+// the encoder falls behind, frames are dropped instead of blocking the
+// render loop; the counts are available for the overlay.
+class FrameRecorder {
+public:
+  FrameRecorder() = default;
+  ~FrameRecorder();
+  FrameRecorder(const FrameRecorder &) = delete;
+  FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+  void Create(VkDevice device, VmaAllocator allocator, uint32_t frameCount);
+  void Destroy();
+
+  // Adds slots after the swapchain grew
+  void EnsureFrames(uint32_t frameCount);
+
+  // `format` is the swapchain format; only 8-bit RGBA/BGRA is supported
+  bool Start(const std::string &path, VkFormat format, uint32_t fps = 30);
+  // Waits for the device, writes out pending frames and closes the file
+  void Stop();
+  bool IsRecording() const { return mRecording; }
+  const std::string &GetPath() const { return mPath; }
+
+  // Called by VulkanContext::EndFrame after the last pass; `image` is in
+  // PRESENT_SRC layout and is returned to it
+  void Capture(VkCommandBuffer cmd, uint32_t frame, VkImage image,
+               VkExtent2D extent);
+
+  uint64_t GetFramesWritten() const { return mFramesWritten; }
+  uint64_t GetFramesDropped() const { return mFramesDropped; }
+  // Smoothed encoder time per frame
+  double GetEncodeMs() const { return mEncodeMs; }
+
+private:
+  struct Slot {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    void *mapped = nullptr;
+    VkDeviceSize size = 0;
+    bool pending = false; // A copy was recorded and not yet read back
+    uint64_t sequence = 0;
+    VkExtent2D extent = {0, 0};
+  };
+  struct Frame {
+    std::vector<uint8_t> pixels; // Tightly packed, 4 bytes per pixel
+    uint32_t width = 0;
+    uint32_t height = 0;
+  };
+
+  void DestroySlot(Slot &slot);
+  bool EnsureSlotSize(Slot &slot, VkDeviceSize size);
+  void ReadBack(Slot &slot);
+  // Reads back every pending slot up to and including `sequence`, in order
+  void FlushUpTo(uint64_t sequence);
+
+  void EncoderLoop();
+  void WriteFrame(const Frame &frame);
+  void WriteY4mFrame(const Frame &frame);
+
+  VkDevice mDevice = VK_NULL_HANDLE;
+  VmaAllocator mAllocator = VK_NULL_HANDLE;
+  std::vector<Slot> mSlots;
+
+  bool mRecording = false;
+  std::string mPath;
+  bool mY4m = false;
+  bool mBgra = true; // Byte order of the swapchain format
+  std::chrono::steady_clock::duration mInterval{};
+  std::chrono::steady_clock::time_point mNextCapture;
+  uint32_t mFps = 30;
+  uint64_t mNextSequence = 0;
+
+  // Encoder thread state; mMutex guards the queue, free list and mDone
+  std::thread mEncoder;
+  std::mutex mMutex;
+  std::condition_variable mWake;
+  std::deque<Frame> mQueue;
+  std::vector<Frame> mFree; // Recycled pixel buffers
+  bool mDone = false;
+
+  // Owned by the encoder thread while recording
+  FILE *mFile = nullptr;
+  uint32_t mStreamWidth = 0;
+  uint32_t mStreamHeight = 0;
+  std::vector<uint8_t> mPlanes; // Y, U and V of one Y4M frame
+
+  std::atomic<uint64_t> mFramesWritten{0};
+  std::atomic<uint64_t> mFramesDropped{0};
+  std::atomic<double> mEncodeMs{0.0};
+};
@@ -0,0 +1,123 @@
+#include "renderer/GpuTimer.h"
+#include <cstring>
+#include <iostream>
+
+static const double kSmoothing = 0.1; // Weight of each new sample
+
+void GpuTimer::Create(VkDevice device, VkPhysicalDevice physicalDevice,
+                      uint32_t queueFamily, uint32_t frameCount,
+                      uint32_t maxScopes) {
+  mDevice = device;
+  mMaxScopes = maxScopes;
+
+  VkPhysicalDeviceProperties props;
+  vkGetPhysicalDeviceProperties(physicalDevice, &props);
+  uint32_t familyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount,
+                                           nullptr);
+  std::vector<VkQueueFamilyProperties> families(familyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount,
+                                           families.data());
+
+  uint32_t validBits =
+      queueFamily < familyCount ? families[queueFamily].timestampValidBits : 0;
+  mSupported = validBits > 0 && props.limits.timestampPeriod > 0.0f;
+  if (!mSupported) {
+    std::cout << "[GpuTimer] Timestamps not supported, GPU timing disabled"
+              << std::endl;
+    return;
+  }
+  mPeriodNs = props.limits.timestampPeriod;
+  mValidMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+  EnsureFrames(frameCount);
+}
+
+void GpuTimer::Destroy() {
+  for (Frame &frame : mFrames) {
+    if (frame.pool)
+      vkDestroyQueryPool(mDevice, frame.pool, nullptr);
+  }
+  mFrames.clear();
+  mCurrent = nullptr;
+}
+
+void GpuTimer::EnsureFrames(uint32_t frameCount) {
+  if (!mSupported)
+    return;
+  mCurrent = nullptr;
+  while (mFrames.size() < frameCount) {
+    mFrames.emplace_back();
+    CreateFrame(mFrames.back());
+  }
+}
+
+void GpuTimer::CreateFrame(Frame &frame) {
+  VkQueryPoolCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  info.queryCount = mMaxScopes * 2;
+  if (vkCreateQueryPool(mDevice, &info, nullptr, &frame.pool) != VK_SUCCESS) {
+    std::cerr << "[GpuTimer] Failed to create query pool" << std::endl;
+    frame.pool = VK_NULL_HANDLE;
+  }
+  frame.written.assign(mMaxScopes, false);
+}
+
+// The slot's fence has been waited on, so its queries are available
+void GpuTimer::ReadResults(Frame &frame) {
+  for (uint32_t scope = 0; scope < mScopes.size(); scope++) {
+    if (!frame.written[scope])
+      continue;
+    uint64_t ticks[2];
+    if (vkGetQueryPoolResults(mDevice, frame.pool, scope * 2, 2,
+                              sizeof(ticks), ticks, sizeof(uint64_t),
+                              VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+      continue;
+    uint64_t elapsed = (ticks[1] - ticks[0]) & mValidMask;
+    double ms = elapsed * mPeriodNs * 1e-6;
+    double &avg = mScopes[scope].ms;
+    avg = avg == 0.0 ? ms : avg + (ms - avg) * kSmoothing;
+  }
+}
+
+void GpuTimer::BeginFrame(VkCommandBuffer cmd, uint32_t frame) {
+  mCurrent = nullptr;
+  if (!mSupported || frame >= mFrames.size() || !mFrames[frame].pool)
+    return;
+  mCurrent = &mFrames[frame];
+  ReadResults(*mCurrent);
+  vkCmdResetQueryPool(cmd, mCurrent->pool, 0, mMaxScopes * 2);
+  mCurrent->written.assign(mMaxScopes, false);
+}
+
+uint32_t GpuTimer::Begin(VkCommandBuffer cmd, const char *name) {
+  uint32_t scope = 0;
+  while (scope < mScopes.size() && mScopes[scope].name != name)
+    scope++;
+  if (scope == mScopes.size()) {
+    if (scope == mMaxScopes)
+      return UINT32_MAX;
+    mScopes.push_back({name, 0.0});
+  }
+  if (mCurrent) {
+    vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        mCurrent->pool, scope * 2);
+  }
+  return scope;
+}
+
+void GpuTimer::End(VkCommandBuffer cmd, uint32_t scope) {
+  if (!mCurrent || scope >= mScopes.size())
+    return;
+  vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                      mCurrent->pool, scope * 2 + 1);
+  mCurrent->written[scope] = true;
+}
+
+double GpuTimer::GetMs(const char *name) const {
+  for (const Scope &scope : mScopes) {
+    if (scope.name == name)
+      return scope.ms;
+  }
+  return 0.0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <string>
+#include <vector>
+
+// GPU time of named passes, measured with timestamp queries. Each swapchain
+// image slot has its own queries; a slot's results are read back the next
+// time it is recorded, after BeginFrame has waited on its fence, so reading
+// never stalls. Times are therefore one swapchain cycle old and smoothed.
+//
+// Usage per frame: BeginFrame (outside any render pass), then Begin/End
+// around each pass. Does nothing if the queue has no timestamp support.
+class GpuTimer {
+public:
+  void Create(VkDevice device, VkPhysicalDevice physicalDevice,
+              uint32_t queueFamily, uint32_t frameCount,
+              uint32_t maxScopes = 8);
+  void Destroy();
+
+  // Adds slots after the swapchain grew
+  void EnsureFrames(uint32_t frameCount);
+
+  void BeginFrame(VkCommandBuffer cmd, uint32_t frame);
+  // Returns a scope id for End, stable for a given name
+  uint32_t Begin(VkCommandBuffer cmd, const char *name);
+  void End(VkCommandBuffer cmd, uint32_t scope);
+
+  // Smoothed milliseconds, 0 until the first result arrives
+  double GetMs(const char *name) const;
+  bool IsSupported() const { return mSupported; }
+
+private:
+  struct Scope {
+    std::string name;
+    double ms = 0.0;
+  };
+  struct Frame {
+    VkQueryPool pool = VK_NULL_HANDLE;
+    std::vector<bool> written; // Per scope, recorded since the last reset
+  };
+
+  void CreateFrame(Frame &frame);
+  void ReadResults(Frame &frame);
+
+  VkDevice mDevice = VK_NULL_HANDLE;
+  bool mSupported = false;
+  double mPeriodNs = 1.0;    // Nanoseconds per timestamp tick
+  uint64_t mValidMask = ~0ull; // timestampValidBits
+
+  uint32_t mMaxScopes = 8;
+  std::vector<Scope> mScopes;
+  std::vector<Frame> mFrames;
+  Frame *mCurrent = nullptr;
+};
@@ -1,4 +1,6 @@
 #include "renderer/Mesh.h"
+#include <algorithm>
+#include <cfloat>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
@@ -12,55 +14,89 @@
     }                                                                          \
   } while (0)
 
-// Helper: create a buffer, upload data via staging, return GPU-only buffer
-static void CreateBufferWithStaging(VkDevice device, VmaAllocator allocator,
-                                    VkQueue queue, uint32_t queueFamily,
-                                    const void *data, VkDeviceSize size,
-                                    VkBufferUsageFlags usage,
-                                    VkBuffer &outBuffer,
-                                    VmaAllocation &outAllocation) {
-  // Staging buffer (CPU-visible)
+// --- MeshUploader ---
+
+static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+MeshUploader::MeshUploader(VkDevice device, VmaAllocator allocator,
+                           VkQueue queue, uint32_t queueFamily)
+    : mDevice(device), mAllocator(allocator), mQueue(queue),
+      mQueueFamily(queueFamily) {}
+
+MeshUploader::~MeshUploader() { ReleaseStaging(); }
+
+size_t MeshUploader::AddMesh(uint32_t vertexCount, uint32_t indexCount) {
+  if (mMapped)
+    throw std::runtime_error("[Mesh] AddMesh after MapStaging");
+
+  Entry entry = {};
+  entry.vertexCount = vertexCount;
+  entry.indexCount = indexCount;
+  entry.vertexOffset = AlignUp(mStagingSize, 16);
+  entry.indexOffset =
+      AlignUp(entry.vertexOffset + vertexCount * sizeof(Vertex), 16);
+  mStagingSize = entry.indexOffset + indexCount * sizeof(uint32_t);
+  mEntries.push_back(entry);
+  return mEntries.size() - 1;
+}
+
+void MeshUploader::MapStaging() {
+  if (mMapped || mStagingSize == 0)
+    return;
+
   VkBufferCreateInfo stagingInfo = {};
   stagingInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-  stagingInfo.size = size;
+  stagingInfo.size = mStagingSize;
   stagingInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
   stagingInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+  // Persistently mapped, written once front to back (write-combined is fine)
   VmaAllocationCreateInfo stagingAllocInfo = {};
-  stagingAllocInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+  stagingAllocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  stagingAllocInfo.flags =
+      VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+      VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
-  VkBuffer stagingBuffer;
-  VmaAllocation stagingAlloc;
-  VK_CHECK(vmaCreateBuffer(allocator, &stagingInfo, &stagingAllocInfo,
-                           &stagingBuffer, &stagingAlloc, nullptr));
+  VmaAllocationInfo info;
+  VK_CHECK(vmaCreateBuffer(mAllocator, &stagingInfo, &stagingAllocInfo,
+                           &mStagingBuffer, &mStagingAllocation, &info));
+  mMapped = static_cast<uint8_t *>(info.pMappedData);
+}
 
-  // Copy data to staging
-  void *mapped;
-  vmaMapMemory(allocator, stagingAlloc, &mapped);
-  memcpy(mapped, data, size);
-  vmaUnmapMemory(allocator, stagingAlloc);
+Vertex *MeshUploader::GetVertices(size_t mesh) {
+  return reinterpret_cast<Vertex *>(mMapped + mEntries[mesh].vertexOffset);
+}
 
-  // GPU buffer
-  VkBufferCreateInfo gpuInfo = {};
-  gpuInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-  gpuInfo.size = size;
-  gpuInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-  gpuInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+uint32_t *MeshUploader::GetIndices(size_t mesh) {
+  return reinterpret_cast<uint32_t *>(mMapped + mEntries[mesh].indexOffset);
+}
 
-  VmaAllocationCreateInfo gpuAllocInfo = {};
-  gpuAllocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+void MeshUploader::SetBounds(size_t mesh, const float boundsMin[3],
+                             const float boundsMax[3]) {
+  memcpy(mEntries[mesh].boundsMin, boundsMin, sizeof(float) * 3);
+  memcpy(mEntries[mesh].boundsMax, boundsMax, sizeof(float) * 3);
+}
 
-  VK_CHECK(vmaCreateBuffer(allocator, &gpuInfo, &gpuAllocInfo, &outBuffer,
-                           &outAllocation, nullptr));
+std::vector<Mesh> MeshUploader::Upload() {
+  std::vector<Mesh> meshes(mEntries.size());
+  if (!mMapped) {
+    mEntries.clear();
+    mStagingSize = 0;
+    return meshes;
+  }
+
+  // No-op on HOST_COHERENT memory
+  vmaFlushAllocation(mAllocator, mStagingAllocation, 0, VK_WHOLE_SIZE);
 
-  // Copy staging → GPU via one-shot command buffer
   VkCommandPoolCreateInfo poolInfo = {};
   poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
   poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-  poolInfo.queueFamilyIndex = queueFamily;
+  poolInfo.queueFamilyIndex = mQueueFamily;
 
   VkCommandPool cmdPool;
-  VK_CHECK(vkCreateCommandPool(device, &poolInfo, nullptr, &cmdPool));
+  VK_CHECK(vkCreateCommandPool(mDevice, &poolInfo, nullptr, &cmdPool));
 
   VkCommandBufferAllocateInfo cmdAllocInfo = {};
   cmdAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -69,48 +105,103 @@ static void CreateBufferWithStaging(VkDevice device, VmaAllocator allocator,
   cmdAllocInfo.commandBufferCount = 1;
 
   VkCommandBuffer cmd;
-  VK_CHECK(vkAllocateCommandBuffers(device, &cmdAllocInfo, &cmd));
+  VK_CHECK(vkAllocateCommandBuffers(mDevice, &cmdAllocInfo, &cmd));
 
   VkCommandBufferBeginInfo beginInfo = {};
   beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
   beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
   vkBeginCommandBuffer(cmd, &beginInfo);
 
-  VkBufferCopy copyRegion = {};
-  copyRegion.size = size;
-  vkCmdCopyBuffer(cmd, stagingBuffer, outBuffer, 1, &copyRegion);
+  auto createGpuBuffer = [&](VkDeviceSize size, VkBufferUsageFlags usage,
+                             VkDeviceSize srcOffset, VkBuffer &outBuffer,
+                             VmaAllocation &outAllocation) {
+    VkBufferCreateInfo gpuInfo = {};
+    gpuInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    gpuInfo.size = size;
+    gpuInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    gpuInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VmaAllocationCreateInfo gpuAllocInfo = {};
+    gpuAllocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+    VK_CHECK(vmaCreateBuffer(mAllocator, &gpuInfo, &gpuAllocInfo, &outBuffer,
+                             &outAllocation, nullptr));
+
+    VkBufferCopy copyRegion = {};
+    copyRegion.srcOffset = srcOffset;
+    copyRegion.size = size;
+    vkCmdCopyBuffer(cmd, mStagingBuffer, outBuffer, 1, &copyRegion);
+  };
+
+  for (size_t i = 0; i < mEntries.size(); i++) {
+    const Entry &entry = mEntries[i];
+    Mesh &mesh = meshes[i];
+    if (entry.vertexCount == 0 || entry.indexCount == 0)
+      continue;
+    mesh.indexCount = entry.indexCount;
+    memcpy(mesh.boundsMin, entry.boundsMin, sizeof(mesh.boundsMin));
+    memcpy(mesh.boundsMax, entry.boundsMax, sizeof(mesh.boundsMax));
+    createGpuBuffer(entry.vertexCount * sizeof(Vertex),
+                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, entry.vertexOffset,
+                    mesh.vertexBuffer, mesh.vertexAllocation);
+    createGpuBuffer(entry.indexCount * sizeof(uint32_t),
+                    VK_BUFFER_USAGE_INDEX_BUFFER_BIT, entry.indexOffset,
+                    mesh.indexBuffer, mesh.indexAllocation);
+  }
 
   vkEndCommandBuffer(cmd);
 
+  VkFenceCreateInfo fenceInfo = {};
+  fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  VkFence fence;
+  VK_CHECK(vkCreateFence(mDevice, &fenceInfo, nullptr, &fence));
+
   VkSubmitInfo submitInfo = {};
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   submitInfo.commandBufferCount = 1;
   submitInfo.pCommandBuffers = &cmd;
 
-  vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(queue);
+  VK_CHECK(vkQueueSubmit(mQueue, 1, &submitInfo, fence));
+  VK_CHECK(vkWaitForFences(mDevice, 1, &fence, VK_TRUE, UINT64_MAX));
+
+  vkDestroyFence(mDevice, fence, nullptr);
+  vkDestroyCommandPool(mDevice, cmdPool, nullptr);
+  ReleaseStaging();
+  return meshes;
+}
 
-  vkDestroyCommandPool(device, cmdPool, nullptr);
-  vmaDestroyBuffer(allocator, stagingBuffer, stagingAlloc);
+void MeshUploader::ReleaseStaging() {
+  if (mStagingBuffer)
+    vmaDestroyBuffer(mAllocator, mStagingBuffer, mStagingAllocation);
+  mStagingBuffer = VK_NULL_HANDLE;
+  mStagingAllocation = VK_NULL_HANDLE;
+  mMapped = nullptr;
+  mEntries.clear();
+  mStagingSize = 0;
 }
 
 Mesh CreateMesh(VkDevice device, VmaAllocator allocator, VkQueue queue,
                 uint32_t queueFamily, const std::vector<Vertex> &vertices,
                 const std::vector<uint32_t> &indices) {
-  Mesh mesh;
-  mesh.indexCount = static_cast<uint32_t>(indices.size());
+  MeshUploader uploader(device, allocator, queue, queueFamily);
+  size_t id = uploader.AddMesh(static_cast<uint32_t>(vertices.size()),
+                               static_cast<uint32_t>(indices.size()));
+  uploader.MapStaging();
+  memcpy(uploader.GetVertices(id), vertices.data(),
+         vertices.size() * sizeof(Vertex));
+  memcpy(uploader.GetIndices(id), indices.data(),
+         indices.size() * sizeof(uint32_t));
 
-  CreateBufferWithStaging(device, allocator, queue, queueFamily,
-                          vertices.data(), vertices.size() * sizeof(Vertex),
-                          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, mesh.vertexBuffer,
-                          mesh.vertexAllocation);
-
-  CreateBufferWithStaging(device, allocator, queue, queueFamily, indices.data(),
-                          indices.size() * sizeof(uint32_t),
-                          VK_BUFFER_USAGE_INDEX_BUFFER_BIT, mesh.indexBuffer,
-                          mesh.indexAllocation);
-
-  return mesh;
+  float boundsMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+  float boundsMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+  for (const Vertex &v : vertices) {
+    for (int axis = 0; axis < 3; axis++) {
+      boundsMin[axis] = std::min(boundsMin[axis], v.position[axis]);
+      boundsMax[axis] = std::max(boundsMax[axis], v.position[axis]);
+    }
+  }
+  uploader.SetBounds(id, boundsMin, boundsMax);
+  return uploader.Upload()[0];
 }
 
 void DestroyMesh(VmaAllocator allocator, Mesh &mesh) {
@@ -125,11 +216,11 @@ void DestroyMesh(VmaAllocator allocator, Mesh &mesh) {
   mesh.indexCount = 0;
 }
 
-void DrawMesh(VkCommandBuffer cmd, const Mesh &mesh) {
+void DrawMesh(VkCommandBuffer cmd, const Mesh &mesh, uint32_t object) {
   VkDeviceSize offset = 0;
   vkCmdBindVertexBuffers(cmd, 0, 1, &mesh.vertexBuffer, &offset);
   vkCmdBindIndexBuffer(cmd, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-  vkCmdDrawIndexed(cmd, mesh.indexCount, 1, 0, 0, 0);
+  vkCmdDrawIndexed(cmd, mesh.indexCount, 1, 0, 0, object);
 }
 
 // --- Colored unit cube with normals ---
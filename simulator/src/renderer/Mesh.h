@@ -13,6 +13,60 @@ struct Mesh {
   VkBuffer indexBuffer = VK_NULL_HANDLE;
   VmaAllocation indexAllocation = VK_NULL_HANDLE;
   uint32_t indexCount = 0;
+  // Object-space AABB, for culling
+  float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+  float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+};
+
+// Uploads a batch of meshes through one persistently mapped staging buffer
+// and a single queue submit. Usage:
+//   1. AddMesh() for every mesh, to size the staging buffer
+//   2. MapStaging(), then write straight into GetVertices()/GetIndices()
+//   3. Upload() to copy into device-local buffers (blocks until done)
+// SetBounds() may be called any time before Upload().
+class MeshUploader {
+public:
+  MeshUploader(VkDevice device, VmaAllocator allocator, VkQueue queue,
+               uint32_t queueFamily);
+  ~MeshUploader();
+  MeshUploader(const MeshUploader &) = delete;
+  MeshUploader &operator=(const MeshUploader &) = delete;
+
+  size_t AddMesh(uint32_t vertexCount, uint32_t indexCount);
+  void MapStaging();
+
+  Vertex *GetVertices(size_t mesh);
+  uint32_t *GetIndices(size_t mesh);
+  void SetBounds(size_t mesh, const float boundsMin[3],
+                 const float boundsMax[3]);
+
+  // Returns the meshes in AddMesh order and releases the staging buffer
+  std::vector<Mesh> Upload();
+
+  VkDeviceSize GetStagingSize() const { return mStagingSize; }
+
+private:
+  struct Entry {
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    VkDeviceSize vertexOffset;
+    VkDeviceSize indexOffset;
+    float boundsMin[3];
+    float boundsMax[3];
+  };
+
+  void ReleaseStaging();
+
+  VkDevice mDevice;
+  VmaAllocator mAllocator;
+  VkQueue mQueue;
+  uint32_t mQueueFamily;
+
+  std::vector<Entry> mEntries;
+  VkDeviceSize mStagingSize = 0;
+  VkBuffer mStagingBuffer = VK_NULL_HANDLE;
+  VmaAllocation mStagingAllocation = VK_NULL_HANDLE;
+  uint8_t *mMapped = nullptr;
 };
 
 // Upload mesh data to GPU via staging buffer
@@ -22,8 +76,9 @@ Mesh CreateMesh(VkDevice device, VmaAllocator allocator, VkQueue queue,
 
 void DestroyMesh(VmaAllocator allocator, Mesh &mesh);
 
-// Bind and draw a mesh
-void DrawMesh(VkCommandBuffer cmd, const Mesh &mesh);
+// Bind and draw a mesh. `object` is its SceneBuffers index, passed to the
+// shader as gl_InstanceIndex through firstInstance.
+void DrawMesh(VkCommandBuffer cmd, const Mesh &mesh, uint32_t object = 0);
 
 // Create a colored unit cube centered at origin
 Mesh CreateCubeMesh(VkDevice device, VmaAllocator allocator, VkQueue queue,
@@ -1,167 +1,99 @@
 #include "renderer/ModelLoader.h"
+#include "AssetBundle.h"
+#include "GlbFile.h"
+#include "MeshKernels.h"
 #include "renderer/Pipeline.h" // For Vertex
 
-#define TINYGLTF_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include <tiny_gltf.h>
-
+#include <algorithm>
+#include <cfloat>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
 
-static void ExtractPrimitive(const tinygltf::Model &model,
-                             const tinygltf::Primitive &prim,
-                             std::vector<Vertex> &outVertices,
-                             std::vector<uint32_t> &outIndices) {
+void CountPrimitive(const GlbFile &model, const GlbPrimitive &prim,
+                    size_t &vertexCount, size_t &indexCount) {
+  const GlbAccessor *pos = model.GetAccessor(prim.Attribute("POSITION"));
+  vertexCount = (pos && pos->data) ? pos->count : 0;
+  indexCount = model.Indices(prim.indices).Count();
+  if (indexCount == 0)
+    indexCount = vertexCount;
+}
+
+// Destinations are only written, never read: they are usually
+// write-combined staging memory.
+void ExtractPrimitive(const GlbFile &model, const GlbPrimitive &prim,
+                      Vertex *outVertices, uint32_t *outIndices) {
   // --- Positions (required) ---
-  if (prim.attributes.find("POSITION") == prim.attributes.end()) {
+  StridedView<float> positions = model.View<float>(prim.Attribute("POSITION"));
+  if (positions.Empty()) {
     std::cerr << "[ModelLoader] Primitive missing POSITION attribute, skipping."
               << std::endl;
     return;
   }
-
-  const tinygltf::Accessor &posAccessor =
-      model.accessors[prim.attributes.at("POSITION")];
-  const tinygltf::BufferView &posView =
-      model.bufferViews[posAccessor.bufferView];
-  const tinygltf::Buffer &posBuffer = model.buffers[posView.buffer];
-  const float *posData = reinterpret_cast<const float *>(
-      &posBuffer.data[posView.byteOffset + posAccessor.byteOffset]);
-  size_t posStride =
-      posView.byteStride ? posView.byteStride / sizeof(float) : 3;
-
-  size_t vertexCount = posAccessor.count;
+  const size_t vertexCount = positions.Count();
+  const size_t stride = sizeof(Vertex);
+  CopyFloat3(outVertices->position, stride, positions.Data(),
+             positions.Stride(), vertexCount);
 
   // --- Normals (optional) ---
-  const float *normalData = nullptr;
-  size_t normalStride = 3;
-  if (prim.attributes.find("NORMAL") != prim.attributes.end()) {
-    const tinygltf::Accessor &normAccessor =
-        model.accessors[prim.attributes.at("NORMAL")];
-    const tinygltf::BufferView &normView =
-        model.bufferViews[normAccessor.bufferView];
-    const tinygltf::Buffer &normBuffer = model.buffers[normView.buffer];
-    normalData = reinterpret_cast<const float *>(
-        &normBuffer.data[normView.byteOffset + normAccessor.byteOffset]);
-    normalStride =
-        normView.byteStride ? normView.byteStride / sizeof(float) : 3;
+  StridedView<float> normals = model.View<float>(prim.Attribute("NORMAL"));
+  if (normals.Count() >= vertexCount) {
+    CopyFloat3(outVertices->normal, stride, normals.Data(), normals.Stride(),
+               vertexCount);
+  } else {
+    const float up[3] = {0.0f, 1.0f, 0.0f};
+    FillFloat3(outVertices->normal, stride, up, vertexCount);
   }
 
   // --- Colors (optional, COLOR_0) ---
-  const float *colorData = nullptr;
-  size_t colorStride = 3;
-  int colorComponents = 3;
-  const uint8_t *colorDataU8 = nullptr;
-  bool colorIsU8 = false;
-
-  if (prim.attributes.find("COLOR_0") != prim.attributes.end()) {
-    const tinygltf::Accessor &colAccessor =
-        model.accessors[prim.attributes.at("COLOR_0")];
-    const tinygltf::BufferView &colView =
-        model.bufferViews[colAccessor.bufferView];
-    const tinygltf::Buffer &colBuffer = model.buffers[colView.buffer];
-
-    colorComponents = (colAccessor.type == TINYGLTF_TYPE_VEC4) ? 4 : 3;
-
-    if (colAccessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT) {
-      colorData = reinterpret_cast<const float *>(
-          &colBuffer.data[colView.byteOffset + colAccessor.byteOffset]);
-      colorStride = colView.byteStride ? colView.byteStride / sizeof(float)
-                                       : colorComponents;
-    } else if (colAccessor.componentType ==
-               TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE) {
-      colorDataU8 =
-          &colBuffer.data[colView.byteOffset + colAccessor.byteOffset];
-      colorIsU8 = true;
-      colorStride = colView.byteStride ? colView.byteStride : colorComponents;
-    }
-  }
-
-  // --- Build vertices ---
-  outVertices.reserve(outVertices.size() + vertexCount);
-  for (size_t i = 0; i < vertexCount; i++) {
-    Vertex v = {};
-
-    v.position[0] = posData[i * posStride + 0];
-    v.position[1] = posData[i * posStride + 1];
-    v.position[2] = posData[i * posStride + 2];
-
-    if (normalData) {
-      v.normal[0] = normalData[i * normalStride + 0];
-      v.normal[1] = normalData[i * normalStride + 1];
-      v.normal[2] = normalData[i * normalStride + 2];
-    } else {
-      v.normal[0] = 0.0f;
-      v.normal[1] = 1.0f;
-      v.normal[2] = 0.0f;
-    }
-
-    if (colorData) {
-      v.color[0] = colorData[i * colorStride + 0];
-      v.color[1] = colorData[i * colorStride + 1];
-      v.color[2] = colorData[i * colorStride + 2];
-    } else if (colorIsU8 && colorDataU8) {
-      v.color[0] = colorDataU8[i * colorStride + 0] / 255.0f;
-      v.color[1] = colorDataU8[i * colorStride + 1] / 255.0f;
-      v.color[2] = colorDataU8[i * colorStride + 2] / 255.0f;
-    } else {
-      // Fallback: use material baseColorFactor if available
-      float matR = 0.7f, matG = 0.7f, matB = 0.7f;
-      if (prim.material >= 0 &&
-          prim.material < static_cast<int>(model.materials.size())) {
-        const auto &mat = model.materials[prim.material];
-        const auto &bcf = mat.pbrMetallicRoughness.baseColorFactor;
-        if (bcf.size() >= 3) {
-          matR = static_cast<float>(bcf[0]);
-          matG = static_cast<float>(bcf[1]);
-          matB = static_cast<float>(bcf[2]);
-        }
-      }
-      v.color[0] = matR;
-      v.color[1] = matG;
-      v.color[2] = matB;
+  const GlbAccessor *col = model.GetAccessor(prim.Attribute("COLOR_0"));
+  bool hasColor = col && col->data && col->count >= vertexCount &&
+                  col->components >= 3;
+  if (hasColor && col->componentType == GLB_COMPONENT_FLOAT) {
+    CopyFloat3(outVertices->color, stride, col->data, col->stride,
+               vertexCount);
+  } else if (hasColor && col->componentType == GLB_COMPONENT_UNSIGNED_BYTE) {
+    ConvertUnorm8ToFloat3(outVertices->color, stride, col->data, col->stride,
+                          vertexCount);
+  } else {
+    // Fallback: use material baseColorFactor if available
+    float matColor[3] = {0.7f, 0.7f, 0.7f};
+    if (prim.material >= 0 &&
+        prim.material < static_cast<int>(model.GetMaterials().size())) {
+      const GlbMaterial &mat = model.GetMaterials()[prim.material];
+      memcpy(matColor, mat.baseColorFactor, sizeof(matColor));
     }
-
-    outVertices.push_back(v);
+    FillFloat3(outVertices->color, stride, matColor, vertexCount);
   }
 
   // --- Indices ---
-  if (prim.indices >= 0) {
-    const tinygltf::Accessor &idxAccessor = model.accessors[prim.indices];
-    const tinygltf::BufferView &idxView =
-        model.bufferViews[idxAccessor.bufferView];
-    const tinygltf::Buffer &idxBuffer = model.buffers[idxView.buffer];
-    const uint8_t *idxData =
-        &idxBuffer.data[idxView.byteOffset + idxAccessor.byteOffset];
-
-    size_t baseVertex = outVertices.size() - vertexCount;
-    outIndices.reserve(outIndices.size() + idxAccessor.count);
-
-    for (size_t i = 0; i < idxAccessor.count; i++) {
-      uint32_t idx = 0;
-      switch (idxAccessor.componentType) {
-      case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-        idx = reinterpret_cast<const uint16_t *>(idxData)[i];
-        break;
-      case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-        idx = reinterpret_cast<const uint32_t *>(idxData)[i];
-        break;
-      case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-        idx = idxData[i];
-        break;
-      default:
-        std::cerr << "[ModelLoader] Unsupported index type: "
-                  << idxAccessor.componentType << std::endl;
-        break;
-      }
-      outIndices.push_back(static_cast<uint32_t>(baseVertex + idx));
-    }
+  GlbIndexView indices = model.Indices(prim.indices);
+  const GlbAccessor *idx = indices.Accessor();
+  if (idx && idx->stride == idx->elementSize) {
+    WidenIndices(outIndices, idx->data, idx->elementSize, idx->count, 0);
+  } else if (idx) {
+    for (size_t i = 0; i < indices.Count(); i++)
+      outIndices[i] = indices[i];
   } else {
     // No indices: generate sequential
-    size_t baseVertex = outVertices.size() - vertexCount;
-    for (size_t i = 0; i < vertexCount; i++) {
-      outIndices.push_back(static_cast<uint32_t>(baseVertex + i));
+    for (size_t i = 0; i < vertexCount; i++)
+      outIndices[i] = static_cast<uint32_t>(i);
+  }
+}
+
+// Object-space AABB of a primitive, read from the mapped GLB
+static void PrimitiveBounds(const GlbFile &model, const GlbPrimitive &prim,
+                            float boundsMin[3], float boundsMax[3]) {
+  StridedView<float> positions = model.View<float>(prim.Attribute("POSITION"));
+  for (int axis = 0; axis < 3; axis++) {
+    boundsMin[axis] = positions.Empty() ? 0.0f : (&positions[0])[axis];
+    boundsMax[axis] = boundsMin[axis];
+  }
+  for (size_t v = 1; v < positions.Count(); v++) {
+    const float *p = &positions[v];
+    for (int axis = 0; axis < 3; axis++) {
+      boundsMin[axis] = std::min(boundsMin[axis], p[axis]);
+      boundsMax[axis] = std::max(boundsMax[axis], p[axis]);
     }
   }
 }
@@ -169,45 +101,130 @@ static void ExtractPrimitive(const tinygltf::Model &model,
 std::vector<Mesh> LoadModel(VkDevice device, VmaAllocator allocator,
                             VkQueue queue, uint32_t queueFamily,
                             const std::string &path) {
-  tinygltf::Model model;
-  tinygltf::TinyGLTF loader;
-  std::string err, warn;
-
-  bool loaded = loader.LoadBinaryFromFile(&model, &err, &warn, path);
-  if (!warn.empty())
-    std::cout << "[ModelLoader] Warning: " << warn << std::endl;
-  if (!err.empty())
+  GlbFile model;
+  std::string err;
+  if (!model.Open(path, &err)) {
     std::cerr << "[ModelLoader] Error: " << err << std::endl;
-  if (!loaded) {
     throw std::runtime_error("[ModelLoader] Failed to load: " + path);
   }
 
-  std::cout << "[ModelLoader] Loaded: " << path << " (" << model.meshes.size()
+  const std::vector<GlbMesh> &meshes = model.GetMeshes();
+  std::cout << "[ModelLoader] Loaded: " << path << " (" << meshes.size()
             << " meshes)" << std::endl;
 
-  std::vector<Mesh> result;
+  // Size every primitive first so the whole model shares one staging
+  // buffer, then convert straight into it and upload with one submit.
+  struct PendingPrimitive {
+    const GlbPrimitive *prim;
+    size_t uploadId;
+  };
+  std::vector<PendingPrimitive> pending;
+  MeshUploader uploader(device, allocator, queue, queueFamily);
 
-  for (size_t m = 0; m < model.meshes.size(); m++) {
-    const tinygltf::Mesh &mesh = model.meshes[m];
+  for (size_t m = 0; m < meshes.size(); m++) {
+    const GlbMesh &mesh = meshes[m];
     for (size_t p = 0; p < mesh.primitives.size(); p++) {
-      std::vector<Vertex> vertices;
-      std::vector<uint32_t> indices;
+      size_t vertexCount = 0, indexCount = 0;
+      CountPrimitive(model, mesh.primitives[p], vertexCount, indexCount);
+      if (vertexCount == 0 || indexCount == 0)
+        continue;
+
+      pending.push_back(
+          {&mesh.primitives[p],
+           uploader.AddMesh(static_cast<uint32_t>(vertexCount),
+                            static_cast<uint32_t>(indexCount))});
 
-      ExtractPrimitive(model, mesh.primitives[p], vertices, indices);
+      std::cout << "  Mesh[" << m << "].prim[" << p << "]: " << vertexCount
+                << " verts, " << indexCount << " indices" << std::endl;
+    }
+  }
+
+  uploader.MapStaging();
+  for (const PendingPrimitive &item : pending) {
+    ExtractPrimitive(model, *item.prim, uploader.GetVertices(item.uploadId),
+                     uploader.GetIndices(item.uploadId));
+    float boundsMin[3], boundsMax[3];
+    PrimitiveBounds(model, *item.prim, boundsMin, boundsMax);
+    uploader.SetBounds(item.uploadId, boundsMin, boundsMax);
+  }
+  std::cout << "[ModelLoader] Staging: " << uploader.GetStagingSize() / 1024
+            << " KB" << std::endl;
+  std::vector<Mesh> result = uploader.Upload();
+
+  std::cout << "[ModelLoader] Total primitives: " << result.size() << std::endl;
+  return result;
+}
 
-      if (vertices.empty() || indices.empty())
+void BakeModelMeshes(const GlbFile &model, std::vector<BundleMeshData> &out) {
+  for (const GlbMesh &mesh : model.GetMeshes()) {
+    for (const GlbPrimitive &prim : mesh.primitives) {
+      size_t vertexCount = 0, indexCount = 0;
+      CountPrimitive(model, prim, vertexCount, indexCount);
+      if (vertexCount == 0 || indexCount == 0)
         continue;
 
-      Mesh vkMesh =
-          CreateMesh(device, allocator, queue, queueFamily, vertices, indices);
-      result.push_back(vkMesh);
+      BundleMeshData data;
+      data.vertices.resize(vertexCount * sizeof(Vertex));
+      data.indices.resize(indexCount);
+      Vertex *vertices = reinterpret_cast<Vertex *>(data.vertices.data());
+      ExtractPrimitive(model, prim, vertices, data.indices.data());
 
-      std::cout << "  Mesh[" << m << "].prim[" << p << "]: " << vertices.size()
-                << " verts, " << indices.size() << " indices" << std::endl;
+      for (int axis = 0; axis < 3; axis++) {
+        data.boundsMin[axis] = data.boundsMax[axis] =
+            vertices[0].position[axis];
+      }
+      for (size_t v = 1; v < vertexCount; v++) {
+        for (int axis = 0; axis < 3; axis++) {
+          float p = vertices[v].position[axis];
+          data.boundsMin[axis] = std::min(data.boundsMin[axis], p);
+          data.boundsMax[axis] = std::max(data.boundsMax[axis], p);
+        }
+      }
+      out.push_back(std::move(data));
     }
   }
+}
 
-  std::cout << "[ModelLoader] Total primitives: " << result.size() << std::endl;
+std::vector<Mesh> LoadBundledModel(VkDevice device, VmaAllocator allocator,
+                                   VkQueue queue, uint32_t queueFamily,
+                                   const AssetBundle &bundle,
+                                   const std::string &name, uint32_t lod) {
+  const BundleModelHeader *model = bundle.GetModel(name);
+  if (!model)
+    throw std::runtime_error("[ModelLoader] No model '" + name + "' in " +
+                             bundle.GetPath());
+  if (bundle.GetVertexSize() != sizeof(Vertex))
+    throw std::runtime_error("[ModelLoader] " + bundle.GetPath() +
+                             " was baked for another vertex layout");
+
+  lod = std::min(lod, model->lodCount - 1);
+  const BundleMesh *meshes = bundle.GetMeshes(name, lod);
+  const uint8_t *payload =
+      bundle.Payload(*bundle.Find(name, BundleEntryType::eMODEL));
+
+  MeshUploader uploader(device, allocator, queue, queueFamily);
+  std::vector<const BundleMesh *> pending;
+  for (uint32_t i = 0; i < model->meshCount; i++) {
+    if (meshes[i].vertexCount == 0 || meshes[i].indexCount == 0)
+      continue;
+    uploader.AddMesh(meshes[i].vertexCount, meshes[i].indexCount);
+    pending.push_back(&meshes[i]);
+  }
+
+  uploader.MapStaging();
+  for (size_t i = 0; i < pending.size(); i++) {
+    memcpy(uploader.GetVertices(i), payload + pending[i]->vertexOffset,
+           pending[i]->vertexCount * sizeof(Vertex));
+    memcpy(uploader.GetIndices(i), payload + pending[i]->indexOffset,
+           pending[i]->indexCount * sizeof(uint32_t));
+    uploader.SetBounds(i, pending[i]->boundsMin, pending[i]->boundsMax);
+  }
+  VkDeviceSize stagingSize = uploader.GetStagingSize();
+  std::vector<Mesh> result = uploader.Upload();
+
+  std::cout << "[ModelLoader] Loaded " << name << " LOD " << lod << " from "
+            << bundle.GetPath() << " (" << result.size() << " primitives, "
+            << stagingSize / 1024 << " KB)" << std::endl;
   return result;
 }
 
@@ -218,8 +235,25 @@ void DestroyModel(VmaAllocator allocator, std::vector<Mesh> &meshes) {
   meshes.clear();
 }
 
-void DrawModel(VkCommandBuffer cmd, const std::vector<Mesh> &meshes) {
+void GetModelBounds(const std::vector<Mesh> &meshes, const glm::mat4 &transform,
+                    glm::vec3 &outMin, glm::vec3 &outMax) {
+  outMin = glm::vec3(FLT_MAX);
+  outMax = glm::vec3(-FLT_MAX);
+  for (const Mesh &mesh : meshes) {
+    for (int corner = 0; corner < 8; corner++) {
+      glm::vec3 local((corner & 1) ? mesh.boundsMax[0] : mesh.boundsMin[0],
+                      (corner & 2) ? mesh.boundsMax[1] : mesh.boundsMin[1],
+                      (corner & 4) ? mesh.boundsMax[2] : mesh.boundsMin[2]);
+      glm::vec3 world = glm::vec3(transform * glm::vec4(local, 1.0f));
+      outMin = glm::min(outMin, world);
+      outMax = glm::max(outMax, world);
+    }
+  }
+}
+
+void DrawModel(VkCommandBuffer cmd, const std::vector<Mesh> &meshes,
+               uint32_t object) {
   for (const auto &mesh : meshes) {
-    DrawMesh(cmd, mesh);
+    DrawMesh(cmd, mesh, object);
   }
 }
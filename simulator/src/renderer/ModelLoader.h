@@ -1,6 +1,7 @@
 #pragma once
 
 #include "renderer/Mesh.h"
+#include <glm/glm.hpp>
 #include <string>
 #include <vector>
 
@@ -8,13 +9,52 @@
 #include <GLFW/glfw3.h>
 #include <vk_mem_alloc.h>
 
+class AssetBundle;
+class GlbFile;
+struct BundleMeshData;
+struct GlbPrimitive;
+
+// Vertex and index counts ExtractPrimitive will write (0 if unusable)
+void CountPrimitive(const GlbFile &model, const GlbPrimitive &prim,
+                    size_t &vertexCount, size_t &indexCount);
+
+// Converts one primitive straight from the mapped GLB into `outVertices`
+// and `outIndices`, which must hold CountPrimitive's counts. Uses one
+// MeshKernels conversion per attribute rather than per-vertex branches.
+void ExtractPrimitive(const GlbFile &model, const GlbPrimitive &prim,
+                      Vertex *outVertices, uint32_t *outIndices);
+
 // Load a GLB file and return a list of Mesh objects (one per primitive)
 std::vector<Mesh> LoadModel(VkDevice device, VmaAllocator allocator,
                             VkQueue queue, uint32_t queueFamily,
                             const std::string &path);
 
+// Converts every usable primitive of `model` into renderer vertices for
+// AssetBundleWriter, in LoadModel's order. Bounds are filled in.
+void BakeModelMeshes(const GlbFile &model, std::vector<BundleMeshData> &out);
+
+// Uploads one LOD (clamped to the coarsest) of a model baked by
+// asset_baker. The vertices are already in renderer layout, so each mesh
+// is a memcpy from the mapped bundle into staging memory.
+std::vector<Mesh> LoadBundledModel(VkDevice device, VmaAllocator allocator,
+                                   VkQueue queue, uint32_t queueFamily,
+                                   const AssetBundle &bundle,
+                                   const std::string &name, uint32_t lod = 0);
+
 // Destroy all meshes in a model
 void DestroyModel(VmaAllocator allocator, std::vector<Mesh> &meshes);
 
-// Draw all meshes in a model
-void DrawModel(VkCommandBuffer cmd, const std::vector<Mesh> &meshes);
+// One model instance in this frame's draw list
+struct DrawItem {
+  const std::vector<Mesh> *meshes;
+  uint32_t object; // SceneBuffers index
+  glm::vec3 boundsMin, boundsMax; // World space, for culling
+};
+
+// World-space AABB of `meshes` placed by `transform`
+void GetModelBounds(const std::vector<Mesh> &meshes, const glm::mat4 &transform,
+                    glm::vec3 &outMin, glm::vec3 &outMax);
+
+// Draw all meshes in a model with one SceneBuffers object index
+void DrawModel(VkCommandBuffer cmd, const std::vector<Mesh> &meshes,
+               uint32_t object = 0);
@@ -1,4 +1,5 @@
 #include "renderer/Pipeline.h"
+#include "renderer/SceneBuffers.h"
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
@@ -34,7 +35,8 @@ VkShaderModule Pipeline::LoadShaderModule(VkDevice device,
 
 void Pipeline::Create(VkDevice device, VkRenderPass renderPass,
                       VkFormat depthFormat, const std::string &vertPath,
-                      const std::string &fragPath) {
+                      const std::string &fragPath, VkPipelineCache cache,
+                      VkSampleCountFlagBits samples) {
   // --- Shader stages ---
   VkShaderModule vertModule = LoadShaderModule(device, vertPath);
   VkShaderModule fragModule = LoadShaderModule(device, fragPath);
@@ -94,7 +96,7 @@ void Pipeline::Create(VkDevice device, VkRenderPass renderPass,
   multisampling.sType =
       VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
   multisampling.sampleShadingEnable = VK_FALSE;
-  multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+  multisampling.rasterizationSamples = samples;
 
   // --- Depth stencil ---
   VkPipelineDepthStencilStateCreateInfo depthStencil = {};
@@ -128,16 +130,13 @@ void Pipeline::Create(VkDevice device, VkRenderPass renderPass,
   dynamicState.dynamicStateCount = 2;
   dynamicState.pDynamicStates = dynamicStates;
 
-  // --- Pipeline layout (push constants for MVP) ---
-  VkPushConstantRange pushConstant = {};
-  pushConstant.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-  pushConstant.offset = 0;
-  pushConstant.size = sizeof(PushConstants);
+  // --- Pipeline layout (camera UBO + object SSBO, see SceneBuffers) ---
+  mSetLayout = SceneBuffers::CreateSetLayout(device);
 
   VkPipelineLayoutCreateInfo layoutInfo = {};
   layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-  layoutInfo.pushConstantRangeCount = 1;
-  layoutInfo.pPushConstantRanges = &pushConstant;
+  layoutInfo.setLayoutCount = 1;
+  layoutInfo.pSetLayouts = &mSetLayout;
 
   if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &mLayout) !=
       VK_SUCCESS) {
@@ -161,8 +160,8 @@ void Pipeline::Create(VkDevice device, VkRenderPass renderPass,
   pipelineInfo.renderPass = renderPass;
   pipelineInfo.subpass = 0;
 
-  if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo,
-                                nullptr, &mPipeline) != VK_SUCCESS) {
+  if (vkCreateGraphicsPipelines(device, cache, 1, &pipelineInfo, nullptr,
+                                &mPipeline) != VK_SUCCESS) {
     throw std::runtime_error("[Pipeline] Failed to create graphics pipeline");
   }
 
@@ -182,6 +181,10 @@ void Pipeline::Destroy(VkDevice device) {
     vkDestroyPipelineLayout(device, mLayout, nullptr);
     mLayout = VK_NULL_HANDLE;
   }
+  if (mSetLayout) {
+    vkDestroyDescriptorSetLayout(device, mSetLayout, nullptr);
+    mSetLayout = VK_NULL_HANDLE;
+  }
 }
 
 void Pipeline::Bind(VkCommandBuffer cmd) {
@@ -44,24 +44,26 @@ struct Vertex {
   }
 };
 
-// Push constants: MVP + model matrix (for normals)
-struct PushConstants {
-  float mvp[16];   // mat4 — model-view-projection
-  float model[16]; // mat4 — model matrix (for transforming normals)
-};
-
 class Pipeline {
 public:
+  // `cache` (VulkanContext::GetPipelineCache) lets the driver reuse
+  // compiled shaders from earlier runs and earlier Create calls. `samples`
+  // must match the render pass (VulkanContext::GetSampleCount).
   void Create(VkDevice device, VkRenderPass renderPass, VkFormat depthFormat,
-              const std::string &vertPath, const std::string &fragPath);
+              const std::string &vertPath, const std::string &fragPath,
+              VkPipelineCache cache = VK_NULL_HANDLE,
+              VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT);
   void Destroy(VkDevice device);
 
   void Bind(VkCommandBuffer cmd);
   VkPipelineLayout GetLayout() const { return mLayout; }
 
+  // Reads a SPIR-V file; throws if it is missing or rejected
+  static VkShaderModule LoadShaderModule(VkDevice device,
+                                         const std::string &path);
+
 private:
   VkPipeline mPipeline = VK_NULL_HANDLE;
   VkPipelineLayout mLayout = VK_NULL_HANDLE;
-
-  VkShaderModule LoadShaderModule(VkDevice device, const std::string &path);
+  VkDescriptorSetLayout mSetLayout = VK_NULL_HANDLE; // SceneBuffers, set 0
 };
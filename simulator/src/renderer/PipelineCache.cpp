@@ -0,0 +1,167 @@
+#include "renderer/PipelineCache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static const char kMagic[4] = {'V', 'X', 'P', 'C'};
+static const uint32_t kCacheVersion = 1;
+
+// Our own header in front of the driver's blob. The driver validates its
+// header too, but some drivers crash on foreign data instead of ignoring it.
+struct CacheFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t vendorID;
+  uint32_t deviceID;
+  uint32_t driverVersion;
+  uint8_t uuid[VK_UUID_SIZE];
+  uint64_t dataSize;
+  uint64_t dataHash; // FNV-1a, catches torn or truncated files
+};
+
+static uint64_t HashBytes(const uint8_t *data, size_t size) {
+  uint64_t hash = 1469598103934665603ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+static void FillHeader(CacheFileHeader &header,
+                       const VkPhysicalDeviceProperties &props) {
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kMagic, 4);
+  header.version = kCacheVersion;
+  header.vendorID = props.vendorID;
+  header.deviceID = props.deviceID;
+  header.driverVersion = props.driverVersion;
+  memcpy(header.uuid, props.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+// Returns the driver blob in `path` if it was written for this device
+static std::vector<uint8_t> LoadCacheFile(const std::string &path,
+                                          const CacheFileHeader &expected) {
+  std::vector<uint8_t> data;
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in)
+    return data;
+  const uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+  in.seekg(0);
+
+  CacheFileHeader header;
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      memcmp(header.magic, kMagic, 4) != 0)
+    return data;
+
+  if (header.version != expected.version ||
+      header.vendorID != expected.vendorID ||
+      header.deviceID != expected.deviceID ||
+      header.driverVersion != expected.driverVersion ||
+      memcmp(header.uuid, expected.uuid, VK_UUID_SIZE) != 0) {
+    std::cout << "[PipelineCache] Ignoring " << path
+              << " (different device or driver)" << std::endl;
+    return data;
+  }
+
+  // Bounded by the file before allocating: a torn write or garbage length
+  // must not throw at startup
+  if (header.dataSize > fileSize - sizeof(header)) {
+    std::cerr << "[PipelineCache] Truncated cache ignored: " << path
+              << std::endl;
+    return data;
+  }
+  data.resize(static_cast<size_t>(header.dataSize));
+  if (!in.read(reinterpret_cast<char *>(data.data()),
+               static_cast<std::streamsize>(data.size())) ||
+      HashBytes(data.data(), data.size()) != header.dataHash) {
+    std::cerr << "[PipelineCache] Corrupt cache ignored: " << path
+              << std::endl;
+    data.clear();
+  }
+  return data;
+}
+
+void PipelineCache::Create(VkDevice device, VkPhysicalDevice physicalDevice,
+                           const std::string &path) {
+  mDevice = device;
+  mPath = path;
+  vkGetPhysicalDeviceProperties(physicalDevice, &mProperties);
+
+  CacheFileHeader expected;
+  FillHeader(expected, mProperties);
+  std::vector<uint8_t> initial = LoadCacheFile(path, expected);
+
+  VkPipelineCacheCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  info.initialDataSize = initial.size();
+  info.pInitialData = initial.empty() ? nullptr : initial.data();
+  if (vkCreatePipelineCache(device, &info, nullptr, &mCache) != VK_SUCCESS &&
+      !initial.empty()) {
+    // Rejected by the driver after all: start empty
+    info.initialDataSize = 0;
+    info.pInitialData = nullptr;
+    initial.clear();
+    vkCreatePipelineCache(device, &info, nullptr, &mCache);
+  }
+
+  mLoadedSize = initial.size();
+  if (mLoadedSize > 0) {
+    std::cout << "[PipelineCache] Loaded " << mLoadedSize / 1024
+              << " KB from " << path << std::endl;
+  }
+}
+
+bool PipelineCache::Save() {
+  if (!mCache || mPath.empty())
+    return false;
+
+  size_t size = 0;
+  if (vkGetPipelineCacheData(mDevice, mCache, &size, nullptr) != VK_SUCCESS)
+    return false;
+  // Nothing compiled since loading; skip the write
+  if (size == mLoadedSize)
+    return true;
+  std::vector<uint8_t> data(size);
+  if (vkGetPipelineCacheData(mDevice, mCache, &size, data.data()) !=
+      VK_SUCCESS)
+    return false;
+  data.resize(size);
+
+  CacheFileHeader header;
+  FillHeader(header, mProperties);
+  header.dataSize = data.size();
+  header.dataHash = HashBytes(data.data(), data.size());
+
+  // Temporary and rename, so a crash never leaves a torn cache
+  std::string tmpPath = mPath + ".tmp";
+  {
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(data.data()),
+              static_cast<std::streamsize>(data.size()));
+    if (!out)
+      return false;
+  }
+  std::remove(mPath.c_str());
+  if (std::rename(tmpPath.c_str(), mPath.c_str()) != 0)
+    return false;
+
+  mLoadedSize = data.size();
+  std::cout << "[PipelineCache] Saved " << data.size() / 1024 << " KB to "
+            << mPath << std::endl;
+  return true;
+}
+
+void PipelineCache::Destroy() {
+  if (!mCache)
+    return;
+  if (!Save())
+    std::cerr << "[PipelineCache] Could not write " << mPath << std::endl;
+  vkDestroyPipelineCache(mDevice, mCache, nullptr);
+  mCache = VK_NULL_HANDLE;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <string>
+
+// One VkPipelineCache shared by every pipeline, persisted between runs.
+// The file is only fed to the driver when its header matches this device
+// (vendor, device ID, pipeline cache UUID) and driver version; anything
+// else starts an empty cache that is written back on Destroy().
+class PipelineCache {
+public:
+  void Create(VkDevice device, VkPhysicalDevice physicalDevice,
+              const std::string &path);
+  // Saves (if pipelines were added since loading) and destroys the cache
+  void Destroy();
+
+  bool Save();
+  VkPipelineCache Get() const { return mCache; }
+
+private:
+  VkDevice mDevice = VK_NULL_HANDLE;
+  VkPipelineCache mCache = VK_NULL_HANDLE;
+  VkPhysicalDeviceProperties mProperties = {};
+  std::string mPath;
+  size_t mLoadedSize = 0;
+};
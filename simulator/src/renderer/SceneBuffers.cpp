@@ -0,0 +1,223 @@
+#include "renderer/SceneBuffers.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#define VK_CHECK(x)                                                            \
+  do {                                                                         \
+    VkResult err = x;                                                          \
+    if (err) {                                                                 \
+      std::cerr << "[SceneBuffers] Vulkan Error: " << err << std::endl;        \
+      throw std::runtime_error("SceneBuffers Vulkan error");                   \
+    }                                                                          \
+  } while (0)
+
+VkDescriptorSetLayout SceneBuffers::CreateSetLayout(VkDevice device) {
+  VkDescriptorSetLayoutBinding bindings[3] = {};
+  bindings[0].binding = 0;
+  bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  bindings[0].descriptorCount = 1;
+  bindings[0].stageFlags =
+      VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+  bindings[1].binding = 1;
+  bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  bindings[1].descriptorCount = 1;
+  bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+  bindings[2].binding = 2;
+  bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  bindings[2].descriptorCount = 1;
+  bindings[2].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  VkDescriptorSetLayoutCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  info.bindingCount = 3;
+  info.pBindings = bindings;
+
+  VkDescriptorSetLayout layout;
+  VK_CHECK(vkCreateDescriptorSetLayout(device, &info, nullptr, &layout));
+  return layout;
+}
+
+void SceneBuffers::Create(VkDevice device, VkPhysicalDevice physicalDevice,
+                          VmaAllocator allocator, uint32_t frameCount,
+                          uint32_t initialObjects) {
+  mDevice = device;
+  mAllocator = allocator;
+  mInitialObjects = initialObjects;
+
+  VkPhysicalDeviceProperties props;
+  vkGetPhysicalDeviceProperties(physicalDevice, &props);
+  VkDeviceSize align = props.limits.minUniformBufferOffsetAlignment;
+  if (align > 0)
+    mCameraStride = (sizeof(CameraData) + align - 1) / align * align;
+
+  mSetLayout = CreateSetLayout(device);
+  EnsureFrames(frameCount);
+}
+
+void SceneBuffers::Destroy() {
+  for (Frame &frame : mFrames) {
+    DestroyBuffer(frame.camera);
+    DestroyBuffer(frame.objects);
+    if (frame.pool)
+      vkDestroyDescriptorPool(mDevice, frame.pool, nullptr);
+  }
+  mFrames.clear();
+  mCurrent = nullptr;
+  if (mSetLayout) {
+    vkDestroyDescriptorSetLayout(mDevice, mSetLayout, nullptr);
+    mSetLayout = VK_NULL_HANDLE;
+  }
+}
+
+void SceneBuffers::EnsureFrames(uint32_t frameCount) {
+  // Frame pointers into the vector are refreshed by the next BeginFrame
+  mCurrent = nullptr;
+  while (mFrames.size() < frameCount) {
+    mFrames.emplace_back();
+    CreateFrame(mFrames.back());
+  }
+}
+
+// Host-visible, persistently mapped. Written sequentially by the CPU and
+// read once per draw by the GPU, so write-combined memory is fine.
+SceneBuffers::Buffer SceneBuffers::CreateBuffer(VkDeviceSize size,
+                                                VkBufferUsageFlags usage) {
+  VkBufferCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  info.size = size;
+  info.usage = usage;
+  info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  VmaAllocationCreateInfo allocInfo = {};
+  allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                    VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  Buffer buffer;
+  VmaAllocationInfo mapped;
+  VK_CHECK(vmaCreateBuffer(mAllocator, &info, &allocInfo, &buffer.buffer,
+                           &buffer.allocation, &mapped));
+  buffer.mapped = mapped.pMappedData;
+  return buffer;
+}
+
+void SceneBuffers::DestroyBuffer(Buffer &buffer) {
+  if (buffer.buffer)
+    vmaDestroyBuffer(mAllocator, buffer.buffer, buffer.allocation);
+  buffer = Buffer();
+}
+
+void SceneBuffers::CreateFrame(Frame &frame) {
+  frame.camera = CreateBuffer(mCameraStride * kMaxViews,
+                              VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+  frame.capacity = mInitialObjects;
+  frame.objects = CreateBuffer(frame.capacity * sizeof(ObjectData),
+                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+  VkDescriptorPoolSize sizes[3] = {
+      {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1},
+      {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
+      {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1},
+  };
+  VkDescriptorPoolCreateInfo poolInfo = {};
+  poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  poolInfo.maxSets = 1;
+  poolInfo.poolSizeCount = 3;
+  poolInfo.pPoolSizes = sizes;
+  VK_CHECK(vkCreateDescriptorPool(mDevice, &poolInfo, nullptr, &frame.pool));
+
+  VkDescriptorSetAllocateInfo setInfo = {};
+  setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  setInfo.descriptorPool = frame.pool;
+  setInfo.descriptorSetCount = 1;
+  setInfo.pSetLayouts = &mSetLayout;
+  VK_CHECK(vkAllocateDescriptorSets(mDevice, &setInfo, &frame.set));
+  WriteDescriptors(frame);
+}
+
+void SceneBuffers::WriteDescriptors(Frame &frame) {
+  VkDescriptorBufferInfo cameraInfo = {frame.camera.buffer, 0,
+                                       sizeof(CameraData)};
+  VkDescriptorBufferInfo objectInfo = {frame.objects.buffer, 0,
+                                       VK_WHOLE_SIZE};
+
+  VkDescriptorImageInfo shadowInfo = {
+      mShadowSampler, mShadowView,
+      VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+
+  VkWriteDescriptorSet writes[3] = {};
+  writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  writes[0].dstSet = frame.set;
+  writes[0].dstBinding = 0;
+  writes[0].descriptorCount = 1;
+  writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+  writes[0].pBufferInfo = &cameraInfo;
+  writes[1] = writes[0];
+  writes[1].dstBinding = 1;
+  writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  writes[1].pBufferInfo = &objectInfo;
+  writes[2] = writes[0];
+  writes[2].dstBinding = 2;
+  writes[2].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  writes[2].pBufferInfo = nullptr;
+  writes[2].pImageInfo = &shadowInfo;
+  // The shadow map is only known after SetShadowMap
+  uint32_t count = mShadowView ? 3 : 2;
+  vkUpdateDescriptorSets(mDevice, count, writes, 0, nullptr);
+}
+
+// Only called between BeginFrame and Bind, while the GPU is done with this
+// slot, so the old buffer can go immediately
+void SceneBuffers::GrowObjects(Frame &frame, uint32_t capacity) {
+  Buffer grown = CreateBuffer(capacity * sizeof(ObjectData),
+                              VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+  memcpy(grown.mapped, frame.objects.mapped,
+         mObjectCount * sizeof(ObjectData));
+  DestroyBuffer(frame.objects);
+  frame.objects = grown;
+  frame.capacity = capacity;
+  WriteDescriptors(frame);
+}
+
+void SceneBuffers::SetShadowMap(VkImageView view, VkSampler sampler) {
+  mShadowView = view;
+  mShadowSampler = sampler;
+  for (Frame &frame : mFrames)
+    WriteDescriptors(frame);
+}
+
+void SceneBuffers::BeginFrame(uint32_t frame, const CameraData &camera) {
+  mCurrent = &mFrames.at(frame);
+  mObjectCount = 0;
+  memcpy(mCurrent->camera.mapped, &camera, sizeof(camera));
+}
+
+void SceneBuffers::SetView(uint32_t view, const CameraData &camera) {
+  if (view >= kMaxViews)
+    return;
+  uint8_t *base = static_cast<uint8_t *>(mCurrent->camera.mapped);
+  memcpy(base + view * mCameraStride, &camera, sizeof(camera));
+}
+
+uint32_t SceneBuffers::AddObject(const glm::mat4 &model) {
+  if (mObjectCount == mCurrent->capacity)
+    GrowObjects(*mCurrent, mCurrent->capacity * 2);
+  ObjectData *objects = static_cast<ObjectData *>(mCurrent->objects.mapped);
+  objects[mObjectCount].model = model;
+  return mObjectCount++;
+}
+
+void SceneBuffers::Bind(VkCommandBuffer cmd, VkPipelineLayout layout,
+                        uint32_t view) {
+  // No-ops on HOST_COHERENT memory
+  vmaFlushAllocation(mAllocator, mCurrent->camera.allocation, 0,
+                     VK_WHOLE_SIZE);
+  vmaFlushAllocation(mAllocator, mCurrent->objects.allocation, 0,
+                     VK_WHOLE_SIZE);
+  uint32_t offset =
+      static_cast<uint32_t>(std::min(view, kMaxViews - 1) * mCameraStride);
+  vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1,
+                          &mCurrent->set, 1, &offset);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <vk_mem_alloc.h>
+
+static const uint32_t kMaxShadowCascades = 4;
+static const uint32_t kMaxViews = 4;
+
+// std140 layout of the camera uniform block (set 0, binding 0), read by
+// both shader stages. The shadow fields are filled in by ShadowMap and are
+// the same for every view.
+struct CameraData {
+  glm::mat4 viewProj;
+  glm::mat4 view;
+  glm::mat4 lightViewProj[kMaxShadowCascades];
+  glm::vec4 cascadeOffsets; // Normal offset (world units) per cascade
+  glm::vec4 lightDir;       // xyz: direction towards the light
+  glm::vec4 shadowParams;   // x: cascades (0 = off), y: PCF radius, z: texel
+};
+
+// std430 layout of one entry of the object storage buffer (set 0, binding 1)
+struct ObjectData {
+  glm::mat4 model;
+};
+
+// Per-frame shader inputs: one CameraData per view in a dynamic uniform
+// buffer and every object's model matrix in a storage buffer, indexed in
+// the vertex shader by gl_InstanceIndex (the draw's firstInstance); binding
+// 2 is the shadow map. Objects are shared by all views.
+// There is one slot per swapchain image; a slot is only rewritten after
+// BeginFrame has waited on that image's fence. Buffers are persistently
+// mapped, so each transform is written once per frame straight into
+// GPU-visible memory.
+//
+// Usage per frame: BeginFrame, SetView for every view after the first,
+// AddObject for every draw, then Bind per view and draw with the returned
+// indices. Bind must come last: the object buffer may be reallocated while
+// objects are added.
+class SceneBuffers {
+public:
+  void Create(VkDevice device, VkPhysicalDevice physicalDevice,
+              VmaAllocator allocator, uint32_t frameCount,
+              uint32_t initialObjects = 256);
+  void Destroy();
+
+  // Adds slots after the swapchain grew; existing slots are untouched
+  void EnsureFrames(uint32_t frameCount);
+
+  // Binding 2, sampled by the fragment shader. Rewrites every slot, so the
+  // device must be idle.
+  void SetShadowMap(VkImageView view, VkSampler sampler);
+
+  // `camera` is view 0
+  void BeginFrame(uint32_t frame, const CameraData &camera);
+  void SetView(uint32_t view, const CameraData &camera);
+  uint32_t AddObject(const glm::mat4 &model);
+  // Binds set 0 with `view`'s camera
+  void Bind(VkCommandBuffer cmd, VkPipelineLayout layout, uint32_t view = 0);
+
+  uint32_t GetObjectCount() const { return mObjectCount; }
+
+  // Matches Pipeline's set 0; identically defined layouts are compatible
+  static VkDescriptorSetLayout CreateSetLayout(VkDevice device);
+
+private:
+  struct Buffer {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    void *mapped = nullptr;
+  };
+  struct Frame {
+    Buffer camera;
+    Buffer objects;
+    uint32_t capacity = 0;
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+  };
+
+  Buffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage);
+  void DestroyBuffer(Buffer &buffer);
+  void CreateFrame(Frame &frame);
+  void GrowObjects(Frame &frame, uint32_t capacity);
+  void WriteDescriptors(Frame &frame);
+
+  VkDevice mDevice = VK_NULL_HANDLE;
+  VmaAllocator mAllocator = VK_NULL_HANDLE;
+  VkDescriptorSetLayout mSetLayout = VK_NULL_HANDLE;
+  uint32_t mInitialObjects = 256;
+  VkDeviceSize mCameraStride = sizeof(CameraData); // Dynamic offset step
+  VkImageView mShadowView = VK_NULL_HANDLE;
+  VkSampler mShadowSampler = VK_NULL_HANDLE;
+
+  std::vector<Frame> mFrames;
+  Frame *mCurrent = nullptr;
+  uint32_t mObjectCount = 0;
+};
@@ -0,0 +1,212 @@
+#include "renderer/SceneViews.h"
+#include "renderer/Camera.h"
+#include "renderer/GpuTimer.h"
+#include "renderer/Pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+static const float kInsetWidth = 0.3f; // Fraction of the target width
+static const float kInsetAspect = 16.0f / 9.0f;
+static const int32_t kInsetMargin = 8; // Pixels
+static const char *kChaseNames[] = {"Chase 1", "Chase 2", "Chase 3"};
+
+// --- Frustum ---
+// Gribb/Hartmann plane extraction; clip space has 0 <= z <= w
+// (GLM_FORCE_DEPTH_ZERO_TO_ONE)
+Frustum ExtractFrustum(const glm::mat4 &m) {
+  glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+  glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+  glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+  glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+  Frustum frustum;
+  frustum.planes[0] = row3 + row0; // Left
+  frustum.planes[1] = row3 - row0; // Right
+  frustum.planes[2] = row3 + row1; // Top/bottom (Y is flipped)
+  frustum.planes[3] = row3 - row1;
+  frustum.planes[4] = row2;        // Near
+  frustum.planes[5] = row3 - row2; // Far
+  return frustum;
+}
+
+// Conservative: tests the box corner furthest along each plane normal
+bool FrustumIntersectsBox(const Frustum &frustum, const glm::vec3 &boxMin,
+                          const glm::vec3 &boxMax) {
+  for (const glm::vec4 &plane : frustum.planes) {
+    glm::vec3 corner(plane.x >= 0.0f ? boxMax.x : boxMin.x,
+                     plane.y >= 0.0f ? boxMax.y : boxMin.y,
+                     plane.z >= 0.0f ? boxMax.z : boxMin.z);
+    if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+      return false;
+  }
+  return true;
+}
+
+// Same conventions as Camera::GetProjectionMatrix
+static glm::mat4 Perspective(float fovDegrees, float aspect, float nearPlane,
+                             float farPlane) {
+  glm::mat4 proj =
+      glm::perspective(glm::radians(fovDegrees), aspect, nearPlane, farPlane);
+  proj[1][1] *= -1.0f;
+  return proj;
+}
+
+static float Aspect(const VkRect2D &rect) {
+  return static_cast<float>(rect.extent.width) /
+         static_cast<float>(std::max(rect.extent.height, 1u));
+}
+
+// --- Views ---
+void SceneViews::AddView(ViewKind kind, const char *name,
+                         const glm::mat4 &view, const glm::mat4 &proj,
+                         VkRect2D rect) {
+  if (mCount == mViews.size())
+    mViews.emplace_back();
+  SceneView &out = mViews[mCount++];
+  out.kind = kind;
+  out.name = name;
+  out.view = view;
+  out.proj = proj;
+  out.rect = rect;
+}
+
+void SceneViews::Update(const Camera &camera, VkExtent2D extent,
+                        const glm::vec3 &fieldMin, const glm::vec3 &fieldMax,
+                        const std::vector<glm::mat4> &robots) {
+  mCount = 0;
+
+  VkRect2D full = {{0, 0}, extent};
+  AddView(ViewKind::eMAIN, "Main", camera.GetViewMatrix(),
+          camera.GetProjectionMatrix(Aspect(full)), full);
+
+  // Insets stack down the left edge; the info panel is on the right
+  uint32_t insetWidth = static_cast<uint32_t>(extent.width * kInsetWidth);
+  uint32_t insetHeight = static_cast<uint32_t>(insetWidth / kInsetAspect);
+  int32_t nextY = kInsetMargin;
+  auto nextRect = [&](VkRect2D &rect) {
+    if (nextY + static_cast<int32_t>(insetHeight) >
+            static_cast<int32_t>(extent.height) ||
+        insetWidth == 0 || insetHeight == 0 || mCount >= kMaxViews)
+      return false;
+    rect = {{kInsetMargin, nextY}, {insetWidth, insetHeight}};
+    nextY += static_cast<int32_t>(insetHeight) + kInsetMargin;
+    return true;
+  };
+
+  glm::vec3 center = (fieldMin + fieldMax) * 0.5f;
+  glm::vec3 size = fieldMax - fieldMin;
+  VkRect2D rect;
+
+  if (showOverview && nextRect(rect)) {
+    // High enough that the whole field fits the shorter frustum side
+    float fov = 45.0f;
+    float halfFit = 0.5f * std::max(size.x / Aspect(rect), size.z) * 1.05f;
+    float height = halfFit / std::tan(glm::radians(fov) * 0.5f);
+    glm::vec3 eye = center + glm::vec3(0.0f, height, 0.0f);
+    AddView(ViewKind::eOVERVIEW, "Overview",
+            glm::lookAt(eye, center, glm::vec3(0.0f, 0.0f, -1.0f)),
+            Perspective(fov, Aspect(rect), height * 0.1f,
+                        height + size.y + 1.0f),
+            rect);
+  }
+
+  if (showDriver && nextRect(rect)) {
+    // Standing a metre behind the +Z wall at eye height
+    glm::vec3 eye(center.x, fieldMin.y + 1.6f, fieldMax.z + 1.0f);
+    AddView(ViewKind::eDRIVER, "Driver",
+            glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f)),
+            Perspective(55.0f, Aspect(rect), 0.1f, 200.0f), rect);
+  }
+
+  if (showChase) {
+    size_t chaseCount =
+        std::min(robots.size(), sizeof(kChaseNames) / sizeof(kChaseNames[0]));
+    for (size_t i = 0; i < chaseCount; i++) {
+      if (!nextRect(rect))
+        break;
+      // The robot's local +Z is its front; follow its heading only
+      const glm::mat4 &robot = robots[i];
+      glm::vec3 position(robot[3]);
+      glm::vec3 forward(robot[2].x, 0.0f, robot[2].z);
+      forward = glm::length(forward) > 1e-6f ? glm::normalize(forward)
+                                             : glm::vec3(0.0f, 0.0f, 1.0f);
+      glm::vec3 eye =
+          position - forward * 1.2f + glm::vec3(0.0f, 0.7f, 0.0f);
+      AddView(ViewKind::eCHASE, kChaseNames[i],
+              glm::lookAt(eye, position + forward * 0.8f,
+                          glm::vec3(0.0f, 1.0f, 0.0f)),
+              Perspective(60.0f, Aspect(rect), 0.05f, 200.0f), rect);
+    }
+  }
+
+  mViews.resize(mCount);
+}
+
+void SceneViews::Upload(SceneBuffers &scene, const CameraData &base) const {
+  for (uint32_t i = 0; i < mViews.size(); i++) {
+    CameraData data = base;
+    data.view = mViews[i].view;
+    data.viewProj = mViews[i].proj * mViews[i].view;
+    scene.SetView(i, data);
+  }
+}
+
+void SceneViews::Cull(const std::vector<DrawItem> &items) {
+  for (SceneView &view : mViews) {
+    auto start = std::chrono::steady_clock::now();
+    Frustum frustum = ExtractFrustum(view.proj * view.view);
+    view.visible.clear();
+    for (uint32_t i = 0; i < items.size(); i++) {
+      if (FrustumIntersectsBox(frustum, items[i].boundsMin,
+                               items[i].boundsMax))
+        view.visible.push_back(i);
+    }
+    view.cullMs = std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  }
+}
+
+void SceneViews::Record(VkCommandBuffer cmd, const Pipeline &pipeline,
+                        SceneBuffers &scene, GpuTimer &timer,
+                        const std::vector<DrawItem> &items) {
+  for (uint32_t i = 0; i < mViews.size(); i++) {
+    SceneView &view = mViews[i];
+    auto start = std::chrono::steady_clock::now();
+    uint32_t scope = timer.Begin(cmd, view.name);
+
+    if (view.kind != ViewKind::eMAIN) {
+      // The main view has already covered this rectangle
+      VkClearAttachment clears[2] = {};
+      clears[0].aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      clears[0].colorAttachment = 0;
+      clears[0].clearValue.color = {{0.05f, 0.05f, 0.06f, 1.0f}};
+      clears[1].aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+      clears[1].clearValue.depthStencil = {1.0f, 0};
+      VkClearRect clearRect = {view.rect, 0, 1};
+      vkCmdClearAttachments(cmd, 2, clears, 1, &clearRect);
+    }
+
+    VkViewport viewport = {};
+    viewport.x = static_cast<float>(view.rect.offset.x);
+    viewport.y = static_cast<float>(view.rect.offset.y);
+    viewport.width = static_cast<float>(view.rect.extent.width);
+    viewport.height = static_cast<float>(view.rect.extent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &view.rect);
+
+    scene.Bind(cmd, pipeline.GetLayout(), i);
+    for (uint32_t item : view.visible)
+      DrawModel(cmd, *items[item].meshes, items[item].object);
+
+    timer.End(cmd, scope);
+    view.recordMs = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+  }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "renderer/ModelLoader.h"
+#include "renderer/SceneBuffers.h"
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+class Camera;
+class GpuTimer;
+class Pipeline;
+
+// Inward-facing planes (xyz normal, w distance) of a view-projection matrix
+struct Frustum {
+  glm::vec4 planes[6];
+};
+
+Frustum ExtractFrustum(const glm::mat4 &viewProj);
+bool FrustumIntersectsBox(const Frustum &frustum, const glm::vec3 &boxMin,
+                          const glm::vec3 &boxMax);
+
+enum class ViewKind { eMAIN, eOVERVIEW, eDRIVER, eCHASE };
+
+// One camera rendered into a rectangle of the scene target
+struct SceneView {
+  ViewKind kind = ViewKind::eMAIN;
+  const char *name = "";
+  glm::mat4 view = glm::mat4(1.0f);
+  glm::mat4 proj = glm::mat4(1.0f);
+  VkRect2D rect = {};
+  std::vector<uint32_t> visible; // Indices into the frame's draw items
+
+  // Cost of the last frame, for the overlay
+  double cullMs = 0.0;
+  double recordMs = 0.0;
+};
+
+// The main orbit camera plus optional picture-in-picture insets for match
+// review: a top-down field overview, the driver-station view from behind
+// the field wall and a chase camera per robot. All views share one frame's
+// SceneBuffers objects (each transform and bound is computed once), the
+// shadow map and the bound pipeline; per view only the camera's dynamic
+// uniform offset changes, and only the draw items inside its frustum are
+// recorded. Insets are drawn in the scene pass after the main view, each
+// clearing its own rectangle first.
+class SceneViews {
+public:
+  bool showOverview = false;
+  bool showDriver = false;
+  bool showChase = false;
+
+  // Rebuilds the views for this frame. `fieldMin`/`fieldMax` place the
+  // overview and driver cameras; each robot transform gets a chase camera.
+  void Update(const Camera &camera, VkExtent2D extent,
+              const glm::vec3 &fieldMin, const glm::vec3 &fieldMax,
+              const std::vector<glm::mat4> &robots);
+
+  // Writes every view's camera; shadow fields are copied from `base`
+  void Upload(SceneBuffers &scene, const CameraData &base) const;
+
+  // Fills each view's visible list from the shared draw items
+  void Cull(const std::vector<DrawItem> &items);
+
+  // Records every view inside the scene pass with `pipeline` bound
+  void Record(VkCommandBuffer cmd, const Pipeline &pipeline,
+              SceneBuffers &scene, GpuTimer &timer,
+              const std::vector<DrawItem> &items);
+
+  const std::vector<SceneView> &GetViews() const { return mViews; }
+
+private:
+  void AddView(ViewKind kind, const char *name, const glm::mat4 &view,
+               const glm::mat4 &proj, VkRect2D rect);
+
+  // Views are kept across frames so their visible lists keep capacity
+  std::vector<SceneView> mViews;
+  size_t mCount = 0; // Views added by this Update
+};
@@ -0,0 +1,192 @@
+#include "renderer/ShaderReloader.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static const double kPollInterval = 0.25; // Seconds between mtime checks
+
+static std::filesystem::file_time_type ModifiedTime(const std::string &path) {
+  std::error_code ec;
+  auto time = std::filesystem::last_write_time(path, ec);
+  return ec ? std::filesystem::file_time_type() : time;
+}
+
+ShaderReloader::ShaderReloader(std::string glslc, std::string vertSource,
+                               std::string fragSource, std::string vertOutput,
+                               std::string fragOutput)
+    : mGlslc(std::move(glslc)), mVertSource(std::move(vertSource)),
+      mFragSource(std::move(fragSource)), mVertOutput(std::move(vertOutput)),
+      mFragOutput(std::move(fragOutput)) {
+  mVertTime = ModifiedTime(mVertSource);
+  mFragTime = ModifiedTime(mFragSource);
+  std::cout << "[ShaderReloader] Watching " << mVertSource << " and "
+            << mFragSource << std::endl;
+}
+
+ShaderReloader::~ShaderReloader() {
+  if (mWorker.joinable())
+    mWorker.join();
+}
+
+bool ShaderReloader::SourcesChanged() {
+  double now = glfwGetTime();
+  if (now < mNextPoll)
+    return false;
+  mNextPoll = now + kPollInterval;
+
+  auto vertTime = ModifiedTime(mVertSource);
+  auto fragTime = ModifiedTime(mFragSource);
+  if (vertTime == mVertTime && fragTime == mFragTime)
+    return false;
+  mVertTime = vertTime;
+  mFragTime = fragTime;
+  return true;
+}
+
+// Runs glslc, capturing its diagnostics into mError on failure
+bool ShaderReloader::Compile(const std::string &source,
+                             const std::string &output) {
+  std::string logPath = output + ".log";
+  std::string command = "\"" + mGlslc + "\" \"" + source + "\" -o \"" +
+                        output + "\" > \"" + logPath + "\" 2>&1";
+#ifdef _WIN32
+  // cmd.exe strips one pair of outer quotes
+  command = "\"" + command + "\"";
+#endif
+  int status = std::system(command.c_str());
+
+  std::ifstream log(logPath);
+  std::stringstream diagnostics;
+  diagnostics << log.rdbuf();
+  log.close();
+  std::remove(logPath.c_str());
+
+  if (status != 0) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mError = diagnostics.str();
+    if (mError.empty())
+      mError = "glslc exited with status " + std::to_string(status);
+    return false;
+  }
+  return true;
+}
+
+// Worker thread: compile both stages to side files, build the pipeline from
+// them, and only then replace the real .spv files
+void ShaderReloader::Rebuild(VkDevice device, VkRenderPass renderPass,
+                             uint32_t generation, VkFormat depthFormat,
+                             VkSampleCountFlagBits samples,
+                             VkPipelineCache cache) {
+  std::string vertTmp = mVertOutput + ".reload";
+  std::string fragTmp = mFragOutput + ".reload";
+  if (!Compile(mVertSource, vertTmp) || !Compile(mFragSource, fragTmp)) {
+    mBusy = false;
+    return;
+  }
+
+  Pipeline pipeline;
+  try {
+    pipeline.Create(device, renderPass, depthFormat, vertTmp, fragTmp, cache,
+                    samples);
+  } catch (const std::exception &e) {
+    pipeline.Destroy(device);
+    std::lock_guard<std::mutex> lock(mMutex);
+    mError = e.what();
+    mBusy = false;
+    return;
+  }
+
+  std::remove(mVertOutput.c_str());
+  std::rename(vertTmp.c_str(), mVertOutput.c_str());
+  std::remove(mFragOutput.c_str());
+  std::rename(fragTmp.c_str(), mFragOutput.c_str());
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPending = pipeline;
+    mPendingGeneration = generation;
+    mReady = true;
+  }
+  mBusy = false;
+}
+
+bool ShaderReloader::Update(VkDevice device, VkRenderPass renderPass,
+                            uint32_t renderPassGeneration,
+                            VkFormat depthFormat,
+                            VkSampleCountFlagBits samples,
+                            VkPipelineCache cache, Pipeline &pipeline,
+                            uint32_t framesInFlight) {
+  // Retire pipelines no frame in flight can reference any more
+  for (size_t i = 0; i < mRetired.size();) {
+    if (mRetired[i].framesLeft-- == 0) {
+      mRetired[i].pipeline.Destroy(device);
+      mRetired.erase(mRetired.begin() + i);
+    } else {
+      i++;
+    }
+  }
+
+  bool swapped = false;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    // Built against a render pass that has since been replaced: it does not
+    // match the current one, so build it again
+    if (mReady && mPendingGeneration != renderPassGeneration) {
+      mPending.Destroy(device);
+      mPending = Pipeline();
+      mReady = false;
+      mRestart = true;
+    }
+    if (mReady) {
+      mRetired.push_back({pipeline, framesInFlight});
+      pipeline = mPending;
+      mPending = Pipeline();
+      mReady = false;
+      swapped = true;
+      mLastError.clear();
+    }
+    if (!mError.empty()) {
+      mLastError = mError;
+      std::cerr << "[ShaderReloader] Rebuild failed, keeping the current "
+                   "pipeline:\n"
+                << mError << std::endl;
+      mError.clear();
+    }
+  }
+  if (swapped)
+    std::cout << "[ShaderReloader] Pipeline swapped in" << std::endl;
+
+  // One rebuild at a time; an edit made meanwhile is seen on a later poll
+  if (!mBusy && (mRestart || SourcesChanged())) {
+    if (mWorker.joinable())
+      mWorker.join();
+    mBusy = true;
+    std::cout << "[ShaderReloader] "
+              << (mRestart ? "Render pass changed" : "Shader source changed")
+              << ", rebuilding..." << std::endl;
+    mRestart = false;
+    mWorker = std::thread(&ShaderReloader::Rebuild, this, device, renderPass,
+                          renderPassGeneration, depthFormat, samples, cache);
+  }
+  return swapped;
+}
+
+void ShaderReloader::Wait() {
+  if (mWorker.joinable())
+    mWorker.join();
+}
+
+void ShaderReloader::Shutdown(VkDevice device) {
+  if (mWorker.joinable())
+    mWorker.join();
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mReady) {
+    mPending.Destroy(device);
+    mReady = false;
+  }
+  for (Retired &retired : mRetired)
+    retired.pipeline.Destroy(device);
+  mRetired.clear();
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "renderer/Pipeline.h"
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Watches the GLSL sources of a pipeline and rebuilds it in the background
+// when they change: glslc runs on a worker thread, which then creates the
+// new pipeline through the shared pipeline cache. The main thread only
+// swaps the finished pipeline in at a frame boundary and destroys the old
+// one once no frame in flight can still use it, so there is no device stall.
+// A shader that fails to compile is reported and the old pipeline kept.
+class ShaderReloader {
+public:
+  // `vertOutput`/`fragOutput` are the .spv files the pipeline loads; they
+  // are replaced once a rebuilt pipeline has been created from them.
+  ShaderReloader(std::string glslc, std::string vertSource,
+                 std::string fragSource, std::string vertOutput,
+                 std::string fragOutput);
+  ~ShaderReloader();
+  ShaderReloader(const ShaderReloader &) = delete;
+  ShaderReloader &operator=(const ShaderReloader &) = delete;
+
+  // Call once per frame before recording. Starts a rebuild when a source
+  // changed, swaps a finished one into `pipeline` and retires old
+  // pipelines after `framesInFlight` further calls. A rebuild made for an
+  // older `renderPassGeneration` is discarded and started again against
+  // `renderPass`. Returns true on a swap.
+  bool Update(VkDevice device, VkRenderPass renderPass,
+              uint32_t renderPassGeneration, VkFormat depthFormat,
+              VkSampleCountFlagBits samples, VkPipelineCache cache,
+              Pipeline &pipeline, uint32_t framesInFlight);
+
+  // Waits for a rebuild in flight; call before destroying the render pass
+  // it was started with
+  void Wait();
+  // Waits for the worker and destroys pending and retired pipelines
+  void Shutdown(VkDevice device);
+
+  const std::string &GetLastError() const { return mLastError; }
+
+private:
+  bool SourcesChanged();
+  void Rebuild(VkDevice device, VkRenderPass renderPass, uint32_t generation,
+               VkFormat depthFormat, VkSampleCountFlagBits samples,
+               VkPipelineCache cache);
+  bool Compile(const std::string &source, const std::string &output);
+
+  std::string mGlslc;
+  std::string mVertSource, mFragSource;
+  std::string mVertOutput, mFragOutput;
+  std::filesystem::file_time_type mVertTime, mFragTime;
+  double mNextPoll = 0.0;
+
+  std::thread mWorker;
+  std::atomic<bool> mBusy{false};
+
+  std::mutex mMutex; // Guards the fields below, written by the worker
+  bool mReady = false;
+  Pipeline mPending;
+  uint32_t mPendingGeneration = 0; // Render pass generation it was built for
+  std::string mError;
+
+  std::string mLastError;
+  bool mRestart = false; // A stale rebuild was dropped; redo it
+  struct Retired {
+    Pipeline pipeline;
+    uint32_t framesLeft;
+  };
+  std::vector<Retired> mRetired;
+};
@@ -0,0 +1,502 @@
+#include "renderer/ShadowMap.h"
+#include "renderer/Camera.h"
+#include "renderer/Pipeline.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <stdexcept>
+
+#define VK_CHECK(x)                                                            \
+  do {                                                                         \
+    VkResult err = x;                                                          \
+    if (err) {                                                                 \
+      std::cerr << "[ShadowMap] Vulkan Error: " << err << std::endl;           \
+      throw std::runtime_error("ShadowMap Vulkan error");                      \
+    }                                                                          \
+  } while (0)
+
+static const VkFormat kShadowFormat = VK_FORMAT_D16_UNORM;
+static const float kShadowDistance = 20.0f; // Beyond this nothing is shadowed
+static const float kSplitLambda = 0.75f;    // 1 = logarithmic, 0 = uniform
+static const float kCasterPullback = 10.0f; // Catches casters behind a box
+static const float kNormalOffsetTexels = 1.5f;
+// Towards the light: upper-right-front, as the shading always assumed
+static const glm::vec3 kLightDir =
+    glm::normalize(glm::vec3(0.5f, 1.0f, 0.3f));
+
+struct QualitySettings {
+  const char *name;
+  uint32_t resolution;
+  uint32_t cascades;
+  uint32_t pcfRadius; // Taps per side: 2 * radius + 1
+};
+
+static const QualitySettings kQualities[] = {
+    {"off", 1, 0, 0},
+    {"low", 1024, 2, 0},
+    {"medium", 2048, 3, 1},
+    {"high", 2048, 4, 2},
+};
+
+bool ParseShadowQuality(const std::string &name, ShadowQuality &out) {
+  for (int i = 0; i < 4; i++) {
+    if (name == kQualities[i].name) {
+      out = static_cast<ShadowQuality>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+const char *GetShadowQualityName(ShadowQuality quality) {
+  return kQualities[static_cast<int>(quality)].name;
+}
+
+void ShadowMap::Create(VkDevice device, VmaAllocator allocator, VkQueue queue,
+                       uint32_t queueFamily, VkPipelineCache cache,
+                       const std::string &vertPath, ShadowQuality quality) {
+  mDevice = device;
+  mAllocator = allocator;
+  mQueue = queue;
+  mQueueFamily = queueFamily;
+
+  VkSamplerCreateInfo samplerInfo = {};
+  samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+  // Linear + compare gives a 2x2 hardware PCF per tap
+  samplerInfo.magFilter = VK_FILTER_LINEAR;
+  samplerInfo.minFilter = VK_FILTER_LINEAR;
+  samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+  samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+  samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+  samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+  samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+  samplerInfo.compareEnable = VK_TRUE;
+  samplerInfo.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+  samplerInfo.maxLod = 0.0f;
+  VK_CHECK(vkCreateSampler(device, &samplerInfo, nullptr, &mSampler));
+
+  CreateRenderPass();
+  CreatePipeline(cache, vertPath);
+
+  mQuality = quality;
+  const QualitySettings &settings = kQualities[static_cast<int>(quality)];
+  mResolution = settings.resolution;
+  mCascadeCount = settings.cascades;
+  mPcfRadius = settings.pcfRadius;
+  CreateTargets();
+}
+
+void ShadowMap::Destroy() {
+  DestroyTargets();
+  if (mPipeline)
+    vkDestroyPipeline(mDevice, mPipeline, nullptr);
+  if (mLayout)
+    vkDestroyPipelineLayout(mDevice, mLayout, nullptr);
+  if (mSetLayout)
+    vkDestroyDescriptorSetLayout(mDevice, mSetLayout, nullptr);
+  if (mRenderPass)
+    vkDestroyRenderPass(mDevice, mRenderPass, nullptr);
+  if (mSampler)
+    vkDestroySampler(mDevice, mSampler, nullptr);
+  mPipeline = VK_NULL_HANDLE;
+  mLayout = VK_NULL_HANDLE;
+  mSetLayout = VK_NULL_HANDLE;
+  mRenderPass = VK_NULL_HANDLE;
+  mSampler = VK_NULL_HANDLE;
+}
+
+void ShadowMap::SetQuality(ShadowQuality quality) {
+  if (quality == mQuality)
+    return;
+  vkDeviceWaitIdle(mDevice);
+  DestroyTargets();
+
+  mQuality = quality;
+  const QualitySettings &settings = kQualities[static_cast<int>(quality)];
+  mResolution = settings.resolution;
+  mCascadeCount = settings.cascades;
+  mPcfRadius = settings.pcfRadius;
+  CreateTargets();
+}
+
+// Depth-only pass that leaves the layer ready for sampling. The incoming
+// dependency orders the write after the previous frame's fragment reads.
+void ShadowMap::CreateRenderPass() {
+  VkAttachmentDescription depth = {};
+  depth.format = kShadowFormat;
+  depth.samples = VK_SAMPLE_COUNT_1_BIT;
+  depth.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+  depth.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  depth.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  depth.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  depth.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  depth.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+  VkAttachmentReference depthRef = {
+      0, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+  VkSubpassDescription subpass = {};
+  subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  subpass.pDepthStencilAttachment = &depthRef;
+
+  VkSubpassDependency deps[2] = {};
+  deps[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+  deps[0].dstSubpass = 0;
+  deps[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+  deps[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                         VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+  deps[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  deps[1].srcSubpass = 0;
+  deps[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+  deps[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+  deps[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+  deps[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  deps[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+  VkRenderPassCreateInfo info = {};
+  info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+  info.attachmentCount = 1;
+  info.pAttachments = &depth;
+  info.subpassCount = 1;
+  info.pSubpasses = &subpass;
+  info.dependencyCount = 2;
+  info.pDependencies = deps;
+  VK_CHECK(vkCreateRenderPass(mDevice, &info, nullptr, &mRenderPass));
+}
+
+void ShadowMap::CreatePipeline(VkPipelineCache cache,
+                               const std::string &vertPath) {
+  VkShaderModule vertModule = Pipeline::LoadShaderModule(mDevice, vertPath);
+
+  VkPipelineShaderStageCreateInfo stage = {};
+  stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  stage.stage = VK_SHADER_STAGE_VERTEX_BIT;
+  stage.module = vertModule;
+  stage.pName = "main";
+
+  // Position only
+  auto bindingDesc = Vertex::GetBindingDescription();
+  auto attrDescs = Vertex::GetAttributeDescriptions();
+  VkPipelineVertexInputStateCreateInfo vertexInput = {};
+  vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+  vertexInput.vertexBindingDescriptionCount = 1;
+  vertexInput.pVertexBindingDescriptions = &bindingDesc;
+  vertexInput.vertexAttributeDescriptionCount = 1;
+  vertexInput.pVertexAttributeDescriptions = &attrDescs[0];
+
+  VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+  inputAssembly.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+  inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+  VkPipelineViewportStateCreateInfo viewportState = {};
+  viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+  viewportState.viewportCount = 1;
+  viewportState.scissorCount = 1;
+
+  // No culling: field parts are often single-sided sheets. Slope-scaled
+  // bias handles acne on surfaces facing away from the light.
+  VkPipelineRasterizationStateCreateInfo rasterizer = {};
+  rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+  rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+  rasterizer.lineWidth = 1.0f;
+  rasterizer.cullMode = VK_CULL_MODE_NONE;
+  rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+  rasterizer.depthBiasEnable = VK_TRUE;
+  rasterizer.depthBiasConstantFactor = 1.25f;
+  rasterizer.depthBiasSlopeFactor = 1.75f;
+
+  VkPipelineMultisampleStateCreateInfo multisampling = {};
+  multisampling.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+  multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+  VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+  depthStencil.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+  depthStencil.depthTestEnable = VK_TRUE;
+  depthStencil.depthWriteEnable = VK_TRUE;
+  depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+  VkPipelineColorBlendStateCreateInfo colorBlending = {};
+  colorBlending.sType =
+      VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+
+  VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT,
+                                    VK_DYNAMIC_STATE_SCISSOR};
+  VkPipelineDynamicStateCreateInfo dynamicState = {};
+  dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+  dynamicState.dynamicStateCount = 2;
+  dynamicState.pDynamicStates = dynamicStates;
+
+  // Set 0 as in the main pipeline, plus the cascade index
+  mSetLayout = SceneBuffers::CreateSetLayout(mDevice);
+  VkPushConstantRange cascadeRange = {VK_SHADER_STAGE_VERTEX_BIT, 0,
+                                      sizeof(uint32_t)};
+  VkPipelineLayoutCreateInfo layoutInfo = {};
+  layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  layoutInfo.setLayoutCount = 1;
+  layoutInfo.pSetLayouts = &mSetLayout;
+  layoutInfo.pushConstantRangeCount = 1;
+  layoutInfo.pPushConstantRanges = &cascadeRange;
+  VK_CHECK(vkCreatePipelineLayout(mDevice, &layoutInfo, nullptr, &mLayout));
+
+  VkGraphicsPipelineCreateInfo pipelineInfo = {};
+  pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+  pipelineInfo.stageCount = 1;
+  pipelineInfo.pStages = &stage;
+  pipelineInfo.pVertexInputState = &vertexInput;
+  pipelineInfo.pInputAssemblyState = &inputAssembly;
+  pipelineInfo.pViewportState = &viewportState;
+  pipelineInfo.pRasterizationState = &rasterizer;
+  pipelineInfo.pMultisampleState = &multisampling;
+  pipelineInfo.pDepthStencilState = &depthStencil;
+  pipelineInfo.pColorBlendState = &colorBlending;
+  pipelineInfo.pDynamicState = &dynamicState;
+  pipelineInfo.layout = mLayout;
+  pipelineInfo.renderPass = mRenderPass;
+  pipelineInfo.subpass = 0;
+  VkResult result = vkCreateGraphicsPipelines(mDevice, cache, 1,
+                                              &pipelineInfo, nullptr,
+                                              &mPipeline);
+  vkDestroyShaderModule(mDevice, vertModule, nullptr);
+  VK_CHECK(result);
+}
+
+void ShadowMap::CreateTargets() {
+  uint32_t layers = std::max(mCascadeCount, 1u);
+
+  VkImageCreateInfo imageInfo = {};
+  imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  imageInfo.imageType = VK_IMAGE_TYPE_2D;
+  imageInfo.format = kShadowFormat;
+  imageInfo.extent = {mResolution, mResolution, 1};
+  imageInfo.mipLevels = 1;
+  imageInfo.arrayLayers = layers;
+  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+  imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                    VK_IMAGE_USAGE_SAMPLED_BIT;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  VmaAllocationCreateInfo allocInfo = {};
+  allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+  VK_CHECK(vmaCreateImage(mAllocator, &imageInfo, &allocInfo, &mImage,
+                          &mAllocation, nullptr));
+
+  VkImageViewCreateInfo viewInfo = {};
+  viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+  viewInfo.image = mImage;
+  viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+  viewInfo.format = kShadowFormat;
+  viewInfo.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, layers};
+  VK_CHECK(vkCreateImageView(mDevice, &viewInfo, nullptr, &mArrayView));
+
+  for (uint32_t i = 0; i < mCascadeCount; i++) {
+    VkImageView layerView;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, i, 1};
+    VK_CHECK(vkCreateImageView(mDevice, &viewInfo, nullptr, &layerView));
+    mLayerViews.push_back(layerView);
+
+    VkFramebufferCreateInfo fbInfo = {};
+    fbInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    fbInfo.renderPass = mRenderPass;
+    fbInfo.attachmentCount = 1;
+    fbInfo.pAttachments = &layerView;
+    fbInfo.width = mResolution;
+    fbInfo.height = mResolution;
+    fbInfo.layers = 1;
+    VkFramebuffer framebuffer;
+    VK_CHECK(vkCreateFramebuffer(mDevice, &fbInfo, nullptr, &framebuffer));
+    mFramebuffers.push_back(framebuffer);
+  }
+
+  // The image is bound for sampling even when no pass has written it (shadows
+  // off), so move every layer into the sampled layout once up front
+  VkCommandPoolCreateInfo poolInfo = {};
+  poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+  poolInfo.queueFamilyIndex = mQueueFamily;
+  VkCommandPool cmdPool;
+  VK_CHECK(vkCreateCommandPool(mDevice, &poolInfo, nullptr, &cmdPool));
+
+  VkCommandBufferAllocateInfo cmdInfo = {};
+  cmdInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  cmdInfo.commandPool = cmdPool;
+  cmdInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  cmdInfo.commandBufferCount = 1;
+  VkCommandBuffer cmd;
+  VK_CHECK(vkAllocateCommandBuffers(mDevice, &cmdInfo, &cmd));
+
+  VkCommandBufferBeginInfo beginInfo = {};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(cmd, &beginInfo);
+
+  VkImageMemoryBarrier barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  barrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = mImage;
+  barrier.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, layers};
+  barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr,
+                       0, nullptr, 1, &barrier);
+  vkEndCommandBuffer(cmd);
+
+  VkSubmitInfo submitInfo = {};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &cmd;
+  VK_CHECK(vkQueueSubmit(mQueue, 1, &submitInfo, VK_NULL_HANDLE));
+  VK_CHECK(vkQueueWaitIdle(mQueue));
+  vkDestroyCommandPool(mDevice, cmdPool, nullptr);
+
+  std::cout << "[ShadowMap] Quality " << GetShadowQualityName(mQuality)
+            << ": " << mCascadeCount << " cascades of " << mResolution
+            << " px" << std::endl;
+}
+
+void ShadowMap::DestroyTargets() {
+  for (VkFramebuffer framebuffer : mFramebuffers)
+    vkDestroyFramebuffer(mDevice, framebuffer, nullptr);
+  for (VkImageView view : mLayerViews)
+    vkDestroyImageView(mDevice, view, nullptr);
+  mFramebuffers.clear();
+  mLayerViews.clear();
+  if (mArrayView)
+    vkDestroyImageView(mDevice, mArrayView, nullptr);
+  if (mImage)
+    vmaDestroyImage(mAllocator, mImage, mAllocation);
+  mArrayView = VK_NULL_HANDLE;
+  mImage = VK_NULL_HANDLE;
+  mAllocation = VK_NULL_HANDLE;
+}
+
+void ShadowMap::FitCascades(const Camera &camera, float aspect,
+                            CameraData &data) {
+  data.lightDir = glm::vec4(kLightDir, 0.0f);
+  data.shadowParams = glm::vec4(static_cast<float>(mCascadeCount),
+                                static_cast<float>(mPcfRadius),
+                                1.0f / static_cast<float>(mResolution), 0.0f);
+  if (mCascadeCount == 0)
+    return;
+
+  float nearPlane = camera.GetNearPlane();
+  float farPlane = std::min(camera.GetFarPlane(), kShadowDistance);
+  glm::mat4 invView = glm::inverse(camera.GetViewMatrix());
+  float tanY = std::tan(glm::radians(camera.GetFov()) * 0.5f);
+  float tanX = tanY * aspect;
+  glm::vec3 up = std::abs(kLightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f)
+                                               : glm::vec3(0.0f, 1.0f, 0.0f);
+
+  float sliceNear = nearPlane;
+  for (uint32_t i = 0; i < mCascadeCount; i++) {
+    float p = static_cast<float>(i + 1) / static_cast<float>(mCascadeCount);
+    float logSplit = nearPlane * std::pow(farPlane / nearPlane, p);
+    float uniformSplit = nearPlane + (farPlane - nearPlane) * p;
+    float sliceFar =
+        kSplitLambda * logSplit + (1.0f - kSplitLambda) * uniformSplit;
+
+    // Bounding sphere of the slice: its size does not change as the camera
+    // turns, so the texel grid stays put
+    glm::vec3 corners[8];
+    glm::vec3 center(0.0f);
+    for (int c = 0; c < 8; c++) {
+      float d = (c & 4) ? sliceFar : sliceNear;
+      glm::vec4 viewPos((c & 1) ? d * tanX : -d * tanX,
+                        (c & 2) ? d * tanY : -d * tanY, -d, 1.0f);
+      corners[c] = glm::vec3(invView * viewPos);
+      center += corners[c] / 8.0f;
+    }
+    float radius = 0.0f;
+    for (const glm::vec3 &corner : corners)
+      radius = std::max(radius, glm::length(corner - center));
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+
+    glm::mat4 lightView = glm::lookAt(
+        center + kLightDir * (radius + kCasterPullback), center, up);
+    glm::mat4 lightProj = glm::ortho(-radius, radius, -radius, radius, 0.0f,
+                                     2.0f * radius + kCasterPullback);
+
+    // Snap the origin to a texel so static geometry does not shimmer
+    glm::vec4 origin = lightProj * lightView * glm::vec4(0, 0, 0, 1);
+    float halfRes = static_cast<float>(mResolution) * 0.5f;
+    glm::vec2 texel = glm::vec2(origin) * halfRes;
+    glm::vec2 offset = (glm::round(texel) - texel) / halfRes;
+    lightProj[3][0] += offset.x;
+    lightProj[3][1] += offset.y;
+
+    mLightViewProj[i] = lightProj * lightView;
+    data.lightViewProj[i] = mLightViewProj[i];
+    data.cascadeOffsets[i] = kNormalOffsetTexels * 2.0f * radius /
+                             static_cast<float>(mResolution);
+    sliceNear = sliceFar;
+  }
+}
+
+// Conservative: true if the AABB's light-space box touches the cascade
+static bool OverlapsCascade(const glm::mat4 &lightViewProj,
+                            const glm::vec3 &boundsMin,
+                            const glm::vec3 &boundsMax) {
+  glm::vec3 lo(FLT_MAX), hi(-FLT_MAX);
+  for (int c = 0; c < 8; c++) {
+    glm::vec3 p((c & 1) ? boundsMax.x : boundsMin.x,
+                (c & 2) ? boundsMax.y : boundsMin.y,
+                (c & 4) ? boundsMax.z : boundsMin.z);
+    glm::vec3 clip = glm::vec3(lightViewProj * glm::vec4(p, 1.0f));
+    lo = glm::min(lo, clip);
+    hi = glm::max(hi, clip);
+  }
+  return hi.x >= -1.0f && lo.x <= 1.0f && hi.y >= -1.0f && lo.y <= 1.0f &&
+         hi.z >= 0.0f && lo.z <= 1.0f;
+}
+
+void ShadowMap::Record(VkCommandBuffer cmd, SceneBuffers &scene,
+                       const std::vector<DrawItem> &items) {
+  mCasterDraws = 0;
+  if (mCascadeCount == 0)
+    return;
+
+  VkClearValue clear = {};
+  clear.depthStencil = {1.0f, 0};
+  VkViewport viewport = {0.0f, 0.0f, static_cast<float>(mResolution),
+                         static_cast<float>(mResolution), 0.0f, 1.0f};
+  VkRect2D scissor = {{0, 0}, {mResolution, mResolution}};
+
+  for (uint32_t i = 0; i < mCascadeCount; i++) {
+    VkRenderPassBeginInfo rpBegin = {};
+    rpBegin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    rpBegin.renderPass = mRenderPass;
+    rpBegin.framebuffer = mFramebuffers[i];
+    rpBegin.renderArea = scissor;
+    rpBegin.clearValueCount = 1;
+    rpBegin.pClearValues = &clear;
+    vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
+
+    if (i == 0) {
+      vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
+      vkCmdSetViewport(cmd, 0, 1, &viewport);
+      vkCmdSetScissor(cmd, 0, 1, &scissor);
+      scene.Bind(cmd, mLayout);
+    }
+    vkCmdPushConstants(cmd, mLayout, VK_SHADER_STAGE_VERTEX_BIT, 0,
+                       sizeof(uint32_t), &i);
+
+    for (const DrawItem &item : items) {
+      if (!OverlapsCascade(mLightViewProj[i], item.boundsMin, item.boundsMax))
+        continue;
+      DrawModel(cmd, *item.meshes, item.object);
+      mCasterDraws++;
+    }
+    vkCmdEndRenderPass(cmd);
+  }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "renderer/ModelLoader.h"
+#include "renderer/SceneBuffers.h"
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <vk_mem_alloc.h>
+
+class Camera;
+
+enum class ShadowQuality { eOFF, eLOW, eMEDIUM, eHIGH };
+
+bool ParseShadowQuality(const std::string &name, ShadowQuality &out);
+const char *GetShadowQualityName(ShadowQuality quality);
+
+// Cascaded shadow map for the directional field light. The camera frustum
+// up to a shadow distance is split into cascades (log/uniform blend); each
+// is bounded by a sphere so its light-space box does not swim as the camera
+// rotates, and snapped to whole texels. Every cascade is one layer of a
+// depth array image, rendered with a depth-only pipeline from only the
+// casters whose bounds overlap that cascade's box.
+//
+// The quality sets resolution, cascade count and PCF kernel size; eOFF
+// skips the pass (the image stays bound, at its smallest size).
+class ShadowMap {
+public:
+  void Create(VkDevice device, VmaAllocator allocator, VkQueue queue,
+              uint32_t queueFamily, VkPipelineCache cache,
+              const std::string &vertPath, ShadowQuality quality);
+  void Destroy();
+
+  // Recreates the image; call SceneBuffers::SetShadowMap afterwards
+  void SetQuality(ShadowQuality quality);
+  ShadowQuality GetQuality() const { return mQuality; }
+
+  // Fills the light and cascade fields of `data` for this frame's camera
+  void FitCascades(const Camera &camera, float aspect, CameraData &data);
+
+  // Records the shadow pass; `scene` must hold this frame's objects (its
+  // descriptor set is bound with the shadow pipeline layout). Call before
+  // the main render pass.
+  void Record(VkCommandBuffer cmd, SceneBuffers &scene,
+              const std::vector<DrawItem> &items);
+
+  VkImageView GetView() const { return mArrayView; }
+  VkSampler GetSampler() const { return mSampler; }
+  uint32_t GetCascadeCount() const { return mCascadeCount; }
+  uint32_t GetResolution() const { return mResolution; }
+  // Casters drawn into all cascades by the last Record
+  uint32_t GetCasterDraws() const { return mCasterDraws; }
+
+private:
+  void CreateRenderPass();
+  void CreatePipeline(VkPipelineCache cache, const std::string &vertPath);
+  void CreateTargets();
+  void DestroyTargets();
+
+  VkDevice mDevice = VK_NULL_HANDLE;
+  VmaAllocator mAllocator = VK_NULL_HANDLE;
+  VkQueue mQueue = VK_NULL_HANDLE;
+  uint32_t mQueueFamily = 0;
+
+  ShadowQuality mQuality = ShadowQuality::eMEDIUM;
+  uint32_t mResolution = 0;
+  uint32_t mCascadeCount = 0;
+  uint32_t mPcfRadius = 0;
+
+  VkRenderPass mRenderPass = VK_NULL_HANDLE;
+  VkDescriptorSetLayout mSetLayout = VK_NULL_HANDLE;
+  VkPipelineLayout mLayout = VK_NULL_HANDLE;
+  VkPipeline mPipeline = VK_NULL_HANDLE;
+  VkSampler mSampler = VK_NULL_HANDLE;
+
+  VkImage mImage = VK_NULL_HANDLE;
+  VmaAllocation mAllocation = VK_NULL_HANDLE;
+  VkImageView mArrayView = VK_NULL_HANDLE; // All layers, for sampling
+  std::vector<VkImageView> mLayerViews;    // One per cascade, for rendering
+  std::vector<VkFramebuffer> mFramebuffers;
+
+  glm::mat4 mLightViewProj[kMaxShadowCascades];
+  uint32_t mCasterDraws = 0;
+};
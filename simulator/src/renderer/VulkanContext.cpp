@@ -1,6 +1,9 @@
 #include "renderer/VulkanContext.h"
+#include "renderer/FrameRecorder.h"
 #include <VkBootstrap.h>
+#include <algorithm>
 #include <array>
+#include <chrono>
 
 #define VMA_IMPLEMENTATION
 #include <vk_mem_alloc.h>
@@ -86,12 +89,17 @@ void VulkanContext::Initialize(GLFWwindow *window, const std::string &appName) {
   VK_CHECK(vmaCreateAllocator(&allocInfo, &mAllocator));
   std::cout << "[VulkanContext] VMA created." << std::endl;
 
-  // --- 6. Swapchain + resources ---
+  // --- 6. Pipeline cache (working directory, like shaders/) ---
+  mPipelineCache.Create(mDevice, mPhysicalDevice, "pipeline_cache.bin");
+
+  // --- 7. Swapchain + resources ---
   int w, h;
   glfwGetFramebufferSize(window, &w, &h);
-  CreateSwapchain(w, h);
-  CreateDepthBuffer();
+  CreateSwapchain(w, h, VK_NULL_HANDLE);
+  ClampRenderSettings();
+  CreateRenderTargets();
   CreateRenderPass();
+  CreateOverlayRenderPass();
   CreateFramebuffers();
   CreateSyncResources();
 
@@ -111,6 +119,11 @@ void VulkanContext::Cleanup() {
     vkDestroyRenderPass(mDevice, mRenderPass, nullptr);
     mRenderPass = VK_NULL_HANDLE;
   }
+  if (mOverlayRenderPass) {
+    vkDestroyRenderPass(mDevice, mOverlayRenderPass, nullptr);
+    mOverlayRenderPass = VK_NULL_HANDLE;
+  }
+  mPipelineCache.Destroy();
   if (mAllocator) {
     vmaDestroyAllocator(mAllocator);
     mAllocator = VK_NULL_HANDLE;
@@ -137,7 +150,10 @@ void VulkanContext::Cleanup() {
 }
 
 // --- Swapchain ---
-void VulkanContext::CreateSwapchain(int width, int height) {
+// `oldSwapchain` (may be null) is handed to the driver so presentation can
+// continue from it; the caller destroys it afterwards.
+void VulkanContext::CreateSwapchain(int width, int height,
+                                    VkSwapchainKHR oldSwapchain) {
   vkb::SwapchainBuilder swapchainBuilder{mPhysicalDevice, mDevice, mSurface};
 
   auto swap_ret = swapchainBuilder
@@ -146,6 +162,11 @@ void VulkanContext::CreateSwapchain(int width, int height) {
                       .set_desired_present_mode(VK_PRESENT_MODE_MAILBOX_KHR)
                       .add_fallback_present_mode(VK_PRESENT_MODE_FIFO_KHR)
                       .set_desired_extent(width, height)
+                      // Destination of the render-scale upscale and source
+                      // of FrameRecorder readbacks
+                      .add_image_usage_flags(VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                             VK_IMAGE_USAGE_TRANSFER_SRC_BIT)
+                      .set_old_swapchain(oldSwapchain)
                       .build();
 
   if (!swap_ret)
@@ -159,6 +180,14 @@ void VulkanContext::CreateSwapchain(int width, int height) {
   mSwapchainImages = vkbSwapchain.get_images().value();
   mSwapchainImageViews = vkbSwapchain.get_image_views().value();
 
+  VkFormatProperties formatProps;
+  vkGetPhysicalDeviceFormatProperties(mPhysicalDevice, mSwapchainImageFormat,
+                                      &formatProps);
+  mUpscaleFilter = (formatProps.optimalTilingFeatures &
+                    VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+                       ? VK_FILTER_LINEAR
+                       : VK_FILTER_NEAREST;
+
   const char *modeStr = "UNKNOWN";
   switch (vkbSwapchain.present_mode) {
   case VK_PRESENT_MODE_MAILBOX_KHR:
@@ -179,59 +208,154 @@ void VulkanContext::CreateSwapchain(int width, int height) {
             << ", " << modeStr << std::endl;
 }
 
-// --- Depth Buffer ---
-void VulkanContext::CreateDepthBuffer() {
+// --- Render settings ---
+void VulkanContext::SetRenderSettings(VkSampleCountFlagBits samples,
+                                      float renderScale) {
+  mSamples = samples;
+  mRenderScale = renderScale;
+  if (mDevice == VK_NULL_HANDLE)
+    return;
+
+  vkDeviceWaitIdle(mDevice);
+  if (mRenderPassReplaceCallback)
+    mRenderPassReplaceCallback();
+  ClampRenderSettings();
+  DestroyFramebuffers();
+  DestroyRenderTargets();
+  vkDestroyRenderPass(mDevice, mRenderPass, nullptr);
+  CreateRenderTargets();
+  CreateRenderPass();
+  CreateFramebuffers();
+  mRenderPassGeneration++;
+}
+
+void VulkanContext::ClampRenderSettings() {
+  VkPhysicalDeviceProperties props;
+  vkGetPhysicalDeviceProperties(mPhysicalDevice, &props);
+  VkSampleCountFlags supported = props.limits.framebufferColorSampleCounts &
+                                 props.limits.framebufferDepthSampleCounts;
+  VkSampleCountFlagBits requested = mSamples;
+  while (mSamples > VK_SAMPLE_COUNT_1_BIT && !(supported & mSamples))
+    mSamples = static_cast<VkSampleCountFlagBits>(mSamples >> 1);
+  if (mSamples != requested) {
+    std::cout << "[VulkanContext] " << requested << "x MSAA unsupported, using "
+              << mSamples << "x" << std::endl;
+  }
+  mRenderScale = std::clamp(mRenderScale, 0.25f, 1.0f);
+}
+
+// --- Render targets ---
+VulkanContext::RenderTarget VulkanContext::CreateRenderTarget(
+    VkFormat format, VkSampleCountFlagBits samples, VkImageUsageFlags usage,
+    VkImageAspectFlags aspect) {
   VkImageCreateInfo imageInfo = {};
   imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
   imageInfo.imageType = VK_IMAGE_TYPE_2D;
-  imageInfo.format = mDepthFormat;
-  imageInfo.extent = {mSwapchainExtent.width, mSwapchainExtent.height, 1};
+  imageInfo.format = format;
+  imageInfo.extent = {mRenderExtent.width, mRenderExtent.height, 1};
   imageInfo.mipLevels = 1;
   imageInfo.arrayLayers = 1;
-  imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.samples = samples;
   imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-  imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+  imageInfo.usage = usage;
   imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
   VmaAllocationCreateInfo vmaAllocInfo = {};
   vmaAllocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
   vmaAllocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 
-  VK_CHECK(vmaCreateImage(mAllocator, &imageInfo, &vmaAllocInfo, &mDepthImage,
-                          &mDepthAllocation, nullptr));
+  RenderTarget target;
+  VK_CHECK(vmaCreateImage(mAllocator, &imageInfo, &vmaAllocInfo,
+                          &target.image, &target.allocation, nullptr));
 
   VkImageViewCreateInfo viewInfo = {};
   viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-  viewInfo.image = mDepthImage;
+  viewInfo.image = target.image;
   viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-  viewInfo.format = mDepthFormat;
-  viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+  viewInfo.format = format;
+  viewInfo.subresourceRange.aspectMask = aspect;
   viewInfo.subresourceRange.baseMipLevel = 0;
   viewInfo.subresourceRange.levelCount = 1;
   viewInfo.subresourceRange.baseArrayLayer = 0;
   viewInfo.subresourceRange.layerCount = 1;
 
-  VK_CHECK(vkCreateImageView(mDevice, &viewInfo, nullptr, &mDepthImageView));
-  std::cout << "[VulkanContext] Depth buffer created." << std::endl;
+  VK_CHECK(vkCreateImageView(mDevice, &viewInfo, nullptr, &target.view));
+  return target;
 }
 
-// --- Render Pass ---
+void VulkanContext::DestroyRenderTarget(RenderTarget &target) {
+  if (target.view)
+    vkDestroyImageView(mDevice, target.view, nullptr);
+  if (target.image)
+    vmaDestroyImage(mAllocator, target.image, target.allocation);
+  target = RenderTarget();
+}
+
+void VulkanContext::CreateRenderTargets() {
+  mRenderExtent.width = std::max(
+      1u, static_cast<uint32_t>(mSwapchainExtent.width * mRenderScale));
+  mRenderExtent.height = std::max(
+      1u, static_cast<uint32_t>(mSwapchainExtent.height * mRenderScale));
+
+  mDepth = CreateRenderTarget(mDepthFormat, mSamples,
+                              VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                              VK_IMAGE_ASPECT_DEPTH_BIT);
+
+  bool msaa = mSamples != VK_SAMPLE_COUNT_1_BIT;
+  if (msaa) {
+    // Only ever resolved, never stored
+    mColor = CreateRenderTarget(mSwapchainImageFormat, mSamples,
+                                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                    VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+                                VK_IMAGE_ASPECT_COLOR_BIT);
+  }
+  if (IsScaled()) {
+    RenderTarget &blitSource = msaa ? mResolve : mColor;
+    blitSource = CreateRenderTarget(mSwapchainImageFormat,
+                                    VK_SAMPLE_COUNT_1_BIT,
+                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                        VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                    VK_IMAGE_ASPECT_COLOR_BIT);
+  }
+
+  std::cout << "[VulkanContext] Scene targets: " << mRenderExtent.width << "x"
+            << mRenderExtent.height << ", " << mSamples << "x MSAA"
+            << std::endl;
+}
+
+void VulkanContext::DestroyRenderTargets() {
+  DestroyRenderTarget(mDepth);
+  DestroyRenderTarget(mColor);
+  DestroyRenderTarget(mResolve);
+}
+
+// --- Render Passes ---
+// Scene pass: color + depth at the render extent, plus a resolve attachment
+// with MSAA. Its output is left for the overlay pass (unscaled) or for the
+// upscaling blit.
 void VulkanContext::CreateRenderPass() {
+  bool msaa = mSamples != VK_SAMPLE_COUNT_1_BIT;
+  VkImageLayout outputLayout = IsScaled()
+                                   ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+                                   : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
   // Color attachment
   VkAttachmentDescription colorAttachment = {};
   colorAttachment.format = mSwapchainImageFormat;
-  colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+  colorAttachment.samples = mSamples;
   colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-  colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  colorAttachment.storeOp =
+      msaa ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
   colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
   colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
   colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  colorAttachment.finalLayout =
+      msaa ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : outputLayout;
 
   // Depth attachment
   VkAttachmentDescription depthAttachment = {};
   depthAttachment.format = mDepthFormat;
-  depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+  depthAttachment.samples = mSamples;
   depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
   depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
   depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
@@ -240,6 +364,13 @@ void VulkanContext::CreateRenderPass() {
   depthAttachment.finalLayout =
       VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
+  // Resolve attachment (MSAA only)
+  VkAttachmentDescription resolveAttachment = colorAttachment;
+  resolveAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+  resolveAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  resolveAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  resolveAttachment.finalLayout = outputLayout;
+
   VkAttachmentReference colorRef = {};
   colorRef.attachment = 0;
   colorRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
@@ -248,58 +379,158 @@ void VulkanContext::CreateRenderPass() {
   depthRef.attachment = 1;
   depthRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
+  VkAttachmentReference resolveRef = {};
+  resolveRef.attachment = 2;
+  resolveRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
   VkSubpassDescription subpass = {};
   subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
   subpass.colorAttachmentCount = 1;
   subpass.pColorAttachments = &colorRef;
+  subpass.pResolveAttachments = msaa ? &resolveRef : nullptr;
   subpass.pDepthStencilAttachment = &depthRef;
 
-  // Dependencies for both color and depth
-  VkSubpassDependency dependency = {};
-  dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-  dependency.dstSubpass = 0;
-  dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
-                            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-  dependency.srcAccessMask = 0;
-  dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
-                            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-  dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
-                             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-
-  std::array<VkAttachmentDescription, 2> attachments = {colorAttachment,
-                                                        depthAttachment};
+  // The render targets are shared by every frame in flight: wait for the
+  // previous frame's writes and its upscaling blit before writing again
+  std::array<VkSubpassDependency, 2> dependencies = {};
+  dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+  dependencies[0].dstSubpass = 0;
+  dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                 VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                 VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT;
+  dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                  VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                 VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                 VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+  dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                  VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+  dependencies[1].srcSubpass = 0;
+  dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+  dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT;
+  dependencies[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                                  VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                  VK_ACCESS_TRANSFER_READ_BIT;
+
+  std::array<VkAttachmentDescription, 3> attachments = {
+      colorAttachment, depthAttachment, resolveAttachment};
 
   VkRenderPassCreateInfo renderPassInfo = {};
   renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-  renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+  renderPassInfo.attachmentCount = msaa ? 3 : 2;
   renderPassInfo.pAttachments = attachments.data();
   renderPassInfo.subpassCount = 1;
   renderPassInfo.pSubpasses = &subpass;
-  renderPassInfo.dependencyCount = 1;
-  renderPassInfo.pDependencies = &dependency;
+  renderPassInfo.dependencyCount =
+      static_cast<uint32_t>(dependencies.size());
+  renderPassInfo.pDependencies = dependencies.data();
 
   VK_CHECK(vkCreateRenderPass(mDevice, &renderPassInfo, nullptr, &mRenderPass));
 }
 
+// Overlay pass: draws on top of the finished scene at window resolution
+void VulkanContext::CreateOverlayRenderPass() {
+  VkAttachmentDescription colorAttachment = {};
+  colorAttachment.format = mSwapchainImageFormat;
+  colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+  colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+  colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+  colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+  VkAttachmentReference colorRef = {};
+  colorRef.attachment = 0;
+  colorRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+  VkSubpassDescription subpass = {};
+  subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  subpass.colorAttachmentCount = 1;
+  subpass.pColorAttachments = &colorRef;
+
+  std::array<VkSubpassDependency, 2> dependencies = {};
+  dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+  dependencies[0].dstSubpass = 0;
+  dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT;
+  dependencies[0].srcAccessMask =
+      VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                                  VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+  // FrameRecorder copies the finished image out after the pass
+  dependencies[1].srcSubpass = 0;
+  dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+  dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+  dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+  VkRenderPassCreateInfo renderPassInfo = {};
+  renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+  renderPassInfo.attachmentCount = 1;
+  renderPassInfo.pAttachments = &colorAttachment;
+  renderPassInfo.subpassCount = 1;
+  renderPassInfo.pSubpasses = &subpass;
+  renderPassInfo.dependencyCount =
+      static_cast<uint32_t>(dependencies.size());
+  renderPassInfo.pDependencies = dependencies.data();
+
+  VK_CHECK(vkCreateRenderPass(mDevice, &renderPassInfo, nullptr,
+                              &mOverlayRenderPass));
+}
+
 // --- Framebuffers ---
 void VulkanContext::CreateFramebuffers() {
+  bool msaa = mSamples != VK_SAMPLE_COUNT_1_BIT;
   mFramebuffers.resize(mSwapchainImageViews.size());
+  mOverlayFramebuffers.resize(mSwapchainImageViews.size());
   for (size_t i = 0; i < mSwapchainImageViews.size(); i++) {
-    std::array<VkImageView, 2> attachments = {mSwapchainImageViews[i],
-                                              mDepthImageView};
+    // Where the scene ends up: the swapchain image unless scaled
+    VkImageView output = IsScaled() ? (msaa ? mResolve.view : mColor.view)
+                                    : mSwapchainImageViews[i];
+    std::array<VkImageView, 3> attachments = {
+        msaa ? mColor.view : output, mDepth.view, output};
 
     VkFramebufferCreateInfo fbInfo = {};
     fbInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
     fbInfo.renderPass = mRenderPass;
-    fbInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    fbInfo.attachmentCount = msaa ? 3 : 2;
     fbInfo.pAttachments = attachments.data();
-    fbInfo.width = mSwapchainExtent.width;
-    fbInfo.height = mSwapchainExtent.height;
+    fbInfo.width = mRenderExtent.width;
+    fbInfo.height = mRenderExtent.height;
     fbInfo.layers = 1;
     VK_CHECK(vkCreateFramebuffer(mDevice, &fbInfo, nullptr, &mFramebuffers[i]));
+
+    fbInfo.renderPass = mOverlayRenderPass;
+    fbInfo.attachmentCount = 1;
+    fbInfo.pAttachments = &mSwapchainImageViews[i];
+    fbInfo.width = mSwapchainExtent.width;
+    fbInfo.height = mSwapchainExtent.height;
+    VK_CHECK(vkCreateFramebuffer(mDevice, &fbInfo, nullptr,
+                                 &mOverlayFramebuffers[i]));
   }
 }
 
+void VulkanContext::DestroyFramebuffers() {
+  for (auto fb : mFramebuffers) {
+    if (fb)
+      vkDestroyFramebuffer(mDevice, fb, nullptr);
+  }
+  mFramebuffers.clear();
+  for (auto fb : mOverlayFramebuffers) {
+    if (fb)
+      vkDestroyFramebuffer(mDevice, fb, nullptr);
+  }
+  mOverlayFramebuffers.clear();
+}
+
 // --- Sync resources ---
 void VulkanContext::CreateSyncResources() {
   uint32_t imageCount = static_cast<uint32_t>(mSwapchainImages.size());
@@ -395,6 +626,13 @@ bool VulkanContext::BeginFrame(VkCommandBuffer &outCmd) {
   beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
   VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
 
+  outCmd = cmd;
+  return true;
+}
+
+void VulkanContext::BeginMainPass() {
+  VkCommandBuffer cmd = mImageData[mCurrentImageIndex].commandBuffer;
+
   // Clear both color and depth
   std::array<VkClearValue, 2> clearValues = {};
   clearValues[0].color = {{0.1f, 0.1f, 0.12f, 1.0f}}; // Dark grey background
@@ -405,11 +643,80 @@ bool VulkanContext::BeginFrame(VkCommandBuffer &outCmd) {
   rpBegin.renderPass = mRenderPass;
   rpBegin.framebuffer = mFramebuffers[mCurrentImageIndex];
   rpBegin.renderArea.offset = {0, 0};
-  rpBegin.renderArea.extent = mSwapchainExtent;
+  rpBegin.renderArea.extent = mRenderExtent;
   rpBegin.clearValueCount = static_cast<uint32_t>(clearValues.size());
   rpBegin.pClearValues = clearValues.data();
 
   vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
+  mInOverlayPass = false;
+
+  VkViewport viewport = {};
+  viewport.width = static_cast<float>(mRenderExtent.width);
+  viewport.height = static_cast<float>(mRenderExtent.height);
+  viewport.minDepth = 0.0f;
+  viewport.maxDepth = 1.0f;
+  vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+  VkRect2D scissor = {};
+  scissor.extent = mRenderExtent;
+  vkCmdSetScissor(cmd, 0, 1, &scissor);
+}
+
+void VulkanContext::BeginOverlayPass() {
+  if (mInOverlayPass)
+    return;
+  VkCommandBuffer cmd = mImageData[mCurrentImageIndex].commandBuffer;
+  vkCmdEndRenderPass(cmd);
+
+  if (IsScaled()) {
+    VkImage swapImage = mSwapchainImages[mCurrentImageIndex];
+    VkImage source = mSamples != VK_SAMPLE_COUNT_1_BIT ? mResolve.image
+                                                        : mColor.image;
+
+    // The acquire semaphore is waited on at the transfer stage too
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = swapImage;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 1, &barrier);
+
+    VkImageBlit blit = {};
+    blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.srcOffsets[1] = {static_cast<int32_t>(mRenderExtent.width),
+                          static_cast<int32_t>(mRenderExtent.height), 1};
+    blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.dstOffsets[1] = {static_cast<int32_t>(mSwapchainExtent.width),
+                          static_cast<int32_t>(mSwapchainExtent.height), 1};
+    vkCmdBlitImage(cmd, source, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   swapImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit,
+                   mUpscaleFilter);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+  }
+
+  VkRenderPassBeginInfo rpBegin = {};
+  rpBegin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+  rpBegin.renderPass = mOverlayRenderPass;
+  rpBegin.framebuffer = mOverlayFramebuffers[mCurrentImageIndex];
+  rpBegin.renderArea.offset = {0, 0};
+  rpBegin.renderArea.extent = mSwapchainExtent;
+  vkCmdBeginRenderPass(cmd, &rpBegin, VK_SUBPASS_CONTENTS_INLINE);
+  mInOverlayPass = true;
 
   VkViewport viewport = {};
   viewport.width = static_cast<float>(mSwapchainExtent.width);
@@ -421,16 +728,18 @@ bool VulkanContext::BeginFrame(VkCommandBuffer &outCmd) {
   VkRect2D scissor = {};
   scissor.extent = mSwapchainExtent;
   vkCmdSetScissor(cmd, 0, 1, &scissor);
-
-  outCmd = cmd;
-  return true;
 }
 
-void VulkanContext::EndFrame() {
+void VulkanContext::EndFrame(FrameRecorder *recorder) {
   ImageData &img = mImageData[mCurrentImageIndex];
   VkCommandBuffer cmd = img.commandBuffer;
 
+  BeginOverlayPass();
   vkCmdEndRenderPass(cmd);
+  if (recorder) {
+    recorder->Capture(cmd, mCurrentImageIndex,
+                      mSwapchainImages[mCurrentImageIndex], mSwapchainExtent);
+  }
   VK_CHECK(vkEndCommandBuffer(cmd));
 
   uint32_t usedAcquireIdx =
@@ -439,8 +748,10 @@ void VulkanContext::EndFrame() {
       static_cast<uint32_t>(mAcquireSemaphores.size());
   VkSemaphore acquireSem = mAcquireSemaphores[usedAcquireIdx];
 
+  // Transfer too: a scaled scene is blitted into the swapchain image
   VkPipelineStageFlags waitStage =
-      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+      VK_PIPELINE_STAGE_TRANSFER_BIT;
 
   VkSubmitInfo submitInfo = {};
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -472,51 +783,61 @@ void VulkanContext::EndFrame() {
 
 // --- Swapchain recreation ---
 void VulkanContext::CleanupSwapchain() {
-  // Depth buffer
-  if (mDepthImageView) {
-    vkDestroyImageView(mDevice, mDepthImageView, nullptr);
-    mDepthImageView = VK_NULL_HANDLE;
-  }
-  if (mDepthImage) {
-    vmaDestroyImage(mAllocator, mDepthImage, mDepthAllocation);
-    mDepthImage = VK_NULL_HANDLE;
-    mDepthAllocation = VK_NULL_HANDLE;
+  CleanupSwapchainViews();
+  if (mSwapchain) {
+    vkDestroySwapchainKHR(mDevice, mSwapchain, nullptr);
+    mSwapchain = VK_NULL_HANDLE;
   }
+}
 
-  for (auto fb : mFramebuffers) {
-    if (fb)
-      vkDestroyFramebuffer(mDevice, fb, nullptr);
-  }
-  mFramebuffers.clear();
+// Everything sized or indexed by the swapchain images, but not the
+// swapchain itself
+void VulkanContext::CleanupSwapchainViews() {
+  DestroyFramebuffers();
+  DestroyRenderTargets();
 
   for (auto iv : mSwapchainImageViews) {
     if (iv)
       vkDestroyImageView(mDevice, iv, nullptr);
   }
   mSwapchainImageViews.clear();
-
-  if (mSwapchain) {
-    vkDestroySwapchainKHR(mDevice, mSwapchain, nullptr);
-    mSwapchain = VK_NULL_HANDLE;
-  }
 }
 
+// Only swapchain-sized resources are rebuilt. The render pass (and so every
+// pipeline built against it) survives unless the surface format changed,
+// which GetRenderPassGeneration() reports.
 void VulkanContext::RecreateSwapchain(int width, int height) {
+  auto start = std::chrono::steady_clock::now();
   vkDeviceWaitIdle(mDevice);
 
-  // Destroy render pass (it references depth format, needs recreating)
-  if (mRenderPass) {
+  VkFormat oldFormat = mSwapchainImageFormat;
+  size_t oldImageCount = mSwapchainImages.size();
+  VkSwapchainKHR oldSwapchain = mSwapchain;
+
+  CleanupSwapchainViews();
+  CreateSwapchain(width, height, oldSwapchain);
+  vkDestroySwapchainKHR(mDevice, oldSwapchain, nullptr);
+
+  if (mSwapchainImageFormat != oldFormat) {
+    if (mRenderPassReplaceCallback)
+      mRenderPassReplaceCallback();
     vkDestroyRenderPass(mDevice, mRenderPass, nullptr);
-    mRenderPass = VK_NULL_HANDLE;
+    vkDestroyRenderPass(mDevice, mOverlayRenderPass, nullptr);
+    CreateRenderPass();
+    CreateOverlayRenderPass();
+    mRenderPassGeneration++;
+    mOverlayGeneration++;
   }
-
-  CleanupSyncResources();
-  CleanupSwapchain();
-  CreateSwapchain(width, height);
-  CreateDepthBuffer();
-  CreateRenderPass();
+  CreateRenderTargets();
   CreateFramebuffers();
-  CreateSyncResources();
+  if (mSwapchainImages.size() != oldImageCount) {
+    CleanupSyncResources();
+    CreateSyncResources();
+  }
+
+  mLastRecreateMs = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
   std::cout << "[VulkanContext] Swapchain recreated: " << width << "x" << height
-            << std::endl;
+            << " in " << mLastRecreateMs << " ms" << std::endl;
 }
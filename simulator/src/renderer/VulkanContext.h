@@ -1,6 +1,7 @@
 #pragma once
 
 #define GLFW_INCLUDE_VULKAN
+#include "renderer/PipelineCache.h"
 #include <GLFW/glfw3.h>
 #include <functional>
 #include <iostream>
@@ -9,6 +10,8 @@
 #include <vector>
 #include <vk_mem_alloc.h>
 
+class FrameRecorder;
+
 class VulkanContext {
 public:
   VulkanContext();
@@ -18,10 +21,39 @@ public:
                   const std::string &appName = "VEX V5 Simulator");
   void Cleanup();
 
+  // Acquires an image and starts its command buffer. Offscreen passes
+  // (shadows) go here, before BeginMainPass starts the scene pass.
   bool BeginFrame(VkCommandBuffer &outCmd);
-  void EndFrame();
+  // Scene pass: GetRenderPass(), at GetRenderExtent() and GetSampleCount()
+  void BeginMainPass();
+  // Ends the scene pass, upscales it into the swapchain image if needed and
+  // starts the overlay pass (GetOverlayRenderPass(), window resolution,
+  // single-sampled) for UI. EndFrame starts it if the caller did not.
+  void BeginOverlayPass();
+  // Submits and presents; `recorder` (if recording) copies the final image
+  void EndFrame(FrameRecorder *recorder = nullptr);
+
+  // MSAA sample count and render scale (fraction of the window size the
+  // scene is rendered at, then upscaled). Unsupported sample counts are
+  // lowered; the scale is clamped to [0.25, 1]. Callable before Initialize.
+  // Bumps GetRenderPassGeneration() once initialized.
+  void SetRenderSettings(VkSampleCountFlagBits samples, float renderScale);
+  VkSampleCountFlagBits GetSampleCount() const { return mSamples; }
+  float GetRenderScale() const { return mRenderScale; }
 
   void RecreateSwapchain(int width, int height);
+  // Bumped when RecreateSwapchain had to replace the render pass; pipelines
+  // built against an older generation must be recreated
+  uint32_t GetRenderPassGeneration() const { return mRenderPassGeneration; }
+  // Bumped when the overlay pass is replaced (surface format change only);
+  // UI pipelines built against it must be recreated
+  uint32_t GetOverlayGeneration() const { return mOverlayGeneration; }
+  // Called (device idle) just before the render pass is destroyed, so
+  // threads still building pipelines against it can be waited for
+  void SetRenderPassReplaceCallback(std::function<void()> callback) {
+    mRenderPassReplaceCallback = std::move(callback);
+  }
+  double GetLastRecreateMs() const { return mLastRecreateMs; }
 
   // Accessors
   VkDevice GetDevice() const { return mDevice; }
@@ -29,11 +61,20 @@ public:
   VkInstance GetInstance() const { return mInstance; }
   VmaAllocator GetAllocator() const { return mAllocator; }
   VkRenderPass GetRenderPass() const { return mRenderPass; }
+  VkRenderPass GetOverlayRenderPass() const { return mOverlayRenderPass; }
   VkExtent2D GetSwapchainExtent() const { return mSwapchainExtent; }
+  VkExtent2D GetRenderExtent() const { return mRenderExtent; }
   VkFormat GetSwapchainFormat() const { return mSwapchainImageFormat; }
   VkFormat GetDepthFormat() const { return mDepthFormat; }
   VkQueue GetGraphicsQueue() const { return mGraphicsQueue; }
   uint32_t GetGraphicsQueueFamily() const { return mGraphicsQueueFamily; }
+  VkPipelineCache GetPipelineCache() const { return mPipelineCache.Get(); }
+  // Upper bound on frames the GPU may still be working on
+  uint32_t GetImageCount() const {
+    return static_cast<uint32_t>(mSwapchainImages.size());
+  }
+  // Swapchain image being recorded; its previous use has finished on the GPU
+  uint32_t GetCurrentImageIndex() const { return mCurrentImageIndex; }
 
 private:
   // Core Vulkan
@@ -48,6 +89,7 @@ private:
   VkQueue mPresentQueue = VK_NULL_HANDLE;
 
   VmaAllocator mAllocator = VK_NULL_HANDLE;
+  PipelineCache mPipelineCache; // Shared by all pipelines, kept on disk
 
   // Swapchain
   VkSwapchainKHR mSwapchain = VK_NULL_HANDLE;
@@ -55,15 +97,35 @@ private:
   VkExtent2D mSwapchainExtent;
   std::vector<VkImage> mSwapchainImages;
   std::vector<VkImageView> mSwapchainImageViews;
-  std::vector<VkFramebuffer> mFramebuffers;
+  std::vector<VkFramebuffer> mFramebuffers;        // Scene pass
+  std::vector<VkFramebuffer> mOverlayFramebuffers; // Swapchain image only
 
   VkRenderPass mRenderPass = VK_NULL_HANDLE;
-
-  // Depth buffer
+  VkRenderPass mOverlayRenderPass = VK_NULL_HANDLE;
+  uint32_t mRenderPassGeneration = 0;
+  uint32_t mOverlayGeneration = 0;
+  std::function<void()> mRenderPassReplaceCallback;
+  double mLastRecreateMs = 0.0;
+
+  // Scene render targets, at mRenderExtent. The scene renders straight
+  // into the swapchain image when neither MSAA nor scaling is on; with MSAA
+  // alone it resolves into it; when scaled it ends in mColor (1x) or
+  // mResolve (MSAA) and is blitted up in BeginOverlayPass.
+  VkSampleCountFlagBits mSamples = VK_SAMPLE_COUNT_1_BIT;
+  float mRenderScale = 1.0f;
+  VkExtent2D mRenderExtent = {0, 0};
+  VkFilter mUpscaleFilter = VK_FILTER_LINEAR;
+  bool mInOverlayPass = false;
+
+  struct RenderTarget {
+    VkImage image = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+  };
   VkFormat mDepthFormat = VK_FORMAT_D32_SFLOAT;
-  VkImage mDepthImage = VK_NULL_HANDLE;
-  VmaAllocation mDepthAllocation = VK_NULL_HANDLE;
-  VkImageView mDepthImageView = VK_NULL_HANDLE;
+  RenderTarget mDepth;
+  RenderTarget mColor;   // Multisampled, or the scaled 1x target
+  RenderTarget mResolve; // Scaled and multisampled only
 
   // Per-swapchain-image resources
   struct ImageData {
@@ -82,11 +144,22 @@ private:
 
   GLFWwindow *mWindow = nullptr;
 
-  void CreateSwapchain(int width, int height);
-  void CreateDepthBuffer();
+  void CreateSwapchain(int width, int height, VkSwapchainKHR oldSwapchain);
+  bool IsScaled() const { return mRenderScale < 1.0f; }
+  void ClampRenderSettings();
+  RenderTarget CreateRenderTarget(VkFormat format,
+                                  VkSampleCountFlagBits samples,
+                                  VkImageUsageFlags usage,
+                                  VkImageAspectFlags aspect);
+  void DestroyRenderTarget(RenderTarget &target);
+  void CreateRenderTargets();
+  void DestroyRenderTargets();
   void CreateRenderPass();
+  void CreateOverlayRenderPass();
   void CreateFramebuffers();
+  void DestroyFramebuffers();
   void CreateSyncResources();
   void CleanupSyncResources();
   void CleanupSwapchain();
+  void CleanupSwapchainViews();
 };
@@ -2,18 +2,72 @@
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec3 fragNormal;
+layout(location = 2) in vec3 fragWorldPos;
 
 layout(location = 0) out vec4 outColor;
 
+// Must match CameraData in SceneBuffers.h
+layout(set = 0, binding = 0) uniform Camera {
+    mat4 viewProj;
+    mat4 view;
+    mat4 lightViewProj[4];
+    vec4 cascadeOffsets;
+    vec4 lightDir;
+    vec4 shadowParams; // x: cascades, y: PCF radius, z: texel size
+} camera;
+
+layout(set = 0, binding = 2) uniform sampler2DArrayShadow shadowMap;
+
+// 1 = lit, 0 = fully shadowed
+float ShadowFactor(vec3 normal) {
+    int cascadeCount = int(camera.shadowParams.x);
+    int radius = int(camera.shadowParams.y);
+    float texel = camera.shadowParams.z;
+
+    // The finest cascade whose box holds the point, with room for the PCF
+    // kernel. Selecting by position rather than view depth lets every view
+    // share the cascades fitted to the main camera.
+    int cascade = 0;
+    vec4 lightPos;
+    vec2 uv;
+    float margin = float(radius + 1) * texel;
+    for (; cascade < cascadeCount; cascade++) {
+        // Offset along the normal by about a texel to avoid self-shadowing
+        vec3 pos = fragWorldPos + normal * camera.cascadeOffsets[cascade];
+        lightPos = camera.lightViewProj[cascade] * vec4(pos, 1.0);
+        uv = lightPos.xy * 0.5 + 0.5;
+        if (all(greaterThanEqual(uv, vec2(margin))) &&
+            all(lessThanEqual(uv, vec2(1.0 - margin))) && lightPos.z <= 1.0)
+            break;
+    }
+    if (cascade >= cascadeCount)
+        return 1.0; // Shadows off, or outside the shadowed region
+
+    float lit = 0.0;
+    for (int y = -radius; y <= radius; y++) {
+        for (int x = -radius; x <= radius; x++) {
+            vec2 offset = vec2(x, y) * texel;
+            lit += texture(shadowMap,
+                           vec4(uv + offset, float(cascade), lightPos.z));
+        }
+    }
+    float taps = float((2 * radius + 1) * (2 * radius + 1));
+    return lit / taps;
+}
+
 void main() {
-    // Directional light from upper-right-front
-    vec3 lightDir = normalize(vec3(0.5, 1.0, 0.3));
+    vec3 normal = normalize(fragNormal);
+    vec3 lightDir = camera.lightDir.xyz;
     float ambient = 0.25;
 
     // Diffuse (half-Lambert for softer shading)
-    float NdotL = dot(normalize(fragNormal), lightDir);
+    float NdotL = dot(normal, lightDir);
     float diffuse = NdotL * 0.5 + 0.5; // half-Lambert: [0,1] range
 
+    // Shadowed surfaces keep part of their diffuse term so the half-Lambert
+    // falloff still reads
+    diffuse *= mix(0.35, 1.0, ShadowFactor(normal));
+
     float lighting = ambient + (1.0 - ambient) * diffuse;
 
     outColor = vec4(fragColor * lighting, 1.0);
@@ -6,16 +6,30 @@ layout(location = 2) in vec3 inColor;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec3 fragWorldPos;
 
-layout(push_constant) uniform PushConstants {
-    mat4 mvp;
-    mat4 model;
-} pc;
+// Must match CameraData in SceneBuffers.h
+layout(set = 0, binding = 0) uniform Camera {
+    mat4 viewProj;
+    mat4 view;
+    mat4 lightViewProj[4];
+    vec4 cascadeOffsets;
+    vec4 lightDir;
+    vec4 shadowParams;
+} camera;
+
+// One model matrix per object, selected by the draw's firstInstance
+layout(std430, set = 0, binding = 1) readonly buffer Objects {
+    mat4 model[];
+} objects;
 
 void main() {
-    gl_Position = pc.mvp * vec4(inPosition, 1.0);
+    mat4 model = objects.model[gl_InstanceIndex];
+    vec4 worldPos = model * vec4(inPosition, 1.0);
+    gl_Position = camera.viewProj * worldPos;
 
     // Transform normal to world space (using model matrix, assumes uniform scale)
-    fragNormal = normalize(mat3(pc.model) * inNormal);
+    fragNormal = normalize(mat3(model) * inNormal);
     fragColor = inColor;
+    fragWorldPos = worldPos.xyz;
 }
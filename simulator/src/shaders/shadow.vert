@@ -0,0 +1,27 @@
+#version 450
+
+layout(location = 0) in vec3 inPosition;
+
+// Must match CameraData in SceneBuffers.h
+layout(set = 0, binding = 0) uniform Camera {
+    mat4 viewProj;
+    mat4 view;
+    mat4 lightViewProj[4];
+    vec4 cascadeOffsets;
+    vec4 lightDir;
+    vec4 shadowParams;
+} camera;
+
+layout(std430, set = 0, binding = 1) readonly buffer Objects {
+    mat4 model[];
+} objects;
+
+layout(push_constant) uniform Shadow {
+    uint cascade;
+} shadow;
+
+void main() {
+    mat4 model = objects.model[gl_InstanceIndex];
+    gl_Position = camera.lightViewProj[shadow.cascade] * model *
+                  vec4(inPosition, 1.0);
+}
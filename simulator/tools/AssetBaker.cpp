@@ -0,0 +1,244 @@
+// asset_baker — bakes GLB models into one memory-mapped asset bundle
+//
+//   asset_baker [-o assets/assets.bundle] [--lods N] [--field field.glb]
+//               model.glb...
+//
+// Each model is stored under its file stem (assets/red_block.glb ->
+// "red_block") with N levels of detail. --field also bakes that GLB's proxy
+// collision, as the simulator would build it in `--field-collision
+// proxies` mode. Run the simulator with `--bundle <file>` to use it.
+#include "AssetBundle.h"
+#include "FieldCollision.h"
+#include "GlbFile.h"
+#include "PhysicsWorld.h"
+#include "renderer/ModelLoader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <unordered_map>
+
+struct BakerOptions {
+  std::string output = "assets/assets.bundle";
+  std::string field;
+  std::vector<std::string> models;
+  int lods = 3;
+};
+
+static void PrintUsage() {
+  std::cerr << "Usage: asset_baker [-o out.bundle] [--lods N] "
+               "[--field field.glb] model.glb..."
+            << std::endl;
+}
+
+static bool ParseArgs(int argc, char **argv, BakerOptions &opts) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if ((!strcmp(arg, "-o") || !strcmp(arg, "--output")) && value) {
+      opts.output = value;
+      i++;
+    } else if (!strcmp(arg, "--lods") && value) {
+      opts.lods = std::atoi(value);
+      if (opts.lods < 1 || opts.lods > 8) {
+        std::cerr << "--lods must be 1-8" << std::endl;
+        return false;
+      }
+      i++;
+    } else if (!strcmp(arg, "--field") && value) {
+      opts.field = value;
+      i++;
+    } else if (arg[0] == '-') {
+      std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+      return false;
+    } else {
+      opts.models.push_back(arg);
+    }
+  }
+  return !opts.models.empty() || !opts.field.empty();
+}
+
+// Vertex-clustering simplification: vertices are snapped to a grid of
+// `cellSize` (shared by every mesh of the model so neighbours stay
+// watertight), each occupied cell becomes one averaged vertex and
+// triangles that collapse are dropped.
+static BundleMeshData Simplify(const BundleMeshData &source, float cellSize,
+                               const float origin[3]) {
+  const Vertex *vertices =
+      reinterpret_cast<const Vertex *>(source.vertices.data());
+  const size_t vertexCount = source.vertices.size() / sizeof(Vertex);
+
+  std::unordered_map<uint64_t, uint32_t> cells;
+  std::vector<uint32_t> remap(vertexCount);
+  std::vector<Vertex> merged;
+  std::vector<float> weights;
+  for (size_t v = 0; v < vertexCount; v++) {
+    uint64_t key = 0;
+    for (int axis = 0; axis < 3; axis++) {
+      float cell = (vertices[v].position[axis] - origin[axis]) / cellSize;
+      key = (key << 21) | (static_cast<uint64_t>(cell) & 0x1FFFFF);
+    }
+    auto it = cells.emplace(key, static_cast<uint32_t>(merged.size()));
+    if (it.second) {
+      merged.push_back(Vertex{});
+      weights.push_back(0.0f);
+    }
+    uint32_t target = it.first->second;
+    remap[v] = target;
+    for (int axis = 0; axis < 3; axis++) {
+      merged[target].position[axis] += vertices[v].position[axis];
+      merged[target].normal[axis] += vertices[v].normal[axis];
+      merged[target].color[axis] += vertices[v].color[axis];
+    }
+    weights[target] += 1.0f;
+  }
+
+  for (size_t i = 0; i < merged.size(); i++) {
+    Vertex &out = merged[i];
+    float length = std::sqrt(out.normal[0] * out.normal[0] +
+                             out.normal[1] * out.normal[1] +
+                             out.normal[2] * out.normal[2]);
+    for (int axis = 0; axis < 3; axis++) {
+      out.position[axis] /= weights[i];
+      out.color[axis] /= weights[i];
+      out.normal[axis] = length > 0.0f ? out.normal[axis] / length : 0.0f;
+    }
+  }
+
+  BundleMeshData result;
+  for (size_t t = 0; t + 2 < source.indices.size(); t += 3) {
+    uint32_t a = remap[source.indices[t]];
+    uint32_t b = remap[source.indices[t + 1]];
+    uint32_t c = remap[source.indices[t + 2]];
+    if (a == b || b == c || a == c)
+      continue;
+    result.indices.insert(result.indices.end(), {a, b, c});
+  }
+  // Too coarse for this mesh: keep the previous level instead
+  if (result.indices.empty())
+    return source;
+
+  result.vertices.resize(merged.size() * sizeof(Vertex));
+  memcpy(result.vertices.data(), merged.data(), result.vertices.size());
+  memcpy(result.boundsMin, source.boundsMin, sizeof(result.boundsMin));
+  memcpy(result.boundsMax, source.boundsMax, sizeof(result.boundsMax));
+  return result;
+}
+
+static bool BakeModel(AssetBundleWriter &writer, const std::string &path,
+                      int lods) {
+  GlbFile model;
+  std::string err;
+  if (!model.Open(path, &err)) {
+    std::cerr << "[AssetBaker] " << err << std::endl;
+    return false;
+  }
+
+  std::vector<BundleMeshData> meshes;
+  BakeModelMeshes(model, meshes);
+  const size_t meshCount = meshes.size();
+  if (meshCount == 0) {
+    std::cerr << "[AssetBaker] " << path << ": no triangle meshes"
+              << std::endl;
+    return false;
+  }
+
+  float origin[3], diagonal = 0.0f;
+  for (int axis = 0; axis < 3; axis++) {
+    float lo = meshes[0].boundsMin[axis], hi = meshes[0].boundsMax[axis];
+    for (size_t m = 1; m < meshCount; m++) {
+      lo = std::min(lo, meshes[m].boundsMin[axis]);
+      hi = std::max(hi, meshes[m].boundsMax[axis]);
+    }
+    origin[axis] = lo;
+    diagonal += (hi - lo) * (hi - lo);
+  }
+  diagonal = std::sqrt(diagonal);
+
+  // LOD n snaps to a grid of 256 / 2^n cells along the model's diagonal
+  for (int lod = 1; lod < lods && diagonal > 0.0f; lod++) {
+    float cellSize = diagonal / static_cast<float>(256 >> lod);
+    for (size_t m = 0; m < meshCount; m++) {
+      BundleMeshData coarser =
+          Simplify(meshes[(lod - 1) * meshCount + m], cellSize, origin);
+      meshes.push_back(std::move(coarser));
+    }
+  }
+  const uint32_t lodCount = static_cast<uint32_t>(meshes.size() / meshCount);
+
+  std::string name = std::filesystem::path(path).stem().string();
+  if (!writer.AddModel(name, lodCount, meshes))
+    return false;
+
+  std::cout << "[AssetBaker] " << name << ": " << meshCount << " meshes";
+  for (uint32_t lod = 0; lod < lodCount; lod++) {
+    size_t triangles = 0;
+    for (size_t m = 0; m < meshCount; m++)
+      triangles += meshes[lod * meshCount + m].indices.size() / 3;
+    std::cout << (lod ? ", " : ", LODs ") << triangles;
+  }
+  std::cout << " triangles" << std::endl;
+  return true;
+}
+
+static bool BakeField(AssetBundleWriter &writer, const std::string &path) {
+  GlbFile model;
+  std::string err;
+  if (!model.Open(path, &err)) {
+    std::cerr << "[AssetBaker] " << err << std::endl;
+    return false;
+  }
+
+  PhysicsWorld physics;
+  PhysicsConfig config;
+  config.enablePvd = false;
+  physics.Initialize(config);
+
+  std::vector<uint8_t> baked;
+  FieldCollisionStats stats;
+  bool ok = BakeFieldCollision(physics, &model, path, baked, &stats);
+  physics.Cleanup();
+  if (!ok) {
+    std::cerr << "[AssetBaker] No field collision built for " << path
+              << std::endl;
+    return false;
+  }
+
+  std::string name = std::filesystem::path(path).stem().string();
+  std::cout << "[AssetBaker] " << name << " collision: " << stats.planes
+            << " plane, " << stats.boxes << " boxes, " << stats.hulls
+            << " hulls (" << baked.size() / 1024 << " KB)" << std::endl;
+  return writer.AddBlob(name, BundleEntryType::eFIELD_COLLISION,
+                        std::move(baked));
+}
+
+int main(int argc, char **argv) {
+  BakerOptions opts;
+  if (!ParseArgs(argc, argv, opts)) {
+    PrintUsage();
+    return 1;
+  }
+
+  AssetBundleWriter writer(sizeof(Vertex));
+  bool ok = true;
+  for (const std::string &model : opts.models)
+    ok = BakeModel(writer, model, opts.lods) && ok;
+  if (!opts.field.empty())
+    ok = BakeField(writer, opts.field) && ok;
+  if (!ok) {
+    std::cerr << "[AssetBaker] Errors above; bundle not written" << std::endl;
+    return 1;
+  }
+
+  if (!writer.Write(opts.output)) {
+    std::cerr << "[AssetBaker] Could not write " << opts.output << std::endl;
+    return 1;
+  }
+  std::cout << "[AssetBaker] Wrote " << opts.output << " ("
+            << std::filesystem::file_size(opts.output) / 1024 << " KB)"
+            << std::endl;
+  return 0;
+}
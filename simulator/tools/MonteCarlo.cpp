@@ -0,0 +1,410 @@
+// monte_carlo — runs one autonomous routine many times under randomized
+// conditions and reports how often it succeeds
+//
+//   monte_carlo [--trials N] [--seed N] [--threads N] [--time-limit s]
+//               [--block-jitter m] [--start-jitter m] [--yaw-jitter deg]
+//               [--friction-jitter f] [--motor-bias f] [--motor-noise f]
+//               [--controller waypoint|pure_pursuit|ramsete]
+//               [--gain name=value]... [--rebuild] [-o trials.vxct|.csv]
+//
+// The routine starts in the home corner (x, z < -0.9), drives past four
+// block positions with the intake on, returns and ejects everything into
+// the corner. Each trial moves the blocks and the start pose, scales wheel
+// friction, and gives each drive side a gain error plus per-step noise.
+// The score is the number of blocks resting in the corner when the routine
+// ends or time runs out; a trial succeeds when all four are.
+//
+// The path is driven by the waypoint controller, or with --controller by
+// a path controller (Autonomous.h) along a smoothed path through the same
+// points; --gain sets its parameters (lookahead, ramsete_b, ...).
+//
+// Every worker thread keeps one HeadlessSim and resets it between trials;
+// --rebuild builds a fresh world per trial instead, which is slower but
+// makes each trial independent of the ones before it on that thread.
+#include "Autonomous.h"
+#include "ColumnTable.h"
+#include "HeadlessSim.h"
+#include "Robot.h"
+#include "WaypointDriver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <thread>
+
+struct MonteCarloOptions {
+  int trials = 1000;
+  uint32_t seed = 1234;
+  int threads = 0; // 0 = all cores
+  float timeLimit = 15.0f;     // s, as the autonomous period
+  float blockJitter = 0.1f;    // m, uniform in x and z
+  float startJitter = 0.05f;   // m, uniform in x and z
+  float yawJitter = 5.0f;      // degrees, uniform
+  float frictionJitter = 0.2f; // Wheel friction scaled by 1 +- this
+  float motorBias = 0.05f;     // SD of each side's gain error
+  float motorNoise = 0.05f;    // SD of per-step power noise
+  std::string controller = "waypoint"; // waypoint | pure_pursuit | ramsete
+  AutonConfig auton;                   // Path controller and --gain values
+  bool rebuild = false;
+  std::string output = "monte_carlo.vxct";
+};
+
+static void PrintUsage() {
+  std::cerr << "Usage: monte_carlo [--trials N] [--seed N] [--threads N] "
+               "[--time-limit s] [--block-jitter m] [--start-jitter m] "
+               "[--yaw-jitter deg] [--friction-jitter f] [--motor-bias f] "
+               "[--motor-noise f] "
+               "[--controller waypoint|pure_pursuit|ramsete] "
+               "[--gain name=value]... [--rebuild] [-o trials.vxct|.csv]\n"
+               "Gains:";
+  for (const std::string &name : GetAutonParamNames())
+    std::cerr << " " << name;
+  std::cerr << std::endl;
+}
+
+static bool ParseArgs(int argc, char **argv, MonteCarloOptions &opts) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    float *number = nullptr;
+    if (!strcmp(arg, "--time-limit"))
+      number = &opts.timeLimit;
+    else if (!strcmp(arg, "--block-jitter"))
+      number = &opts.blockJitter;
+    else if (!strcmp(arg, "--start-jitter"))
+      number = &opts.startJitter;
+    else if (!strcmp(arg, "--yaw-jitter"))
+      number = &opts.yawJitter;
+    else if (!strcmp(arg, "--friction-jitter"))
+      number = &opts.frictionJitter;
+    else if (!strcmp(arg, "--motor-bias"))
+      number = &opts.motorBias;
+    else if (!strcmp(arg, "--motor-noise"))
+      number = &opts.motorNoise;
+
+    if (number && value) {
+      *number = std::strtof(value, nullptr);
+      if (*number < 0.0f) {
+        std::cerr << arg << " must not be negative" << std::endl;
+        return false;
+      }
+      i++;
+    } else if (!strcmp(arg, "--trials") && value) {
+      opts.trials = std::atoi(value);
+      i++;
+    } else if (!strcmp(arg, "--seed") && value) {
+      opts.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+      i++;
+    } else if (!strcmp(arg, "--threads") && value) {
+      opts.threads = std::atoi(value);
+      i++;
+    } else if (!strcmp(arg, "--controller") && value) {
+      opts.controller = value;
+      if (opts.controller != "waypoint" &&
+          !ParsePathController(opts.controller, opts.auton.controller)) {
+        std::cerr << "Unknown controller: " << value << std::endl;
+        return false;
+      }
+      i++;
+    } else if (!strcmp(arg, "--gain") && value) {
+      const char *eq = strchr(value, '=');
+      char *end = nullptr;
+      float gain = eq ? std::strtof(eq + 1, &end) : 0.0f;
+      if (!eq || end == eq + 1 || *end != '\0' ||
+          !SetAutonParam(opts.auton, std::string(value, eq), gain)) {
+        std::cerr << "Bad --gain: " << value << std::endl;
+        return false;
+      }
+      i++;
+    } else if (!strcmp(arg, "--rebuild")) {
+      opts.rebuild = true;
+    } else if ((!strcmp(arg, "-o") || !strcmp(arg, "--output")) && value) {
+      opts.output = value;
+      i++;
+    } else {
+      std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+      return false;
+    }
+  }
+  return opts.trials > 0 && opts.threads >= 0 && opts.timeLimit > 0.0f &&
+         opts.frictionJitter < 1.0f;
+}
+
+// --- Routine ---
+
+static const float kPi = 3.14159265f;
+static const float kHomeEdge = -0.9f; // Home corner: x and z below this
+static const PxVec3 kStart(-1.3f, 0.3f, -1.3f);
+static const PxVec3 kBlocks[] = {{-1.2f, 0.07f, -0.3f},
+                                 {-0.5f, 0.07f, 0.4f},
+                                 {0.4f, 0.07f, 0.6f},
+                                 {0.3f, 0.07f, -0.3f}};
+static const int kBlockCount = 4;
+// Past each block, then back in along the diagonal so ejected blocks
+// travel into the corner
+static const PxVec3 kPath[] = {kBlocks[0], kBlocks[1], kBlocks[2],
+                               kBlocks[3], {-0.5f, 0.0f, -0.5f},
+                               {-1.05f, 0.0f, -1.05f}};
+static const float kSettleTime = 0.5f;  // Before the routine starts
+static const float kEjectPeriod = 0.3f; // Between outtakes
+static const float kScoreDelay = 1.0f;  // After the last outtake
+
+struct TrialSetup {
+  RobotConfig robot;
+  PxTransform start;
+  std::vector<PxVec3> blocks;
+  float frictionScale = 1.0f;
+  float leftGain = 1.0f;
+  float rightGain = 1.0f;
+};
+
+struct TrialResult {
+  int score = 0;
+  int blocksCollected = 0; // Most held at once
+  double finishTime = std::numeric_limits<double>::quiet_NaN();
+  double trackingError = std::numeric_limits<double>::quiet_NaN();
+  double runMs = 0.0;
+};
+
+static TrialSetup MakeTrial(const MonteCarloOptions &opts,
+                            float driveDirection, std::mt19937 &rng) {
+  std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+
+  TrialSetup setup;
+  setup.frictionScale = 1.0f + opts.frictionJitter * signedUnit(rng);
+  setup.robot.wheelStaticFriction *= setup.frictionScale;
+  setup.robot.wheelDynamicFriction *= setup.frictionScale;
+  // normal_distribution needs an SD > 0; 0 turns the bias off
+  if (opts.motorBias > 0.0f) {
+    std::normal_distribution<float> bias(0.0f, opts.motorBias);
+    setup.leftGain = 1.0f + bias(rng);
+    setup.rightGain = 1.0f + bias(rng);
+  }
+
+  // Facing +Z in the direction of travel
+  float yaw = (driveDirection > 0.0f ? 0.0f : kPi) +
+              opts.yawJitter * kPi / 180.0f * signedUnit(rng);
+  PxVec3 position = kStart + PxVec3(opts.startJitter * signedUnit(rng), 0.0f,
+                                    opts.startJitter * signedUnit(rng));
+  setup.start = PxTransform(position, PxQuat(yaw, PxVec3(0.0f, 1.0f, 0.0f)));
+
+  for (const PxVec3 &block : kBlocks) {
+    setup.blocks.push_back(block + PxVec3(opts.blockJitter * signedUnit(rng),
+                                          0.0f,
+                                          opts.blockJitter * signedUnit(rng)));
+  }
+  return setup;
+}
+
+static TrialResult RunTrial(HeadlessSim &sim, const TrialSetup &setup,
+                            const MonteCarloOptions &opts,
+                            float driveDirection, std::mt19937 &rng) {
+  auto start = std::chrono::steady_clock::now();
+  sim.Reset(setup.robot, setup.start, setup.blocks);
+  Robot &robot = sim.GetRobot();
+  while (sim.GetTime() < kSettleTime)
+    sim.Step();
+
+  const std::vector<PxVec3> path(std::begin(kPath), std::end(kPath));
+  const bool waypoint = opts.controller == "waypoint";
+  WaypointDriver driver(driveDirection);
+  driver.SetWaypoints(path);
+  AutonRunner auton(opts.auton, robot.GetWheelRadius(),
+                    setup.robot.maxWheelSpeed, driveDirection);
+  if (!waypoint) {
+    AutonRoutine routine;
+    routine.AddPath(path);
+    auton.Start(routine);
+  }
+  // As for the bias, an SD of 0 means no noise
+  const bool noisy = opts.motorNoise > 0.0f;
+  std::normal_distribution<float> noise(0.0f, noisy ? opts.motorNoise : 1.0f);
+  const float routineStart = sim.GetTime();
+  float nextEject = 0.0f, scoreAt = 0.0f;
+  TrialResult result;
+
+  while (sim.GetTime() - routineStart < opts.timeLimit) {
+    float time = sim.GetTime() - routineStart;
+    float left = 0.0f, right = 0.0f;
+    PxTransform pose = robot.GetChassis()->getGlobalPose();
+    bool driving = waypoint ? driver.Update(pose, left, right)
+                            : auton.Update(pose, HeadlessSim::kStep, left,
+                                           right);
+    if (driving) {
+      sim.IntakeNearest();
+      left *= setup.leftGain;
+      right *= setup.rightGain;
+      if (noisy) {
+        left += noise(rng);
+        right += noise(rng);
+      }
+      nextEject = time;
+    } else if (std::isnan(result.finishTime)) {
+      // Home: eject one block per period, then let them settle
+      if (time >= nextEject) {
+        if (robot.HasBlock()) {
+          robot.Outtake();
+          nextEject = time + kEjectPeriod;
+        } else {
+          result.finishTime = time;
+          scoreAt = time + kScoreDelay;
+        }
+      }
+    } else if (time >= scoreAt) {
+      break;
+    }
+    robot.SetDriveInput(left, right);
+    sim.Step();
+    result.blocksCollected =
+        std::max(result.blocksCollected, robot.GetHeldCount());
+  }
+
+  if (!waypoint)
+    result.trackingError = auton.GetMeanTrackingError();
+  for (const GameBlock &block : sim.GetBlocks()) {
+    PxVec3 p = block.body->getGlobalPose().p;
+    if (!block.held && p.x < kHomeEdge && p.z < kHomeEdge)
+      result.score++;
+  }
+  result.runMs = std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  return result;
+}
+
+int main(int argc, char **argv) {
+  MonteCarloOptions opts;
+  if (!ParseArgs(argc, argv, opts)) {
+    PrintUsage();
+    return 1;
+  }
+
+  int threads = opts.threads > 0
+                    ? opts.threads
+                    : std::max(1, static_cast<int>(
+                                      std::thread::hardware_concurrency()));
+  threads = std::min(threads, opts.trials);
+  std::cerr << "[MonteCarlo] " << opts.trials << " trials on " << threads
+            << " threads (" << opts.controller << ", "
+            << (opts.rebuild ? "fresh world" : "pooled reset")
+            << " per trial)" << std::endl;
+
+  // One PhysX SDK for the process; each worker steps its own scene on it
+  PhysicsWorld sdk;
+  sdk.Initialize(HeadlessSim::MakePhysicsConfig());
+  std::streambuf *stdoutBuf = std::cout.rdbuf(nullptr);
+  float driveDirection = MeasureDriveDirection(sdk);
+
+  std::vector<TrialSetup> setups(opts.trials);
+  std::vector<TrialResult> results(opts.trials);
+  std::atomic<int> next{0}, done{0};
+  auto runStart = std::chrono::steady_clock::now();
+  auto worker = [&]() {
+    std::unique_ptr<HeadlessSim> pooled;
+    for (int i = next++; i < opts.trials; i = next++) {
+      // Seeded per trial, so a trial's conditions do not depend on which
+      // worker ran it
+      std::seed_seq seq{opts.seed, static_cast<uint32_t>(i)};
+      std::mt19937 rng(seq);
+      setups[i] = MakeTrial(opts, driveDirection, rng);
+      if (!pooled || opts.rebuild) {
+        pooled.reset();
+        pooled = std::make_unique<HeadlessSim>(sdk, setups[i].robot,
+                                               setups[i].start.p);
+      }
+      results[i] = RunTrial(*pooled, setups[i], opts, driveDirection, rng);
+      int finished = ++done;
+      if (finished % std::max(1, opts.trials / 10) == 0)
+        std::cerr << "[MonteCarlo] " << finished << "/" << opts.trials
+                  << std::endl;
+    }
+  };
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++)
+    pool.emplace_back(worker);
+  for (std::thread &thread : pool)
+    thread.join();
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - runStart)
+                       .count();
+  std::cout.rdbuf(stdoutBuf);
+  std::cout.clear();
+
+  // --- Per-trial table ---
+  ColumnTable table;
+  table.Resize(opts.trials);
+  const char *columns[] = {
+      "trial",   "score",   "success",   "blocks_collected", "finish_time",
+      "start_x", "start_z", "start_yaw", "friction_scale",   "left_gain",
+      "right_gain", "tracking_error", "run_ms"};
+  for (const char *name : columns)
+    table.AddColumn(name);
+  std::vector<int> histogram(kBlockCount + 1, 0);
+  std::vector<double> finishTimes;
+  double scoreSum = 0.0;
+  for (int i = 0; i < opts.trials; i++) {
+    const TrialSetup &s = setups[i];
+    const TrialResult &r = results[i];
+    PxVec3 forward = s.start.q.rotate(PxVec3(0.0f, 0.0f, 1.0f));
+    double row[] = {static_cast<double>(i),
+                    static_cast<double>(r.score),
+                    r.score == kBlockCount ? 1.0 : 0.0,
+                    static_cast<double>(r.blocksCollected),
+                    r.finishTime,
+                    s.start.p.x,
+                    s.start.p.z,
+                    std::atan2(forward.x, forward.z) * 180.0 / kPi,
+                    s.frictionScale,
+                    s.leftGain,
+                    s.rightGain,
+                    r.trackingError,
+                    r.runMs};
+    for (size_t c = 0; c < table.GetColumnCount(); c++)
+      table.Set(c, i, row[c]);
+    histogram[r.score]++;
+    scoreSum += r.score;
+    if (!std::isnan(r.finishTime))
+      finishTimes.push_back(r.finishTime);
+  }
+
+  std::string err;
+  if (!table.Save(opts.output, &err)) {
+    std::cerr << "[MonteCarlo] " << err << std::endl;
+    return 1;
+  }
+
+  // --- Summary ---
+  // Success rate with a 95% normal-approximation interval
+  double n = opts.trials;
+  double rate = histogram[kBlockCount] / n;
+  double margin = 1.96 * std::sqrt(rate * (1.0 - rate) / n);
+  std::cout << "Trials:       " << opts.trials << " in " << seconds << " s ("
+            << n / std::max(seconds, 1e-9) << " trials/s)" << std::endl;
+  std::cout << "Success rate: " << rate * 100.0 << "% +- " << margin * 100.0
+            << "%" << std::endl;
+  std::cout << "Mean score:   " << scoreSum / n << " / " << kBlockCount
+            << std::endl;
+  for (int score = 0; score <= kBlockCount; score++) {
+    std::cout << "  score " << score << ": " << histogram[score] << " ("
+              << histogram[score] * 100.0 / n << "%)" << std::endl;
+  }
+  if (!finishTimes.empty()) {
+    std::sort(finishTimes.begin(), finishTimes.end());
+    auto percentile = [&](double p) {
+      return finishTimes[static_cast<size_t>(p * (finishTimes.size() - 1))];
+    };
+    std::cout << "Finish time:  p50 " << percentile(0.5) << " s, p90 "
+              << percentile(0.9) << " s (" << finishTimes.size()
+              << " finished)" << std::endl;
+  }
+  std::cout << "Results:      " << opts.output << std::endl;
+  return 0;
+}
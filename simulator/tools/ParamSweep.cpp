@@ -0,0 +1,665 @@
+// param_sweep — runs a headless driving scenario over a grid or sample of
+// robot parameters on every core and writes one result row per run
+//
+//   param_sweep --param name=min:max[:count] [--param name=value]...
+//               [--sampling grid|random|lhs] [--samples N] [--seed N]
+//               [--threads N | --processes N [--retries N] [--job-timeout s]]
+//               [--controller waypoint|pure_pursuit|ramsete]
+//               [--routine file] [--timeout seconds] [-o results.vxct|.csv]
+//
+// Grid sampling takes `count` evenly spaced values per parameter (default
+// 5) and runs every combination; random and lhs (Latin hypercube) draw
+// --samples configurations from the ranges. Parameters not given keep the
+// RobotConfig and AutonConfig defaults. Robot: drive_torque,
+// max_wheel_speed, wheel_static_friction, wheel_dynamic_friction,
+// linear_damping, angular_damping, intake_range. Controller (pure_pursuit
+// and ramsete only): max_velocity, max_acceleration, max_centripetal,
+// lookahead, ramsete_b, ramsete_zeta, turn_kp, turn_ki, turn_kd,
+// turn_tolerance, max_turn_rate, track_width.
+//
+// Each run drives one lap of a 2 m square, intaking blocks placed beside
+// the path, then stops. The default waypoint controller seeks the corners;
+// pure_pursuit and ramsete follow a smoothed path through them and turn
+// back to the start heading. --routine runs an autonomous routine file
+// (see Autonomous.h) instead, with no blocks. Columns: the parameters,
+// lap_time (s, empty if the lap was not finished), final_position_error
+// (m from the start or the routine's end), final_heading_error (degrees),
+// blocks_collected, tracking_error (mean m from the planned path; path
+// controllers only) and run_ms (wall time).
+//
+// --processes runs the configurations in that many copies of param_sweep
+// (started with --worker) instead of threads: each has its own PhysX SDK,
+// and one that crashes or passes --job-timeout is restarted and its run
+// retried up to --retries times. Runs that still fail are left empty.
+#include "Autonomous.h"
+#include "ColumnTable.h"
+#include "HeadlessSim.h"
+#include "JobCoordinator.h"
+#include "Robot.h"
+#include "WaypointDriver.h"
+#include "WorkerProcess.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <thread>
+
+struct ParamRange {
+  std::string name;
+  float min = 0.0f;
+  float max = 0.0f;
+  int count = 5; // Grid values
+};
+
+struct SweepOptions {
+  std::vector<ParamRange> params;
+  std::string sampling = "grid"; // grid | random | lhs
+  int samples = 256;
+  uint32_t seed = 1234;
+  int threads = 0;   // 0 = all cores
+  int processes = 0; // Worker processes instead of threads; 0 = none
+  int retries = 2;
+  float jobTimeout = 120.0f; // s of wall time per run in a worker
+  float timeout = 20.0f;
+  std::string controller = "waypoint"; // waypoint | pure_pursuit | ramsete
+  std::string routine;                 // AutonRoutine file; empty = lap
+  std::string output = "sweep.vxct";
+};
+
+// One run's parameters; `auton` is used by the path controllers
+struct SweepConfig {
+  RobotConfig robot;
+  AutonConfig auton;
+};
+
+static bool SetSweepParam(SweepConfig &config, const std::string &name,
+                          float value) {
+  return SetRobotParam(config.robot, name, value) ||
+         SetAutonParam(config.auton, name, value);
+}
+
+static bool GetSweepParam(const SweepConfig &config, const std::string &name,
+                          float &value) {
+  return GetRobotParam(config.robot, name, value) ||
+         GetAutonParam(config.auton, name, value);
+}
+
+// Robot parameters, then controller ones
+static const std::vector<std::string> &GetSweepParamNames() {
+  static const std::vector<std::string> names = [] {
+    std::vector<std::string> out = GetRobotParamNames();
+    const std::vector<std::string> &auton = GetAutonParamNames();
+    out.insert(out.end(), auton.begin(), auton.end());
+    return out;
+  }();
+  return names;
+}
+
+static void PrintUsage() {
+  std::cerr << "Usage: param_sweep --param name=min:max[:count] "
+               "[--param name=value]... [--sampling grid|random|lhs] "
+               "[--samples N] [--seed N] [--threads N | --processes N "
+               "[--retries N] [--job-timeout s]] "
+               "[--controller waypoint|pure_pursuit|ramsete] "
+               "[--routine file] [--timeout s] [-o results.vxct|.csv]\n"
+               "Parameters:";
+  for (const std::string &name : GetRobotParamNames())
+    std::cerr << " " << name;
+  std::cerr << "\nController parameters:";
+  for (const std::string &name : GetAutonParamNames())
+    std::cerr << " " << name;
+  std::cerr << std::endl;
+}
+
+// "name=min:max[:count]" or "name=value"
+static bool ParseParam(const char *text, ParamRange &out) {
+  const char *eq = strchr(text, '=');
+  if (!eq)
+    return false;
+  out.name.assign(text, eq);
+  float unused;
+  if (!GetSweepParam(SweepConfig(), out.name, unused))
+    return false;
+
+  char *end = nullptr;
+  out.min = std::strtof(eq + 1, &end);
+  if (end == eq + 1)
+    return false;
+  out.max = out.min;
+  out.count = 1;
+  if (*end == ':') {
+    out.max = std::strtof(end + 1, &end);
+    out.count = 5;
+    if (*end == ':')
+      out.count = static_cast<int>(std::strtol(end + 1, &end, 10));
+  }
+  // Both ends must be accepted (some controller parameters must be > 0);
+  // every value swept lies between them
+  SweepConfig check;
+  return *end == '\0' && out.count >= 1 && out.max >= out.min &&
+         SetSweepParam(check, out.name, out.min) &&
+         SetSweepParam(check, out.name, out.max);
+}
+
+static bool ParseArgs(int argc, char **argv, SweepOptions &opts) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (!strcmp(arg, "--param") && value) {
+      ParamRange range;
+      if (!ParseParam(value, range)) {
+        std::cerr << "Bad --param: " << value << std::endl;
+        return false;
+      }
+      opts.params.push_back(range);
+      i++;
+    } else if (!strcmp(arg, "--sampling") && value) {
+      opts.sampling = value;
+      if (opts.sampling != "grid" && opts.sampling != "random" &&
+          opts.sampling != "lhs") {
+        std::cerr << "Unknown sampling: " << value << std::endl;
+        return false;
+      }
+      i++;
+    } else if (!strcmp(arg, "--samples") && value) {
+      opts.samples = std::atoi(value);
+      i++;
+    } else if (!strcmp(arg, "--seed") && value) {
+      opts.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+      i++;
+    } else if (!strcmp(arg, "--threads") && value) {
+      opts.threads = std::atoi(value);
+      i++;
+    } else if (!strcmp(arg, "--processes") && value) {
+      opts.processes = std::atoi(value);
+      i++;
+    } else if (!strcmp(arg, "--retries") && value) {
+      opts.retries = std::atoi(value);
+      i++;
+    } else if (!strcmp(arg, "--job-timeout") && value) {
+      opts.jobTimeout = std::strtof(value, nullptr);
+      i++;
+    } else if (!strcmp(arg, "--timeout") && value) {
+      opts.timeout = std::strtof(value, nullptr);
+      i++;
+    } else if (!strcmp(arg, "--controller") && value) {
+      opts.controller = value;
+      PathController controller;
+      if (opts.controller != "waypoint" &&
+          !ParsePathController(opts.controller, controller)) {
+        std::cerr << "Unknown controller: " << value << std::endl;
+        return false;
+      }
+      i++;
+    } else if (!strcmp(arg, "--routine") && value) {
+      opts.routine = value;
+      i++;
+    } else if ((!strcmp(arg, "-o") || !strcmp(arg, "--output")) && value) {
+      opts.output = value;
+      i++;
+    } else {
+      std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+      return false;
+    }
+  }
+  if (opts.controller == "waypoint") {
+    float unused;
+    for (const ParamRange &range : opts.params) {
+      if (GetAutonParam(AutonConfig(), range.name, unused)) {
+        std::cerr << range.name << " needs --controller pure_pursuit or "
+                  << "ramsete" << std::endl;
+        return false;
+      }
+    }
+    if (!opts.routine.empty()) {
+      std::cerr << "--routine needs --controller pure_pursuit or ramsete"
+                << std::endl;
+      return false;
+    }
+  }
+  return !opts.params.empty() && opts.samples > 0 && opts.threads >= 0 &&
+         opts.processes >= 0 && opts.retries >= 0 && opts.jobTimeout >= 0.0f &&
+         opts.timeout > 0.0f;
+}
+
+// --- Sampling ---
+
+static std::vector<SweepConfig> MakeConfigs(const SweepOptions &opts) {
+  std::vector<SweepConfig> configs;
+  const std::vector<ParamRange> &params = opts.params;
+
+  if (opts.sampling == "grid") {
+    size_t total = 1;
+    for (const ParamRange &p : params)
+      total *= static_cast<size_t>(p.count);
+    configs.resize(total);
+    for (size_t i = 0; i < total; i++) {
+      // Mixed-radix index: the first parameter varies slowest
+      size_t rest = i;
+      for (size_t p = params.size(); p-- > 0;) {
+        int step = static_cast<int>(rest % params[p].count);
+        rest /= params[p].count;
+        float t = params[p].count > 1
+                      ? static_cast<float>(step) / (params[p].count - 1)
+                      : 0.0f;
+        SetSweepParam(configs[i], params[p].name,
+                      params[p].min + t * (params[p].max - params[p].min));
+      }
+    }
+    return configs;
+  }
+
+  std::mt19937 rng(opts.seed);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  size_t n = static_cast<size_t>(opts.samples);
+  configs.resize(n);
+  for (const ParamRange &p : params) {
+    // Latin hypercube: each parameter's range is cut into n strata and
+    // every stratum is used exactly once, in a random order
+    std::vector<size_t> strata(n);
+    std::iota(strata.begin(), strata.end(), size_t(0));
+    if (opts.sampling == "lhs")
+      std::shuffle(strata.begin(), strata.end(), rng);
+    for (size_t i = 0; i < n; i++) {
+      float t = opts.sampling == "lhs" ? (strata[i] + unit(rng)) / n
+                                       : unit(rng);
+      SetSweepParam(configs[i], p.name, p.min + t * (p.max - p.min));
+    }
+  }
+  return configs;
+}
+
+// --- Scenario ---
+
+struct RunResult {
+  double lapTime = std::numeric_limits<double>::quiet_NaN();
+  double positionError = 0.0;
+  double headingError = 0.0;
+  int blocksCollected = 0;
+  double trackingError = std::numeric_limits<double>::quiet_NaN();
+  double runMs = 0.0;
+  bool failed = false; // Its worker process never returned a result
+};
+
+// What every run drives: the waypoint controller on the lap, or a path
+// controller on the lap or on `routine`
+struct Scenario {
+  bool waypoint = true;
+  PathController controller = PathController::eRAMSETE;
+  const AutonRoutine *routine = nullptr; // Null = the lap
+};
+
+static const float kPi = 3.14159265f;
+
+// Square lap, starting and ending at the first corner facing the second
+static const PxVec3 kCorners[] = {{-1.0f, 0.0f, -1.0f},
+                                  {-1.0f, 0.0f, 1.0f},
+                                  {1.0f, 0.0f, 1.0f},
+                                  {1.0f, 0.0f, -1.0f}};
+static const int kCornerCount = 4;
+static const float kSettleTime = 0.5f; // Before the clock starts
+static const float kStopTime = 1.0f;   // After the lap, before measuring
+
+static RunResult RunLap(PhysicsWorld &sdk, const SweepConfig &config,
+                        const Scenario &scenario, float driveDirection,
+                        float timeout) {
+  auto start = std::chrono::steady_clock::now();
+  HeadlessSim sim(sdk, config.robot,
+                  PxVec3(kCorners[0].x, 0.5f, kCorners[0].z));
+  Robot &robot = sim.GetRobot();
+
+  if (scenario.routine) {
+    if (scenario.routine->HasStart()) {
+      sim.Reset(config.robot, scenario.routine->GetStart(driveDirection, 0.5f),
+                {});
+    }
+  } else {
+    // Two blocks per side, 15 cm off the line so the intake range matters
+    for (int c = 0; c < kCornerCount; c++) {
+      PxVec3 a = kCorners[c], b = kCorners[(c + 1) % kCornerCount];
+      PxVec3 along = (b - a).getNormalized();
+      PxVec3 side(along.z, 0.0f, -along.x);
+      for (float t : {0.35f, 0.7f}) {
+        PxVec3 p = a + (b - a) * t + side * ((c % 2) ? 0.15f : -0.15f);
+        sim.AddBlock(c % 2 ? BlockColor::BLUE : BlockColor::RED,
+                     PxVec3(p.x, 0.07f, p.z));
+      }
+    }
+  }
+
+  while (sim.GetTime() < kSettleTime)
+    sim.Step();
+
+  WaypointDriver driver(driveDirection);
+  driver.SetWaypoints({kCorners[1], kCorners[2], kCorners[3], kCorners[0]});
+  const float startHeading =
+      driver.GetHeading(robot.GetChassis()->getGlobalPose());
+
+  // Path controllers run a routine; the lap's turns back to the start
+  // heading at the end, so every controller is measured the same way
+  AutonConfig autonConfig = config.auton;
+  autonConfig.controller = scenario.controller;
+  AutonRunner auton(autonConfig, robot.GetWheelRadius(),
+                    config.robot.maxWheelSpeed, driveDirection);
+  AutonRoutine lap;
+  const AutonRoutine *routine = scenario.routine;
+  if (!scenario.waypoint && !routine) {
+    lap.AddPath({kCorners[1], kCorners[2], kCorners[3], kCorners[0]});
+    lap.AddTurn(startHeading);
+    routine = &lap;
+  }
+  PxVec3 endPosition = kCorners[0];
+  float endHeading = startHeading;
+  if (routine) {
+    auton.Start(*routine);
+    routine->GetEnd(endPosition, endHeading);
+  }
+
+  const float lapStart = sim.GetTime();
+  float stopAt = -1.0f;
+  RunResult result;
+
+  while (sim.GetTime() - lapStart < timeout) {
+    float left = 0.0f, right = 0.0f;
+    if (stopAt < 0.0f) {
+      PxTransform pose = robot.GetChassis()->getGlobalPose();
+      bool running = routine ? auton.Update(pose, HeadlessSim::kStep, left,
+                                            right)
+                             : driver.Update(pose, left, right);
+      if (!running) {
+        result.lapTime = sim.GetTime() - lapStart;
+        stopAt = sim.GetTime();
+      }
+    }
+    if (stopAt >= 0.0f && sim.GetTime() - stopAt >= kStopTime)
+      break;
+    robot.SetDriveInput(left, right);
+    sim.IntakeNearest();
+    sim.Step();
+  }
+
+  PxTransform pose = robot.GetChassis()->getGlobalPose();
+  result.positionError =
+      std::sqrt((pose.p.x - endPosition.x) * (pose.p.x - endPosition.x) +
+                (pose.p.z - endPosition.z) * (pose.p.z - endPosition.z));
+  float headingError = WrapAngle(driver.GetHeading(pose) - endHeading);
+  result.headingError = std::abs(headingError) * 180.0f / kPi;
+  result.blocksCollected = robot.GetHeldCount();
+  if (routine)
+    result.trackingError = auton.GetMeanTrackingError();
+  result.runMs = std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  return result;
+}
+
+// --- Runners ---
+
+static void ReportProgress(size_t finished, size_t total) {
+  if (finished % std::max<size_t>(1, total / 20) == 0)
+    std::cerr << "[Sweep] " << finished << "/" << total << std::endl;
+}
+
+// Every run on its own scene of one shared SDK, `threads` at a time
+static void RunInThreads(const SweepOptions &opts,
+                         const std::vector<SweepConfig> &configs,
+                         const Scenario &scenario, int threads,
+                         std::vector<RunResult> &results) {
+  PhysicsWorld sdk;
+  sdk.Initialize(HeadlessSim::MakePhysicsConfig());
+
+  // Robot and world setup log per run; silence std::cout while sweeping
+  std::streambuf *stdoutBuf = std::cout.rdbuf(nullptr);
+  float driveDirection = MeasureDriveDirection(sdk);
+
+  std::atomic<size_t> next{0}, done{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < configs.size(); i = next++) {
+      results[i] =
+          RunLap(sdk, configs[i], scenario, driveDirection, opts.timeout);
+      ReportProgress(++done, configs.size());
+    }
+  };
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++)
+    pool.emplace_back(worker);
+  for (std::thread &thread : pool)
+    thread.join();
+  std::cout.rdbuf(stdoutBuf);
+  std::cout.clear();
+}
+
+// Jobs and results travel as space-separated numbers, printed with enough
+// digits to read back exactly
+static std::string FormatNumbers(const std::vector<double> &values) {
+  std::string text;
+  char number[32];
+  for (double value : values) {
+    std::snprintf(number, sizeof(number), "%.17g", value);
+    if (!text.empty())
+      text += ' ';
+    text += number;
+  }
+  return text;
+}
+
+static bool ParseNumbers(const std::string &text, size_t count,
+                         std::vector<double> &values) {
+  values.clear();
+  const char *p = text.c_str();
+  for (size_t i = 0; i < count; i++) {
+    char *end = nullptr;
+    values.push_back(std::strtod(p, &end));
+    if (end == p)
+      return false;
+    p = end;
+  }
+  return true;
+}
+
+// Job: the run timeout, the controller (-1 waypoint, else PathController)
+// and every parameter in GetSweepParamNames order. Result: the RunResult
+// fields in declaration order. The routine file is a worker argument.
+static std::string EncodeJob(const SweepConfig &config,
+                             const Scenario &scenario, float timeout) {
+  std::vector<double> values = {
+      timeout,
+      scenario.waypoint ? -1.0 : static_cast<double>(scenario.controller)};
+  for (const std::string &name : GetSweepParamNames()) {
+    float value = 0.0f;
+    GetSweepParam(config, name, value);
+    values.push_back(value);
+  }
+  return FormatNumbers(values);
+}
+
+// --worker [--routine file]: runs jobs from the coordinator on stdin until
+// it closes it
+static int RunSweepWorker(const char *routinePath) {
+  AutonRoutine routine;
+  std::string err;
+  if (routinePath && !routine.Load(routinePath, &err)) {
+    std::cerr << "[Sweep] " << err << std::endl;
+    return 1;
+  }
+  // Set up on the first job, once the loop owns stdout
+  PhysicsWorld sdk;
+  float driveDirection = 0.0f;
+  const std::vector<std::string> &names = GetSweepParamNames();
+  std::vector<double> values;
+  return RunWorkerLoop([&](const std::string &job, std::string &result) {
+    if (driveDirection == 0.0f) {
+      std::cout.rdbuf(nullptr);
+      sdk.Initialize(HeadlessSim::MakePhysicsConfig());
+      driveDirection = MeasureDriveDirection(sdk);
+    }
+    if (!ParseNumbers(job, names.size() + 2, values))
+      return false;
+    Scenario scenario;
+    scenario.waypoint = values[1] < 0.0;
+    if (!scenario.waypoint)
+      scenario.controller = static_cast<PathController>(values[1]);
+    scenario.routine = routinePath ? &routine : nullptr;
+    SweepConfig config;
+    for (size_t i = 0; i < names.size(); i++)
+      SetSweepParam(config, names[i], static_cast<float>(values[i + 2]));
+    RunResult run = RunLap(sdk, config, scenario, driveDirection,
+                           static_cast<float>(values[0]));
+    result = FormatNumbers({run.lapTime, run.positionError, run.headingError,
+                            static_cast<double>(run.blocksCollected),
+                            run.trackingError, run.runMs});
+    return true;
+  });
+}
+
+// Every run in one of `processes` worker processes, each with its own SDK
+static void RunInProcesses(const SweepOptions &opts,
+                           const std::vector<SweepConfig> &configs,
+                           const Scenario &scenario, int processes,
+                           const char *argv0,
+                           std::vector<RunResult> &results) {
+  std::vector<std::string> jobs;
+  for (const SweepConfig &config : configs)
+    jobs.push_back(EncodeJob(config, scenario, opts.timeout));
+
+  CoordinatorConfig coordinator;
+  coordinator.workerCommand = {GetExecutablePath(argv0), "--worker"};
+  if (!opts.routine.empty()) {
+    coordinator.workerCommand.push_back("--routine");
+    coordinator.workerCommand.push_back(opts.routine);
+  }
+  coordinator.workers = processes;
+  coordinator.maxAttempts = opts.retries + 1;
+  coordinator.jobTimeout = opts.jobTimeout;
+  JobCoordinator jobCoordinator(coordinator);
+
+  size_t done = 0;
+  std::vector<double> values;
+  jobCoordinator.Run(
+      jobs,
+      [&](size_t job, const std::string &result) {
+        RunResult &run = results[job];
+        if (ParseNumbers(result, 6, values)) {
+          run.lapTime = values[0];
+          run.positionError = values[1];
+          run.headingError = values[2];
+          run.blocksCollected = static_cast<int>(values[3]);
+          run.trackingError = values[4];
+          run.runMs = values[5];
+        } else {
+          std::cerr << "[Sweep] Run " << job << ": bad result" << std::endl;
+          run.failed = true;
+        }
+        ReportProgress(++done, configs.size());
+      },
+      [&](size_t job, const std::string &reason) {
+        std::cerr << "[Sweep] Run " << job << " failed: " << reason
+                  << std::endl;
+        results[job].failed = true;
+        ReportProgress(++done, configs.size());
+      });
+}
+
+int main(int argc, char **argv) {
+  if (argc >= 2 && !strcmp(argv[1], "--worker")) {
+    bool routine = argc == 4 && !strcmp(argv[2], "--routine");
+    return RunSweepWorker(routine ? argv[3] : nullptr);
+  }
+
+  SweepOptions opts;
+  if (!ParseArgs(argc, argv, opts)) {
+    PrintUsage();
+    return 1;
+  }
+  Scenario scenario;
+  scenario.waypoint = opts.controller == "waypoint";
+  if (!scenario.waypoint)
+    ParsePathController(opts.controller, scenario.controller);
+  AutonRoutine routine;
+  if (!opts.routine.empty()) {
+    std::string err;
+    if (!routine.Load(opts.routine, &err)) {
+      std::cerr << "[Sweep] " << err << std::endl;
+      return 1;
+    }
+    scenario.routine = &routine;
+  }
+
+  std::vector<SweepConfig> configs = MakeConfigs(opts);
+  int workers = opts.processes;
+  if (workers == 0)
+    workers = opts.threads > 0
+                  ? opts.threads
+                  : std::max(1, static_cast<int>(
+                                    std::thread::hardware_concurrency()));
+  workers = std::min<int>(workers, static_cast<int>(configs.size()));
+  std::cerr << "[Sweep] " << configs.size() << " configurations ("
+            << opts.sampling << ", " << opts.controller << ") on " << workers
+            << (opts.processes > 0 ? " processes" : " threads") << std::endl;
+
+  std::vector<RunResult> results(configs.size());
+  auto sweepStart = std::chrono::steady_clock::now();
+  if (opts.processes > 0)
+    RunInProcesses(opts, configs, scenario, workers, argv[0], results);
+  else
+    RunInThreads(opts, configs, scenario, workers, results);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - sweepStart)
+                       .count();
+
+  ColumnTable table;
+  table.Resize(configs.size());
+  size_t runColumn = table.AddColumn("run");
+  // Controller parameters only matter to the path controllers
+  size_t paramCount = scenario.waypoint ? GetRobotParamNames().size()
+                                        : GetSweepParamNames().size();
+  for (size_t p = 0; p < paramCount; p++) {
+    const std::string &name = GetSweepParamNames()[p];
+    size_t column = table.AddColumn(name);
+    for (size_t i = 0; i < configs.size(); i++) {
+      float value = 0.0f;
+      GetSweepParam(configs[i], name, value);
+      table.Set(column, i, value);
+    }
+  }
+  size_t lapColumn = table.AddColumn("lap_time");
+  size_t positionColumn = table.AddColumn("final_position_error");
+  size_t headingColumn = table.AddColumn("final_heading_error");
+  size_t blocksColumn = table.AddColumn("blocks_collected");
+  size_t trackingColumn = table.AddColumn("tracking_error");
+  size_t msColumn = table.AddColumn("run_ms");
+  int finishedLaps = 0, failedRuns = 0;
+  for (size_t i = 0; i < configs.size(); i++) {
+    table.Set(runColumn, i, static_cast<double>(i));
+    if (results[i].failed) {
+      failedRuns++;
+      continue; // Result columns stay empty
+    }
+    table.Set(lapColumn, i, results[i].lapTime);
+    table.Set(positionColumn, i, results[i].positionError);
+    table.Set(headingColumn, i, results[i].headingError);
+    table.Set(blocksColumn, i, results[i].blocksCollected);
+    table.Set(trackingColumn, i, results[i].trackingError);
+    table.Set(msColumn, i, results[i].runMs);
+    finishedLaps += std::isnan(results[i].lapTime) ? 0 : 1;
+  }
+
+  std::string err;
+  if (!table.Save(opts.output, &err)) {
+    std::cerr << "[Sweep] " << err << std::endl;
+    return 1;
+  }
+  std::cerr << "[Sweep] " << configs.size() << " runs in " << seconds
+            << " s (" << configs.size() / std::max(seconds, 1e-9)
+            << " runs/s), " << finishedLaps << " finished the lap, "
+            << failedRuns << " failed -> " << opts.output << std::endl;
+  return 0;
+}
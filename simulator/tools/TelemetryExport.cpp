@@ -0,0 +1,161 @@
+// telemetry_export — converts a telemetry log (simulator --telemetry) to
+// CSV or a column table
+//
+//   telemetry_export log.vxtl [-o out.csv|.vxct] [--columns a,b,prefix*]
+//                    [--every N] [--info]
+//
+// The output starts with step and time columns, then the selected columns
+// (all by default; a trailing * matches by prefix, e.g. block3_*). --every
+// keeps every Nth step. --info lists the columns and sizes instead.
+#include "ColumnTable.h"
+#include "TelemetryLog.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+struct ExportOptions {
+  std::string input;
+  std::string output = "telemetry.csv";
+  std::vector<std::string> columns; // Empty = all
+  int every = 1;
+  bool info = false;
+};
+
+static void PrintUsage() {
+  std::cerr << "Usage: telemetry_export log.vxtl [-o out.csv|.vxct] "
+               "[--columns a,b,prefix*] [--every N] [--info]"
+            << std::endl;
+}
+
+static bool ParseArgs(int argc, char **argv, ExportOptions &opts) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if ((!strcmp(arg, "-o") || !strcmp(arg, "--output")) && value) {
+      opts.output = value;
+      i++;
+    } else if (!strcmp(arg, "--columns") && value) {
+      std::string list = value;
+      size_t start = 0;
+      while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos)
+          comma = list.size();
+        if (comma > start)
+          opts.columns.push_back(list.substr(start, comma - start));
+        start = comma + 1;
+      }
+      i++;
+    } else if (!strcmp(arg, "--every") && value) {
+      opts.every = std::atoi(value);
+      i++;
+    } else if (!strcmp(arg, "--info")) {
+      opts.info = true;
+    } else if (arg[0] != '-' && opts.input.empty()) {
+      opts.input = arg;
+    } else {
+      std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+      return false;
+    }
+  }
+  return !opts.input.empty() && opts.every >= 1;
+}
+
+static bool Matches(const std::string &name, const std::string &pattern) {
+  if (!pattern.empty() && pattern.back() == '*')
+    return name.compare(0, pattern.size() - 1, pattern, 0,
+                        pattern.size() - 1) == 0;
+  return name == pattern;
+}
+
+int main(int argc, char **argv) {
+  ExportOptions opts;
+  if (!ParseArgs(argc, argv, opts)) {
+    PrintUsage();
+    return 1;
+  }
+
+  TelemetryReader reader;
+  std::string err;
+  if (!reader.Open(opts.input, &err)) {
+    std::cerr << "[Export] " << err << std::endl;
+    return 1;
+  }
+  const std::vector<std::string> &names = reader.GetColumnNames();
+  std::vector<uint64_t> steps;
+  reader.GetRowNumbers(steps);
+
+  if (opts.info) {
+    std::error_code ec;
+    double bytes = static_cast<double>(
+        std::filesystem::file_size(opts.input, ec));
+    double raw = static_cast<double>(reader.GetRowCount()) * names.size() *
+                 sizeof(float);
+    std::cout << opts.input << ": " << reader.GetRowCount() << " steps of "
+              << reader.GetStepTime() * 1000.0f << " ms, " << names.size()
+              << " columns, " << bytes << " bytes (" << raw / bytes
+              << "x smaller than raw floats)" << std::endl;
+    if (!steps.empty() && steps.back() + 1 != steps.size())
+      std::cout << "  " << steps.back() + 1 - steps.size()
+                << " steps were dropped while logging" << std::endl;
+    for (const std::string &name : names)
+      std::cout << "  " << name << std::endl;
+    return 0;
+  }
+
+  std::vector<size_t> selected;
+  for (size_t c = 0; c < names.size(); c++) {
+    bool keep = opts.columns.empty();
+    for (const std::string &pattern : opts.columns)
+      keep = keep || Matches(names[c], pattern);
+    if (keep)
+      selected.push_back(c);
+  }
+  for (const std::string &pattern : opts.columns) {
+    bool found = false;
+    for (const std::string &name : names)
+      found = found || Matches(name, pattern);
+    if (!found) {
+      std::cerr << "[Export] No column matches " << pattern << std::endl;
+      return 1;
+    }
+  }
+
+  // Rows kept by --every, by step number so gaps stay aligned
+  std::vector<size_t> rows;
+  for (size_t r = 0; r < steps.size(); r++) {
+    if (steps[r] % opts.every == 0)
+      rows.push_back(r);
+  }
+
+  ColumnTable table;
+  table.Resize(rows.size());
+  size_t stepColumn = table.AddColumn("step");
+  size_t timeColumn = table.AddColumn("time");
+  for (size_t i = 0; i < rows.size(); i++) {
+    table.Set(stepColumn, i, static_cast<double>(steps[rows[i]]));
+    table.Set(timeColumn, i,
+              static_cast<double>(steps[rows[i]]) * reader.GetStepTime());
+  }
+  // One column at a time: only the selected columns are decoded
+  std::vector<float> values;
+  for (size_t c : selected) {
+    if (!reader.ReadColumn(c, values, &err)) {
+      std::cerr << "[Export] " << err << std::endl;
+      return 1;
+    }
+    size_t column = table.AddColumn(names[c]);
+    for (size_t i = 0; i < rows.size(); i++)
+      table.Set(column, i, values[rows[i]]);
+  }
+
+  if (!table.Save(opts.output, &err)) {
+    std::cerr << "[Export] " << err << std::endl;
+    return 1;
+  }
+  std::cerr << "[Export] " << rows.size() << " steps x " << selected.size()
+            << " columns -> " << opts.output << std::endl;
+  return 0;
+}